@@ -0,0 +1,353 @@
+/**
+ * \file BatchSpeedTest.cpp
+ * \brief Benchmarks of the SE3 batch kernels, against loops over the scalar
+ * functions.
+ * \details Each iteration processes BATCH_SIZE elements; run with --isa to
+ * compare the instruction sets.
+ *
+ * \author ASRL
+ */
+#include <cstdlib>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <lgmath/io/BinaryFormat.hpp>
+#include <lgmath/se3/Batch.hpp>
+#include <lgmath/se3/Operations.hpp>
+#include <lgmath/se3/TransformationWithCovariance.hpp>
+
+#include "Benchmark.hpp"
+
+namespace {
+
+using namespace lgmath;
+using namespace lgmath::benchmark;
+
+typedef Eigen::Matrix<double, 6, 1> Vector6d;
+
+/** \brief Number of elements per iteration */
+const std::size_t BATCH_SIZE = 1024;
+
+/** \brief Random algebra vectors in the batch layout */
+std::vector<double> randomVectors() {
+  std::vector<double> xi(6 * BATCH_SIZE);
+  for (double& x : xi) {
+    x = Eigen::Matrix<double, 1, 1>::Random()(0);
+  }
+  return xi;
+}
+
+/** \brief Random transformations in the batch layout */
+std::vector<double> randomTransforms() {
+  const std::vector<double> xi = randomVectors();
+  std::vector<double> T(se3::BATCH_POSE_ROWS * BATCH_SIZE);
+  se3::vec2tranBatch(xi.data(), T.data(), BATCH_SIZE);
+  return T;
+}
+
+void batchVec2tran(State& state) {
+  const std::vector<double> xi = randomVectors();
+  std::vector<double> T(se3::BATCH_POSE_ROWS * BATCH_SIZE);
+  for (auto _ : state) {
+    se3::vec2tranBatch(xi.data(), T.data(), BATCH_SIZE);
+    clobberMemory();
+  }
+  state.setBytesPerIteration(sizeof(double) * (xi.size() + T.size()));
+}
+LGMATH_BENCHMARK("se3/batch/vec2tran", batchVec2tran);
+
+void batchVec2tranScalar(State& state) {
+  std::vector<Vector6d> xi(BATCH_SIZE);
+  for (auto& v : xi) {
+    v = Vector6d::Random();
+  }
+  std::vector<Eigen::Matrix4d> T(BATCH_SIZE);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+      T[i] = se3::vec2tran(xi[i]);
+    }
+    clobberMemory();
+  }
+}
+LGMATH_BENCHMARK("se3/batch/vec2tran (scalar loop)", batchVec2tranScalar);
+
+void batchTran2vec(State& state) {
+  const std::vector<double> T = randomTransforms();
+  std::vector<double> xi(6 * BATCH_SIZE);
+  for (auto _ : state) {
+    se3::tran2vecBatch(T.data(), xi.data(), BATCH_SIZE);
+    clobberMemory();
+  }
+  state.setBytesPerIteration(sizeof(double) * (xi.size() + T.size()));
+}
+LGMATH_BENCHMARK("se3/batch/tran2vec", batchTran2vec);
+
+void batchTran2vecScalar(State& state) {
+  std::vector<Eigen::Matrix4d> T(BATCH_SIZE);
+  for (auto& T_i : T) {
+    T_i = se3::vec2tran(Vector6d::Random());
+  }
+  std::vector<Vector6d> xi(BATCH_SIZE);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+      xi[i] = se3::tran2vec(T[i]);
+    }
+    clobberMemory();
+  }
+}
+LGMATH_BENCHMARK("se3/batch/tran2vec (scalar loop)", batchTran2vecScalar);
+
+void batchTransformPoints(State& state) {
+  const se3::Transformation T_ba(Vector6d(Vector6d::Random()));
+  const std::vector<double> p_a = randomVectors();
+  std::vector<double> p_b(3 * BATCH_SIZE);
+  for (auto _ : state) {
+    se3::transformPointsBatch(T_ba, p_a.data(), p_b.data(), BATCH_SIZE);
+    clobberMemory();
+  }
+  state.setBytesPerIteration(sizeof(double) * 6 * BATCH_SIZE);
+}
+LGMATH_BENCHMARK("se3/batch/transformPoints", batchTransformPoints);
+
+void batchTransformPointsScalar(State& state) {
+  const se3::Transformation T_ba(Vector6d(Vector6d::Random()));
+  std::vector<Eigen::Vector4d> p_a(BATCH_SIZE), p_b(BATCH_SIZE);
+  for (auto& p : p_a) {
+    p << Eigen::Vector3d::Random(), 1.0;
+  }
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+      p_b[i] = T_ba * p_a[i];
+    }
+    clobberMemory();
+  }
+}
+LGMATH_BENCHMARK("se3/batch/transformPoints (scalar loop)",
+                 batchTransformPointsScalar);
+
+void batchPropagateCovariance(State& state) {
+  const std::vector<double> T = randomTransforms();
+  std::vector<double> cov(se3::BATCH_COVARIANCE_ROWS * BATCH_SIZE);
+  for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+    const Eigen::Matrix<double, 6, 6> A = Eigen::Matrix<double, 6, 6>::Random();
+    const auto packed = io::packCovariance(A * A.transpose());
+    for (std::size_t k = 0; k < se3::BATCH_COVARIANCE_ROWS; ++k) {
+      cov[k * BATCH_SIZE + i] = packed(k);
+    }
+  }
+  std::vector<double> out(cov.size());
+  for (auto _ : state) {
+    se3::propagateCovarianceBatch(T.data(), cov.data(), out.data(),
+                                  BATCH_SIZE);
+    clobberMemory();
+  }
+  state.setBytesPerIteration(sizeof(double) *
+                             (T.size() + cov.size() + out.size()));
+}
+LGMATH_BENCHMARK("se3/batch/propagateCovariance", batchPropagateCovariance);
+
+void batchPropagateCovarianceScalar(State& state) {
+  std::vector<Eigen::Matrix<double, 6, 6>> Ad(BATCH_SIZE), cov(BATCH_SIZE),
+      out(BATCH_SIZE);
+  for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+    Ad[i] = se3::tranAd(se3::vec2tran(Vector6d::Random()));
+    const Eigen::Matrix<double, 6, 6> A = Eigen::Matrix<double, 6, 6>::Random();
+    cov[i] = A * A.transpose();
+  }
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+      out[i] = Ad[i] * cov[i] * Ad[i].transpose();
+    }
+    clobberMemory();
+  }
+}
+LGMATH_BENCHMARK("se3/batch/propagateCovariance (scalar loop)",
+                 batchPropagateCovarianceScalar);
+
+void batchInverse(State& state) {
+  const std::vector<double> T = randomTransforms();
+  std::vector<double> out(T.size());
+  for (auto _ : state) {
+    se3::inverseBatch(T.data(), out.data(), BATCH_SIZE);
+    clobberMemory();
+  }
+  state.setBytesPerIteration(sizeof(double) * (T.size() + out.size()));
+}
+LGMATH_BENCHMARK("se3/batch/inverse", batchInverse);
+
+void batchInverseScalar(State& state) {
+  std::vector<se3::Transformation> T, out(BATCH_SIZE);
+  for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+    T.emplace_back(Vector6d(Vector6d::Random()));
+  }
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+      out[i] = T[i].inverse();
+    }
+    clobberMemory();
+  }
+}
+LGMATH_BENCHMARK("se3/batch/inverse (scalar loop)", batchInverseScalar);
+
+/** \brief Keyframe pairs: each pose with its successor and a random pose */
+std::vector<std::size_t> randomPairs() {
+  std::vector<std::size_t> pairs(2 * BATCH_SIZE);
+  for (std::size_t k = 0; k < BATCH_SIZE; ++k) {
+    pairs[k] = k;
+    pairs[BATCH_SIZE + k] =
+        k % 2 == 0 ? (k + 1) % BATCH_SIZE : std::rand() % BATCH_SIZE;
+  }
+  return pairs;
+}
+
+void batchRelativePoses(State& state) {
+  const std::vector<double> T = randomTransforms();
+  const std::vector<std::size_t> pairs = randomPairs();
+  std::vector<double> out(T.size());
+  for (auto _ : state) {
+    se3::relativePosesBatch(T.data(), BATCH_SIZE, pairs.data(), out.data(),
+                            BATCH_SIZE);
+    clobberMemory();
+  }
+}
+LGMATH_BENCHMARK("se3/batch/relativePoses", batchRelativePoses);
+
+void batchRelativePosesScalar(State& state) {
+  std::vector<se3::Transformation> T, out(BATCH_SIZE);
+  for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+    T.emplace_back(Vector6d(Vector6d::Random()));
+  }
+  const std::vector<std::size_t> pairs = randomPairs();
+  for (auto _ : state) {
+    for (std::size_t k = 0; k < BATCH_SIZE; ++k) {
+      out[k] = T[pairs[k]] / T[pairs[BATCH_SIZE + k]];
+    }
+    clobberMemory();
+  }
+}
+LGMATH_BENCHMARK("se3/batch/relativePoses (scalar loop)",
+                 batchRelativePosesScalar);
+
+void batchRelativePosesCovariance(State& state) {
+  const std::vector<double> T = randomTransforms();
+  const std::vector<std::size_t> pairs = randomPairs();
+  std::vector<double> cov(se3::BATCH_COVARIANCE_ROWS * BATCH_SIZE, 0.0);
+  for (std::size_t row = 0; row < 6; ++row) {
+    for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+      cov[(row * (13 - row) / 2) * BATCH_SIZE + i] = 1.0;
+    }
+  }
+  std::vector<double> out(T.size()), outCov(cov.size());
+  for (auto _ : state) {
+    se3::relativePosesBatch(T.data(), cov.data(), BATCH_SIZE, pairs.data(),
+                            out.data(), outCov.data(), BATCH_SIZE);
+    clobberMemory();
+  }
+}
+LGMATH_BENCHMARK("se3/batch/relativePoses+covariance",
+                 batchRelativePosesCovariance);
+
+void batchRelativePosesCovarianceScalar(State& state) {
+  std::vector<se3::TransformationWithCovariance> T, out(BATCH_SIZE);
+  for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+    T.emplace_back(se3::Transformation(Vector6d(Vector6d::Random())),
+                   Eigen::Matrix<double, 6, 6>::Identity());
+  }
+  const std::vector<std::size_t> pairs = randomPairs();
+  for (auto _ : state) {
+    for (std::size_t k = 0; k < BATCH_SIZE; ++k) {
+      out[k] = T[pairs[k]] / T[pairs[BATCH_SIZE + k]];
+    }
+    clobberMemory();
+  }
+}
+LGMATH_BENCHMARK("se3/batch/relativePoses+covariance (scalar loop)",
+                 batchRelativePosesCovarianceScalar);
+
+void batchApplyJac(State& state) {
+  const std::vector<double> xi = randomVectors();
+  const std::vector<double> v = randomVectors();
+  std::vector<double> out(6 * BATCH_SIZE);
+  for (auto _ : state) {
+    se3::applyJacBatch(xi.data(), v.data(), out.data(), BATCH_SIZE);
+    clobberMemory();
+  }
+  state.setBytesPerIteration(sizeof(double) * 18 * BATCH_SIZE);
+}
+LGMATH_BENCHMARK("se3/batch/applyJac", batchApplyJac);
+
+void batchApplyJacScalar(State& state) {
+  std::vector<Vector6d> xi(BATCH_SIZE), v(BATCH_SIZE), out(BATCH_SIZE);
+  for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+    xi[i] = Vector6d::Random();
+    v[i] = Vector6d::Random();
+  }
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+      out[i] = se3::applyJac(xi[i], v[i]);
+    }
+    clobberMemory();
+  }
+}
+LGMATH_BENCHMARK("se3/batch/applyJac (scalar loop)", batchApplyJacScalar);
+
+void batchApplyJacInv(State& state) {
+  const std::vector<double> xi = randomVectors();
+  const std::vector<double> v = randomVectors();
+  std::vector<double> out(6 * BATCH_SIZE);
+  for (auto _ : state) {
+    se3::applyJacInvBatch(xi.data(), v.data(), out.data(), BATCH_SIZE);
+    clobberMemory();
+  }
+  state.setBytesPerIteration(sizeof(double) * 18 * BATCH_SIZE);
+}
+LGMATH_BENCHMARK("se3/batch/applyJacInv", batchApplyJacInv);
+
+void batchApplyJacInvScalar(State& state) {
+  std::vector<Vector6d> xi(BATCH_SIZE), v(BATCH_SIZE), out(BATCH_SIZE);
+  for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+    xi[i] = Vector6d::Random();
+    v[i] = Vector6d::Random();
+  }
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+      out[i] = se3::applyJacInv(xi[i], v[i]);
+    }
+    clobberMemory();
+  }
+}
+LGMATH_BENCHMARK("se3/batch/applyJacInv (scalar loop)", batchApplyJacInvScalar);
+
+void batchInterpolate(State& state) {
+  const se3::Transformation T_0(Vector6d(Vector6d::Random()));
+  const se3::Transformation T_1(Vector6d(Vector6d::Random()));
+  std::vector<double> alpha(BATCH_SIZE), T(se3::BATCH_POSE_ROWS * BATCH_SIZE);
+  for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+    alpha[i] = double(i) / BATCH_SIZE;
+  }
+  for (auto _ : state) {
+    se3::interpolateBatch(T_0, T_1, alpha.data(), T.data(), BATCH_SIZE);
+    clobberMemory();
+  }
+  state.setBytesPerIteration(sizeof(double) * (alpha.size() + T.size()));
+}
+LGMATH_BENCHMARK("se3/batch/interpolate", batchInterpolate);
+
+void batchInterpolateScalar(State& state) {
+  const se3::Transformation T_0(Vector6d(Vector6d::Random()));
+  const se3::Transformation T_1(Vector6d(Vector6d::Random()));
+  std::vector<se3::Transformation> T(BATCH_SIZE);
+  for (auto _ : state) {
+    // The hand-rolled form, with a logarithm per element
+    for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+      const double alpha = double(i) / BATCH_SIZE;
+      T[i] = T_0 *
+             se3::Transformation(Vector6d(alpha * (T_0.inverse() * T_1).vec()));
+    }
+    clobberMemory();
+  }
+}
+LGMATH_BENCHMARK("se3/batch/interpolate (scalar loop)", batchInterpolateScalar);
+
+}  // namespace
@@ -0,0 +1,466 @@
+/**
+ * \file Benchmark.cpp
+ * \brief Runner of the lgmath micro-benchmarks.
+ * \details Usage: lgmath_benchmarks [--filter=REGEX] [--json=FILE]
+ * [--repetitions=N] [--batch-ms=T] [--warmup-ms=T] [--perf] [--list]
+ * [--isa=NAME[,NAME...]|all]
+ *
+ * With --isa, the benchmarks are run once per listed instruction set of the
+ * batch kernels (see lgmath/Dispatch.hpp), and the name of the instruction set
+ * is appended to the benchmark names.
+ *
+ * With --perf, the hardware counters of the timed loops are also reported per
+ * call (see PerfCounters.hpp).
+ *
+ * \author ASRL
+ */
+#include "Benchmark.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+
+#include <lgmath/Dispatch.hpp>
+
+namespace lgmath {
+namespace benchmark {
+
+std::vector<Benchmark>& registry() {
+  static std::vector<Benchmark> benchmarks;
+  return benchmarks;
+}
+
+namespace {
+
+/** \brief Command line options */
+struct Options {
+  std::string filter = ".*";
+  std::string json;
+  unsigned int repetitions = 100;
+  double batchNanoseconds = 1e6;
+  double warmupNanoseconds = 1e8;
+  bool perf = false;
+  bool list = false;
+  std::vector<common::Isa> isas;
+};
+
+/** \brief Timing statistics of one benchmark, per iteration */
+struct Result {
+  std::string name;
+  std::size_t iterations;
+  unsigned int repetitions;
+  double min;
+  double median;
+  double mean;
+  double p99;
+  double stddev;
+  double bytesPerSecond;
+
+  /** \brief Hardware counters per call, negative if unavailable */
+  PerfValues counters;
+};
+
+/** \brief Description of the machine the benchmarks ran on */
+struct Context {
+  std::string date;
+  std::string host;
+  std::string cpu;
+  long cpus;
+  double mhz;
+  std::string governor;
+  std::string compiler;
+  std::string isa;
+  bool debug;
+  std::vector<std::string> warnings;
+};
+
+/** \brief Parses a comma separated list of instruction sets, or "all" */
+std::vector<common::Isa> parseIsas(const std::string& value) {
+  if (value == "all") {
+    return common::supportedIsas();
+  }
+  std::vector<common::Isa> isas;
+  std::stringstream stream(value);
+  std::string name;
+  while (std::getline(stream, name, ',')) {
+    const common::Isa isa = common::parseIsa(name);
+    if (!common::isaSupported(isa)) {
+      throw std::invalid_argument("Instruction set '" + name +
+                                  "' is not supported on this machine");
+    }
+    isas.push_back(isa);
+  }
+  return isas;
+}
+
+Options parseOptions(int argc, char** argv) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const std::size_t eq = arg.find('=');
+    const std::string key = arg.substr(0, eq);
+    const std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+    if (key == "--filter") {
+      options.filter = value;
+    } else if (key == "--json") {
+      options.json = value;
+    } else if (key == "--repetitions") {
+      options.repetitions = std::max(1, std::stoi(value));
+    } else if (key == "--batch-ms") {
+      options.batchNanoseconds = 1e6 * std::stod(value);
+    } else if (key == "--warmup-ms") {
+      options.warmupNanoseconds = 1e6 * std::stod(value);
+    } else if (key == "--perf") {
+      options.perf = true;
+    } else if (key == "--list") {
+      options.list = true;
+    } else if (key == "--isa") {
+      options.isas = parseIsas(value);
+    } else {
+      throw std::invalid_argument("Unknown option '" + arg + "'");
+    }
+  }
+  return options;
+}
+
+/** \brief Reads the first line of a file, or returns an empty string */
+std::string readLine(const std::string& path) {
+  std::ifstream file(path);
+  std::string line;
+  std::getline(file, line);
+  return line;
+}
+
+/** \brief Gets the value of the first key in /proc/cpuinfo */
+std::string cpuinfo(const std::string& key) {
+  std::ifstream file("/proc/cpuinfo");
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.compare(0, key.size(), key) == 0) {
+      const std::size_t colon = line.find(':');
+      if (colon != std::string::npos && colon + 2 <= line.size()) {
+        return line.substr(colon + 2);
+      }
+    }
+  }
+  return "";
+}
+
+Context getContext() {
+  Context context;
+  char buffer[256];
+  const std::time_t now = std::time(nullptr);
+  std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S%z",
+                std::localtime(&now));
+  context.date = buffer;
+  context.host = gethostname(buffer, sizeof(buffer)) == 0 ? buffer : "";
+  context.cpu = cpuinfo("model name");
+  context.cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  const std::string mhz = cpuinfo("cpu MHz");
+  context.mhz = mhz.empty() ? 0.0 : std::stod(mhz);
+  context.governor =
+      readLine("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor");
+  context.compiler = __VERSION__;
+  context.isa = common::isaName(common::activeIsa());
+#ifdef NDEBUG
+  context.debug = false;
+#else
+  context.debug = true;
+#endif
+
+  if (!context.governor.empty() && context.governor != "performance") {
+    context.warnings.push_back(
+        "CPU frequency scaling is enabled (governor '" + context.governor +
+        "'), timings will be noisy; set the 'performance' governor.");
+  }
+  if (readLine("/sys/devices/system/cpu/intel_pstate/no_turbo") == "0" ||
+      readLine("/sys/devices/system/cpu/cpufreq/boost") == "1") {
+    context.warnings.push_back(
+        "CPU turbo boost is enabled, timings depend on temperature and load.");
+  }
+  if (context.debug) {
+    context.warnings.push_back(
+        "The benchmarks were built without NDEBUG, timings are not "
+        "representative of a release build.");
+  }
+  return context;
+}
+
+/** \brief Runs one batch of the benchmark, returns ns per iteration */
+double runBatch(const Benchmark& benchmark, std::size_t iterations,
+                std::size_t* bytesPerIteration,
+                PerfCounters* counters = nullptr) {
+  State state(iterations, counters);
+  benchmark.function(state);
+  *bytesPerIteration = state.bytesPerIteration();
+  return state.elapsedNanoseconds() / iterations;
+}
+
+Result run(const Benchmark& benchmark, const Options& options,
+           PerfCounters* counters) {
+  std::size_t bytes = 0;
+
+  // Calibrate the batch size; this also warms up caches and branch predictors
+  std::size_t iterations = 1;
+  double spent = 0.0;
+  for (;;) {
+    const double perIteration = runBatch(benchmark, iterations, &bytes);
+    spent += perIteration * iterations;
+    if (perIteration * iterations >= 0.5 * options.batchNanoseconds) {
+      break;
+    }
+    const double scale =
+        options.batchNanoseconds / std::max(perIteration * iterations, 1.0);
+    iterations = std::size_t(
+        std::ceil(iterations * std::min(std::max(scale, 2.0), 100.0)));
+  }
+  const double perIteration = runBatch(benchmark, iterations, &bytes);
+  spent += perIteration * iterations;
+  iterations = std::max<std::size_t>(
+      1, std::size_t(options.batchNanoseconds / perIteration));
+
+  // Warm up, e.g. until the CPU leaves its idle frequency
+  while (spent < options.warmupNanoseconds) {
+    spent += runBatch(benchmark, iterations, &bytes) * iterations;
+  }
+
+  std::vector<double> samples(options.repetitions);
+  PerfValues counts;
+  counts.fill(0.0);
+  for (double& sample : samples) {
+    sample = runBatch(benchmark, iterations, &bytes, counters);
+    if (counters != nullptr) {
+      const PerfValues values = counters->read();
+      for (std::size_t i = 0; i < NUM_PERF_EVENTS; ++i) {
+        counts[i] = (values[i] < 0.0 || counts[i] < 0.0)
+                        ? -1.0
+                        : counts[i] + values[i];
+      }
+    }
+  }
+  std::sort(samples.begin(), samples.end());
+
+  Result result;
+  result.name = benchmark.name;
+  result.iterations = iterations;
+  result.repetitions = options.repetitions;
+  const std::size_t n = samples.size();
+  result.min = samples.front();
+  result.median = 0.5 * (samples[(n - 1) / 2] + samples[n / 2]);
+  result.p99 = samples[std::size_t(std::ceil(0.99 * n)) - 1];
+  double sum = 0.0, sumSq = 0.0;
+  for (double sample : samples) {
+    sum += sample;
+    sumSq += sample * sample;
+  }
+  result.mean = sum / n;
+  result.stddev =
+      std::sqrt(std::max(0.0, sumSq / n - result.mean * result.mean));
+  result.bytesPerSecond = bytes == 0 ? 0.0 : 1e9 * bytes / result.median;
+  for (std::size_t i = 0; i < NUM_PERF_EVENTS; ++i) {
+    result.counters[i] =
+        counters == nullptr || counts[i] < 0.0
+            ? -1.0
+            : counts[i] / (double(iterations) * options.repetitions);
+  }
+  return result;
+}
+
+std::string escape(const std::string& text) {
+  std::string escaped;
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+    }
+    escaped += c;
+  }
+  return escaped;
+}
+
+void writeJson(const std::string& path, const Context& context,
+               const std::vector<Result>& results, bool perf) {
+  std::ofstream out(path);
+  if (!out) {
+    throw std::runtime_error("Could not open '" + path + "'");
+  }
+  out << std::setprecision(10);
+  out << "{\n  \"context\": {\n"
+      << "    \"date\": \"" << escape(context.date) << "\",\n"
+      << "    \"host\": \"" << escape(context.host) << "\",\n"
+      << "    \"cpu\": \"" << escape(context.cpu) << "\",\n"
+      << "    \"num_cpus\": " << context.cpus << ",\n"
+      << "    \"mhz\": " << context.mhz << ",\n"
+      << "    \"governor\": \"" << escape(context.governor) << "\",\n"
+      << "    \"compiler\": \"" << escape(context.compiler) << "\",\n"
+      << "    \"isa\": \"" << escape(context.isa) << "\",\n"
+      << "    \"debug\": " << (context.debug ? "true" : "false") << "\n"
+      << "  },\n  \"benchmarks\": [";
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    const Result& r = results[i];
+    out << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << escape(r.name)
+        << "\", \"iterations\": " << r.iterations
+        << ", \"repetitions\": " << r.repetitions << ", \"min_ns\": " << r.min
+        << ", \"median_ns\": " << r.median << ", \"mean_ns\": " << r.mean
+        << ", \"p99_ns\": " << r.p99 << ", \"stddev_ns\": " << r.stddev
+        << ", \"bytes_per_second\": " << r.bytesPerSecond;
+    if (perf) {
+      out << ", \"counters\": {";
+      for (std::size_t e = 0; e < NUM_PERF_EVENTS; ++e) {
+        out << (e == 0 ? "" : ", ") << "\"" << perfEventName(PerfEvent(e))
+            << "\": ";
+        if (r.counters[e] < 0.0) {
+          out << "null";
+        } else {
+          out << r.counters[e];
+        }
+      }
+      out << "}";
+    }
+    out << "}";
+  }
+  out << "\n  ]\n}\n";
+}
+
+}  // namespace
+}  // namespace benchmark
+}  // namespace lgmath
+
+int main(int argc, char** argv) {
+  using namespace lgmath::benchmark;
+  Options options;
+  try {
+    options = parseOptions(argc, argv);
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  const std::regex filter(options.filter);
+  std::vector<Benchmark> benchmarks;
+  for (const Benchmark& benchmark : registry()) {
+    if (std::regex_search(benchmark.name, filter)) {
+      benchmarks.push_back(benchmark);
+    }
+  }
+  std::sort(benchmarks.begin(), benchmarks.end(),
+            [](const Benchmark& a, const Benchmark& b) {
+              return a.name < b.name;
+            });
+  if (options.list) {
+    for (const Benchmark& benchmark : benchmarks) {
+      std::cout << benchmark.name << std::endl;
+    }
+    return 0;
+  }
+
+  const Context context = getContext();
+  std::cout << "Date:     " << context.date << std::endl;
+  std::cout << "CPU:      " << context.cpu << " (" << context.cpus
+            << " cores, " << context.mhz << " MHz)" << std::endl;
+  std::cout << "Compiler: " << context.compiler << std::endl;
+  std::cout << "ISA:      " << context.isa << std::endl;
+  for (const std::string& warning : context.warnings) {
+    std::cout << "WARNING:  " << warning << std::endl;
+  }
+  std::cout << std::endl;
+
+  // Counters are per thread, and benchmarks run on this thread
+  std::unique_ptr<PerfCounters> counters;
+  if (options.perf) {
+    counters.reset(new PerfCounters());
+    if (!counters->available()) {
+      std::cout << "NOTE:     Hardware counters are unavailable ("
+                << counters->error() << "), reporting timings only."
+                << std::endl;
+      counters.reset();
+    } else if (!counters->error().empty()) {
+      std::cout << "NOTE:     Some hardware counters are unavailable ("
+                << counters->error() << ")." << std::endl;
+    }
+    std::cout << std::endl;
+  }
+
+  // Without --isa, run once on the active instruction set
+  std::vector<lgmath::common::Isa> isas = options.isas;
+  if (isas.empty()) {
+    isas.push_back(lgmath::common::activeIsa());
+  }
+  int width = 12;
+  for (const Benchmark& benchmark : benchmarks) {
+    width = std::max(width, int(benchmark.name.size()) + 2);
+  }
+  if (!options.isas.empty()) {
+    width += 10;
+  }
+  std::cout << std::left << std::setw(width) << "Benchmark" << std::right
+            << std::setw(10) << "Batch" << std::setw(11) << "Min ns"
+            << std::setw(11) << "Median ns" << std::setw(11) << "Mean ns"
+            << std::setw(11) << "p99 ns" << std::setw(11) << "MB/s";
+  if (counters) {
+    std::cout << std::setw(10) << "Cycles" << std::setw(10) << "Instr"
+              << std::setw(7) << "IPC" << std::setw(10) << "Br-miss"
+              << std::setw(10) << "L1D-miss" << std::setw(10) << "LLC-miss";
+  }
+  std::cout << std::endl;
+  std::cout << std::string(width + 65 + (counters ? 57 : 0), '-')
+            << std::endl;
+
+  std::vector<Result> results;
+  for (const Benchmark& benchmark : benchmarks) {
+    for (lgmath::common::Isa isa : isas) {
+      lgmath::common::setIsa(isa);
+      Result r = run(benchmark, options, counters.get());
+      if (!options.isas.empty()) {
+        r.name += std::string(" [") + lgmath::common::isaName(isa) + "]";
+      }
+      std::cout << std::left << std::setw(width) << r.name << std::right
+                << std::setw(10) << r.iterations << std::fixed
+                << std::setprecision(1) << std::setw(11) << r.min
+                << std::setw(11) << r.median << std::setw(11) << r.mean
+                << std::setw(11) << r.p99 << std::setw(11);
+      if (r.bytesPerSecond > 0.0) {
+        std::cout << r.bytesPerSecond / (1024.0 * 1024.0);
+      } else {
+        std::cout << "-";
+      }
+      if (counters) {
+        const double cycles = r.counters[std::size_t(PerfEvent::CYCLES)];
+        const double instructions =
+            r.counters[std::size_t(PerfEvent::INSTRUCTIONS)];
+        for (std::size_t e = 0; e < NUM_PERF_EVENTS; ++e) {
+          std::cout << std::setw(10);
+          if (r.counters[e] < 0.0) {
+            std::cout << "-";
+          } else {
+            std::cout << r.counters[e];
+          }
+          if (PerfEvent(e) == PerfEvent::INSTRUCTIONS) {
+            std::cout << std::setw(7) << std::setprecision(2);
+            if (cycles > 0.0 && instructions >= 0.0) {
+              std::cout << instructions / cycles;
+            } else {
+              std::cout << "-";
+            }
+            std::cout << std::setprecision(1);
+          }
+        }
+      }
+      std::cout << std::endl;
+      results.push_back(r);
+    }
+  }
+
+  if (!options.json.empty()) {
+    writeJson(options.json, context, results, options.perf);
+  }
+  return 0;
+}
@@ -0,0 +1,176 @@
+/**
+ * \file Benchmark.hpp
+ * \brief A small statistical micro-benchmark harness.
+ * \details Benchmarks are registered with LGMATH_BENCHMARK and run by the
+ * lgmath_benchmarks executable. Each benchmark is warmed up, its batch size is
+ * calibrated so that one batch takes a fixed time, and then it is timed over a
+ * number of repeated batches; the min/median/mean/p99 time per iteration is
+ * reported, and optionally exported as JSON so that results can be tracked over
+ * time.
+ *
+ *   void so3Vec2rot(lgmath::benchmark::State& state) {
+ *     Eigen::Vector3d aaxis = Eigen::Vector3d::Random();  // not timed
+ *     for (auto _ : state) {                              // timed
+ *       lgmath::benchmark::doNotOptimize(lgmath::so3::vec2rot(aaxis));
+ *     }
+ *   }
+ *   LGMATH_BENCHMARK("so3/vec2rot", so3Vec2rot);
+ *
+ * \author ASRL
+ */
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "PerfCounters.hpp"
+
+namespace lgmath {
+namespace benchmark {
+
+/**
+ * \brief Number of distinct inputs that benchmarks cycle through.
+ * \details Cycling through random inputs, rather than repeating one, keeps the
+ * branch predictor from learning a single path; a power of two so that the
+ * index is a mask.
+ */
+static constexpr std::size_t NUM_INPUTS = 256;
+
+/**
+ * \brief Prevents the compiler from optimizing away the computation of value.
+ * \details The address of value escapes to an empty asm block that may read
+ * any memory, so value must be materialized.
+ */
+template <class T>
+inline void doNotOptimize(const T& value) {
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+/** \brief Forces pending writes to memory to be considered observable */
+inline void clobberMemory() { asm volatile("" : : : "memory"); }
+
+/**
+ * \brief Controls the timed loop of a benchmark.
+ * \details Iterating over the state runs the requested number of iterations;
+ * the clock (and the hardware counters, if any) starts when the loop begins
+ * and stops when it ends, so setup before the loop is not measured.
+ */
+class State {
+ public:
+  /**
+   * \brief Value of the timed loop; it has a user-provided destructor so that
+   * the unused loop variable does not trigger a warning
+   */
+  struct Value {
+    ~Value() {}
+  };
+
+  /** \brief Iterator of the timed loop */
+  class Iterator {
+   public:
+    Iterator(State* state, std::size_t remaining)
+        : state_(state), remaining_(remaining) {}
+    bool operator!=(const Iterator&) {
+      if (remaining_ != 0) {
+        return true;
+      }
+      state_->stop();
+      return false;
+    }
+    Iterator& operator++() {
+      --remaining_;
+      return *this;
+    }
+    Value operator*() const { return Value(); }
+
+   private:
+    State* state_;
+    std::size_t remaining_;
+  };
+
+  /** \brief Constructor, counters may be null */
+  explicit State(std::size_t iterations, PerfCounters* counters = nullptr)
+      : iterations_(iterations),
+        bytesPerIteration_(0),
+        counters_(counters),
+        elapsed_(0) {}
+
+  /** \brief Gets the number of iterations of the timed loop */
+  std::size_t iterations() const { return iterations_; }
+
+  /** \brief Sets the bytes processed by each iteration, to report MB/s */
+  void setBytesPerIteration(std::size_t bytes) { bytesPerIteration_ = bytes; }
+
+  /** \brief Gets the bytes processed by each iteration */
+  std::size_t bytesPerIteration() const { return bytesPerIteration_; }
+
+  /** \brief Gets the time spent in the timed loop, in nanoseconds */
+  double elapsedNanoseconds() const { return elapsed_; }
+
+  Iterator begin() {
+    if (counters_ != nullptr) {
+      counters_->start();
+    }
+    start_ = std::chrono::steady_clock::now();
+    return Iterator(this, iterations_);
+  }
+  Iterator end() { return Iterator(this, 0); }
+
+ private:
+  void stop() {
+    elapsed_ = std::chrono::duration<double, std::nano>(
+                   std::chrono::steady_clock::now() - start_)
+                   .count();
+    if (counters_ != nullptr) {
+      counters_->stop();
+    }
+  }
+
+  /** \brief Number of iterations of the timed loop */
+  std::size_t iterations_;
+
+  /** \brief Bytes processed by each iteration */
+  std::size_t bytesPerIteration_;
+
+  /** \brief Hardware counters around the timed loop, may be null */
+  PerfCounters* counters_;
+
+  /** \brief Start of the timed loop */
+  std::chrono::steady_clock::time_point start_;
+
+  /** \brief Time spent in the timed loop, in nanoseconds */
+  double elapsed_;
+};
+
+/** \brief A benchmark function */
+typedef void (*Function)(State&);
+
+/** \brief A registered benchmark */
+struct Benchmark {
+  std::string name;
+  Function function;
+};
+
+/** \brief Gets all registered benchmarks */
+std::vector<Benchmark>& registry();
+
+/** \brief Registers a benchmark at static initialization */
+struct Registrar {
+  Registrar(const char* name, Function function) {
+    registry().push_back(Benchmark{name, function});
+  }
+};
+
+}  // namespace benchmark
+}  // namespace lgmath
+
+#define LGMATH_BENCHMARK_CONCAT_(a, b) a##b
+#define LGMATH_BENCHMARK_CONCAT(a, b) LGMATH_BENCHMARK_CONCAT_(a, b)
+
+/** \brief Registers function under name */
+#define LGMATH_BENCHMARK(name, function)                  \
+  static ::lgmath::benchmark::Registrar                   \
+      LGMATH_BENCHMARK_CONCAT(lgmathBenchmark, __LINE__)( \
+          name, function)
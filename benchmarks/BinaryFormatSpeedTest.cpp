@@ -0,0 +1,73 @@
+/**
+ * \file BinaryFormatSpeedTest.cpp
+ * \brief Benchmarks of the binary encoding of transformations.
+ *
+ * \author ASRL
+ */
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <lgmath/io/BinaryFormat.hpp>
+#include <lgmath/se3/TransformationWithCovariance.hpp>
+
+#include "Benchmark.hpp"
+
+namespace {
+
+using namespace lgmath;
+using namespace lgmath::benchmark;
+
+const std::size_t RECORD = io::TRANSFORMATION_WITH_COVARIANCE_RECORD_SIZE;
+
+se3::TransformationWithCovariance randomTransform() {
+  Eigen::Matrix<double, 6, 1> xi = Eigen::Matrix<double, 6, 1>::Random();
+  Eigen::Matrix<double, 6, 6> A = Eigen::Matrix<double, 6, 6>::Random();
+  return se3::TransformationWithCovariance(xi, A * A.transpose());
+}
+
+/** \brief Records of NUM_INPUTS random transformations */
+std::vector<unsigned char> randomRecords() {
+  std::vector<unsigned char> buffer(NUM_INPUTS * RECORD);
+  for (std::size_t i = 0; i < NUM_INPUTS; ++i) {
+    io::encode(randomTransform(), &buffer[i * RECORD], RECORD);
+  }
+  return buffer;
+}
+
+void binaryEncode(State& state) {
+  const se3::TransformationWithCovariance T = randomTransform();
+  std::vector<unsigned char> buffer(NUM_INPUTS * RECORD);
+  state.setBytesPerIteration(RECORD);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    io::encode(T, &buffer[(i++ & (NUM_INPUTS - 1)) * RECORD], RECORD);
+    clobberMemory();
+  }
+}
+LGMATH_BENCHMARK("io/BinaryFormat/encode", binaryEncode);
+
+void binaryDecode(State& state) {
+  const auto buffer = randomRecords();
+  state.setBytesPerIteration(RECORD);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    doNotOptimize(io::decodeTransformationWithCovariance(
+        &buffer[(i++ & (NUM_INPUTS - 1)) * RECORD], RECORD));
+  }
+}
+LGMATH_BENCHMARK("io/BinaryFormat/decode", binaryDecode);
+
+void binaryView(State& state) {
+  const auto buffer = randomRecords();
+  state.setBytesPerIteration(RECORD);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    io::TransformationWithCovarianceView view(
+        &buffer[(i++ & (NUM_INPUTS - 1)) * RECORD], RECORD);
+    doNotOptimize(view.r_ab_inb()(0) + view.packedCov()(0));
+  }
+}
+LGMATH_BENCHMARK("io/BinaryFormat/view", binaryView);
+
+}  // namespace
@@ -0,0 +1,57 @@
+/**
+ * \file CachedTransformationSpeedTest.cpp
+ * \brief Benchmarks of the CachedTransformation class.
+ * \details Each iteration queries vec() and adjoint() of one pose, as a
+ * pose-graph edge would; every pose is modified once per READS queries, so the
+ * cache hit rate is (READS - 1) / READS.
+ *
+ * \author ASRL
+ */
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <lgmath/se3/CachedTransformation.hpp>
+#include <lgmath/se3/Transformation.hpp>
+
+#include "Benchmark.hpp"
+
+namespace {
+
+using namespace lgmath;
+using namespace lgmath::benchmark;
+
+typedef Eigen::Matrix<double, 6, 1> Vector6d;
+
+template <class TransformationType, std::size_t READS>
+void queryPoses(State& state) {
+  std::vector<se3::Transformation> inputs;
+  for (std::size_t i = 0; i < NUM_INPUTS; ++i) {
+    inputs.emplace_back(Vector6d(Vector6d::Random()));
+  }
+  std::vector<TransformationType> poses(inputs.begin(), inputs.end());
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i & (NUM_INPUTS - 1);
+    if ((i / NUM_INPUTS) % READS == 0) {
+      // The optimizer moved this pose since its last sweep
+      poses[j] = inputs[j];
+    }
+    ++i;
+    doNotOptimize(poses[j].vec());
+    doNotOptimize(poses[j].adjoint());
+  }
+}
+
+LGMATH_BENCHMARK("CachedTransformation/vec+adjoint (uncached)",
+                 (queryPoses<se3::Transformation, 1>));
+LGMATH_BENCHMARK("CachedTransformation/vec+adjoint (hit rate 0%)",
+                 (queryPoses<se3::CachedTransformation, 1>));
+LGMATH_BENCHMARK("CachedTransformation/vec+adjoint (hit rate 50%)",
+                 (queryPoses<se3::CachedTransformation, 2>));
+LGMATH_BENCHMARK("CachedTransformation/vec+adjoint (hit rate 75%)",
+                 (queryPoses<se3::CachedTransformation, 4>));
+LGMATH_BENCHMARK("CachedTransformation/vec+adjoint (hit rate 94%)",
+                 (queryPoses<se3::CachedTransformation, 16>));
+
+}  // namespace
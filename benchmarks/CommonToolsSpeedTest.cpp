@@ -0,0 +1,68 @@
+/**
+ * \file CommonToolsSpeedTest.cpp
+ * \brief Benchmarks of the timers and latency probes, i.e. their overhead.
+ *
+ * \author ASRL
+ */
+#include <lgmath/CommonTools.hpp>
+#include <lgmath/Trace.hpp>
+
+#include "Benchmark.hpp"
+
+namespace {
+
+using namespace lgmath;
+using namespace lgmath::benchmark;
+
+void commonTimer(State& state) {
+  common::Timer timer;
+  for (auto _ : state) {
+    doNotOptimize(timer.nanoseconds());
+  }
+}
+LGMATH_BENCHMARK("common/Timer", commonTimer);
+
+void commonTscClock(State& state) {
+  for (auto _ : state) {
+    doNotOptimize(common::TscClock::now());
+  }
+}
+LGMATH_BENCHMARK("common/TscClock", commonTscClock);
+
+void commonHistogramRecord(State& state) {
+  common::LatencyHistogram histogram;
+  std::uint64_t value = 0;
+  for (auto _ : state) {
+    histogram.record(value++ & 1023);
+  }
+  doNotOptimize(histogram);
+}
+LGMATH_BENCHMARK("common/LatencyHistogram/record", commonHistogramRecord);
+
+void commonScopedProbe(State& state) {
+  common::TscClock::nanosecondsPerTick();
+  for (auto _ : state) {
+    LGMATH_SCOPED_PROBE("benchmark/probe");
+  }
+}
+LGMATH_BENCHMARK("common/ScopedProbe", commonScopedProbe);
+
+void commonTraceScopeDisabled(State& state) {
+  common::setTracingEnabled(false);
+  for (auto _ : state) {
+    LGMATH_TRACE_SCOPE("benchmark/trace");
+  }
+}
+LGMATH_BENCHMARK("common/TraceScope/disabled", commonTraceScopeDisabled);
+
+void commonTraceScopeEnabled(State& state) {
+  common::setTracingEnabled(true);
+  for (auto _ : state) {
+    LGMATH_TRACE_SCOPE("benchmark/trace");
+  }
+  common::setTracingEnabled(false);
+  common::clearTrace();
+}
+LGMATH_BENCHMARK("common/TraceScope/enabled", commonTraceScopeEnabled);
+
+}  // namespace
@@ -0,0 +1,117 @@
+/**
+ * \file DeskewSpeedTest.cpp
+ * \brief Benchmarks of the de-skew of a lidar scan, against the exact pose of
+ * every point.
+ * \details Each iteration de-skews one scan of NUM_POINTS points in time
+ * order.
+ *
+ * \author ASRL
+ */
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <lgmath/Parallel.hpp>
+#include <lgmath/se3/Batch.hpp>
+#include <lgmath/se3/Deskew.hpp>
+#include <lgmath/se3/Transformation.hpp>
+
+#include "Benchmark.hpp"
+
+namespace {
+
+using namespace lgmath;
+using namespace lgmath::benchmark;
+
+typedef Eigen::Matrix<double, 6, 1> Vector6d;
+
+/** \brief Number of points of a scan */
+const std::size_t NUM_POINTS = 131072;
+
+/** \brief The motion over the scan */
+const se3::Transformation T_END(
+    Vector6d((Vector6d() << 2.0, 0.1, 0.0, 0.02, -0.05, 0.5).finished()));
+
+/** \brief A scan in time order, in the layout of se3/Batch.hpp */
+struct Scan {
+  Scan() : t(NUM_POINTS), p(3 * NUM_POINTS), out(3 * NUM_POINTS) {
+    for (std::size_t i = 0; i < NUM_POINTS; ++i) {
+      t[i] = 0.1 * i / NUM_POINTS;
+    }
+    for (double& x : p) {
+      x = 50.0 * Eigen::Matrix<double, 1, 1>::Random()(0);
+    }
+  }
+  std::vector<double> t, p, out;
+};
+
+/** \brief The hand-rolled exact pose per point */
+void deskewScalar(State& state) {
+  Scan scan;
+  const se3::Transformation T_start;
+  for (auto _ : state) {
+    const Vector6d xi = (T_start.inverse() * T_END).vec();
+    for (std::size_t i = 0; i < NUM_POINTS; ++i) {
+      const se3::Transformation T =
+          T_start * se3::Transformation(Vector6d(scan.t[i] / 0.1 * xi));
+      const Eigen::Vector3d p(scan.p[i], scan.p[NUM_POINTS + i],
+                              scan.p[2 * NUM_POINTS + i]);
+      const Eigen::Vector3d out = T.C_ba() * p + T.r_ab_inb();
+      for (int k = 0; k < 3; ++k) {
+        scan.out[k * NUM_POINTS + i] = out(k);
+      }
+    }
+    clobberMemory();
+  }
+}
+
+/** \brief The exact pose per point, with the batch kernels */
+void deskewExactBatch(State& state) {
+  Scan scan;
+  std::vector<double> alpha(NUM_POINTS), T(se3::BATCH_POSE_ROWS * NUM_POINTS);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < NUM_POINTS; ++i) {
+      alpha[i] = scan.t[i] / 0.1;
+    }
+    se3::interpolateBatch(se3::Transformation(), T_END, alpha.data(), T.data(),
+                          NUM_POINTS);
+    se3::transformPointsBatch(T.data(), scan.p.data(), scan.out.data(),
+                              NUM_POINTS);
+    clobberMemory();
+  }
+}
+
+template <std::size_t K>
+void deskew(State& state) {
+  Scan scan;
+  for (auto _ : state) {
+    const se3::Deskew deskew(se3::Transformation(), T_END, 0.0, 0.1, K);
+    deskew.apply(scan.t.data(), scan.p.data(), scan.out.data(), NUM_POINTS);
+    clobberMemory();
+  }
+  state.setBytesPerIteration(sizeof(double) * 7 * NUM_POINTS);
+}
+
+template <std::size_t K>
+void deskewParallel(State& state) {
+  Scan scan;
+  const common::ExecutionPolicy policy = common::ExecutionPolicy::parallel();
+  for (auto _ : state) {
+    const se3::Deskew deskew(se3::Transformation(), T_END, 0.0, 0.1, K);
+    deskew.apply(policy, scan.t.data(), scan.p.data(), scan.out.data(),
+                 NUM_POINTS);
+    clobberMemory();
+  }
+  state.setBytesPerIteration(sizeof(double) * 7 * NUM_POINTS);
+}
+
+LGMATH_BENCHMARK("se3/deskew/128k (scalar loop)", deskewScalar);
+LGMATH_BENCHMARK("se3/deskew/128k (exact batch)", deskewExactBatch);
+LGMATH_BENCHMARK("se3/deskew/128k/K=4", deskew<4>);
+LGMATH_BENCHMARK("se3/deskew/128k/K=16", deskew<16>);
+LGMATH_BENCHMARK("se3/deskew/128k/K=64", deskew<64>);
+LGMATH_BENCHMARK("se3/deskew/128k/K=1024", deskew<1024>);
+LGMATH_BENCHMARK("se3/deskew/128k/K=16 (default executor)",
+                 deskewParallel<16>);
+
+}  // namespace
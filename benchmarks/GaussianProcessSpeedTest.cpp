@@ -0,0 +1,69 @@
+/**
+ * \file GaussianProcessSpeedTest.cpp
+ * \brief Benchmarks of the WNOA prior interpolation, batch against single
+ * queries.
+ *
+ * \author ASRL
+ */
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <lgmath/se3/Batch.hpp>
+#include <lgmath/se3/GaussianProcess.hpp>
+
+#include "Benchmark.hpp"
+
+namespace {
+
+using namespace lgmath;
+using namespace lgmath::benchmark;
+
+typedef Eigen::Matrix<double, 6, 1> Vector6d;
+
+/** \brief Number of queries */
+const std::size_t NUM_QUERIES = 100000;
+
+/** \brief An interval of 0.1 s */
+se3::gp::Interval testInterval() {
+  const se3::gp::Knot knot1 = {
+      0.0, se3::Transformation(Vector6d(Vector6d::Random())),
+      Vector6d(Vector6d::Random())};
+  const se3::gp::Knot knot2 = {
+      0.1,
+      se3::Transformation(Vector6d(0.1 * Vector6d::Random())) * knot1.T,
+      Vector6d(Vector6d::Random())};
+  return se3::gp::Interval(knot1, knot2);
+}
+
+void batchStates(State& state) {
+  const se3::gp::Interval interval = testInterval();
+  const Eigen::VectorXd t = Eigen::VectorXd::LinSpaced(NUM_QUERIES, 0.0, 0.1);
+  std::vector<double> T(se3::BATCH_POSE_ROWS * NUM_QUERIES);
+  std::vector<double> varpi(6 * NUM_QUERIES);
+  for (auto _ : state) {
+    interval.states(t.data(), T.data(), varpi.data(), NUM_QUERIES);
+    clobberMemory();
+  }
+  state.setBytesPerIteration(sizeof(double) *
+                             (t.size() + T.size() + varpi.size()));
+}
+
+void statesLoop(State& state) {
+  const se3::gp::Interval interval = testInterval();
+  const Eigen::VectorXd t = Eigen::VectorXd::LinSpaced(NUM_QUERIES, 0.0, 0.1);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < NUM_QUERIES; ++i) {
+      se3::Transformation T = interval.pose(t(i));
+      Vector6d varpi = interval.velocity(t(i));
+      doNotOptimize(T);
+      doNotOptimize(varpi);
+    }
+    clobberMemory();
+  }
+}
+
+LGMATH_BENCHMARK("gp/states 100k", batchStates);
+LGMATH_BENCHMARK("gp/pose+velocity loop 100k", statesLoop);
+
+}  // namespace
@@ -0,0 +1,80 @@
+/**
+ * \file MeanSpeedTest.cpp
+ * \brief Benchmarks of the weighted pose means, sequential against the
+ * default thread pool.
+ *
+ * \author ASRL
+ */
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <lgmath/Parallel.hpp>
+#include <lgmath/se3/Mean.hpp>
+
+#include "Benchmark.hpp"
+
+namespace {
+
+using namespace lgmath;
+using namespace lgmath::benchmark;
+
+typedef Eigen::Matrix<double, 6, 1> Vector6d;
+
+/** \brief Number of poses */
+const std::size_t NUM_POSES = 10000;
+
+/** \brief Poses scattered about a random one */
+std::vector<se3::Transformation> testPoses() {
+  const se3::Transformation T(Vector6d(Vector6d::Random()));
+  std::vector<se3::Transformation> poses;
+  for (std::size_t i = 0; i < NUM_POSES; ++i) {
+    poses.push_back(se3::Transformation(Vector6d(0.2 * Vector6d::Random())) *
+                    T);
+  }
+  return poses;
+}
+
+void karcherMean(State& state, const common::ExecutionPolicy& policy) {
+  const std::vector<se3::Transformation> poses = testPoses();
+  Eigen::Matrix<double, 6, 6> spread;
+  for (auto _ : state) {
+    se3::Transformation T =
+        se3::mean(policy, poses, {}, se3::MeanMethod::KARCHER, &spread);
+    doNotOptimize(T);
+    clobberMemory();
+  }
+}
+
+void chordalMean(State& state, const common::ExecutionPolicy& policy) {
+  const std::vector<se3::Transformation> poses = testPoses();
+  for (auto _ : state) {
+    se3::Transformation T =
+        se3::mean(policy, poses, {}, se3::MeanMethod::CHORDAL);
+    doNotOptimize(T);
+    clobberMemory();
+  }
+}
+
+void karcherSequential(State& state) {
+  karcherMean(state, common::ExecutionPolicy::sequential());
+}
+
+void karcherParallel(State& state) {
+  karcherMean(state, common::ExecutionPolicy::parallel());
+}
+
+void chordalSequential(State& state) {
+  chordalMean(state, common::ExecutionPolicy::sequential());
+}
+
+void chordalParallel(State& state) {
+  chordalMean(state, common::ExecutionPolicy::parallel());
+}
+
+LGMATH_BENCHMARK("mean/karcher seq 10k", karcherSequential);
+LGMATH_BENCHMARK("mean/karcher par 10k", karcherParallel);
+LGMATH_BENCHMARK("mean/chordal seq 10k", chordalSequential);
+LGMATH_BENCHMARK("mean/chordal par 10k", chordalParallel);
+
+}  // namespace
@@ -0,0 +1,134 @@
+/**
+ * \file ParallelSpeedTest.cpp
+ * \brief Scaling benchmarks of the batch functions on thread pools of 1 to 16
+ * threads.
+ * \details The sizes are those of a lidar scan (1M point transforms) and of a
+ * pose graph (100k relative poses); each benchmark runs on its own
+ * common::ThreadPool, with dynamic chunking.
+ *
+ * \author ASRL
+ */
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <lgmath/Parallel.hpp>
+#include <lgmath/se3/Batch.hpp>
+#include <lgmath/se3/Transformation.hpp>
+
+#include "Benchmark.hpp"
+
+namespace {
+
+using namespace lgmath;
+using namespace lgmath::benchmark;
+
+typedef Eigen::Matrix<double, 6, 1> Vector6d;
+
+/** \brief Number of points */
+const std::size_t NUM_POINTS = 1 << 20;
+
+/** \brief Number of poses and of relative poses */
+const std::size_t NUM_POSES = 10000;
+const std::size_t NUM_PAIRS = 100000;
+
+/** \brief Random values */
+std::vector<double> randomValues(std::size_t n) {
+  std::vector<double> values(n);
+  for (double& x : values) {
+    x = Eigen::Matrix<double, 1, 1>::Random()(0);
+  }
+  return values;
+}
+
+/** \brief Random transformations in the batch layout */
+std::vector<double> randomTransforms(std::size_t n) {
+  const std::vector<double> xi = randomValues(6 * n);
+  std::vector<double> T(se3::BATCH_POSE_ROWS * n);
+  se3::vec2tranBatch(xi.data(), T.data(), n);
+  return T;
+}
+
+/** \brief Pairs of consecutive and random poses, as in a pose graph */
+std::vector<std::size_t> randomPairs() {
+  std::vector<std::size_t> pairs(2 * NUM_PAIRS);
+  for (std::size_t k = 0; k < NUM_PAIRS; ++k) {
+    pairs[k] = k % NUM_POSES;
+    pairs[NUM_PAIRS + k] =
+        k % 2 == 0 ? (k + 1) % NUM_POSES : (k * 7919) % NUM_POSES;
+  }
+  return pairs;
+}
+
+template <std::size_t THREADS>
+void transformPoints(State& state) {
+  common::ThreadPool pool(THREADS);
+  const common::ExecutionPolicy policy(pool);
+  const se3::Transformation T_ba(Vector6d(Vector6d::Random()));
+  const std::vector<double> p_a = randomValues(3 * NUM_POINTS);
+  std::vector<double> p_b(3 * NUM_POINTS);
+  for (auto _ : state) {
+    se3::transformPointsBatch(policy, T_ba, p_a.data(), p_b.data(),
+                              NUM_POINTS);
+    clobberMemory();
+  }
+  state.setBytesPerIteration(sizeof(double) * (p_a.size() + p_b.size()));
+}
+
+template <std::size_t THREADS>
+void relativePoses(State& state) {
+  common::ThreadPool pool(THREADS);
+  const common::ExecutionPolicy policy(pool);
+  const std::vector<double> T = randomTransforms(NUM_POSES);
+  const std::vector<std::size_t> pairs = randomPairs();
+  std::vector<double> out(se3::BATCH_POSE_ROWS * NUM_PAIRS);
+  for (auto _ : state) {
+    se3::relativePosesBatch(policy, T.data(), NUM_POSES, pairs.data(),
+                            out.data(), NUM_PAIRS);
+    clobberMemory();
+  }
+}
+
+template <std::size_t THREADS>
+void relativePosesWithCovariance(State& state) {
+  common::ThreadPool pool(THREADS);
+  const common::ExecutionPolicy policy(pool);
+  const std::vector<double> T = randomTransforms(NUM_POSES);
+  const std::vector<double> cov =
+      randomValues(se3::BATCH_COVARIANCE_ROWS * NUM_POSES);
+  const std::vector<std::size_t> pairs = randomPairs();
+  std::vector<double> out(se3::BATCH_POSE_ROWS * NUM_PAIRS);
+  std::vector<double> outCov(se3::BATCH_COVARIANCE_ROWS * NUM_PAIRS);
+  for (auto _ : state) {
+    se3::relativePosesBatch(policy, T.data(), cov.data(), NUM_POSES,
+                            pairs.data(), out.data(), outCov.data(),
+                            NUM_PAIRS);
+    clobberMemory();
+  }
+}
+
+LGMATH_BENCHMARK("parallel/transformPoints 1M/1 thread", transformPoints<1>);
+LGMATH_BENCHMARK("parallel/transformPoints 1M/2 threads", transformPoints<2>);
+LGMATH_BENCHMARK("parallel/transformPoints 1M/4 threads", transformPoints<4>);
+LGMATH_BENCHMARK("parallel/transformPoints 1M/8 threads", transformPoints<8>);
+LGMATH_BENCHMARK("parallel/transformPoints 1M/16 threads",
+                 transformPoints<16>);
+
+LGMATH_BENCHMARK("parallel/relativePoses 100k/1 thread", relativePoses<1>);
+LGMATH_BENCHMARK("parallel/relativePoses 100k/2 threads", relativePoses<2>);
+LGMATH_BENCHMARK("parallel/relativePoses 100k/4 threads", relativePoses<4>);
+LGMATH_BENCHMARK("parallel/relativePoses 100k/8 threads", relativePoses<8>);
+LGMATH_BENCHMARK("parallel/relativePoses 100k/16 threads", relativePoses<16>);
+
+LGMATH_BENCHMARK("parallel/relativePoses+covariance 100k/1 thread",
+                 relativePosesWithCovariance<1>);
+LGMATH_BENCHMARK("parallel/relativePoses+covariance 100k/2 threads",
+                 relativePosesWithCovariance<2>);
+LGMATH_BENCHMARK("parallel/relativePoses+covariance 100k/4 threads",
+                 relativePosesWithCovariance<4>);
+LGMATH_BENCHMARK("parallel/relativePoses+covariance 100k/8 threads",
+                 relativePosesWithCovariance<8>);
+LGMATH_BENCHMARK("parallel/relativePoses+covariance 100k/16 threads",
+                 relativePosesWithCovariance<16>);
+
+}  // namespace
@@ -0,0 +1,194 @@
+/**
+ * \file PerfCounters.cpp
+ * \brief Hardware performance counters for the micro-benchmarks.
+ *
+ * \author ASRL
+ */
+#include "PerfCounters.hpp"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace lgmath {
+namespace benchmark {
+
+const char* perfEventName(PerfEvent event) {
+  switch (event) {
+    case PerfEvent::CYCLES:
+      return "cycles";
+    case PerfEvent::INSTRUCTIONS:
+      return "instructions";
+    case PerfEvent::BRANCH_MISSES:
+      return "branch_misses";
+    case PerfEvent::L1D_MISSES:
+      return "l1d_misses";
+    case PerfEvent::LLC_MISSES:
+      return "llc_misses";
+    case PerfEvent::NUM_PERF_EVENTS:
+      break;
+  }
+  return "";
+}
+
+#ifdef __linux__
+
+namespace {
+
+/** \brief Cache event config: cache, operation and result */
+std::uint64_t cacheEvent(std::uint64_t cache) {
+  return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+int openCounter(PerfEvent event) {
+  struct perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  switch (event) {
+    case PerfEvent::CYCLES:
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = PERF_COUNT_HW_CPU_CYCLES;
+      break;
+    case PerfEvent::INSTRUCTIONS:
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+      break;
+    case PerfEvent::BRANCH_MISSES:
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+      break;
+    case PerfEvent::L1D_MISSES:
+      attr.type = PERF_TYPE_HW_CACHE;
+      attr.config = cacheEvent(PERF_COUNT_HW_CACHE_L1D);
+      break;
+    case PerfEvent::LLC_MISSES:
+      attr.type = PERF_TYPE_HW_CACHE;
+      attr.config = cacheEvent(PERF_COUNT_HW_CACHE_LL);
+      break;
+    case PerfEvent::NUM_PERF_EVENTS:
+      errno = EINVAL;
+      return -1;
+  }
+  // This thread, any CPU, no group
+  return int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+/** \brief Reads the value, time enabled and time running of a counter */
+bool readCounter(int fd, std::uint64_t data[3]) {
+  return fd >= 0 && ::read(fd, data, 3 * sizeof(std::uint64_t)) ==
+                        ssize_t(3 * sizeof(std::uint64_t));
+}
+
+}  // namespace
+
+PerfCounters::PerfCounters() {
+  startEnabled_.fill(0);
+  startRunning_.fill(0);
+  for (std::size_t i = 0; i < NUM_PERF_EVENTS; ++i) {
+    fds_[i] = openCounter(PerfEvent(i));
+    if (fds_[i] < 0 && error_.empty()) {
+      error_ = std::string(perfEventName(PerfEvent(i))) + ": " +
+               std::strerror(errno);
+      if (errno == EACCES || errno == EPERM) {
+        error_ += " (see /proc/sys/kernel/perf_event_paranoid)";
+      }
+    }
+  }
+}
+
+PerfCounters::~PerfCounters() {
+  for (int fd : fds_) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+}
+
+void PerfCounters::start() {
+  for (std::size_t i = 0; i < NUM_PERF_EVENTS; ++i) {
+    std::uint64_t data[3];
+    if (readCounter(fds_[i], data)) {
+      startEnabled_[i] = data[1];
+      startRunning_[i] = data[2];
+    }
+  }
+  for (int fd : fds_) {
+    if (fd >= 0) {
+      ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+      ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+}
+
+void PerfCounters::stop() {
+  for (int fd : fds_) {
+    if (fd >= 0) {
+      ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+  }
+}
+
+PerfValues PerfCounters::read() const {
+  PerfValues values;
+  for (std::size_t i = 0; i < NUM_PERF_EVENTS; ++i) {
+    values[i] = -1.0;
+    // value, time enabled, time running
+    std::uint64_t data[3];
+    if (!readCounter(fds_[i], data)) {
+      continue;
+    }
+    // The value was reset by start(), the times accumulate over the runs
+    const std::uint64_t enabled = data[1] - startEnabled_[i];
+    const std::uint64_t running = data[2] - startRunning_[i];
+    if (running > 0) {
+      values[i] = double(data[0]) * double(enabled) / double(running);
+    }
+  }
+  return values;
+}
+
+#else
+
+PerfCounters::PerfCounters() : error_("perf events require Linux") {
+  fds_.fill(-1);
+  startEnabled_.fill(0);
+  startRunning_.fill(0);
+}
+
+PerfCounters::~PerfCounters() {}
+
+void PerfCounters::start() {}
+
+void PerfCounters::stop() {}
+
+PerfValues PerfCounters::read() const {
+  PerfValues values;
+  values.fill(-1.0);
+  return values;
+}
+
+#endif
+
+bool PerfCounters::available() const {
+  for (int fd : fds_) {
+    if (fd >= 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace benchmark
+}  // namespace lgmath
@@ -0,0 +1,87 @@
+/**
+ * \file PerfCounters.hpp
+ * \brief Hardware performance counters for the micro-benchmarks.
+ * \details Reads the Linux perf_event_open counters of the calling thread.
+ * Counters that cannot be opened (no PMU in a virtual machine, a restrictive
+ * /proc/sys/kernel/perf_event_paranoid, or a non-Linux host) are reported as
+ * unavailable rather than failing the benchmarks.
+ *
+ * \author ASRL
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace lgmath {
+namespace benchmark {
+
+/** \brief Counted hardware events */
+enum class PerfEvent : std::size_t {
+  CYCLES = 0,
+  INSTRUCTIONS,
+  BRANCH_MISSES,
+  L1D_MISSES,
+  LLC_MISSES,
+  // Not an event: the number of events, new ones go above
+  NUM_PERF_EVENTS,
+};
+
+/** \brief Number of counted hardware events */
+static constexpr std::size_t NUM_PERF_EVENTS =
+    static_cast<std::size_t>(PerfEvent::NUM_PERF_EVENTS);
+
+/** \brief Counter values, negative if the counter is unavailable */
+typedef std::array<double, NUM_PERF_EVENTS> PerfValues;
+
+/** \brief Gets the short name of an event, as used in the JSON output */
+const char* perfEventName(PerfEvent event);
+
+/** \brief A set of hardware counters for the calling thread */
+class PerfCounters {
+ public:
+  /** \brief Constructor, opens the counters; does not throw */
+  PerfCounters();
+
+  /** \brief Destructor, closes the counters */
+  ~PerfCounters();
+
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  /** \brief Returns whether any counter could be opened */
+  bool available() const;
+
+  /** \brief Gets why counters are unavailable, if they are */
+  const std::string& error() const { return error_; }
+
+  /** \brief Resets and starts the counters */
+  void start();
+
+  /** \brief Stops the counters */
+  void stop();
+
+  /**
+   * \brief Gets the counts between start() and stop(), scaled for the time
+   * the counters were multiplexed out; negative if unavailable.
+   */
+  PerfValues read() const;
+
+ private:
+  /** \brief File descriptor of each counter, -1 if unavailable */
+  std::array<int, NUM_PERF_EVENTS> fds_;
+
+  /**
+   * \brief Time enabled and running of each counter at start(), which
+   * PERF_EVENT_IOC_RESET does not reset
+   */
+  std::array<std::uint64_t, NUM_PERF_EVENTS> startEnabled_, startRunning_;
+
+  /** \brief Reason the first unavailable counter could not be opened */
+  std::string error_;
+};
+
+}  // namespace benchmark
+}  // namespace lgmath
@@ -0,0 +1,138 @@
+/**
+ * \file PoseArraySpeedTest.cpp
+ * \brief Benchmarks of the structure of arrays PoseArray, against
+ * std::vector<Transformation>.
+ * \details Each iteration sweeps all SIZE poses; the sizes fit in the L1 cache,
+ * the L2 cache and the last level cache respectively, to show how the layouts
+ * use the memory bandwidth.
+ *
+ * \author ASRL
+ */
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <lgmath/se3/PoseArray.hpp>
+#include <lgmath/se3/Transformation.hpp>
+
+#include "Benchmark.hpp"
+
+namespace {
+
+using namespace lgmath;
+using namespace lgmath::benchmark;
+
+typedef Eigen::Matrix<double, 6, 1> Vector6d;
+
+/** \brief Random transformations */
+std::vector<se3::Transformation> randomTransformations(std::size_t n) {
+  std::vector<se3::Transformation> poses;
+  poses.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    poses.emplace_back(Vector6d(Vector6d::Random()));
+  }
+  return poses;
+}
+
+/** \brief Reads one component of every pose: the translations */
+template <std::size_t SIZE>
+void sumTranslationsVector(State& state) {
+  const std::vector<se3::Transformation> poses = randomTransformations(SIZE);
+  for (auto _ : state) {
+    Eigen::Vector3d sum = Eigen::Vector3d::Zero();
+    for (const auto& T : poses) {
+      sum += T.r_ab_inb();
+    }
+    doNotOptimize(sum);
+  }
+}
+
+template <std::size_t SIZE>
+void sumTranslationsArray(State& state) {
+  const se3::PoseArray poses(randomTransformations(SIZE));
+  for (auto _ : state) {
+    // The same additions, in the same order, as for the vector
+    const double* r0 = poses.data() + 3 * poses.stride();
+    const double* r1 = poses.data() + 7 * poses.stride();
+    const double* r2 = poses.data() + 11 * poses.stride();
+    Eigen::Vector3d sum = Eigen::Vector3d::Zero();
+    for (std::size_t i = 0; i < SIZE; ++i) {
+      sum += Eigen::Vector3d(r0[i], r1[i], r2[i]);
+    }
+    doNotOptimize(sum);
+  }
+}
+
+template <std::size_t SIZE>
+void inverseVector(State& state) {
+  const std::vector<se3::Transformation> poses = randomTransformations(SIZE);
+  std::vector<se3::Transformation> out(SIZE);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < SIZE; ++i) {
+      out[i] = poses[i].inverse();
+    }
+    clobberMemory();
+  }
+}
+
+template <std::size_t SIZE>
+void inverseArray(State& state) {
+  const se3::PoseArray poses(randomTransformations(SIZE));
+  se3::PoseArray out(SIZE);
+  for (auto _ : state) {
+    se3::inverseBatch(poses.data(), out.data(), SIZE, poses.stride());
+    clobberMemory();
+  }
+}
+
+template <std::size_t SIZE>
+void composeVector(State& state) {
+  const std::vector<se3::Transformation> lhs = randomTransformations(SIZE);
+  const std::vector<se3::Transformation> rhs = randomTransformations(SIZE);
+  std::vector<se3::Transformation> out(SIZE);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < SIZE; ++i) {
+      out[i] = lhs[i] * rhs[i];
+    }
+    clobberMemory();
+  }
+}
+
+template <std::size_t SIZE>
+void composeArray(State& state) {
+  const se3::PoseArray lhs(randomTransformations(SIZE));
+  const se3::PoseArray rhs(randomTransformations(SIZE));
+  se3::PoseArray out(SIZE);
+  for (auto _ : state) {
+    se3::composeBatch(lhs.data(), rhs.data(), out.data(), SIZE, lhs.stride());
+    clobberMemory();
+  }
+}
+
+LGMATH_BENCHMARK("PoseArray/sum translations/256 (vector)",
+                 sumTranslationsVector<256>);
+LGMATH_BENCHMARK("PoseArray/sum translations/256", sumTranslationsArray<256>);
+LGMATH_BENCHMARK("PoseArray/sum translations/16k (vector)",
+                 sumTranslationsVector<16384>);
+LGMATH_BENCHMARK("PoseArray/sum translations/16k",
+                 sumTranslationsArray<16384>);
+LGMATH_BENCHMARK("PoseArray/sum translations/256k (vector)",
+                 sumTranslationsVector<262144>);
+LGMATH_BENCHMARK("PoseArray/sum translations/256k",
+                 sumTranslationsArray<262144>);
+
+LGMATH_BENCHMARK("PoseArray/inverse/256 (vector)", inverseVector<256>);
+LGMATH_BENCHMARK("PoseArray/inverse/256", inverseArray<256>);
+LGMATH_BENCHMARK("PoseArray/inverse/16k (vector)", inverseVector<16384>);
+LGMATH_BENCHMARK("PoseArray/inverse/16k", inverseArray<16384>);
+LGMATH_BENCHMARK("PoseArray/inverse/256k (vector)", inverseVector<262144>);
+LGMATH_BENCHMARK("PoseArray/inverse/256k", inverseArray<262144>);
+
+LGMATH_BENCHMARK("PoseArray/compose/256 (vector)", composeVector<256>);
+LGMATH_BENCHMARK("PoseArray/compose/256", composeArray<256>);
+LGMATH_BENCHMARK("PoseArray/compose/16k (vector)", composeVector<16384>);
+LGMATH_BENCHMARK("PoseArray/compose/16k", composeArray<16384>);
+LGMATH_BENCHMARK("PoseArray/compose/256k (vector)", composeVector<262144>);
+LGMATH_BENCHMARK("PoseArray/compose/256k", composeArray<262144>);
+
+}  // namespace
@@ -1,153 +1,109 @@
-#include <gtest/gtest.h>
-#include <lgmath/CommonTools.hpp>
-#include <lgmath/so3/Operations.hpp>
-#include <lgmath/so3/Rotation.hpp>
+/**
+ * \file RotationSpeedTest.cpp
+ * \brief Benchmarks of the Rotation class.
+ *
+ * \author ASRL
+ */
+#include <vector>
 
-TEST(LGMath, RotationBenchmark) {
-  // Init variables
-  double margin = 5.0;  // 500% increase
-  unsigned int N = 1000000;
-  unsigned int L = 1000;
-  unsigned int M = 10000;
-  lgmath::common::Timer timer;
-  double time1, time2;
-  double recorded;
+#include <Eigen/Core>
 
-  // Allocate test memory
-  lgmath::so3::Rotation rotation;
-  Eigen::Vector3d v3 = Eigen::Vector3d::Random();
+#include <lgmath/so3/Rotation.hpp>
 
-  /////////////////////////////////////////////////////////////////////////////////////////////
-  /// Rotation Testing
-  /////////////////////////////////////////////////////////////////////////////////////////////
-  std::cout << "Starting Rotation Tests" << std::endl;
-  std::cout << "-----------------------------" << std::endl;
-  std::cout << "Comparison timings are to get a ballpark estimate."
-            << std::endl;
-  std::cout << "Check that it is not an order of magnitude off; you may not be "
-               "in release mode."
-            << std::endl;
-  std::cout << " " << std::endl;
+#include "Benchmark.hpp"
 
-  // test
-  std::cout << "Test rotation vec2rot, over " << N << " iterations."
-            << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    rotation = lgmath::so3::Rotation(v3);
-  }
-  time1 = timer.nanoseconds();
-  recorded = 0.091;
-  std::cout << "your speed: " << time1 / double(N) << "nsec per call."
-            << std::endl;
-  std::cout << "recorded:   " << 1000.0 * recorded
-            << "nsec per call, 2.4 GHz processor, July 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((time1 / double(N)), 1000.0 * recorded * margin);
+namespace {
 
-  // test
-  std::cout << "Test lval vs rval assignment, over " << N << " iterations."
-            << std::endl;
-  lgmath::so3::Rotation tmp(rotation);
-  lgmath::so3::Rotation tmp2(rotation);
-  double build_time;
-  build_time = time1 = time2 = 0;
+using namespace lgmath;
+using namespace lgmath::benchmark;
 
-  for (unsigned int j = 0; j < L; ++j) {
-    timer.reset();
-    for (unsigned int i = 0; i < M; i++) {
-      tmp = lgmath::so3::Rotation(rotation);
-    }
-    build_time += timer.nanoseconds();
+std::vector<Eigen::Vector3d> randomVectors() {
+  std::vector<Eigen::Vector3d> vectors(NUM_INPUTS);
+  for (auto& v : vectors) {
+    v = Eigen::Vector3d::Random();
+  }
+  return vectors;
+}
 
-    timer.reset();
-    for (unsigned int i = 0; i < M; i++) {
-      tmp = lgmath::so3::Rotation(rotation);
-      tmp2 = tmp;
-    }
-    time1 += timer.nanoseconds();
+std::vector<so3::Rotation> randomRotations() {
+  std::vector<so3::Rotation> rotations;
+  for (const auto& v : randomVectors()) {
+    rotations.emplace_back(v);
+  }
+  return rotations;
+}
 
-    timer.reset();
-    for (unsigned int i = 0; i < M; i++) {
-      tmp = lgmath::so3::Rotation(rotation);
-      tmp2 = std::move(tmp);
-    }
-    time2 += timer.nanoseconds();
+void rotationFromVector(State& state) {
+  const auto inputs = randomVectors();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    doNotOptimize(so3::Rotation(inputs[i++ & (NUM_INPUTS - 1)]));
   }
+}
+LGMATH_BENCHMARK("Rotation/vec2rot", rotationFromVector);
 
-  std::cout << "Lval assignment time: " << (time1 - build_time) / double(M * L)
-            << "nsec per call." << std::endl;
-  std::cout << "Rval assignment time: " << (time2 - build_time) / double(M * L)
-            << "nsec per call." << std::endl;
-  std::cout << "Difference: " << (time1 - time2) / (time1 - build_time) * 100
-            << "%" << std::endl;
-  std::cout << " " << std::endl;
+void rotationVec(State& state) {
+  const auto inputs = randomRotations();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    doNotOptimize(inputs[i++ & (NUM_INPUTS - 1)].vec());
+  }
+}
+LGMATH_BENCHMARK("Rotation/rot2vec", rotationVec);
 
-  // test
-  std::cout << "Test rotation rot2vec, over " << N << " iterations."
-            << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    v3 = rotation.vec();
+void rotationCopyAssign(State& state) {
+  const auto inputs = randomRotations();
+  so3::Rotation C;
+  std::size_t i = 0;
+  for (auto _ : state) {
+    C = inputs[i++ & (NUM_INPUTS - 1)];
+    doNotOptimize(C);
   }
-  time1 = timer.nanoseconds();
-  recorded = 0.051;
-  std::cout << "your speed: " << time1 / double(N) << "nsec per call."
-            << std::endl;
-  std::cout << "recorded:   " << 1000.0 * recorded
-            << "nsec per call, 2.4 GHz processor, July 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((time1 / double(N)), 1000.0 * recorded * margin);
+}
+LGMATH_BENCHMARK("Rotation/assign/lvalue", rotationCopyAssign);
 
-  // test
-  std::cout << "Test product over " << N << " iterations." << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    rotation = rotation * rotation;
+void rotationMoveAssign(State& state) {
+  const auto inputs = randomVectors();
+  so3::Rotation C;
+  std::size_t i = 0;
+  for (auto _ : state) {
+    C = so3::Rotation(inputs[i++ & (NUM_INPUTS - 1)]);
+    doNotOptimize(C);
   }
-  time1 = timer.nanoseconds();
-  recorded = 0.027;
-  std::cout << "your speed: " << time1 / double(N) << "nsec per call."
-            << std::endl;
-  std::cout << "recorded:   " << 1000.0 * recorded
-            << "nsec per call, 2.4 GHz processor, July 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((time1 / double(N)), 1000.0 * recorded * margin);
+}
+LGMATH_BENCHMARK("Rotation/assign/rvalue", rotationMoveAssign);
 
-  // test
-  std::cout << "Test product with inverse over " << N << " iterations."
-            << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    rotation = rotation / rotation;
+void rotationProduct(State& state) {
+  const auto inputs = randomRotations();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++;
+    doNotOptimize(inputs[j & (NUM_INPUTS - 1)] *
+                  inputs[(j + 1) & (NUM_INPUTS - 1)]);
   }
-  time1 = timer.nanoseconds();
-  recorded = 0.027;
-  std::cout << "your speed: " << time1 / double(N) << "nsec per call."
-            << std::endl;
-  std::cout << "recorded:   " << 1000.0 * recorded
-            << "nsec per call, 2.4 GHz processor, July 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((time1 / double(N)), 1000.0 * recorded * margin);
+}
+LGMATH_BENCHMARK("Rotation/product", rotationProduct);
 
-  // test
-  std::cout << "Test product with landmark over " << N << " iterations."
-            << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    v3 = rotation * v3;
+void rotationProductInverse(State& state) {
+  const auto inputs = randomRotations();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++;
+    doNotOptimize(inputs[j & (NUM_INPUTS - 1)] /
+                  inputs[(j + 1) & (NUM_INPUTS - 1)]);
   }
-  time1 = timer.nanoseconds();
-  recorded = 0.008;
-  std::cout << "your speed: " << time1 / double(N) << "nsec per call."
-            << std::endl;
-  std::cout << "recorded:   " << 1000.0 * recorded
-            << "nsec per call, 2.4 GHz processor, July 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((time1 / double(N)), 1000.0 * recorded * margin);
 }
+LGMATH_BENCHMARK("Rotation/productInverse", rotationProductInverse);
 
-int main(int argc, char** argv) {
-  testing::InitGoogleTest(&argc, argv);
-  return RUN_ALL_TESTS();
+void rotationLandmark(State& state) {
+  const auto rotations = randomRotations();
+  const auto points = randomVectors();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++ & (NUM_INPUTS - 1);
+    doNotOptimize(rotations[j] * points[j]);
+  }
 }
+LGMATH_BENCHMARK("Rotation/landmark", rotationLandmark);
+
+}  // namespace
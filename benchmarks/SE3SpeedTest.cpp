@@ -1,189 +1,230 @@
-#include <gtest/gtest.h>
+/**
+ * \file SE3SpeedTest.cpp
+ * \brief Benchmarks of the SE3 Lie group functions.
+ *
+ * \author ASRL
+ */
+#include <vector>
+
+#include <Eigen/Core>
 
-#include <lgmath/CommonTools.hpp>
 #include <lgmath/se3/Operations.hpp>
 
-TEST(LGMath, SE3Benchmark) {
-  // Init variables
-  double margin = 5.0;  // 500% increase
-  unsigned int N = 1000000;
-  lgmath::common::Timer timer;
-  double time1;
-  double recorded;
-
-  // Allocate test memory
-  Eigen::Matrix<double, 3, 3> m33;
-  Eigen::Matrix<double, 4, 4> m44;
-  Eigen::Matrix<double, 6, 4> m64;
-  Eigen::Matrix<double, 4, 6> m46;
-  Eigen::Matrix<double, 6, 6> m66;
-  Eigen::Matrix<double, 4, 1> v4 = Eigen::Matrix<double, 4, 1>::Random();
-  Eigen::Matrix<double, 6, 1> v6 = Eigen::Matrix<double, 6, 1>::Random();
-
-  /////////////////////////////////////////////////////////////////////////////////////////////
-  /// SE Testing
-  /////////////////////////////////////////////////////////////////////////////////////////////
-  std::cout << "Starting SE(3) Tests" << std::endl;
-  std::cout << "--------------------" << std::endl;
-  std::cout << "Comparison timings are to get a ballpark estimate."
-            << std::endl;
-  std::cout << "Check that it is not an order of magnitude off; you may not be "
-               "in release mode."
-            << std::endl;
-  std::cout << " " << std::endl;
-
-  // test
-  std::cout << "Test SE3 hat, over " << N << " iterations." << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    m44 = lgmath::se3::hat(v6);
-  }
-  time1 = timer.milliseconds();
-  recorded = 0.0189;
-  std::cout << "your speed: " << 1000.0 * time1 / double(N) << "usec per call."
-            << std::endl;
-  std::cout << "recorded:   " << recorded
-            << "usec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((1000.0 * time1 / double(N)), recorded * margin);
-
-  // test
-  std::cout << "Test SE3 curlyhat, over " << N << " iterations." << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    m66 = lgmath::se3::curlyhat(v6);
-  }
-  time1 = timer.milliseconds();
-  recorded = 0.0233;
-  std::cout << "your speed: " << 1000.0 * time1 / double(N) << "usec per call."
-            << std::endl;
-  std::cout << "recorded:   " << recorded
-            << "usec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((1000.0 * time1 / double(N)), recorded * margin);
-
-  // test
-  std::cout << "Test SE3 point2fs, over " << N << " iterations." << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    m46 = lgmath::se3::point2fs(v4.head<3>());
-  }
-  time1 = timer.milliseconds();
-  recorded = 0.0131;
-  std::cout << "your speed: " << 1000.0 * time1 / double(N) << "usec per call."
-            << std::endl;
-  std::cout << "recorded:   " << recorded
-            << "usec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((1000.0 * time1 / double(N)), recorded * margin);
-
-  // test
-  std::cout << "Test SE3 point2sf, over " << N << " iterations." << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    m64 = lgmath::se3::point2sf(v4.head<3>());
-  }
-  time1 = timer.milliseconds();
-  recorded = 0.0125;
-  std::cout << "your speed: " << 1000.0 * time1 / double(N) << "usec per call."
-            << std::endl;
-  std::cout << "recorded:   " << recorded
-            << "usec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((1000.0 * time1 / double(N)), recorded * margin);
-
-  // test
-  std::cout << "Test SE3 vec2tran, over " << N << " iterations." << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    m44 = lgmath::se3::vec2tran(v6);
-  }
-  time1 = timer.milliseconds();
-  recorded = 0.112;
-  std::cout << "your speed: " << 1000.0 * time1 / double(N) << "usec per call."
-            << std::endl;
-  std::cout << "recorded:   " << recorded
-            << "usec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((1000.0 * time1 / double(N)), recorded * margin);
-
-  // test
-  std::cout << "Test SE3 tran2vec, over " << N << " iterations." << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    v6 = lgmath::se3::tran2vec(m44);
-  }
-  time1 = timer.milliseconds();
-  recorded = 0.129;
-  std::cout << "your speed: " << 1000.0 * time1 / double(N) << "usec per call."
-            << std::endl;
-  std::cout << "recorded:   " << recorded
-            << "usec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((1000.0 * time1 / double(N)), recorded * margin);
-
-  // test
-  std::cout << "Test SE3 tranAd, over " << N << " iterations." << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    m66 = lgmath::se3::tranAd(m44);
-  }
-  time1 = timer.milliseconds();
-  recorded = 0.027;
-  std::cout << "your speed: " << 1000.0 * time1 / double(N) << "usec per call."
-            << std::endl;
-  std::cout << "recorded:   " << recorded
-            << "usec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((1000.0 * time1 / double(N)), recorded * margin);
-
-  // test
-  std::cout << "Test SE3 vec2Q, over " << N << " iterations." << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    m33 = lgmath::se3::vec2Q(v6);
-  }
-  time1 = timer.milliseconds();
-  recorded = 0.187;
-  std::cout << "your speed: " << 1000.0 * time1 / double(N) << "usec per call."
-            << std::endl;
-  std::cout << "recorded:   " << recorded
-            << "usec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((1000.0 * time1 / double(N)), recorded * margin);
-
-  // test
-  std::cout << "Test SE3 vec2jac, over " << N << " iterations." << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    m66 = lgmath::se3::vec2jac(v6);
-  }
-  time1 = timer.milliseconds();
-  recorded = 0.291;
-  std::cout << "your speed: " << 1000.0 * time1 / double(N) << "usec per call."
-            << std::endl;
-  std::cout << "recorded:   " << recorded
-            << "usec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((1000.0 * time1 / double(N)), recorded * margin);
-
-  // test
-  std::cout << "Test SE3 vec2jacinv, over " << N << " iterations." << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    m66 = lgmath::se3::vec2jacinv(v6);
-  }
-  time1 = timer.milliseconds();
-  recorded = 0.277;
-  std::cout << "your speed: " << 1000.0 * time1 / double(N) << "usec per call."
-            << std::endl;
-  std::cout << "recorded:   " << recorded
-            << "usec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((1000.0 * time1 / double(N)), recorded * margin);
-}
-
-int main(int argc, char** argv) {
-  testing::InitGoogleTest(&argc, argv);
-  return RUN_ALL_TESTS();
+#include "Benchmark.hpp"
+
+namespace {
+
+using namespace lgmath;
+using namespace lgmath::benchmark;
+
+typedef Eigen::Matrix<double, 6, 1> Vector6d;
+
+std::vector<Vector6d> randomVectors() {
+  std::vector<Vector6d> vectors(NUM_INPUTS);
+  for (auto& v : vectors) {
+    v = Vector6d::Random();
+  }
+  return vectors;
+}
+
+std::vector<Eigen::Vector3d> randomPoints() {
+  std::vector<Eigen::Vector3d> points(NUM_INPUTS);
+  for (auto& p : points) {
+    p = Eigen::Vector3d::Random();
+  }
+  return points;
+}
+
+std::vector<Eigen::Matrix4d> randomTransforms() {
+  std::vector<Eigen::Matrix4d> transforms(NUM_INPUTS);
+  for (auto& T : transforms) {
+    T = se3::vec2tran(Vector6d::Random());
+  }
+  return transforms;
+}
+
+void se3Hat(State& state) {
+  const auto inputs = randomVectors();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    doNotOptimize(se3::hat(inputs[i++ & (NUM_INPUTS - 1)]));
+  }
+}
+LGMATH_BENCHMARK("se3/hat", se3Hat);
+
+void se3Curlyhat(State& state) {
+  const auto inputs = randomVectors();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    doNotOptimize(se3::curlyhat(inputs[i++ & (NUM_INPUTS - 1)]));
+  }
+}
+LGMATH_BENCHMARK("se3/curlyhat", se3Curlyhat);
+
+void se3Point2fs(State& state) {
+  const auto inputs = randomPoints();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    doNotOptimize(se3::point2fs(inputs[i++ & (NUM_INPUTS - 1)]));
+  }
+}
+LGMATH_BENCHMARK("se3/point2fs", se3Point2fs);
+
+void se3Point2sf(State& state) {
+  const auto inputs = randomPoints();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    doNotOptimize(se3::point2sf(inputs[i++ & (NUM_INPUTS - 1)]));
+  }
+}
+LGMATH_BENCHMARK("se3/point2sf", se3Point2sf);
+
+void se3Vec2tran(State& state) {
+  const auto inputs = randomVectors();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    doNotOptimize(se3::vec2tran(inputs[i++ & (NUM_INPUTS - 1)]));
+  }
+}
+LGMATH_BENCHMARK("se3/vec2tran", se3Vec2tran);
+
+void se3Tran2vec(State& state) {
+  const auto inputs = randomTransforms();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    doNotOptimize(se3::tran2vec(inputs[i++ & (NUM_INPUTS - 1)]));
+  }
+}
+LGMATH_BENCHMARK("se3/tran2vec", se3Tran2vec);
+
+void se3TranAd(State& state) {
+  const auto inputs = randomTransforms();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    doNotOptimize(se3::tranAd(inputs[i++ & (NUM_INPUTS - 1)]));
+  }
+}
+LGMATH_BENCHMARK("se3/tranAd", se3TranAd);
+
+void se3Vec2Q(State& state) {
+  const auto inputs = randomVectors();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    doNotOptimize(se3::vec2Q(inputs[i++ & (NUM_INPUTS - 1)]));
+  }
+}
+LGMATH_BENCHMARK("se3/vec2Q", se3Vec2Q);
+
+void se3Vec2jac(State& state) {
+  const auto inputs = randomVectors();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    doNotOptimize(se3::vec2jac(inputs[i++ & (NUM_INPUTS - 1)]));
+  }
+}
+LGMATH_BENCHMARK("se3/vec2jac", se3Vec2jac);
+
+void se3Vec2jacinv(State& state) {
+  const auto inputs = randomVectors();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    doNotOptimize(se3::vec2jacinv(inputs[i++ & (NUM_INPUTS - 1)]));
+  }
+}
+LGMATH_BENCHMARK("se3/vec2jacinv", se3Vec2jacinv);
+
+// Matrix-free products, against forming the matrix and multiplying
+
+void se3ApplyCurlyhat(State& state) {
+  const auto inputs = randomVectors();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++;
+    doNotOptimize(se3::applyCurlyhat(inputs[j & (NUM_INPUTS - 1)],
+                                     inputs[(j + 1) & (NUM_INPUTS - 1)]));
+  }
+}
+LGMATH_BENCHMARK("se3/applyCurlyhat", se3ApplyCurlyhat);
+
+void se3CurlyhatTimes(State& state) {
+  const auto inputs = randomVectors();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++;
+    doNotOptimize((se3::curlyhat(inputs[j & (NUM_INPUTS - 1)]) *
+                   inputs[(j + 1) & (NUM_INPUTS - 1)])
+                      .eval());
+  }
+}
+LGMATH_BENCHMARK("se3/applyCurlyhat (dense)", se3CurlyhatTimes);
+
+void se3ApplyJac(State& state) {
+  const auto inputs = randomVectors();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++;
+    doNotOptimize(se3::applyJac(inputs[j & (NUM_INPUTS - 1)],
+                                inputs[(j + 1) & (NUM_INPUTS - 1)]));
+  }
 }
+LGMATH_BENCHMARK("se3/applyJac", se3ApplyJac);
+
+void se3Vec2jacTimes(State& state) {
+  const auto inputs = randomVectors();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++;
+    doNotOptimize((se3::vec2jac(inputs[j & (NUM_INPUTS - 1)]) *
+                   inputs[(j + 1) & (NUM_INPUTS - 1)])
+                      .eval());
+  }
+}
+LGMATH_BENCHMARK("se3/applyJac (dense)", se3Vec2jacTimes);
+
+void se3ApplyJacTranspose(State& state) {
+  const auto inputs = randomVectors();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++;
+    doNotOptimize(se3::applyJacTranspose(inputs[j & (NUM_INPUTS - 1)],
+                                         inputs[(j + 1) & (NUM_INPUTS - 1)]));
+  }
+}
+LGMATH_BENCHMARK("se3/applyJacTranspose", se3ApplyJacTranspose);
+
+void se3Vec2jacTransposeTimes(State& state) {
+  const auto inputs = randomVectors();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++;
+    doNotOptimize((se3::vec2jac(inputs[j & (NUM_INPUTS - 1)]).transpose() *
+                   inputs[(j + 1) & (NUM_INPUTS - 1)])
+                      .eval());
+  }
+}
+LGMATH_BENCHMARK("se3/applyJacTranspose (dense)", se3Vec2jacTransposeTimes);
+
+void se3ApplyJacInv(State& state) {
+  const auto inputs = randomVectors();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++;
+    doNotOptimize(se3::applyJacInv(inputs[j & (NUM_INPUTS - 1)],
+                                   inputs[(j + 1) & (NUM_INPUTS - 1)]));
+  }
+}
+LGMATH_BENCHMARK("se3/applyJacInv", se3ApplyJacInv);
+
+void se3Vec2jacinvTimes(State& state) {
+  const auto inputs = randomVectors();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++;
+    doNotOptimize((se3::vec2jacinv(inputs[j & (NUM_INPUTS - 1)]) *
+                   inputs[(j + 1) & (NUM_INPUTS - 1)])
+                      .eval());
+  }
+}
+LGMATH_BENCHMARK("se3/applyJacInv (dense)", se3Vec2jacinvTimes);
+
+}  // namespace
@@ -1,109 +1,81 @@
-#include <gtest/gtest.h>
+/**
+ * \file SO3SpeedTest.cpp
+ * \brief Benchmarks of the SO3 Lie group functions.
+ *
+ * \author ASRL
+ */
+#include <vector>
+
+#include <Eigen/Core>
 
-#include <lgmath/CommonTools.hpp>
 #include <lgmath/so3/Operations.hpp>
 
-TEST(LGMath, SO3Benchmark) {
-  // Init variables
-  double margin = 5.0;  // 500% increase
-  unsigned int N = 1000000;
-  lgmath::common::Timer timer;
-  double time1;
-  double recorded;
+#include "Benchmark.hpp"
 
-  // Allocate test memory
-  Eigen::Matrix<double, 3, 3> m33;
-  Eigen::Matrix<double, 3, 1> v3 = Eigen::Matrix<double, 3, 1>::Random();
+namespace {
 
-  /////////////////////////////////////////////////////////////////////////////////////////////
-  /// SO Testing
-  /////////////////////////////////////////////////////////////////////////////////////////////
-  std::cout << "Starting SO(3) Tests" << std::endl;
-  std::cout << "--------------------" << std::endl;
-  std::cout << "Comparison timings are to get a ballpark estimate."
-            << std::endl;
-  std::cout << "Check that it is not an order of magnitude off; you may not be "
-               "in release mode."
-            << std::endl;
-  std::cout << " " << std::endl;
+using namespace lgmath;
+using namespace lgmath::benchmark;
 
-  // test
-  std::cout << "Test SO3 hat, over " << N << " iterations." << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    m33 = lgmath::so3::hat(v3);
+std::vector<Eigen::Vector3d> randomVectors() {
+  std::vector<Eigen::Vector3d> vectors(NUM_INPUTS);
+  for (auto& v : vectors) {
+    v = Eigen::Vector3d::Random();
   }
-  time1 = timer.milliseconds();
-  recorded = 0.00637;
-  std::cout << "your speed: " << 1000.0 * time1 / double(N) << "usec per call."
-            << std::endl;
-  std::cout << "recorded:   " << recorded
-            << "usec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((1000.0 * time1 / double(N)), recorded * margin);
+  return vectors;
+}
+
+std::vector<Eigen::Matrix3d> randomRotations() {
+  std::vector<Eigen::Matrix3d> rotations(NUM_INPUTS);
+  for (auto& C : rotations) {
+    C = so3::vec2rot(Eigen::Vector3d::Random());
+  }
+  return rotations;
+}
 
-  // test
-  std::cout << "Test SO3 vec2rot, over " << N << " iterations." << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    m33 = lgmath::so3::vec2rot(v3);
+void so3Hat(State& state) {
+  const auto inputs = randomVectors();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    doNotOptimize(so3::hat(inputs[i++ & (NUM_INPUTS - 1)]));
   }
-  time1 = timer.milliseconds();
-  recorded = 0.077;
-  std::cout << "your speed: " << 1000.0 * time1 / double(N) << "usec per call."
-            << std::endl;
-  std::cout << "recorded:   " << recorded
-            << "usec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((1000.0 * time1 / double(N)), recorded * margin);
+}
+LGMATH_BENCHMARK("so3/hat", so3Hat);
 
-  // test
-  std::cout << "Test SO3 rot2vec, over " << N << " iterations." << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    v3 = lgmath::so3::rot2vec(m33);
+void so3Vec2rot(State& state) {
+  const auto inputs = randomVectors();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    doNotOptimize(so3::vec2rot(inputs[i++ & (NUM_INPUTS - 1)]));
   }
-  time1 = timer.milliseconds();
-  recorded = 0.053;
-  std::cout << "your speed: " << 1000.0 * time1 / double(N) << "usec per call."
-            << std::endl;
-  std::cout << "recorded:   " << recorded
-            << "usec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((1000.0 * time1 / double(N)), recorded * margin);
+}
+LGMATH_BENCHMARK("so3/vec2rot", so3Vec2rot);
 
-  // test
-  std::cout << "Test SO3 vec2jac, over " << N << " iterations." << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    m33 = lgmath::so3::vec2jac(v3);
+void so3Rot2vec(State& state) {
+  const auto inputs = randomRotations();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    doNotOptimize(so3::rot2vec(inputs[i++ & (NUM_INPUTS - 1)]));
   }
-  time1 = timer.milliseconds();
-  recorded = 0.0907;
-  std::cout << "your speed: " << 1000.0 * time1 / double(N) << "usec per call."
-            << std::endl;
-  std::cout << "recorded:   " << recorded
-            << "usec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((1000.0 * time1 / double(N)), recorded * margin);
+}
+LGMATH_BENCHMARK("so3/rot2vec", so3Rot2vec);
 
-  // test
-  std::cout << "Test SO3 vec2jacinv, over " << N << " iterations." << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    m33 = lgmath::so3::vec2jacinv(v3);
+void so3Vec2jac(State& state) {
+  const auto inputs = randomVectors();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    doNotOptimize(so3::vec2jac(inputs[i++ & (NUM_INPUTS - 1)]));
   }
-  time1 = timer.milliseconds();
-  recorded = 0.0623;
-  std::cout << "your speed: " << 1000.0 * time1 / double(N) << "usec per call."
-            << std::endl;
-  std::cout << "recorded:   " << recorded
-            << "usec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((1000.0 * time1 / double(N)), recorded * margin);
 }
+LGMATH_BENCHMARK("so3/vec2jac", so3Vec2jac);
 
-int main(int argc, char** argv) {
-  testing::InitGoogleTest(&argc, argv);
-  return RUN_ALL_TESTS();
+void so3Vec2jacinv(State& state) {
+  const auto inputs = randomVectors();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    doNotOptimize(so3::vec2jacinv(inputs[i++ & (NUM_INPUTS - 1)]));
+  }
 }
+LGMATH_BENCHMARK("so3/vec2jacinv", so3Vec2jacinv);
+
+}  // namespace
@@ -0,0 +1,84 @@
+/**
+ * \file SamplingSpeedTest.cpp
+ * \brief Benchmarks of the pose sampling, batch against a loop of
+ * single samples.
+ *
+ * \author ASRL
+ */
+#include <random>
+#include <vector>
+
+#include <Eigen/Cholesky>
+#include <Eigen/Core>
+
+#include <lgmath/Parallel.hpp>
+#include <lgmath/se3/Batch.hpp>
+#include <lgmath/se3/Operations.hpp>
+#include <lgmath/se3/Sampling.hpp>
+
+#include "Benchmark.hpp"
+
+namespace {
+
+using namespace lgmath;
+using namespace lgmath::benchmark;
+
+typedef Eigen::Matrix<double, 6, 1> Vector6d;
+typedef Eigen::Matrix<double, 6, 6> Matrix6d;
+
+/** \brief Number of samples */
+const std::size_t NUM_SAMPLES = 100000;
+
+/** \brief A mean pose with a correlated covariance */
+se3::TransformationWithCovariance testPose() {
+  const Matrix6d A = 0.1 * Matrix6d::Random();
+  return se3::TransformationWithCovariance(
+      se3::Transformation(Vector6d(Vector6d::Random())),
+      A * A.transpose() + 1e-4 * Matrix6d::Identity());
+}
+
+void batchSample(State& state) {
+  const se3::TransformationWithCovariance T = testPose();
+  std::vector<double> samples(se3::BATCH_POSE_ROWS * NUM_SAMPLES);
+  std::mt19937_64 rng(42);
+  for (auto _ : state) {
+    se3::sample(T, NUM_SAMPLES, rng, samples.data());
+    clobberMemory();
+  }
+  state.setBytesPerIteration(sizeof(double) * samples.size());
+}
+
+void parallelSample(State& state) {
+  const se3::TransformationWithCovariance T = testPose();
+  std::vector<double> samples(se3::BATCH_POSE_ROWS * NUM_SAMPLES);
+  for (auto _ : state) {
+    se3::sample(common::ExecutionPolicy::parallel(), T, NUM_SAMPLES, 42,
+                samples.data());
+    clobberMemory();
+  }
+  state.setBytesPerIteration(sizeof(double) * samples.size());
+}
+
+void sampleLoop(State& state) {
+  const se3::TransformationWithCovariance T = testPose();
+  std::mt19937_64 rng(42);
+  std::normal_distribution<double> normal;
+  for (auto _ : state) {
+    const Matrix6d L = Eigen::LLT<Matrix6d>(T.cov()).matrixL();
+    for (std::size_t i = 0; i < NUM_SAMPLES; ++i) {
+      Vector6d z;
+      for (int k = 0; k < 6; ++k) {
+        z(k) = normal(rng);
+      }
+      se3::Transformation T_k = se3::Transformation(Vector6d(L * z)) * T;
+      doNotOptimize(T_k);
+    }
+    clobberMemory();
+  }
+}
+
+LGMATH_BENCHMARK("sample/batch 100k", batchSample);
+LGMATH_BENCHMARK("sample/parallel 100k", parallelSample);
+LGMATH_BENCHMARK("sample/loop 100k", sampleLoop);
+
+}  // namespace
@@ -0,0 +1,90 @@
+/**
+ * \file SplineSpeedTest.cpp
+ * \brief Benchmarks of the SE3 spline poses at 1M sorted times.
+ * \details The spline has a control pose every 0.1 s over 100 s, so that
+ * about 1000 queries share each segment; the queries per second are 1M over
+ * the time per iteration. The single pose loop is the baseline of the batch
+ * poses.
+ *
+ * \author ASRL
+ */
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <lgmath/Parallel.hpp>
+#include <lgmath/se3/Batch.hpp>
+#include <lgmath/se3/Spline.hpp>
+#include <lgmath/se3/Transformation.hpp>
+
+#include "Benchmark.hpp"
+
+namespace {
+
+using namespace lgmath;
+using namespace lgmath::benchmark;
+
+typedef Eigen::Matrix<double, 6, 1> Vector6d;
+
+/** \brief Number of queries */
+const std::size_t NUM_QUERIES = 1000000;
+
+/** \brief Number of control poses */
+const std::size_t NUM_CONTROL_POSES = 1003;
+
+/** \brief A random walk of control poses */
+se3::Spline randomSpline() {
+  std::vector<se3::Transformation> controlPoses;
+  se3::Transformation T;
+  for (std::size_t k = 0; k < NUM_CONTROL_POSES; ++k) {
+    controlPoses.push_back(T);
+    T = se3::Transformation(Vector6d(0.2 * Vector6d::Random())) * T;
+  }
+  return se3::Spline(0.0, 0.1, controlPoses);
+}
+
+/** \brief Sorted times over the whole spline */
+Eigen::VectorXd sortedTimes(const se3::Spline& spline) {
+  return Eigen::VectorXd::LinSpaced(NUM_QUERIES, spline.startTime(),
+                                    spline.endTime());
+}
+
+void batchPoses(State& state) {
+  const se3::Spline spline = randomSpline();
+  const Eigen::VectorXd t = sortedTimes(spline);
+  std::vector<double> T(se3::BATCH_POSE_ROWS * NUM_QUERIES);
+  for (auto _ : state) {
+    spline.poses(t.data(), T.data(), NUM_QUERIES);
+    clobberMemory();
+  }
+  state.setBytesPerIteration(sizeof(double) * (t.size() + T.size()));
+}
+
+void batchPosesPool(State& state) {
+  const se3::Spline spline = randomSpline();
+  const Eigen::VectorXd t = sortedTimes(spline);
+  std::vector<double> T(se3::BATCH_POSE_ROWS * NUM_QUERIES);
+  for (auto _ : state) {
+    spline.poses(common::ExecutionPolicy(), t.data(), T.data(), NUM_QUERIES);
+    clobberMemory();
+  }
+  state.setBytesPerIteration(sizeof(double) * (t.size() + T.size()));
+}
+
+void posesLoop(State& state) {
+  const se3::Spline spline = randomSpline();
+  const Eigen::VectorXd t = sortedTimes(spline);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < NUM_QUERIES; ++i) {
+      se3::Transformation T = spline.pose(t(i));
+      doNotOptimize(T);
+    }
+    clobberMemory();
+  }
+}
+
+LGMATH_BENCHMARK("spline/poses 1M sorted", batchPoses);
+LGMATH_BENCHMARK("spline/poses 1M sorted/default pool", batchPosesPool);
+LGMATH_BENCHMARK("spline/pose loop 1M sorted", posesLoop);
+
+}  // namespace
@@ -0,0 +1,81 @@
+/**
+ * \file TrajectoryCodecSpeedTest.cpp
+ * \brief Benchmarks of the trajectory codec, per pose.
+ * \details Throughput is of the raw 3x4 poses.
+ *
+ * \author ASRL
+ */
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <lgmath/io/TrajectoryCodec.hpp>
+#include <lgmath/se3/Transformation.hpp>
+
+#include "Benchmark.hpp"
+
+namespace {
+
+using namespace lgmath;
+using namespace lgmath::benchmark;
+
+const std::size_t NUM_POSES = 4096;
+const std::size_t RAW_POSE = 12 * sizeof(double);
+
+/** \brief Smooth trajectory at 100 Hz */
+std::vector<se3::Transformation> smoothTrajectory() {
+  std::vector<se3::Transformation> poses;
+  se3::Transformation T;
+  for (std::size_t i = 0; i < NUM_POSES; i++) {
+    Eigen::Matrix<double, 6, 1> xi = Eigen::Matrix<double, 6, 1>::Random();
+    xi *= 1e-3;
+    xi(0) += 0.1;
+    xi(5) += 0.01 * std::sin(0.01 * i);
+    T = se3::Transformation(xi) * T;
+    poses.push_back(T);
+  }
+  return poses;
+}
+
+void codecEncode(State& state) {
+  const auto poses = smoothTrajectory();
+  std::stringstream stream;
+  io::TrajectoryEncoder encoder(stream);
+  state.setBytesPerIteration(RAW_POSE);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    encoder.push(poses[i++ % NUM_POSES]);
+  }
+}
+LGMATH_BENCHMARK("io/TrajectoryCodec/encode", codecEncode);
+
+void codecDecode(State& state) {
+  const auto poses = smoothTrajectory();
+  std::stringstream stream;
+  {
+    io::TrajectoryEncoder encoder(stream);
+    for (const auto& T : poses) {
+      encoder.push(T);
+    }
+  }
+  const std::string bytes = stream.str();
+  state.setBytesPerIteration(RAW_POSE);
+
+  std::stringstream input(bytes);
+  io::TrajectoryDecoder decoder(input);
+  se3::Transformation T;
+  for (auto _ : state) {
+    if (!decoder.next(&T)) {
+      // Rewind; rare enough not to affect the timing
+      input.clear();
+      input.seekg(io::TRAJECTORY_CODEC_HEADER_SIZE);
+      decoder.next(&T);
+    }
+    doNotOptimize(T);
+  }
+}
+LGMATH_BENCHMARK("io/TrajectoryCodec/decode", codecDecode);
+
+}  // namespace
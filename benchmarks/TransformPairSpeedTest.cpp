@@ -0,0 +1,81 @@
+/**
+ * \file TransformPairSpeedTest.cpp
+ * \brief Benchmarks of the joint compounding of correlated poses, against
+ * dense 12x12 Jacobian products.
+ *
+ * \author ASRL
+ */
+#include <Eigen/Core>
+
+#include <lgmath/se3/TransformationPairWithCovariance.hpp>
+
+#include "Benchmark.hpp"
+
+namespace {
+
+using namespace lgmath;
+using namespace lgmath::benchmark;
+
+typedef Eigen::Matrix<double, 6, 1> Vector6d;
+typedef Eigen::Matrix<double, 6, 6> Matrix6d;
+typedef Eigen::Matrix<double, 6, 12> Matrix6x12d;
+typedef se3::TransformationPairWithCovariance::Matrix12d Matrix12d;
+
+/** \brief Two random poses with a random joint covariance */
+se3::TransformationPairWithCovariance testPair() {
+  const Matrix12d A = Matrix12d::Random();
+  return se3::TransformationPairWithCovariance(
+      se3::Transformation(Vector6d(Vector6d::Random())),
+      se3::Transformation(Vector6d(Vector6d::Random())),
+      A * A.transpose() + Matrix12d::Identity());
+}
+
+void relative(State& state) {
+  const se3::TransformationPairWithCovariance pair = testPair();
+  for (auto _ : state) {
+    se3::TransformationWithCovariance T = pair.relative();
+    doNotOptimize(T);
+  }
+}
+
+void relativeDense(State& state) {
+  const se3::TransformationPairWithCovariance pair = testPair();
+  const se3::Transformation T_1 = pair.first(), T_2 = pair.second();
+  for (auto _ : state) {
+    const se3::Transformation T = T_1 / T_2;
+    Matrix6x12d J;
+    J << Matrix6d::Identity(), -T.adjoint();
+    se3::TransformationWithCovariance out(
+        T, Matrix6d(J * pair.cov() * J.transpose()));
+    doNotOptimize(out);
+  }
+}
+
+void inverse(State& state) {
+  const se3::TransformationPairWithCovariance pair = testPair();
+  for (auto _ : state) {
+    se3::TransformationPairWithCovariance out = pair.inverse();
+    doNotOptimize(out);
+  }
+}
+
+void inverseDense(State& state) {
+  const se3::TransformationPairWithCovariance pair = testPair();
+  const se3::Transformation T_1 = pair.first(), T_2 = pair.second();
+  for (auto _ : state) {
+    const se3::Transformation T_1inv = T_1.inverse(), T_2inv = T_2.inverse();
+    Matrix12d K = Matrix12d::Zero();
+    K.topLeftCorner<6, 6>() = -T_1inv.adjoint();
+    K.bottomRightCorner<6, 6>() = -T_2inv.adjoint();
+    se3::TransformationPairWithCovariance out(T_1inv, T_2inv,
+                                              K * pair.cov() * K.transpose());
+    doNotOptimize(out);
+  }
+}
+
+LGMATH_BENCHMARK("pair/relative", relative);
+LGMATH_BENCHMARK("pair/relative dense", relativeDense);
+LGMATH_BENCHMARK("pair/inverse", inverse);
+LGMATH_BENCHMARK("pair/inverse dense", inverseDense);
+
+}  // namespace
@@ -1,185 +1,334 @@
-#include <gtest/gtest.h>
+/**
+ * \file TransformSpeedTest.cpp
+ * \brief Benchmarks of the Transformation class.
+ *
+ * \author ASRL
+ */
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+#include <Eigen/Geometry>
 
-#include <lgmath/CommonTools.hpp>
 #include <lgmath/se3/Operations.hpp>
 #include <lgmath/se3/Transformation.hpp>
+#include <lgmath/se3/TransformationMap.hpp>
+
+#include "Benchmark.hpp"
+
+namespace {
+
+using namespace lgmath;
+using namespace lgmath::benchmark;
+
+typedef Eigen::Matrix<double, 6, 1> Vector6d;
+
+std::vector<Vector6d> randomVectors() {
+  std::vector<Vector6d> vectors(NUM_INPUTS);
+  for (auto& v : vectors) {
+    v = Vector6d::Random();
+  }
+  return vectors;
+}
+
+std::vector<se3::Transformation> randomTransforms() {
+  std::vector<se3::Transformation> transforms;
+  for (const auto& v : randomVectors()) {
+    transforms.emplace_back(v);
+  }
+  return transforms;
+}
+
+/** \brief Random poses stored back to back in a buffer of the given layout */
+std::vector<double> randomPoseBuffer(se3::PoseLayout layout) {
+  const int size = se3::poseLayoutSize(layout);
+  std::vector<double> buffer(size * NUM_INPUTS);
+  const auto transforms = randomTransforms();
+  for (std::size_t i = 0; i < NUM_INPUTS; ++i) {
+    se3::TransformationMap(buffer.data() + i * size, layout) = transforms[i];
+  }
+  return buffer;
+}
+
+std::vector<Eigen::Vector4d> randomPoints() {
+  std::vector<Eigen::Vector4d> points(NUM_INPUTS);
+  for (auto& p : points) {
+    p << Eigen::Vector3d::Random(), 1.0;
+  }
+  return points;
+}
+
+void transformFromVector(State& state) {
+  const auto inputs = randomVectors();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    doNotOptimize(se3::Transformation(inputs[i++ & (NUM_INPUTS - 1)]));
+  }
+}
+LGMATH_BENCHMARK("Transformation/vec2tran", transformFromVector);
+
+void transformVec(State& state) {
+  const auto inputs = randomTransforms();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    doNotOptimize(inputs[i++ & (NUM_INPUTS - 1)].vec());
+  }
+}
+LGMATH_BENCHMARK("Transformation/tran2vec", transformVec);
+
+void transformMatrix(State& state) {
+  const auto inputs = randomTransforms();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    doNotOptimize(inputs[i++ & (NUM_INPUTS - 1)].matrix());
+  }
+}
+LGMATH_BENCHMARK("Transformation/accessors/matrix", transformMatrix);
+
+void transformMatrix34(State& state) {
+  const auto inputs = randomTransforms();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    doNotOptimize(inputs[i++ & (NUM_INPUTS - 1)].matrix34());
+  }
+}
+LGMATH_BENCHMARK("Transformation/accessors/matrix34", transformMatrix34);
+
+void transformIsometry(State& state) {
+  const auto inputs = randomTransforms();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    doNotOptimize(inputs[i++ & (NUM_INPUTS - 1)].isometry().matrix());
+  }
+}
+LGMATH_BENCHMARK("Transformation/accessors/isometry", transformIsometry);
+
+void transformRba(State& state) {
+  const auto inputs = randomTransforms();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    doNotOptimize(inputs[i++ & (NUM_INPUTS - 1)].r_ba_ina());
+  }
+}
+LGMATH_BENCHMARK("Transformation/accessors/r_ba_ina", transformRba);
+
+void transformCopyAssign(State& state) {
+  const auto inputs = randomTransforms();
+  se3::Transformation T;
+  std::size_t i = 0;
+  for (auto _ : state) {
+    T = inputs[i++ & (NUM_INPUTS - 1)];
+    doNotOptimize(T);
+  }
+}
+LGMATH_BENCHMARK("Transformation/assign/lvalue", transformCopyAssign);
+
+void transformMoveAssign(State& state) {
+  const auto inputs = randomVectors();
+  se3::Transformation T;
+  std::size_t i = 0;
+  for (auto _ : state) {
+    T = se3::Transformation(inputs[i++ & (NUM_INPUTS - 1)]);
+    doNotOptimize(T);
+  }
+}
+LGMATH_BENCHMARK("Transformation/assign/rvalue", transformMoveAssign);
 
-TEST(LGMath, TransformBenchmark) {
-  // Init variables
-  double margin = 5.0;  // 500% increase
-  unsigned int N = 1000000;
-  unsigned int L = 1000;
-  unsigned int M = 10000;
-  lgmath::common::Timer timer;
-  double time1, time2;
-  double recorded;
-
-  // Allocate test memory
-  lgmath::se3::Transformation transform;
-  Eigen::Matrix<double, 4, 1> v4 = Eigen::Matrix<double, 4, 1>::Random();
-  Eigen::Matrix<double, 6, 1> v6 = Eigen::Matrix<double, 6, 1>::Random();
-
-  /////////////////////////////////////////////////////////////////////////////////////////////
-  /// Transformation Testing
-  /////////////////////////////////////////////////////////////////////////////////////////////
-  std::cout << "Starting Transformation Tests" << std::endl;
-  std::cout << "-----------------------------" << std::endl;
-  std::cout << "Comparison timings are to get a ballpark estimate."
-            << std::endl;
-  std::cout << "Check that it is not an order of magnitude off; you may not be "
-               "in release mode."
-            << std::endl;
-  std::cout << " " << std::endl;
-
-  // test
-  std::cout << "Test transform vec2tran, over " << N << " iterations."
-            << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    transform = lgmath::se3::Transformation(v6);
-  }
-  time1 = timer.nanoseconds();
-  recorded = 0.122;
-  std::cout << "your speed: " << time1 / double(N) << "nsec per call."
-            << std::endl;
-  std::cout << "recorded:   " << 1000.0 * recorded
-            << "nsec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((time1 / double(N)), 1000.0 * recorded * margin);
-
-  // test
-  std::cout << "Test transform tran2vec, over " << N << " iterations."
-            << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    v6 = transform.vec();
-  }
-  time1 = timer.nanoseconds();
-  recorded = 0.132;
-  std::cout << "your speed: " << time1 / double(N) << "nsec per call."
-            << std::endl;
-  std::cout << "recorded:   " << 1000.0 * recorded
-            << "nsec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((time1 / double(N)), 1000.0 * recorded * margin);
-
-  // test
-  std::cout << "Test lval vs rval assignment, over " << N << " iterations."
-            << std::endl;
-  lgmath::se3::Transformation tmp(transform);
-  lgmath::se3::Transformation tmp2(transform);
-  double build_time;
-  build_time = time1 = time2 = 0;
-
-  for (unsigned int j = 0; j < L; ++j) {
-    timer.reset();
-    for (unsigned int i = 0; i < M; i++) {
-      tmp = lgmath::se3::Transformation(transform);
-    }
-    build_time += timer.nanoseconds();
-
-    timer.reset();
-    for (unsigned int i = 0; i < M; i++) {
-      tmp = lgmath::se3::Transformation(transform);
-      tmp2 = tmp;
-    }
-    time1 += timer.nanoseconds();
-
-    timer.reset();
-    for (unsigned int i = 0; i < M; i++) {
-      tmp = lgmath::se3::Transformation(transform);
-      tmp2 = std::move(tmp);
-    }
-    time2 += timer.nanoseconds();
-  }
-
-  std::cout << "Lval assignment time: " << (time1 - build_time) / double(M * L)
-            << "nsec per call." << std::endl;
-  std::cout << "Rval assignment time: " << (time2 - build_time) / double(M * L)
-            << "nsec per call." << std::endl;
-  std::cout << "Difference: " << (time1 - time2) / (time1 - build_time) * 100
-            << "%" << std::endl;
-  std::cout << " " << std::endl;
-
-  // test
-  std::cout << "Test std::swap, over " << N << " iterations." << std::endl;
-
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
+void transformSwap(State& state) {
+  auto inputs = randomTransforms();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++;
     using std::swap;
-    swap(tmp, tmp2);
-  }
-  time1 = timer.nanoseconds();
-
-  std::cout << "std::swap time: " << (time1) / double(N) << "nsec per call."
-            << std::endl;
-  std::cout << " " << std::endl;
-
-  // test
-  std::cout << "Test transform vec2tran, over " << N << " iterations."
-            << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    transform = lgmath::se3::Transformation(v6);
-  }
-  time1 = timer.nanoseconds();
-  recorded = 0.122;
-  std::cout << "your speed: " << time1 / double(N) << "nsec per call."
-            << std::endl;
-  std::cout << "recorded:   " << 1000.0 * recorded
-            << "nsec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((time1 / double(N)), 1000.0 * recorded * margin);
-
-  // test
-  std::cout << "Test product over " << N << " iterations." << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    transform = transform * transform;
-  }
-  time1 = timer.nanoseconds();
-  recorded = 0.033;
-  std::cout << "your speed: " << time1 / double(N) << "nsec per call."
-            << std::endl;
-  std::cout << "recorded:   " << 1000.0 * recorded
-            << "nsec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((time1 / double(N)), 1000.0 * recorded * margin);
-
-  // test
-  std::cout << "Test product with inverse over " << N << " iterations."
-            << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    transform = transform / transform;
-  }
-  time1 = timer.nanoseconds();
-  recorded = 0.035;
-  std::cout << "your speed: " << time1 / double(N) << "nsec per call."
-            << std::endl;
-  std::cout << "recorded:   " << 1000.0 * recorded
-            << "nsec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((time1 / double(N)), 1000.0 * recorded * margin);
-
-  // test
-  std::cout << "Test product with landmark over " << N << " iterations."
-            << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    v4 = transform * v4;
-  }
-  time1 = timer.nanoseconds();
-  recorded = 0.015;
-  std::cout << "your speed: " << time1 / double(N) << "nsec per call."
-            << std::endl;
-  std::cout << "recorded:   " << 1000.0 * recorded
-            << "nsec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((time1 / double(N)), 1000.0 * recorded * margin);
-}
-
-int main(int argc, char** argv) {
-  testing::InitGoogleTest(&argc, argv);
-  return RUN_ALL_TESTS();
+    swap(inputs[j & (NUM_INPUTS - 1)], inputs[(j + 1) & (NUM_INPUTS - 1)]);
+    clobberMemory();
+  }
+}
+LGMATH_BENCHMARK("Transformation/swap", transformSwap);
+
+void transformProduct(State& state) {
+  const auto inputs = randomTransforms();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++;
+    doNotOptimize(inputs[j & (NUM_INPUTS - 1)] *
+                  inputs[(j + 1) & (NUM_INPUTS - 1)]);
+  }
 }
+LGMATH_BENCHMARK("Transformation/product", transformProduct);
+
+void transformProductInverse(State& state) {
+  const auto inputs = randomTransforms();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++;
+    doNotOptimize(inputs[j & (NUM_INPUTS - 1)] /
+                  inputs[(j + 1) & (NUM_INPUTS - 1)]);
+  }
+}
+LGMATH_BENCHMARK("Transformation/productInverse", transformProductInverse);
+
+void transformLandmark(State& state) {
+  const auto transforms = randomTransforms();
+  const auto points = randomPoints();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++ & (NUM_INPUTS - 1);
+    doNotOptimize(transforms[j] * points[j]);
+  }
+}
+LGMATH_BENCHMARK("Transformation/landmark", transformLandmark);
+
+void transformComposeWithJacobians(State& state) {
+  const auto inputs = randomTransforms();
+  se3::Transformation T;
+  Eigen::Matrix<double, 6, 6> J_1, J_2;
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++;
+    se3::composeWithJacobians(inputs[j & (NUM_INPUTS - 1)],
+                              inputs[(j + 1) & (NUM_INPUTS - 1)], &T, &J_1,
+                              &J_2);
+    doNotOptimize(T);
+    doNotOptimize(J_2);
+  }
+}
+LGMATH_BENCHMARK("Transformation/jacobians/compose",
+                 transformComposeWithJacobians);
+
+void transformComposeWithJacobiansNoReproject(State& state) {
+  const auto inputs = randomTransforms();
+  se3::Transformation T;
+  Eigen::Matrix<double, 6, 6> J_1, J_2;
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++;
+    se3::composeWithJacobians(inputs[j & (NUM_INPUTS - 1)],
+                              inputs[(j + 1) & (NUM_INPUTS - 1)], &T, &J_1,
+                              &J_2, false);
+    doNotOptimize(T);
+    doNotOptimize(J_2);
+  }
+}
+LGMATH_BENCHMARK("Transformation/jacobians/compose (no reprojection)",
+                 transformComposeWithJacobiansNoReproject);
+
+void transformComposeThenAdjoint(State& state) {
+  const auto inputs = randomTransforms();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++;
+    const se3::Transformation& T_1 = inputs[j & (NUM_INPUTS - 1)];
+    doNotOptimize(T_1 * inputs[(j + 1) & (NUM_INPUTS - 1)]);
+    doNotOptimize(Eigen::Matrix<double, 6, 6>::Identity().eval());
+    doNotOptimize(T_1.adjoint());
+  }
+}
+LGMATH_BENCHMARK("Transformation/jacobians/compose (separate calls)",
+                 transformComposeThenAdjoint);
+
+void transformInverseWithJacobian(State& state) {
+  const auto inputs = randomTransforms();
+  se3::Transformation T;
+  Eigen::Matrix<double, 6, 6> J;
+  std::size_t i = 0;
+  for (auto _ : state) {
+    se3::inverseWithJacobian(inputs[i++ & (NUM_INPUTS - 1)], &T, &J);
+    doNotOptimize(T);
+    doNotOptimize(J);
+  }
+}
+LGMATH_BENCHMARK("Transformation/jacobians/inverse",
+                 transformInverseWithJacobian);
+
+void transformInverseThenAdjoint(State& state) {
+  const auto inputs = randomTransforms();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const se3::Transformation T = inputs[i++ & (NUM_INPUTS - 1)].inverse();
+    doNotOptimize(T);
+    doNotOptimize((-T.adjoint()).eval());
+  }
+}
+LGMATH_BENCHMARK("Transformation/jacobians/inverse (separate calls)",
+                 transformInverseThenAdjoint);
+
+void transformPointWithJacobian(State& state) {
+  const auto transforms = randomTransforms();
+  const auto points = randomPoints();
+  Eigen::Matrix3d J_p;
+  Eigen::Matrix<double, 3, 6> J_T;
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++ & (NUM_INPUTS - 1);
+    doNotOptimize(se3::transformPointWithJacobian(
+        transforms[j], points[j].head<3>(), &J_p, &J_T));
+    doNotOptimize(J_p);
+    doNotOptimize(J_T);
+  }
+}
+LGMATH_BENCHMARK("Transformation/jacobians/landmark",
+                 transformPointWithJacobian);
+
+void transformPointThenPoint2fs(State& state) {
+  const auto transforms = randomTransforms();
+  const auto points = randomPoints();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++ & (NUM_INPUTS - 1);
+    const Eigen::Vector4d p_b = transforms[j] * points[j];
+    doNotOptimize(p_b);
+    doNotOptimize(transforms[j].C_ba());
+    doNotOptimize(se3::point2fs(p_b.head<3>()));
+  }
+}
+LGMATH_BENCHMARK("Transformation/jacobians/landmark (separate calls)",
+                 transformPointThenPoint2fs);
+
+void transformMapLandmark(State& state) {
+  const auto poses = randomPoseBuffer(se3::PoseLayout::ROW_MAJOR_3X4);
+  const auto points = randomPoints();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++ & (NUM_INPUTS - 1);
+    const se3::ConstTransformationMap T(poses.data() + 12 * j,
+                                        se3::PoseLayout::ROW_MAJOR_3X4);
+    doNotOptimize(T * points[j]);
+  }
+}
+LGMATH_BENCHMARK("Transformation/map/landmark", transformMapLandmark);
+
+void transformCopyLandmark(State& state) {
+  const auto poses = randomPoseBuffer(se3::PoseLayout::ROW_MAJOR_3X4);
+  const auto points = randomPoints();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++ & (NUM_INPUTS - 1);
+    Eigen::Matrix4d T_ba = Eigen::Matrix4d::Identity();
+    T_ba.topRows<3>() =
+        Eigen::Map<const Eigen::Matrix<double, 3, 4, Eigen::RowMajor>>(
+            poses.data() + 12 * j);
+    doNotOptimize(se3::Transformation(T_ba) * points[j]);
+  }
+}
+LGMATH_BENCHMARK("Transformation/map/landmark (copy to Matrix4d)",
+                 transformCopyLandmark);
+
+void transformMapCompose(State& state) {
+  const auto layout = se3::PoseLayout::TRANSLATION_QUATERNION;
+  const auto poses = randomPoseBuffer(layout);
+  std::vector<double> out(7);
+  se3::TransformationMap T_out(out.data(), layout);
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++ & (NUM_INPUTS - 1);
+    const std::size_t k = (j + 1) & (NUM_INPUTS - 1);
+    se3::compose(se3::ConstTransformationMap(poses.data() + 7 * j, layout),
+                 se3::ConstTransformationMap(poses.data() + 7 * k, layout),
+                 &T_out);
+    clobberMemory();
+  }
+}
+LGMATH_BENCHMARK("Transformation/map/compose pose", transformMapCompose);
+
+}  // namespace
@@ -1,225 +1,208 @@
-#include <gtest/gtest.h>
+/**
+ * \file TransformWithCovarianceSpeedTest.cpp
+ * \brief Benchmarks of the TransformationWithCovariance class.
+ *
+ * \author ASRL
+ */
+#include <vector>
+
+#include <Eigen/Core>
 
-#include <lgmath/CommonTools.hpp>
-#include <lgmath/se3/Operations.hpp>
 #include <lgmath/se3/TransformationWithCovariance.hpp>
 
-TEST(LGMath, TransformWithCovarianceBenchmark) {
-  // Init variables
-  double margin = 5.0;  // 500% increase
-  unsigned int N = 1000000;
-  unsigned int L = 1000;
-  unsigned int M = 10000;
-  lgmath::common::Timer timer;
-  double time1, time2;
-  double recorded;
-
-  // Allocate test memory
-  lgmath::se3::TransformationWithCovariance transform;
-  lgmath::se3::TransformationWithCovariance transform_unset;
-  Eigen::Matrix<double, 4, 1> v4 = Eigen::Matrix<double, 4, 1>::Random();
-  Eigen::Matrix<double, 6, 1> v6 = Eigen::Matrix<double, 6, 1>::Random();
-  Eigen::Matrix<double, 6, 6> U6 = Eigen::Matrix<double, 6, 6>::Random();
-
-  // This is a TransformWithCovariance with intentionally unset covariance
-  transform_unset = lgmath::se3::TransformationWithCovariance(v6);
-
-  /////////////////////////////////////////////////////////////////////////////////////////////
-  /// Transformation Testing
-  /////////////////////////////////////////////////////////////////////////////////////////////
-  std::cout << "Starting TransformationWithCovariance Tests" << std::endl;
-  std::cout << "-----------------------------" << std::endl;
-  std::cout << "Comparison timings are to get a ballpark estimate."
-            << std::endl;
-  std::cout << "Check that it is not an order of magnitude off; you may not be "
-               "in release mode."
-            << std::endl;
-  std::cout << " " << std::endl;
-
-  // test
-  std::cout << "Test transform vec2tran, over " << N << " iterations."
-            << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    transform = lgmath::se3::TransformationWithCovariance(v6, U6);
-  }
-  time1 = timer.nanoseconds();
-  recorded = 0.155;
-  std::cout << "your speed: " << time1 / double(N) << "nsec per call."
-            << std::endl;
-  std::cout << "recorded:   " << 1000.0 * recorded
-            << "nsec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((time1 / double(N)), 1000.0 * recorded * margin);
-
-  // test
-  std::cout << "Test transform tran2vec, over " << N << " iterations."
-            << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    v6 = transform.vec();
-  }
-  time1 = timer.nanoseconds();
-  recorded = 0.127;
-  std::cout << "your speed: " << time1 / double(N) << "nsec per call."
-            << std::endl;
-  std::cout << "recorded:   " << 1000.0 * recorded
-            << "nsec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((time1 / double(N)), 1000.0 * recorded * margin);
-
-  // test
-  std::cout << "Test lval vs rval assignment, over " << N << " iterations."
-            << std::endl;
-  lgmath::se3::TransformationWithCovariance tmp(transform);
-  lgmath::se3::TransformationWithCovariance tmp2(transform);
-  double build_time;
-  build_time = time1 = time2 = 0;
-
-  for (unsigned int j = 0; j < L; ++j) {
-    timer.reset();
-    for (unsigned int i = 0; i < M; i++) {
-      tmp = lgmath::se3::TransformationWithCovariance(transform);
-    }
-    build_time += timer.nanoseconds();
-
-    timer.reset();
-    for (unsigned int i = 0; i < M; i++) {
-      tmp = lgmath::se3::TransformationWithCovariance(transform);
-      tmp2 = tmp;
-    }
-    time1 += timer.nanoseconds();
-
-    timer.reset();
-    for (unsigned int i = 0; i < M; i++) {
-      tmp = lgmath::se3::TransformationWithCovariance(transform);
-      tmp2 = std::move(tmp);
-    }
-    time2 += timer.nanoseconds();
-  }
-
-  std::cout << "Lval assignment time: " << (time1 - build_time) / double(M * L)
-            << "nsec per call." << std::endl;
-  std::cout << "Rval assignment time: " << (time2 - build_time) / double(M * L)
-            << "nsec per call." << std::endl;
-  std::cout << "Difference: " << (time1 - time2) / (time1 - build_time) * 100
-            << "%" << std::endl;
-  std::cout << " " << std::endl;
-
-  // test
-  std::cout << "Test TransformWithCovariance*TransformWithCovariance over " << N
-            << " iterations." << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    transform = transform * transform;
-  }
-  time1 = timer.nanoseconds();
-  recorded = 0.189;
-  std::cout << "your speed: " << time1 / double(N) << "nsec per call."
-            << std::endl;
-  std::cout << "recorded:   " << 1000.0 * recorded
-            << "nsec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((time1 / double(N)), 1000.0 * recorded * margin);
-
-  // test
-  std::cout << "Test TransformWithCovariance * Unset Transform over " << N
-            << " iterations." << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    transform = transform * transform_unset;
-  }
-  time1 = timer.nanoseconds();
-  recorded = 0.189;
-  std::cout << "your speed: " << time1 / double(N) << "nsec per call."
-            << std::endl;
-  std::cout << "recorded:   " << 1000.0 * recorded
-            << "nsec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((time1 / double(N)), 1000.0 * recorded * margin);
-
-  // test
-  std::cout << "Test Unset Transform * TransformWithCovariance over " << N
-            << " iterations." << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    transform = transform_unset * transform;
-  }
-  time1 = timer.nanoseconds();
-  recorded = 0.189;
-  std::cout << "your speed: " << time1 / double(N) << "nsec per call."
-            << std::endl;
-  std::cout << "recorded:   " << 1000.0 * recorded
-            << "nsec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((time1 / double(N)), 1000.0 * recorded * margin);
-
-  // test
-  std::cout << "Test TransformWithCovariance/TransformWithCovariance over " << N
-            << " iterations." << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    transform = transform / transform;
-  }
-  time1 = timer.nanoseconds();
-  recorded = 0.204;
-  std::cout << "your speed: " << time1 / double(N) << "nsec per call."
-            << std::endl;
-  std::cout << "recorded:   " << 1000.0 * recorded
-            << "nsec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((time1 / double(N)), 1000.0 * recorded * margin);
-
-  // test
-  std::cout << "Test TransformWithCovariance / Unset Transform over " << N
-            << " iterations." << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    transform = transform / transform_unset;
-  }
-  time1 = timer.nanoseconds();
-  recorded = 0.204;
-  std::cout << "your speed: " << time1 / double(N) << "nsec per call."
-            << std::endl;
-  std::cout << "recorded:   " << 1000.0 * recorded
-            << "nsec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((time1 / double(N)), 1000.0 * recorded * margin);
-
-  // test
-  std::cout << "Test Unset Transform / TransformWithCovariance over " << N
-            << " iterations." << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    transform = transform_unset / transform;
-  }
-  time1 = timer.nanoseconds();
-  recorded = 0.204;
-  std::cout << "your speed: " << time1 / double(N) << "nsec per call."
-            << std::endl;
-  std::cout << "recorded:   " << 1000.0 * recorded
-            << "nsec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((time1 / double(N)), 1000.0 * recorded * margin);
-
-  // test
-  std::cout << "Test product with landmark over " << N << " iterations."
-            << std::endl;
-  timer.reset();
-  for (unsigned int i = 0; i < N; i++) {
-    v4 = transform * v4;
-  }
-  time1 = timer.nanoseconds();
-  recorded = 0.0139;
-  std::cout << "your speed: " << time1 / double(N) << "nsec per call."
-            << std::endl;
-  std::cout << "recorded:   " << 1000.0 * recorded
-            << "nsec per call, 2.4 GHz processor, March 2015" << std::endl;
-  std::cout << " " << std::endl;
-  EXPECT_LT((time1 / double(N)), 1000.0 * recorded * margin);
-}
-
-int main(int argc, char** argv) {
-  testing::InitGoogleTest(&argc, argv);
-  return RUN_ALL_TESTS();
+#include "Benchmark.hpp"
+
+namespace {
+
+using namespace lgmath;
+using namespace lgmath::benchmark;
+
+typedef Eigen::Matrix<double, 6, 1> Vector6d;
+typedef Eigen::Matrix<double, 6, 6> Matrix6d;
+
+std::vector<Vector6d> randomVectors() {
+  std::vector<Vector6d> vectors(NUM_INPUTS);
+  for (auto& v : vectors) {
+    v = Vector6d::Random();
+  }
+  return vectors;
+}
+
+std::vector<Matrix6d> randomCovariances() {
+  std::vector<Matrix6d> covariances(NUM_INPUTS);
+  for (auto& U : covariances) {
+    const Matrix6d A = Matrix6d::Random();
+    U = A * A.transpose();
+  }
+  return covariances;
+}
+
+std::vector<se3::TransformationWithCovariance> randomTransforms() {
+  const auto vectors = randomVectors();
+  const auto covariances = randomCovariances();
+  std::vector<se3::TransformationWithCovariance> transforms;
+  for (std::size_t i = 0; i < NUM_INPUTS; ++i) {
+    transforms.emplace_back(vectors[i], covariances[i]);
+  }
+  return transforms;
 }
+
+/** \brief Transforms whose covariance is intentionally unset */
+std::vector<se3::TransformationWithCovariance> unsetTransforms() {
+  std::vector<se3::TransformationWithCovariance> transforms;
+  for (const auto& v : randomVectors()) {
+    transforms.emplace_back(v);
+  }
+  return transforms;
+}
+
+std::vector<Eigen::Vector4d> randomPoints() {
+  std::vector<Eigen::Vector4d> points(NUM_INPUTS);
+  for (auto& p : points) {
+    p << Eigen::Vector3d::Random(), 1.0;
+  }
+  return points;
+}
+
+void twcFromVector(State& state) {
+  const auto vectors = randomVectors();
+  const auto covariances = randomCovariances();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++ & (NUM_INPUTS - 1);
+    doNotOptimize(
+        se3::TransformationWithCovariance(vectors[j], covariances[j]));
+  }
+}
+LGMATH_BENCHMARK("TransformationWithCovariance/vec2tran", twcFromVector);
+
+void twcVec(State& state) {
+  const auto inputs = randomTransforms();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    doNotOptimize(inputs[i++ & (NUM_INPUTS - 1)].vec());
+  }
+}
+LGMATH_BENCHMARK("TransformationWithCovariance/tran2vec", twcVec);
+
+void twcCopyAssign(State& state) {
+  const auto inputs = randomTransforms();
+  se3::TransformationWithCovariance T;
+  std::size_t i = 0;
+  for (auto _ : state) {
+    T = inputs[i++ & (NUM_INPUTS - 1)];
+    doNotOptimize(T);
+  }
+}
+LGMATH_BENCHMARK("TransformationWithCovariance/assign/lvalue", twcCopyAssign);
+
+void twcMoveAssign(State& state) {
+  const auto vectors = randomVectors();
+  const auto covariances = randomCovariances();
+  se3::TransformationWithCovariance T;
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++ & (NUM_INPUTS - 1);
+    T = se3::TransformationWithCovariance(vectors[j], covariances[j]);
+    doNotOptimize(T);
+  }
+}
+LGMATH_BENCHMARK("TransformationWithCovariance/assign/rvalue", twcMoveAssign);
+
+void twcProduct(State& state) {
+  const auto inputs = randomTransforms();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++;
+    doNotOptimize(inputs[j & (NUM_INPUTS - 1)] *
+                  inputs[(j + 1) & (NUM_INPUTS - 1)]);
+  }
+}
+LGMATH_BENCHMARK("TransformationWithCovariance/product", twcProduct);
+
+void twcComposeInPlace(State& state) {
+  const auto inputs = randomTransforms();
+  se3::TransformationWithCovariance T;
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++;
+    // Restart from an input so that the covariance does not grow unbounded
+    T = inputs[j & (NUM_INPUTS - 1)];
+    T *= inputs[(j + 1) & (NUM_INPUTS - 1)];
+    doNotOptimize(T);
+  }
+}
+LGMATH_BENCHMARK("TransformationWithCovariance/operator*=", twcComposeInPlace);
+
+void twcProductUnsetRhs(State& state) {
+  const auto set = randomTransforms();
+  const auto unset = unsetTransforms();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++ & (NUM_INPUTS - 1);
+    doNotOptimize(set[j] * unset[j]);
+  }
+}
+LGMATH_BENCHMARK("TransformationWithCovariance/product/unsetRhs",
+                 twcProductUnsetRhs);
+
+void twcProductUnsetLhs(State& state) {
+  const auto set = randomTransforms();
+  const auto unset = unsetTransforms();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++ & (NUM_INPUTS - 1);
+    doNotOptimize(unset[j] * set[j]);
+  }
+}
+LGMATH_BENCHMARK("TransformationWithCovariance/product/unsetLhs",
+                 twcProductUnsetLhs);
+
+void twcProductInverse(State& state) {
+  const auto inputs = randomTransforms();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++;
+    doNotOptimize(inputs[j & (NUM_INPUTS - 1)] /
+                  inputs[(j + 1) & (NUM_INPUTS - 1)]);
+  }
+}
+LGMATH_BENCHMARK("TransformationWithCovariance/productInverse",
+                 twcProductInverse);
+
+void twcProductInverseUnsetRhs(State& state) {
+  const auto set = randomTransforms();
+  const auto unset = unsetTransforms();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++ & (NUM_INPUTS - 1);
+    doNotOptimize(set[j] / unset[j]);
+  }
+}
+LGMATH_BENCHMARK("TransformationWithCovariance/productInverse/unsetRhs",
+                 twcProductInverseUnsetRhs);
+
+void twcProductInverseUnsetLhs(State& state) {
+  const auto set = randomTransforms();
+  const auto unset = unsetTransforms();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++ & (NUM_INPUTS - 1);
+    doNotOptimize(unset[j] / set[j]);
+  }
+}
+LGMATH_BENCHMARK("TransformationWithCovariance/productInverse/unsetLhs",
+                 twcProductInverseUnsetLhs);
+
+void twcLandmark(State& state) {
+  const auto transforms = randomTransforms();
+  const auto points = randomPoints();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const std::size_t j = i++ & (NUM_INPUTS - 1);
+    doNotOptimize(transforms[j] * points[j]);
+  }
+}
+LGMATH_BENCHMARK("TransformationWithCovariance/landmark", twcLandmark);
+
+}  // namespace
@@ -0,0 +1,105 @@
+/**
+ * \file UnscentedSpeedTest.cpp
+ * \brief Benchmarks of the unscented transform, against a loop of scalar
+ * sigma points and the linearized propagation.
+ *
+ * \author ASRL
+ */
+#include <cmath>
+#include <vector>
+
+#include <Eigen/Cholesky>
+#include <Eigen/Core>
+
+#include <lgmath/se3/Unscented.hpp>
+
+#include "Benchmark.hpp"
+
+namespace {
+
+using namespace lgmath;
+using namespace lgmath::benchmark;
+
+typedef Eigen::Matrix<double, 6, 1> Vector6d;
+typedef Eigen::Matrix<double, 6, 6> Matrix6d;
+
+/** \brief A random pose with a correlated covariance */
+se3::TransformationWithCovariance testPose() {
+  const Matrix6d A = 0.2 * Matrix6d::Random();
+  return se3::TransformationWithCovariance(
+      se3::Transformation(Vector6d(Vector6d::Random())),
+      A * A.transpose() + 1e-3 * Matrix6d::Identity());
+}
+
+/** \brief The function of the pose */
+se3::Transformation square(const se3::Transformation& T) { return T * T; }
+
+void unscented(State& state) {
+  const se3::TransformationWithCovariance T = testPose();
+  for (auto _ : state) {
+    se3::TransformationWithCovariance Y =
+        se3::unscentedTransform(T, square);
+    doNotOptimize(Y);
+  }
+}
+
+/** \brief The same 13 sigma points, one pose at a time */
+void unscentedLoop(State& state) {
+  const se3::TransformationWithCovariance T = testPose();
+  const double scale = std::sqrt(6.0), mean0 = 0.0, other = 1.0 / 12.0;
+  for (auto _ : state) {
+    const Matrix6d L =
+        scale * Eigen::LLT<Matrix6d>(T.cov()).matrixL().toDenseMatrix();
+    std::vector<se3::Transformation> Y;
+    Y.push_back(square(T));
+    for (int j = 0; j < 6; ++j) {
+      Y.push_back(square(se3::Transformation(Vector6d(L.col(j))) * T));
+      Y.push_back(square(se3::Transformation(Vector6d(-L.col(j))) * T));
+    }
+    se3::Transformation Y_mean = Y[0];
+    std::vector<Vector6d> xi(Y.size());
+    Vector6d delta;
+    for (int k = 0; k < 10; ++k) {
+      const se3::Transformation inverse = Y_mean.inverse();
+      delta.setZero();
+      for (std::size_t i = 0; i < Y.size(); ++i) {
+        xi[i] = (Y[i] * inverse).vec();
+        delta += (i == 0 ? mean0 : other) * xi[i];
+      }
+      Y_mean = se3::Transformation(delta) * Y_mean;
+      if (delta.norm() < 1e-12) {
+        break;
+      }
+    }
+    Matrix6d cov = Matrix6d::Zero();
+    for (std::size_t i = 0; i < Y.size(); ++i) {
+      const Vector6d d = xi[i] - delta;
+      cov += (i == 0 ? 2.0 : other) * d * d.transpose();
+    }
+    se3::TransformationWithCovariance out(Y_mean, cov);
+    doNotOptimize(out);
+  }
+}
+
+void unscentedCompose(State& state) {
+  const se3::TransformationWithCovariance T1 = testPose(), T2 = testPose();
+  for (auto _ : state) {
+    se3::TransformationWithCovariance T = se3::unscentedCompose(T1, T2);
+    doNotOptimize(T);
+  }
+}
+
+void linearizedCompose(State& state) {
+  const se3::TransformationWithCovariance T1 = testPose(), T2 = testPose();
+  for (auto _ : state) {
+    se3::TransformationWithCovariance T = T1 * T2;
+    doNotOptimize(T);
+  }
+}
+
+LGMATH_BENCHMARK("unscented/transform", unscented);
+LGMATH_BENCHMARK("unscented/transform loop", unscentedLoop);
+LGMATH_BENCHMARK("unscented/compose", unscentedCompose);
+LGMATH_BENCHMARK("unscented/linearized compose", linearizedCompose);
+
+}  // namespace
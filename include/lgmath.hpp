@@ -13,15 +13,36 @@
 // todo
 
 // SO3
+#include <lgmath/so3/Mean.hpp>
 #include <lgmath/so3/Operations.hpp>
 #include <lgmath/so3/Rotation.hpp>
+#include <lgmath/so3/RotationMap.hpp>
 #include <lgmath/so3/Types.hpp>
 
 // SE3
 #include <lgmath/se3/Operations.hpp>
 #include <lgmath/se3/Transformation.hpp>
+#include <lgmath/se3/TransformationMap.hpp>
 #include <lgmath/se3/Types.hpp>
+#include <lgmath/Parallel.hpp>
+#include <lgmath/se3/Batch.hpp>
+#include <lgmath/se3/Interpolation.hpp>
+#include <lgmath/se3/CachedTransformation.hpp>
+#include <lgmath/se3/Deskew.hpp>
+#include <lgmath/se3/GaussianProcess.hpp>
+#include <lgmath/se3/Mean.hpp>
+#include <lgmath/se3/PoseArray.hpp>
+#include <lgmath/se3/PoseCovArray.hpp>
+#include <lgmath/se3/Sampling.hpp>
+#include <lgmath/se3/Spline.hpp>
+#include <lgmath/se3/TransformationPairWithCovariance.hpp>
+#include <lgmath/se3/Unscented.hpp>
 
 // R3
 #include <lgmath/r3/Operations.hpp>
 #include <lgmath/r3/Types.hpp>
+
+// IO
+#include <lgmath/io/BinaryFormat.hpp>
+#include <lgmath/io/TrajectoryCodec.hpp>
+#include <lgmath/io/TrajectoryStore.hpp>
@@ -1,15 +1,30 @@
 /**
  * \file CommonTools.hpp
  * \brief A header-only helper file with a few common tools.
- * \details Implements a basic timer tool.
+ * \details Implements a basic timer tool, a cycle-counter clock, and latency
+ * histograms with an RAII probe for instrumenting hot paths.
  *
  * \author Sean Anderson, ASRL
  */
 #pragma once
 
-// system timer
-#include <sys/time.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 
 namespace lgmath {
 namespace common {
@@ -21,34 +36,398 @@ class Timer {
   Timer() { reset(); }
 
   /** \brief Reset timer */
-  void reset() { beg_ = this->get_wall_time(); }
+  void reset() { beg_ = clock::now(); }
 
   /** \brief Get seconds since last reset */
-  double seconds() const { return this->get_wall_time() - beg_; }
+  double seconds() const { return 1e-9 * this->nanoseconds(); }
 
   /** \brief Get milliseconds since last reset */
-  double milliseconds() const { return 1e3 * (this->get_wall_time() - beg_); }
+  double milliseconds() const { return 1e-6 * this->nanoseconds(); }
 
   /** \brief Get microseconds since last reset */
-  double microseconds() const { return 1e6 * (this->get_wall_time() - beg_); }
+  double microseconds() const { return 1e-3 * this->nanoseconds(); }
 
   /** \brief Get nanoseconds since last reset */
-  double nanoseconds() const { return 1e9 * (this->get_wall_time() - beg_); }
+  double nanoseconds() const {
+    return std::chrono::duration<double, std::nano>(clock::now() - beg_)
+        .count();
+  }
 
  private:
-  /** \brief Get current wall time */
-  double get_wall_time() const {
-    struct timeval time;
-    //  Handle error
-    if (gettimeofday(&time, NULL)) {
+  /** \brief Monotonic clock, unaffected by changes of the system time */
+  typedef std::chrono::steady_clock clock;
+
+  /** \brief Time at reset */
+  clock::time_point beg_;
+};
+
+/**
+ * \brief Clock reading the CPU timestamp counter, for timing short sections.
+ * \details On x86 this is rdtsc, on AArch64 the virtual counter; elsewhere it
+ * falls back to steady_clock nanoseconds. Reading it takes a few nanoseconds,
+ * about a tenth of a steady_clock call. Ticks are converted to nanoseconds
+ * with a ratio calibrated against steady_clock on first use (which takes
+ * about 10 ms). Assumes an invariant counter, as on all recent x86 CPUs.
+ */
+class TscClock {
+ public:
+  /** \brief Gets the current counter value */
+  static std::uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    std::uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+  }
+
+  /** \brief Gets the duration of one tick in nanoseconds */
+  static double nanosecondsPerTick() {
+    static const double ratio = calibrate();
+    return ratio;
+  }
+
+  /** \brief Converts a number of ticks to nanoseconds */
+  static double toNanoseconds(std::uint64_t ticks) {
+    return double(ticks) * nanosecondsPerTick();
+  }
+
+ private:
+  /** \brief Measures the tick period against steady_clock */
+  static double calibrate() {
+    typedef std::chrono::steady_clock clock;
+    const clock::time_point start = clock::now();
+    const std::uint64_t startTicks = now();
+    clock::time_point end;
+    do {
+      end = clock::now();
+    } while (end - start < std::chrono::milliseconds(10));
+    const std::uint64_t ticks = now() - startTicks;
+    const double ns = std::chrono::duration<double, std::nano>(end - start)
+                          .count();
+    return ticks == 0 ? 1.0 : ns / double(ticks);
+  }
+};
+
+/**
+ * \brief Log-linear latency histogram, in the style of HdrHistogram.
+ * \details Values (nanoseconds) below 16 have their own buckets; above that,
+ * each power of two is split into 16 linear sub-buckets, so a recorded value
+ * is known to within 1/16 (6.25%) with a fixed 976 buckets covering the whole
+ * uint64 range.
+ *
+ * record() is wait-free but must only be called by one thread at a time (the
+ * histogram's owner, see latencyHistogram()); any thread may read, copy or
+ * merge it concurrently and sees a slightly stale but consistent-enough view.
+ */
+class LatencyHistogram {
+ public:
+  /** \brief Number of linear sub-buckets per power of two, as bits */
+  static constexpr unsigned int SUB_BUCKET_BITS = 4;
+
+  /** \brief Number of linear sub-buckets per power of two */
+  static constexpr std::size_t SUB_BUCKETS = std::size_t(1) << SUB_BUCKET_BITS;
+
+  /** \brief Number of buckets */
+  static constexpr std::size_t NUM_BUCKETS =
+      (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+  /** \brief Default constructor, empty histogram */
+  LatencyHistogram() { this->clear(); }
+
+  /** \brief Copy constructor, takes a snapshot of other */
+  LatencyHistogram(const LatencyHistogram& other) {
+    this->clear();
+    this->merge(other);
+  }
+
+  /** \brief Copy assignment operator, takes a snapshot of other */
+  LatencyHistogram& operator=(const LatencyHistogram& other) {
+    if (this != &other) {
+      this->clear();
+      this->merge(other);
+    }
+    return *this;
+  }
+
+  /** \brief Gets the bucket of a value */
+  static std::size_t bucket(std::uint64_t value) {
+    if (value < SUB_BUCKETS) {
+      return std::size_t(value);
+    }
+    const unsigned int exponent = 63 - __builtin_clzll(value);
+    const unsigned int shift = exponent - SUB_BUCKET_BITS;
+    return (shift + 1) * SUB_BUCKETS +
+           std::size_t((value >> shift) & (SUB_BUCKETS - 1));
+  }
+
+  /** \brief Gets the smallest value of a bucket */
+  static std::uint64_t lowerBound(std::size_t bucket) {
+    if (bucket < SUB_BUCKETS) {
+      return bucket;
+    }
+    const unsigned int shift = unsigned(bucket / SUB_BUCKETS) - 1;
+    return (SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+  }
+
+  /** \brief Gets the largest value of a bucket */
+  static std::uint64_t upperBound(std::size_t bucket) {
+    if (bucket < SUB_BUCKETS) {
+      return bucket;
+    }
+    const unsigned int shift = unsigned(bucket / SUB_BUCKETS) - 1;
+    return lowerBound(bucket) + ((std::uint64_t(1) << shift) - 1);
+  }
+
+  /** \brief Records a value; only the owning thread may call this */
+  void record(std::uint64_t value) {
+    increment(counts_[bucket(value)], 1);
+    increment(count_, 1);
+    increment(sum_, value);
+    if (value < min_.load(std::memory_order_relaxed)) {
+      min_.store(value, std::memory_order_relaxed);
+    }
+    if (value > max_.load(std::memory_order_relaxed)) {
+      max_.store(value, std::memory_order_relaxed);
+    }
+  }
+
+  /** \brief Adds the values recorded in other; owner only */
+  void merge(const LatencyHistogram& other) {
+    for (std::size_t i = 0; i < NUM_BUCKETS; ++i) {
+      const std::uint64_t n = other.counts_[i].load(std::memory_order_relaxed);
+      if (n != 0) {
+        increment(counts_[i], n);
+      }
+    }
+    increment(count_, other.count_.load(std::memory_order_relaxed));
+    increment(sum_, other.sum_.load(std::memory_order_relaxed));
+    min_.store(std::min(min_.load(std::memory_order_relaxed),
+                        other.min_.load(std::memory_order_relaxed)),
+               std::memory_order_relaxed);
+    max_.store(std::max(max_.load(std::memory_order_relaxed),
+                        other.max_.load(std::memory_order_relaxed)),
+               std::memory_order_relaxed);
+  }
+
+  /** \brief Removes all values; owner only */
+  void clear() {
+    for (auto& n : counts_) {
+      n.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    min_.store(UINT64_MAX, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+  }
+
+  /** \brief Gets the number of recorded values */
+  std::uint64_t count() const {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+  /** \brief Gets the number of values recorded in a bucket */
+  std::uint64_t count(std::size_t bucket) const {
+    return counts_[bucket].load(std::memory_order_relaxed);
+  }
+
+  /** \brief Gets the smallest recorded value, 0 if empty */
+  std::uint64_t min() const { return count() == 0 ? 0 : min_.load(); }
+
+  /** \brief Gets the largest recorded value */
+  std::uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+
+  /** \brief Gets the mean of the recorded values, 0 if empty */
+  double mean() const {
+    const std::uint64_t n = count();
+    return n == 0 ? 0.0 : double(sum_.load(std::memory_order_relaxed)) / n;
+  }
+
+  /**
+   * \brief Gets the value at percentile p (in [0, 100]), as the largest value
+   * of its bucket (clamped to max()); 0 if empty.
+   */
+  std::uint64_t percentile(double p) const {
+    std::uint64_t total = 0;
+    for (const auto& n : counts_) {
+      total += n.load(std::memory_order_relaxed);
+    }
+    if (total == 0) {
       return 0;
     }
-    return (double)time.tv_sec + (double)time.tv_usec * .000001;
+    const double clamped = std::min(100.0, std::max(0.0, p));
+    const std::uint64_t rank = std::max<std::uint64_t>(
+        1, std::uint64_t(clamped / 100.0 * double(total) + 0.5));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < NUM_BUCKETS; ++i) {
+      seen += counts_[i].load(std::memory_order_relaxed);
+      if (seen >= rank) {
+        return std::min(upperBound(i), max());
+      }
+    }
+    return max();
+  }
+
+  /** \brief Prints a summary line: count, mean and percentiles in ns */
+  void print(std::ostream& out) const {
+    out << "count " << count() << ", mean " << std::fixed
+        << std::setprecision(1) << mean() << ", min " << min() << ", p50 "
+        << percentile(50) << ", p90 " << percentile(90) << ", p99 "
+        << percentile(99) << ", p99.9 " << percentile(99.9) << ", max "
+        << max() << " (ns)";
+  }
+
+ private:
+  /** \brief Single-writer increment, cheaper than an atomic fetch_add */
+  static void increment(std::atomic<std::uint64_t>& value, std::uint64_t n) {
+    value.store(value.load(std::memory_order_relaxed) + n,
+                std::memory_order_relaxed);
+  }
+
+  /** \brief Number of values recorded in each bucket */
+  std::array<std::atomic<std::uint64_t>, NUM_BUCKETS> counts_;
+
+  /** \brief Number, sum and extremes of the recorded values */
+  std::atomic<std::uint64_t> count_;
+  std::atomic<std::uint64_t> sum_;
+  std::atomic<std::uint64_t> min_;
+  std::atomic<std::uint64_t> max_;
+};
+
+/**
+ * \brief Owns the per-thread latency histograms of every probe name.
+ * \details Histograms are never freed, so those of exited threads are still
+ * included when merging.
+ */
+class HistogramRegistry {
+ public:
+  /** \brief Gets the process-wide registry */
+  static HistogramRegistry& instance() {
+    static HistogramRegistry registry;
+    return registry;
+  }
+
+  /** \brief Creates a histogram for the calling thread under name */
+  LatencyHistogram* create(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    histograms_.emplace_back(new LatencyHistogram());
+    byName_[name].push_back(histograms_.back().get());
+    return histograms_.back().get();
+  }
+
+  /** \brief Gets the names of all registered histograms */
+  std::vector<std::string> names() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::string> names;
+    for (const auto& entry : byName_) {
+      names.push_back(entry.first);
+    }
+    return names;
+  }
+
+  /** \brief Merges the histograms of all threads under name */
+  LatencyHistogram merged(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    LatencyHistogram result;
+    auto it = byName_.find(name);
+    if (it != byName_.end()) {
+      for (const LatencyHistogram* histogram : it->second) {
+        result.merge(*histogram);
+      }
+    }
+    return result;
   }
 
-  /** \brief Wall time at reset */
-  double beg_;
+  /**
+   * \brief Clears all histograms. Values recorded concurrently may be lost,
+   * so only call this while the instrumented threads are quiescent.
+   */
+  void clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& histogram : histograms_) {
+      histogram->clear();
+    }
+  }
+
+  /** \brief Prints the merged summary of every name */
+  void dump(std::ostream& out) const {
+    for (const std::string& name : names()) {
+      out << name << ": ";
+      merged(name).print(out);
+      out << std::endl;
+    }
+  }
+
+ private:
+  HistogramRegistry() = default;
+
+  /** \brief Protects the maps; not taken when recording */
+  mutable std::mutex mutex_;
+
+  /** \brief All histograms */
+  std::vector<std::unique_ptr<LatencyHistogram>> histograms_;
+
+  /** \brief Histograms of each name, one per thread that used it */
+  std::map<std::string, std::vector<LatencyHistogram*>> byName_;
+};
+
+/**
+ * \brief Gets the calling thread's histogram for name, creating it on first
+ * use. Takes a lock the first time and a map lookup afterwards; hot paths
+ * should cache the result (as LGMATH_SCOPED_PROBE does).
+ */
+inline LatencyHistogram& latencyHistogram(const std::string& name) {
+  thread_local std::map<std::string, LatencyHistogram*> histograms;
+  LatencyHistogram*& histogram = histograms[name];
+  if (histogram == nullptr) {
+    histogram = HistogramRegistry::instance().create(name);
+  }
+  return *histogram;
+}
+
+/** \brief Records the lifetime of the probe, in nanoseconds, to a histogram */
+class ScopedProbe {
+ public:
+  /** \brief Constructor, starts timing */
+  explicit ScopedProbe(LatencyHistogram& histogram)
+      : histogram_(histogram), start_(TscClock::now()) {}
+
+  /** \brief Destructor, records the elapsed time */
+  ~ScopedProbe() {
+    histogram_.record(std::uint64_t(
+        TscClock::toNanoseconds(TscClock::now() - start_) + 0.5));
+  }
+
+  ScopedProbe(const ScopedProbe&) = delete;
+  ScopedProbe& operator=(const ScopedProbe&) = delete;
+
+ private:
+  /** \brief Histogram to record to */
+  LatencyHistogram& histogram_;
+
+  /** \brief Counter value at construction */
+  std::uint64_t start_;
 };
 
 }  // namespace common
 }  // namespace lgmath
+
+#define LGMATH_PROBE_CONCAT_(a, b) a##b
+#define LGMATH_PROBE_CONCAT(a, b) LGMATH_PROBE_CONCAT_(a, b)
+
+/**
+ * \brief Records the time until the end of the enclosing scope to the calling
+ * thread's histogram for name (a string literal); the histogram is looked up
+ * once per thread.
+ */
+#define LGMATH_SCOPED_PROBE(name)                                           \
+  static thread_local ::lgmath::common::LatencyHistogram&                   \
+      LGMATH_PROBE_CONCAT(lgmathProbeHistogram, __LINE__) =                 \
+          ::lgmath::common::latencyHistogram(name);                         \
+  ::lgmath::common::ScopedProbe LGMATH_PROBE_CONCAT(lgmathProbe, __LINE__)( \
+      LGMATH_PROBE_CONCAT(lgmathProbeHistogram, __LINE__))
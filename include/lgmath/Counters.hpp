@@ -0,0 +1,142 @@
+/**
+ * \file Counters.hpp
+ * \brief Opt-in counters of the branches and operations taken inside lgmath.
+ * \details The counters are compiled in only when lgmath is configured with
+ * -DLGMATH_ENABLE_COUNTERS=ON, which defines LGMATH_ENABLE_COUNTERS for the
+ * library and its users. Otherwise LGMATH_COUNT expands to nothing and the
+ * snapshot functions return zeros, so calling code builds either way.
+ *
+ * Each thread increments its own block of counters without locking or atomic
+ * read-modify-writes; snapshots read the blocks of one or all threads.
+ *
+ * \author ASRL
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+namespace lgmath {
+namespace common {
+
+/** \brief Counted branches and operations */
+enum class Counter : std::size_t {
+  // so3 operations
+  SO3_VEC2ROT = 0,
+  SO3_VEC2ROT_SMALL_ANGLE,
+  SO3_VEC2ROT_SERIES,
+  SO3_ROT2VEC,
+  SO3_ROT2VEC_NEAR_PI,
+  SO3_ROT2VEC_NEAR_ZERO,
+  SO3_VEC2JAC,
+  SO3_VEC2JAC_SMALL_ANGLE,
+  SO3_VEC2JAC_SERIES,
+  SO3_VEC2JACINV,
+  SO3_VEC2JACINV_SMALL_ANGLE,
+  SO3_VEC2JACINV_SERIES,
+  // se3 operations
+  SE3_VEC2TRAN,
+  SE3_VEC2TRAN_SMALL_ANGLE,
+  SE3_VEC2TRAN_SERIES,
+  SE3_TRAN2VEC,
+  SE3_TRANAD,
+  SE3_VEC2Q,
+  SE3_VEC2JAC,
+  SE3_VEC2JAC_SMALL_ANGLE,
+  SE3_VEC2JAC_SERIES,
+  SE3_VEC2JACINV,
+  SE3_VEC2JACINV_SMALL_ANGLE,
+  SE3_VEC2JACINV_SERIES,
+  // Rotation
+  ROTATION_REPROJECT,
+  ROTATION_REPROJECT_APPLIED,
+  ROTATION_INVERSE,
+  ROTATION_COMPOSE,
+  ROTATION_COMPOSE_INVERSE,
+  // Transformation
+  TRANSFORMATION_REPROJECT,
+  TRANSFORMATION_INVERSE,
+  TRANSFORMATION_COMPOSE,
+  TRANSFORMATION_COMPOSE_INVERSE,
+  // TransformationWithCovariance
+  TRANSFORMATION_WITH_COVARIANCE_INVERSE,
+  TRANSFORMATION_WITH_COVARIANCE_COMPOSE,
+  TRANSFORMATION_WITH_COVARIANCE_COMPOSE_INVERSE,
+  // Compositions whose result has no valid covariance
+  TRANSFORMATION_WITH_COVARIANCE_COVARIANCE_UNSET,
+  // CachedTransformation lookups
+  CACHED_TRANSFORMATION_VEC_HIT,
+  CACHED_TRANSFORMATION_VEC_MISS,
+  CACHED_TRANSFORMATION_ADJOINT_HIT,
+  CACHED_TRANSFORMATION_ADJOINT_MISS,
+  // Not a counter: the number of counters, new ones go above
+  NUM_COUNTERS,
+};
+
+/** \brief Number of counters */
+static constexpr std::size_t NUM_COUNTERS =
+    static_cast<std::size_t>(Counter::NUM_COUNTERS);
+
+/** \brief Values of all counters, indexed by Counter */
+typedef std::array<std::uint64_t, NUM_COUNTERS> CounterValues;
+
+/** \brief Returns whether the counters were compiled in */
+constexpr bool countersEnabled() {
+#ifdef LGMATH_ENABLE_COUNTERS
+  return true;
+#else
+  return false;
+#endif
+}
+
+/** \brief Gets the name of a counter, e.g. "so3/rot2vec/near_pi" */
+const char* counterName(Counter counter);
+
+/** \brief Gets the counters of the calling thread */
+CounterValues counterSnapshot();
+
+/**
+ * \brief Gets the sum of the counters of all threads, including threads that
+ * have exited. Counts of other threads that are still running may lag by a
+ * few increments.
+ */
+CounterValues counterSnapshotAll();
+
+/** \brief Resets the counters of the calling thread */
+void resetCounters();
+
+/**
+ * \brief Resets the counters of all threads. Increments made concurrently
+ * may be lost, so only call this while the instrumented threads are
+ * quiescent; otherwise, subtract two snapshots instead.
+ */
+void resetAllCounters();
+
+/** \brief Gets the difference of two snapshots, after - before */
+CounterValues counterDifference(const CounterValues& after,
+                                const CounterValues& before);
+
+/** \brief Prints the non-zero counters, one per line */
+void printCounters(std::ostream& out, const CounterValues& values);
+
+namespace detail {
+
+/** \brief Increments a counter of the calling thread */
+void incrementCounter(Counter counter);
+
+}  // namespace detail
+}  // namespace common
+}  // namespace lgmath
+
+/**
+ * \brief Counts one occurrence of a Counter, named without its scope, e.g.
+ * LGMATH_COUNT(SO3_ROT2VEC); compiled out unless LGMATH_ENABLE_COUNTERS is set
+ */
+#ifdef LGMATH_ENABLE_COUNTERS
+#define LGMATH_COUNT(counter) \
+  ::lgmath::common::detail::incrementCounter(::lgmath::common::Counter::counter)
+#else
+#define LGMATH_COUNT(counter) ((void)0)
+#endif
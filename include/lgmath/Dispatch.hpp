@@ -0,0 +1,61 @@
+/**
+ * \file Dispatch.hpp
+ * \brief Runtime selection of the instruction set of the batch kernels.
+ * \details lgmath is built for the baseline instruction set of the target,
+ * so that one binary runs on every CPU of a fleet. The heavy batch kernels
+ * (see se3/Batch.hpp) are additionally compiled for SSE4.2, AVX2 and AVX-512,
+ * and the best variant supported by the running CPU is selected on first use.
+ * The environment variable LGMATH_ISA (generic, sse4.2, avx2 or avx512) caps
+ * the selection at load time, and setIsa() forces a level at runtime, e.g. to
+ * compare the variants on one machine.
+ *
+ * \author ASRL
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace lgmath {
+namespace common {
+
+/** \brief Instruction set levels of the batch kernels, in increasing order */
+enum class Isa : int {
+  GENERIC = 0,
+  SSE4_2,
+  AVX2,
+  AVX512,
+};
+
+/** \brief Gets the name of an instruction set, e.g. "avx2" */
+const char* isaName(Isa isa);
+
+/** \brief Parses an instruction set name; throws std::invalid_argument */
+Isa parseIsa(const std::string& name);
+
+/**
+ * \brief Returns whether the kernels of an instruction set were built and
+ * the running CPU (and OS) supports it
+ */
+bool isaSupported(Isa isa);
+
+/** \brief Gets all supported instruction sets, in increasing order */
+std::vector<Isa> supportedIsas();
+
+/**
+ * \brief Gets the best supported instruction set, capped by the LGMATH_ISA
+ * environment variable if it is set
+ */
+Isa detectIsa();
+
+/** \brief Gets the instruction set the batch kernels currently use */
+Isa activeIsa();
+
+/**
+ * \brief Forces the instruction set of the batch kernels, for all threads;
+ * throws std::invalid_argument if it is not supported.
+ */
+void setIsa(Isa isa);
+
+}  // namespace common
+}  // namespace lgmath
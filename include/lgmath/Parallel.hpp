@@ -0,0 +1,225 @@
+/**
+ * \file Parallel.hpp
+ * \brief Executors and execution policies of the batch functions.
+ * \details The batch functions (see se3/Batch.hpp) take an optional
+ * ExecutionPolicy first argument, which splits their elements into tasks and
+ * runs the tasks on an Executor. Applications that already own a thread pool
+ * implement Executor on top of it; otherwise the default executor is a work
+ * stealing pool with one thread per hardware thread, started on first use.
+ *
+ * The tasks are ranges of whole chunks of 64 elements, so that no two tasks
+ * write to the same cache line of an output, and the kernels process each
+ * element with the same instructions however the elements are split: the
+ * results are bitwise identical on any executor and any number of threads.
+ * With Chunking::DYNAMIC, the size of the tasks follows the concurrency of the
+ * executor, for load balance. With Chunking::DETERMINISTIC, it only depends on
+ * the number of elements and the grain size, so that the tasks themselves are
+ * the same on any executor, e.g. to compare traces across machines.
+ *
+ * libstdc++ implements the C++17 execution policies (<execution>) with TBB,
+ * which every user of this header would then have to link, so the policies
+ * are lgmath types: ExecutionPolicy::sequential() and
+ * ExecutionPolicy::parallel() stand for std::execution::seq and par.
+ *
+ * \author ASRL
+ */
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lgmath {
+namespace common {
+
+/** \brief Runs the tasks of the batch functions */
+class Executor {
+ public:
+  /** \brief Destructor. Default implementation. */
+  virtual ~Executor() = default;
+
+  /**
+   * \brief Calls task(i) for every i in [0, numTasks), possibly concurrently,
+   * and returns once all calls returned. If a call throws, the calls that did
+   * not start yet may be skipped, and one of the exceptions is rethrown.
+   */
+  virtual void run(std::size_t numTasks,
+                   const std::function<void(std::size_t)>& task) = 0;
+
+  /** \brief Number of tasks that may run at the same time */
+  virtual std::size_t concurrency() const = 0;
+};
+
+/** \brief Runs all tasks in order on the calling thread */
+class SerialExecutor : public Executor {
+ public:
+  void run(std::size_t numTasks,
+           const std::function<void(std::size_t)>& task) override;
+
+  std::size_t concurrency() const override { return 1; }
+};
+
+/**
+ * \brief A work stealing thread pool.
+ * \details run() deals the tasks out to the queues of the workers in
+ * contiguous blocks; each worker takes tasks from the front of its own queue,
+ * and steals from the back of the other queues when its own is empty. The
+ * calling thread also steals tasks until all of its tasks are done, so run()
+ * may be called from several threads at once and from within a task.
+ */
+class ThreadPool : public Executor {
+ public:
+  /**
+   * \brief Starts a pool in which numThreads threads, the caller of run()
+   * included, run the tasks; if 0, one per hardware thread
+   */
+  explicit ThreadPool(std::size_t numThreads = 0);
+
+  /** \brief Stops the workers, once no call to run() is in progress */
+  ~ThreadPool() override;
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  void run(std::size_t numTasks,
+           const std::function<void(std::size_t)>& task) override;
+
+  std::size_t concurrency() const override { return queues_.size() + 1; }
+
+ private:
+  /** \brief The tasks of one call to run() */
+  struct Batch {
+    const std::function<void(std::size_t)>* task;
+    std::size_t remaining;
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable done;
+  };
+
+  /** \brief One task */
+  struct Task {
+    Batch* batch;
+    std::size_t index;
+  };
+
+  /** \brief The task queue of one worker */
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  /** \brief Main loop of worker w */
+  void work(std::size_t w);
+
+  /**
+   * \brief Takes a task from the front of queue first, or from the back of
+   * another queue; returns false if all queues are empty
+   */
+  bool take(std::size_t first, Task* task);
+
+  /** \brief Runs a task and marks it done */
+  static void execute(const Task& task);
+
+  /** \brief One queue per worker */
+  std::vector<std::unique_ptr<Queue>> queues_;
+
+  /** \brief The workers */
+  std::vector<std::thread> workers_;
+
+  /** \brief Guards pending_ and stop_ for the sleeping workers */
+  std::mutex wakeMutex_;
+
+  /** \brief Wakes the workers when tasks are queued or the pool stops */
+  std::condition_variable wake_;
+
+  /** \brief Number of queued tasks */
+  std::size_t pending_;
+
+  /** \brief Whether the workers should exit */
+  bool stop_;
+};
+
+/** \brief Gets the executor that runs all tasks on the calling thread */
+Executor& serialExecutor();
+
+/**
+ * \brief Gets the default executor, a ThreadPool with one thread per hardware
+ * thread that is started on first use
+ */
+Executor& defaultExecutor();
+
+/** \brief How the batch functions size their tasks */
+enum class Chunking {
+  /** \brief Sized from the concurrency of the executor, for load balance */
+  DYNAMIC,
+  /**
+   * \brief Sized from the number of elements and the grain size only, for
+   * the same tasks on any executor
+   */
+  DETERMINISTIC,
+};
+
+/** \brief How a batch function splits its elements and runs them */
+class ExecutionPolicy {
+ public:
+  /** \brief Runs on the default executor, with dynamic chunking */
+  ExecutionPolicy();
+
+  /**
+   * \brief Runs on an executor, which must outlive the calls using the
+   * policy
+   * \param[in] executor The executor
+   * \param[in] chunking How to size the tasks
+   * \param[in] grainSize Least number of elements per task, rounded up to a
+   * whole chunk; each batch function has its own default if 0
+   */
+  explicit ExecutionPolicy(Executor& executor,
+                           Chunking chunking = Chunking::DYNAMIC,
+                           std::size_t grainSize = 0);
+
+  /** \brief Runs on the calling thread, as std::execution::seq */
+  static ExecutionPolicy sequential();
+
+  /** \brief Runs on the default executor, as std::execution::par */
+  static ExecutionPolicy parallel();
+
+  /** \brief Gets the executor */
+  Executor& executor() const { return *executor_; }
+
+  /** \brief Gets the chunking */
+  Chunking chunking() const { return chunking_; }
+
+  /** \brief Gets the grain size, 0 for the default of each function */
+  std::size_t grainSize() const { return grainSize_; }
+
+  /**
+   * \brief Calls f(begin, end) on ranges of whole chunks that cover [0, n),
+   * each range a task of the executor
+   * \param[in] n Number of elements
+   * \param[in] defaultGrain Grain size if the policy has none, e.g. the number
+   * of elements that take a few microseconds
+   * \param[in] f The function
+   */
+  void forEachRange(
+      std::size_t n, std::size_t defaultGrain,
+      const std::function<void(std::size_t, std::size_t)>& f) const;
+
+ private:
+  /** \brief The executor, never null */
+  Executor* executor_;
+
+  /** \brief How to size the tasks */
+  Chunking chunking_;
+
+  /** \brief Least number of elements per task, 0 for the default */
+  std::size_t grainSize_;
+};
+
+}  // namespace common
+}  // namespace lgmath
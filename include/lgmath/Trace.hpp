@@ -0,0 +1,143 @@
+/**
+ * \file Trace.hpp
+ * \brief Optional tracing of lgmath batch operations, exported as Chrome
+ * trace JSON.
+ * \details When tracing is enabled, LGMATH_TRACE_SCOPE records the begin and
+ * end time of the enclosing scope into a ring buffer of the calling thread;
+ * writeChromeTrace() exports the buffers of all threads in the Chrome trace
+ * event format, which chrome://tracing and https://ui.perfetto.dev open
+ * locally. Tracing is disabled by default, and a disabled scope costs one
+ * relaxed load and one predictable branch.
+ *
+ * \author ASRL
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include <lgmath/CommonTools.hpp>
+
+namespace lgmath {
+namespace common {
+
+/** \brief A completed scope in a trace */
+struct TraceEvent {
+  /** \brief Name of the scope, a string literal */
+  const char* name;
+
+  /** \brief Begin and end, in TscClock ticks */
+  std::uint64_t begin;
+  std::uint64_t end;
+
+  /** \brief Number of items processed in the scope, 0 if not applicable */
+  std::uint64_t count;
+};
+
+/**
+ * \brief Number of events retained per thread; older events are overwritten.
+ * A thread allocates its ring buffer on its first traced event, and the
+ * buffer of an exited thread is freed by clearTrace().
+ */
+static constexpr std::size_t TRACE_BUFFER_CAPACITY = 1 << 16;
+
+namespace detail {
+
+/** \brief Whether scopes are recorded */
+extern std::atomic<bool> tracingEnabled;
+
+/** \brief Appends an event to the ring buffer of the calling thread */
+void recordTraceEvent(const TraceEvent& event);
+
+}  // namespace detail
+
+/** \brief Returns whether tracing is enabled */
+inline bool tracingEnabled() {
+  return detail::tracingEnabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * \brief Enables or disables tracing. The first enabling sets the origin of
+ * the exported timestamps.
+ */
+void setTracingEnabled(bool enabled);
+
+/** \brief Names the calling thread in the exported trace */
+void setTraceThreadName(const std::string& name);
+
+/**
+ * \brief Discards the recorded events of all threads, and frees the ring
+ * buffers of the exited ones; events recorded concurrently may survive, so
+ * quiesce the traced threads first.
+ */
+void clearTrace();
+
+/** \brief Gets the number of events retained in all ring buffers */
+std::size_t traceEventCount();
+
+/** \brief Gets the memory held by the ring buffers of all threads, in bytes */
+std::size_t traceBufferBytes();
+
+/** \brief Gets the number of events overwritten in all ring buffers */
+std::size_t traceEventsDropped();
+
+/**
+ * \brief Writes the retained events of all threads as Chrome trace JSON.
+ * Events recorded concurrently may be torn, so disable tracing or quiesce
+ * the traced threads first.
+ */
+void writeChromeTrace(std::ostream& out);
+
+/** \brief Writes the Chrome trace JSON to a file; throws if it cannot */
+void writeChromeTrace(const std::string& path);
+
+/** \brief Records the enclosing scope if tracing is enabled, see above */
+class TraceScope {
+ public:
+  /** \brief Constructor, starts the scope if tracing is enabled */
+  explicit TraceScope(const char* name, std::uint64_t count = 0)
+      : name_(nullptr), begin_(0), count_(0) {
+    if (tracingEnabled()) {
+      name_ = name;
+      count_ = count;
+      begin_ = TscClock::now();
+    }
+  }
+
+  /** \brief Destructor, records the scope if it was started */
+  ~TraceScope() {
+    if (name_ != nullptr) {
+      detail::recordTraceEvent({name_, begin_, TscClock::now(), count_});
+    }
+  }
+
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+ private:
+  /** \brief Name of the scope, null if tracing was disabled at its start */
+  const char* name_;
+
+  /** \brief Begin of the scope, in TscClock ticks */
+  std::uint64_t begin_;
+
+  /** \brief Number of items processed in the scope */
+  std::uint64_t count_;
+};
+
+}  // namespace common
+}  // namespace lgmath
+
+#define LGMATH_TRACE_CONCAT_(a, b) a##b
+#define LGMATH_TRACE_CONCAT(a, b) LGMATH_TRACE_CONCAT_(a, b)
+
+/**
+ * \brief Traces the enclosing scope under name (a string literal), with an
+ * optional number of processed items, e.g. LGMATH_TRACE_SCOPE("x", n)
+ */
+#define LGMATH_TRACE_SCOPE(...)                                      \
+  ::lgmath::common::TraceScope LGMATH_TRACE_CONCAT(lgmathTraceScope, \
+                                                   __LINE__)(__VA_ARGS__)
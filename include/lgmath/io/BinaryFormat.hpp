@@ -0,0 +1,206 @@
+/**
+ * \file BinaryFormat.hpp
+ * \brief Header file for the fixed-layout binary encoding of lgmath types.
+ * \details Every record starts with an 8-byte header followed by little-endian
+ * IEEE-754 doubles, so that records can be written back-to-back in a file or
+ * message and read in place (see the view classes) without any copies.
+ *
+ *   header   : [version, type, flags, 0, 0, 0, 0, 0]           (8 bytes)
+ *   rotation : C_ba, 3x3 row-major                             (9 doubles)
+ *   pose     : [C_ba | r_ab_inb], 3x4 row-major                (12 doubles)
+ *   cov      : upper triangle of the 6x6 covariance, row-major (21 doubles)
+ *
+ * The pose block is the same 3x4 row-major layout used by the KITTI odometry
+ * benchmark. Bit 0 of the flags is set when the covariance is set; an unset
+ * covariance is written as zeros so that the record size never changes.
+ *
+ * \author ASRL
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <Eigen/Core>
+
+#include <lgmath/se3/Transformation.hpp>
+#include <lgmath/se3/TransformationWithCovariance.hpp>
+#include <lgmath/so3/Rotation.hpp>
+
+/// Binary input/output of lgmath types
+namespace lgmath {
+namespace io {
+
+/** \brief Version of the record layout written by this library */
+static constexpr std::uint8_t BINARY_FORMAT_VERSION = 1;
+
+/** \brief Type tag stored in the second byte of the record header */
+enum class RecordType : std::uint8_t {
+  ROTATION = 1,
+  TRANSFORMATION = 2,
+  TRANSFORMATION_WITH_COVARIANCE = 3
+};
+
+/** \brief Header flag set when the covariance of the record is set */
+static constexpr std::uint8_t FLAG_COVARIANCE_SET = 0x01;
+
+/** \brief Size of the record header, keeps the payload 8-byte aligned */
+static constexpr std::size_t RECORD_HEADER_SIZE = 8;
+
+/** \brief Number of doubles in the packed upper triangle of a 6x6 covariance */
+static constexpr std::size_t PACKED_COVARIANCE_SIZE = 21;
+
+/** \brief Encoded size of a so3::Rotation */
+static constexpr std::size_t ROTATION_RECORD_SIZE =
+    RECORD_HEADER_SIZE + 9 * sizeof(double);
+
+/** \brief Encoded size of a se3::Transformation */
+static constexpr std::size_t TRANSFORMATION_RECORD_SIZE =
+    RECORD_HEADER_SIZE + 12 * sizeof(double);
+
+/** \brief Encoded size of a se3::TransformationWithCovariance */
+static constexpr std::size_t TRANSFORMATION_WITH_COVARIANCE_RECORD_SIZE =
+    TRANSFORMATION_RECORD_SIZE + PACKED_COVARIANCE_SIZE * sizeof(double);
+
+/** \brief Packs the upper triangle of a 6x6 covariance (row-major) */
+Eigen::Matrix<double, 21, 1> packCovariance(
+    const Eigen::Matrix<double, 6, 6>& covariance);
+
+/** \brief Rebuilds a symmetric 6x6 covariance from its packed upper triangle */
+Eigen::Matrix<double, 6, 6> unpackCovariance(
+    const Eigen::Ref<const Eigen::Matrix<double, 21, 1>>& packed);
+
+/**
+ * \brief Writes C into buffer, which must hold at least ROTATION_RECORD_SIZE
+ * bytes.
+ * \return the number of bytes written
+ */
+std::size_t encode(const so3::Rotation& C, unsigned char* buffer,
+                   std::size_t size);
+
+/**
+ * \brief Writes T into buffer, which must hold at least
+ * TRANSFORMATION_RECORD_SIZE bytes.
+ * \return the number of bytes written
+ */
+std::size_t encode(const se3::Transformation& T, unsigned char* buffer,
+                   std::size_t size);
+
+/**
+ * \brief Writes T into buffer, which must hold at least
+ * TRANSFORMATION_WITH_COVARIANCE_RECORD_SIZE bytes.
+ * \return the number of bytes written
+ */
+std::size_t encode(const se3::TransformationWithCovariance& T,
+                   unsigned char* buffer, std::size_t size);
+
+/** \brief Reads a rotation record, the rotation is not reprojected */
+so3::Rotation decodeRotation(const unsigned char* buffer, std::size_t size);
+
+/**
+ * \brief Reads a transformation (or transformation with covariance) record, the
+ * rotation is not reprojected
+ */
+se3::Transformation decodeTransformation(const unsigned char* buffer,
+                                         std::size_t size);
+
+/**
+ * \brief Reads a transformation with covariance record, the rotation is not
+ * reprojected
+ */
+se3::TransformationWithCovariance decodeTransformationWithCovariance(
+    const unsigned char* buffer, std::size_t size);
+
+/**
+ * \brief Read-only view of an encoded rotation record.
+ * \details The view validates the header on construction and then maps the
+ * payload directly; the buffer must outlive the view. Views require a
+ * little-endian host, and throw std::runtime_error otherwise.
+ */
+class RotationView {
+ public:
+  using MatrixMap =
+      Eigen::Map<const Eigen::Matrix<double, 3, 3, Eigen::RowMajor>>;
+
+  /** \brief Constructor, throws std::invalid_argument on a bad record */
+  RotationView(const unsigned char* buffer, std::size_t size);
+
+  /** \brief Gets the rotation matrix, mapped in place */
+  MatrixMap matrix() const { return MatrixMap(data_); }
+
+  /** \brief Copies the record into a Rotation */
+  so3::Rotation rotation() const;
+
+ private:
+  /** \brief Start of the payload */
+  const double* data_;
+};
+
+/**
+ * \brief Read-only view of an encoded transformation record.
+ * \details Also accepts transformation with covariance records, in which case
+ * the covariance block is ignored.
+ */
+class TransformationView {
+ public:
+  using Matrix34Map =
+      Eigen::Map<const Eigen::Matrix<double, 3, 4, Eigen::RowMajor>>;
+  using RotationMap =
+      Eigen::Map<const Eigen::Matrix<double, 3, 3, Eigen::RowMajor>,
+                 Eigen::Unaligned, Eigen::OuterStride<4>>;
+  using TranslationMap = Eigen::Map<const Eigen::Vector3d, Eigen::Unaligned,
+                                    Eigen::InnerStride<4>>;
+
+  /** \brief Constructor, throws std::invalid_argument on a bad record */
+  TransformationView(const unsigned char* buffer, std::size_t size);
+
+  /** \brief Gets the top 3x4 block of the transformation matrix, in place */
+  Matrix34Map matrix34() const { return Matrix34Map(data_); }
+
+  /** \brief Gets the rotation matrix, mapped in place */
+  RotationMap C_ba() const { return RotationMap(data_); }
+
+  /** \brief Gets the r_ab_inb vector, mapped in place */
+  TranslationMap r_ab_inb() const { return TranslationMap(data_ + 3); }
+
+  /** \brief Gets basic matrix representation of the transformation */
+  Eigen::Matrix4d matrix() const;
+
+  /** \brief Copies the record into a Transformation */
+  se3::Transformation transformation() const;
+
+ protected:
+  /** \brief Start of the payload */
+  const double* data_;
+};
+
+/** \brief Read-only view of an encoded transformation with covariance record */
+class TransformationWithCovarianceView : public TransformationView {
+ public:
+  using PackedCovarianceMap = Eigen::Map<const Eigen::Matrix<double, 21, 1>>;
+
+  /** \brief Constructor, throws std::invalid_argument on a bad record */
+  TransformationWithCovarianceView(const unsigned char* buffer,
+                                   std::size_t size);
+
+  /** \brief Returns whether or not a covariance was set when encoding */
+  bool covarianceSet() const { return covarianceSet_; }
+
+  /** \brief Gets the packed upper triangle of the covariance, in place */
+  PackedCovarianceMap packedCov() const {
+    return PackedCovarianceMap(data_ + 12);
+  }
+
+  /** \brief Unpacks the covariance, throws if it was not set */
+  Eigen::Matrix<double, 6, 6> cov() const;
+
+  /** \brief Copies the record into a TransformationWithCovariance */
+  se3::TransformationWithCovariance transformationWithCovariance() const;
+
+ private:
+  /** \brief Covariance flag */
+  bool covarianceSet_;
+};
+
+}  // namespace io
+}  // namespace lgmath
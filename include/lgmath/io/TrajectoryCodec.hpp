@@ -0,0 +1,273 @@
+/**
+ * \file TrajectoryCodec.hpp
+ * \brief Header file for a lossy, Lie-algebra delta codec for trajectories.
+ * \details Each pose T_k is stored as the increment from the previously
+ * reconstructed pose, xi_k = ln(T_k * T_{k-1}^{-1}), quantized component-wise
+ * with a step of twice the requested tolerance. Because the increment is taken
+ * from the reconstructed (not the original) previous pose, quantization error
+ * does not accumulate along the trajectory. The quantized increments are
+ * predicted from the previous increment (constant velocity) and the residuals
+ * are entropy coded with adaptive Rice codes.
+ *
+ * Poses are grouped in blocks that start with an exact keyframe (a
+ * transformation record in the lgmath binary format), so that a block can be
+ * decoded on its own; this bounds the effect of any floating-point differences
+ * between encoder and decoder and allows random access.
+ *
+ *   stream : header, block, block, ...
+ *   header : "LGMCODEC", version, 0, 0, 0, keyframe interval (uint32),
+ *            translation tolerance (double), rotation tolerance (double)
+ *   block  : payload bytes (uint32), pose count (uint32),
+ *            keyframe record, Rice-coded residuals (byte aligned)
+ *
+ * \author ASRL
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <lgmath/se3/Transformation.hpp>
+
+namespace lgmath {
+namespace io {
+
+/** \brief Version of the compressed trajectory layout */
+static constexpr std::uint8_t TRAJECTORY_CODEC_VERSION = 1;
+
+/** \brief Size of the compressed trajectory stream header */
+static constexpr std::size_t TRAJECTORY_CODEC_HEADER_SIZE = 32;
+
+/**
+ * \brief Parameters of the trajectory codec.
+ * \details The tolerances bound each component of the quantized increment
+ * xi_k. The resulting pose error, ln(T_reconstructed * T^{-1}), is the
+ * increment error mapped through the left Jacobian of xi_k, so it is at most
+ * sqrt(3) times the tolerance for the small increments of a densely sampled
+ * trajectory, and grows by roughly a factor 1 + |xi_k| / 2 for large jumps.
+ */
+struct TrajectoryCodecOptions {
+  /** \brief Maximum error of each translational component of the increment */
+  double translationTolerance = 1e-4;
+
+  /** \brief Maximum error of each rotational component of the increment */
+  double rotationTolerance = 1e-5;
+
+  /** \brief Number of poses per block, each block starts with a keyframe */
+  std::uint32_t keyframeInterval = 100;
+};
+
+/**
+ * \brief Compression ratio and reconstruction error of an encoded trajectory.
+ * \details Errors are measured as the translational and rotational parts of
+ * ln(T_reconstructed * T^{-1}).
+ */
+struct TrajectoryCodecStats {
+  /** \brief Number of poses encoded */
+  std::size_t poses = 0;
+
+  /** \brief Size of the poses as 3x4 double matrices */
+  std::size_t rawBytes = 0;
+
+  /** \brief Size of the compressed stream, including headers */
+  std::size_t compressedBytes = 0;
+
+  /** \brief Largest translational error norm */
+  double maxTranslationError = 0.0;
+
+  /** \brief Largest rotational error norm */
+  double maxRotationError = 0.0;
+
+  /** \brief Sum of the squared translational error norms */
+  double sumSqTranslationError = 0.0;
+
+  /** \brief Sum of the squared rotational error norms */
+  double sumSqRotationError = 0.0;
+
+  /** \brief Gets rawBytes / compressedBytes */
+  double compressionRatio() const;
+
+  /** \brief Gets the root-mean-square translational error */
+  double rmsTranslationError() const;
+
+  /** \brief Gets the root-mean-square rotational error */
+  double rmsRotationError() const;
+};
+
+namespace detail {
+
+/** \brief Adaptive Rice coder state of the six increment components */
+struct RiceState {
+  std::array<std::uint64_t, 6> sum;
+  std::uint64_t count;
+};
+
+/** \brief Decoding state within one block of a compressed trajectory */
+struct BlockCursor {
+  /** \brief Rice-coded residuals of the block */
+  const unsigned char* data;
+  std::size_t size;
+
+  /** \brief Next bit to read */
+  std::size_t bit;
+
+  /** \brief Poses in the block, and poses decoded so far */
+  std::uint32_t poses;
+  std::uint32_t decoded;
+
+  /** \brief Previous quantized increment, used as the prediction */
+  std::array<std::int64_t, 6> prevQ;
+
+  RiceState rice;
+
+  /** \brief Last decoded pose */
+  se3::Transformation T;
+};
+
+}  // namespace detail
+
+/**
+ * \brief Streaming trajectory encoder.
+ * \details Poses are written to the output stream one block at a time, so the
+ * memory use is bounded by the keyframe interval.
+ */
+class TrajectoryEncoder {
+ public:
+  /** \brief Constructor, writes the stream header */
+  explicit TrajectoryEncoder(
+      std::ostream& out,
+      const TrajectoryCodecOptions& options = TrajectoryCodecOptions());
+
+  /** \brief Destructor, finishes the stream if finish() was not called */
+  ~TrajectoryEncoder();
+
+  TrajectoryEncoder(const TrajectoryEncoder&) = delete;
+  TrajectoryEncoder& operator=(const TrajectoryEncoder&) = delete;
+
+  /** \brief Encodes the next pose */
+  void push(const se3::Transformation& T);
+
+  /** \brief Writes out the last (partial) block, no poses may follow */
+  void finish();
+
+  /** \brief Gets the compression ratio and reconstruction error so far */
+  const TrajectoryCodecStats& stats() const { return stats_; }
+
+ private:
+  /** \brief Writes the current block to the output stream */
+  void flushBlock();
+
+  /** \brief Output stream */
+  std::ostream& out_;
+
+  /** \brief Codec parameters */
+  TrajectoryCodecOptions options_;
+
+  /** \brief Quantization steps of the six increment components */
+  Eigen::Matrix<double, 6, 1> steps_;
+
+  /** \brief Bytes of the current block */
+  std::vector<unsigned char> block_;
+
+  /** \brief Pending bits of the current block */
+  std::uint64_t bits_;
+
+  /** \brief Number of pending bits */
+  unsigned int numBits_;
+
+  /** \brief Number of poses in the current block */
+  std::uint32_t blockPoses_;
+
+  /** \brief Previous quantized increment, used as the prediction */
+  std::array<std::int64_t, 6> prevQ_;
+
+  /** \brief Entropy coder state */
+  detail::RiceState rice_;
+
+  /** \brief Previous pose, as the decoder will reconstruct it */
+  se3::Transformation T_prev_;
+
+  /** \brief Whether finish() has been called */
+  bool finished_;
+
+  /** \brief Compression statistics */
+  TrajectoryCodecStats stats_;
+};
+
+/** \brief Streaming trajectory decoder */
+class TrajectoryDecoder {
+ public:
+  /** \brief Constructor, reads the stream header */
+  explicit TrajectoryDecoder(std::istream& in);
+
+  /** \brief Gets the codec parameters the stream was written with */
+  const TrajectoryCodecOptions& options() const { return options_; }
+
+  /**
+   * \brief Decodes the next pose.
+   * \return false once the end of the stream is reached
+   */
+  bool next(se3::Transformation* T);
+
+ private:
+  /** \brief Input stream */
+  std::istream& in_;
+
+  /** \brief Codec parameters */
+  TrajectoryCodecOptions options_;
+
+  /** \brief Quantization steps of the six increment components */
+  Eigen::Matrix<double, 6, 1> steps_;
+
+  /** \brief Bytes of the current block */
+  std::vector<unsigned char> block_;
+
+  /** \brief Decoding state of the current block */
+  detail::BlockCursor cursor_;
+};
+
+/**
+ * \brief Random access to an encoded trajectory held in memory.
+ * \details Indexes the blocks on construction; a pose is then decoded from
+ * the keyframe that starts its block, so at most keyframeInterval - 1
+ * increments are integrated per lookup. The buffer must outlive this object.
+ */
+class CompressedTrajectory {
+ public:
+  /** \brief Constructor, throws std::invalid_argument on a bad stream */
+  CompressedTrajectory(const unsigned char* data, std::size_t size);
+
+  /** \brief Gets the codec parameters the stream was written with */
+  const TrajectoryCodecOptions& options() const { return options_; }
+
+  /** \brief Gets the number of poses */
+  std::size_t size() const { return size_; }
+
+  /** \brief Decodes pose i, throws std::out_of_range if i >= size() */
+  se3::Transformation at(std::size_t i) const;
+
+ private:
+  /** \brief Start of the stream */
+  const unsigned char* data_;
+
+  /** \brief Codec parameters */
+  TrajectoryCodecOptions options_;
+
+  /** \brief Quantization steps of the six increment components */
+  Eigen::Matrix<double, 6, 1> steps_;
+
+  /** \brief Byte offset of each block */
+  std::vector<std::size_t> blocks_;
+
+  /** \brief Number of poses */
+  std::size_t size_;
+};
+
+}  // namespace io
+}  // namespace lgmath
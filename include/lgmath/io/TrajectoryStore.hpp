@@ -0,0 +1,261 @@
+/**
+ * \file TrajectoryStore.hpp
+ * \brief Header file for an append-only, memory-mapped trajectory file.
+ * \details A trajectory file is a 64-byte header followed by fixed-size
+ * records, each an int64 timestamp and a transformation with covariance record
+ * in the lgmath binary format (see BinaryFormat.hpp). Timestamps must be
+ * strictly increasing, so a record is found by binary search in O(log n), and
+ * the file is mapped rather than read, so only the pages that are touched are
+ * ever loaded.
+ *
+ * One TrajectoryWriter may append to a file while any number of
+ * TrajectoryReaders (in the same or other processes) read it; the writer
+ * publishes the record count only after the record itself is written, and
+ * readers pick up new records with refresh().
+ *
+ * \author ASRL
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+
+#include <lgmath/io/BinaryFormat.hpp>
+#include <lgmath/se3/Transformation.hpp>
+#include <lgmath/se3/TransformationWithCovariance.hpp>
+
+namespace lgmath {
+namespace io {
+
+/** \brief Version of the trajectory file layout written by this library */
+static constexpr std::uint32_t TRAJECTORY_FORMAT_VERSION = 1;
+
+/** \brief Size of the trajectory file header */
+static constexpr std::size_t TRAJECTORY_HEADER_SIZE = 64;
+
+/** \brief Size of one trajectory record: a timestamp and a pose record */
+static constexpr std::size_t TRAJECTORY_RECORD_SIZE =
+    sizeof(std::int64_t) + TRANSFORMATION_WITH_COVARIANCE_RECORD_SIZE;
+
+/**
+ * \brief Appends timestamped poses to a trajectory file.
+ * \details Creates the file if it does not exist, otherwise continues
+ * appending after its last record. Only one writer may hold a file at a time;
+ * a second writer throws std::runtime_error.
+ */
+class TrajectoryWriter {
+ public:
+  /**
+   * \brief Constructor.
+   * \param[in] path Path of the trajectory file
+   * \param[in] reserve Number of records to preallocate space for
+   */
+  explicit TrajectoryWriter(const std::string& path, std::size_t reserve = 0);
+
+  /** \brief Destructor, trims the preallocated space and closes the file */
+  ~TrajectoryWriter();
+
+  TrajectoryWriter(const TrajectoryWriter&) = delete;
+  TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+
+  /**
+   * \brief Appends a pose, throws std::invalid_argument if timestamp is not
+   * strictly greater than the last one in the file.
+   */
+  void append(std::int64_t timestamp,
+              const se3::TransformationWithCovariance& T);
+
+  /** \brief Appends a pose without covariance */
+  void append(std::int64_t timestamp, const se3::Transformation& T);
+
+  /** \brief Gets the number of records in the file */
+  std::size_t size() const { return count_; }
+
+  /** \brief Flushes the written records to disk */
+  void flush();
+
+ private:
+  /** \brief Grows the file and the mapping to hold at least count records */
+  void reserve(std::size_t count);
+
+  /** \brief Path of the file, for error messages */
+  std::string path_;
+
+  /** \brief File descriptor */
+  int fd_;
+
+  /** \brief Start of the mapping */
+  unsigned char* data_;
+
+  /** \brief Length of the mapping (and of the file) in bytes */
+  std::size_t mapped_;
+
+  /** \brief Number of records written */
+  std::size_t count_;
+
+  /** \brief Timestamp of the last record */
+  std::int64_t lastTimestamp_;
+};
+
+/**
+ * \brief Reads a trajectory file in place.
+ * \details Records are returned as views into the mapping, without copies or
+ * allocation. Views and iterators stay valid until the next call to refresh()
+ * that picks up new records, or until the reader is destroyed.
+ */
+class TrajectoryReader {
+ public:
+  /** \brief A timestamped pose, viewed in place */
+  struct Record {
+    std::int64_t timestamp;
+    TransformationWithCovarianceView pose;
+  };
+
+  /** \brief Random access iterator over the records */
+  class const_iterator {
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = Record;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = Record;
+
+    const_iterator() : reader_(nullptr), index_(0) {}
+    const_iterator(const TrajectoryReader* reader, std::size_t index)
+        : reader_(reader), index_(index) {}
+
+    Record operator*() const { return (*reader_)[index_]; }
+    Record operator[](difference_type n) const { return *(*this + n); }
+
+    /** \brief Gets the index of the record in the file */
+    std::size_t index() const { return index_; }
+
+    const_iterator& operator++() {
+      ++index_;
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator temp(*this);
+      ++index_;
+      return temp;
+    }
+    const_iterator& operator--() {
+      --index_;
+      return *this;
+    }
+    const_iterator operator--(int) {
+      const_iterator temp(*this);
+      --index_;
+      return temp;
+    }
+    const_iterator& operator+=(difference_type n) {
+      index_ += n;
+      return *this;
+    }
+    const_iterator& operator-=(difference_type n) {
+      index_ -= n;
+      return *this;
+    }
+    const_iterator operator+(difference_type n) const {
+      return const_iterator(reader_, index_ + n);
+    }
+    const_iterator operator-(difference_type n) const {
+      return const_iterator(reader_, index_ - n);
+    }
+    difference_type operator-(const const_iterator& other) const {
+      return difference_type(index_) - difference_type(other.index_);
+    }
+
+    bool operator==(const const_iterator& other) const {
+      return index_ == other.index_;
+    }
+    bool operator!=(const const_iterator& other) const {
+      return index_ != other.index_;
+    }
+    bool operator<(const const_iterator& other) const {
+      return index_ < other.index_;
+    }
+    bool operator>(const const_iterator& other) const {
+      return index_ > other.index_;
+    }
+    bool operator<=(const const_iterator& other) const {
+      return index_ <= other.index_;
+    }
+    bool operator>=(const const_iterator& other) const {
+      return index_ >= other.index_;
+    }
+
+   private:
+    const TrajectoryReader* reader_;
+    std::size_t index_;
+  };
+
+  /** \brief Constructor, throws std::runtime_error if the file is invalid */
+  explicit TrajectoryReader(const std::string& path);
+
+  /** \brief Destructor, unmaps and closes the file */
+  ~TrajectoryReader();
+
+  TrajectoryReader(const TrajectoryReader&) = delete;
+  TrajectoryReader& operator=(const TrajectoryReader&) = delete;
+
+  /**
+   * \brief Picks up the records appended since construction or the last
+   * refresh, remapping the file if it grew.
+   * \return the number of records now visible
+   */
+  std::size_t refresh();
+
+  /** \brief Gets the number of visible records */
+  std::size_t size() const { return count_; }
+
+  /** \brief Returns whether there are no visible records */
+  bool empty() const { return count_ == 0; }
+
+  /** \brief Gets the timestamp of record i, unchecked */
+  std::int64_t timestamp(std::size_t i) const;
+
+  /** \brief Gets record i, unchecked */
+  Record operator[](std::size_t i) const;
+
+  /** \brief Gets record i, throws std::out_of_range if i >= size() */
+  Record at(std::size_t i) const;
+
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, count_); }
+
+  /** \brief Finds the first record with a timestamp not less than t */
+  const_iterator lowerBound(std::int64_t t) const;
+
+  /** \brief Finds the record with timestamp t, or end() if there is none */
+  const_iterator find(std::int64_t t) const;
+
+ private:
+  /** \brief Maps length bytes of the file, replacing any previous mapping */
+  void map(std::size_t length);
+
+  /** \brief Gets the start of record i */
+  const unsigned char* record(std::size_t i) const {
+    return data_ + TRAJECTORY_HEADER_SIZE + i * TRAJECTORY_RECORD_SIZE;
+  }
+
+  /** \brief Path of the file, for error messages */
+  std::string path_;
+
+  /** \brief File descriptor */
+  int fd_;
+
+  /** \brief Start of the mapping */
+  const unsigned char* data_;
+
+  /** \brief Length of the mapping in bytes */
+  std::size_t mapped_;
+
+  /** \brief Number of visible records */
+  std::size_t count_;
+};
+
+}  // namespace io
+}  // namespace lgmath
@@ -0,0 +1,322 @@
+/**
+ * \file Batch.hpp
+ * \brief Header file for the SE3 batch kernels.
+ * \details These functions apply the exponential and logarithmic maps, point
+ * transforms, covariance propagation, composition, inversion, relative poses,
+ * interpolation and products with the adjoint and the se3 Jacobians to many
+ * elements at once (see also se3::PoseArray). The elements are stored
+ * as a structure of arrays: row k of element i is at data[k * stride + i],
+ * where the stride (the number of elements, by default) is common to all
+ * arguments, except for the gathered poses of relativePosesBatch. The rows of
+ * each kind of element are
+ *
+ *  - xi:   6 rows, the se3 algebra vector (rho, aaxis), as in se3::vec2tran;
+ *          other 6-vectors (v) use the same layout;
+ *  - T:    12 rows, the 3x4 pose [C_ba | r] in row-major order, i.e. the top
+ *          rows of Transformation::matrix();
+ *  - p:    3 rows, the x, y and z of a point;
+ *  - cov:  21 rows, the upper triangle of a 6x6 covariance in row-major
+ *          order, as in io::packCovariance.
+ *
+ * The kernels are compiled for several instruction sets, and the best one the
+ * CPU supports is used (see Dispatch.hpp). Outputs may alias their inputs of
+ * the same kind, but must not partially overlap them.
+ *
+ * Each function has an overload taking a common::ExecutionPolicy first, which
+ * splits the elements into tasks for an executor (see Parallel.hpp). Without
+ * a policy, the functions run on the calling thread, except
+ * relativePosesBatch, which splits large pair lists on the default executor.
+ *
+ * \author ASRL
+ */
+#pragma once
+
+#include <cstddef>
+
+#include <lgmath/se3/Transformation.hpp>
+
+namespace lgmath {
+namespace common {
+class ExecutionPolicy;
+}  // namespace common
+
+namespace se3 {
+
+/** \brief Number of rows of a pose in the batch layout */
+static constexpr std::size_t BATCH_POSE_ROWS = 12;
+
+/** \brief Number of rows of a packed covariance in the batch layout */
+static constexpr std::size_t BATCH_COVARIANCE_ROWS = 21;
+
+/**
+ * \brief Builds n transformations from se3 algebra vectors (exponential map)
+ * \param[in] xi The algebra vectors, 6 rows
+ * \param[out] T The transformations, 12 rows
+ * \param[in] n Number of elements
+ * \param[in] stride Distance between rows, n if 0
+ */
+void vec2tranBatch(const double* xi, double* T, std::size_t n,
+                   std::size_t stride = 0);
+
+/** \brief vec2tranBatch, with the elements split by a policy */
+void vec2tranBatch(const common::ExecutionPolicy& policy, const double* xi,
+                   double* T, std::size_t n, std::size_t stride = 0);
+
+/**
+ * \brief Computes the se3 algebra vectors of n transformations (logarithmic
+ * map)
+ * \param[in] T The transformations, 12 rows
+ * \param[out] xi The algebra vectors, 6 rows
+ * \param[in] n Number of elements
+ * \param[in] stride Distance between rows, n if 0
+ */
+void tran2vecBatch(const double* T, double* xi, std::size_t n,
+                   std::size_t stride = 0);
+
+/** \brief tran2vecBatch, with the elements split by a policy */
+void tran2vecBatch(const common::ExecutionPolicy& policy, const double* T,
+                   double* xi, std::size_t n, std::size_t stride = 0);
+
+/**
+ * \brief Transforms n points by one transformation, p_b = T_ba * p_a
+ * \param[in] T_ba The transformation
+ * \param[in] p_a The points, 3 rows
+ * \param[out] p_b The transformed points, 3 rows
+ * \param[in] n Number of elements
+ * \param[in] stride Distance between rows, n if 0
+ */
+void transformPointsBatch(const Transformation& T_ba, const double* p_a,
+                          double* p_b, std::size_t n, std::size_t stride = 0);
+
+/** \brief transformPointsBatch, with the elements split by a policy */
+void transformPointsBatch(const common::ExecutionPolicy& policy,
+                          const Transformation& T_ba, const double* p_a,
+                          double* p_b, std::size_t n, std::size_t stride = 0);
+
+/**
+ * \brief Transforms n points each by its own transformation,
+ * p_b_i = T_i * p_a_i
+ * \param[in] T The transformations, 12 rows
+ * \param[in] p_a The points, 3 rows
+ * \param[out] p_b The transformed points, 3 rows
+ * \param[in] n Number of elements
+ * \param[in] stride Distance between rows, n if 0
+ */
+void transformPointsBatch(const double* T, const double* p_a, double* p_b,
+                          std::size_t n, std::size_t stride = 0);
+
+/** \brief transformPointsBatch, with the elements split by a policy */
+void transformPointsBatch(const common::ExecutionPolicy& policy,
+                          const double* T, const double* p_a, double* p_b,
+                          std::size_t n, std::size_t stride = 0);
+
+/**
+ * \brief Propagates n covariances through their transformations,
+ * out_i = Ad(T_i) * cov_i * Ad(T_i)^T
+ * \param[in] T The transformations, 12 rows
+ * \param[in] cov The packed covariances, 21 rows
+ * \param[out] out The packed propagated covariances, 21 rows
+ * \param[in] n Number of elements
+ * \param[in] stride Distance between rows, n if 0
+ */
+void propagateCovarianceBatch(const double* T, const double* cov, double* out,
+                              std::size_t n, std::size_t stride = 0);
+
+/** \brief propagateCovarianceBatch, with the elements split by a policy */
+void propagateCovarianceBatch(const common::ExecutionPolicy& policy,
+                              const double* T, const double* cov, double* out,
+                              std::size_t n, std::size_t stride = 0);
+
+/**
+ * \brief Composes n pairs of transformations, out_i = lhs_i * rhs_i, as
+ * Transformation::operator* does but without reprojecting the results
+ * \param[in] lhs The left-hand transformations, 12 rows
+ * \param[in] rhs The right-hand transformations, 12 rows
+ * \param[out] out The compositions, 12 rows
+ * \param[in] n Number of elements
+ * \param[in] stride Distance between rows, n if 0
+ */
+void composeBatch(const double* lhs, const double* rhs, double* out,
+                  std::size_t n, std::size_t stride = 0);
+
+/** \brief composeBatch, with the elements split by a policy */
+void composeBatch(const common::ExecutionPolicy& policy, const double* lhs,
+                  const double* rhs, double* out, std::size_t n,
+                  std::size_t stride = 0);
+
+/**
+ * \brief Inverts n transformations, out_i = T_i^-1, as in
+ * Transformation::inverse
+ * \param[in] T The transformations, 12 rows
+ * \param[out] out The inverse transformations, 12 rows
+ * \param[in] n Number of elements
+ * \param[in] stride Distance between rows, n if 0
+ */
+void inverseBatch(const double* T, double* out, std::size_t n,
+                  std::size_t stride = 0);
+
+/** \brief inverseBatch, with the elements split by a policy */
+void inverseBatch(const common::ExecutionPolicy& policy, const double* T,
+                  double* out, std::size_t n, std::size_t stride = 0);
+
+/**
+ * \brief Inverts n transformations and their covariances, as in
+ * TransformationWithCovariance::inverse
+ * \param[in] T The transformations, 12 rows
+ * \param[in] cov The packed covariances, 21 rows
+ * \param[out] out The inverse transformations, 12 rows
+ * \param[out] outCov The packed covariances of the inverses,
+ * Ad(T_i^-1) * cov_i * Ad(T_i^-1)^T, 21 rows
+ * \param[in] n Number of elements
+ * \param[in] stride Distance between rows, n if 0
+ */
+void inverseBatch(const double* T, const double* cov, double* out,
+                  double* outCov, std::size_t n, std::size_t stride = 0);
+
+/** \brief inverseBatch, with the elements split by a policy */
+void inverseBatch(const common::ExecutionPolicy& policy, const double* T,
+                  const double* cov, double* out, double* outCov, std::size_t n,
+                  std::size_t stride = 0);
+
+/**
+ * \brief Computes the relative poses out_k = T_i * T_j^-1 of m index pairs
+ * (i, j), as Transformation::operator/ does but without reprojecting the
+ * results. Large pair lists are split on the default executor.
+ * \param[in] T The transformations, 12 rows with a stride of numPoses
+ * \param[in] numPoses Number of transformations
+ * \param[in] pairs The indices i (row 0) and j (row 1) of each pair
+ * \param[out] out The relative poses, 12 rows; must not overlap T
+ * \param[in] m Number of pairs
+ * \param[in] stride Distance between the rows of pairs and out, m if 0
+ * \throws std::invalid_argument If an index is not less than numPoses
+ */
+void relativePosesBatch(const double* T, std::size_t numPoses,
+                        const std::size_t* pairs, double* out, std::size_t m,
+                        std::size_t stride = 0);
+
+/** \brief relativePosesBatch, with the elements split by a policy */
+void relativePosesBatch(const common::ExecutionPolicy& policy, const double* T,
+                        std::size_t numPoses, const std::size_t* pairs,
+                        double* out, std::size_t m, std::size_t stride = 0);
+
+/**
+ * \brief Computes the relative poses of m index pairs and their covariances,
+ * as TransformationWithCovariance::operator/ does (without reprojection):
+ * outCov_k = cov_i + Ad(out_k) * cov_j * Ad(out_k)^T
+ * \param[in] T The transformations, 12 rows with a stride of numPoses
+ * \param[in] cov The packed covariances, 21 rows with a stride of numPoses
+ * \param[in] numPoses Number of transformations
+ * \param[in] pairs The indices i (row 0) and j (row 1) of each pair
+ * \param[out] out The relative poses, 12 rows; must not overlap T
+ * \param[out] outCov Their packed covariances, 21 rows; must not overlap cov
+ * \param[in] m Number of pairs
+ * \param[in] stride Distance between the rows of pairs, out and outCov, m if
+ * 0
+ * \throws std::invalid_argument If an index is not less than numPoses
+ */
+void relativePosesBatch(const double* T, const double* cov,
+                        std::size_t numPoses, const std::size_t* pairs,
+                        double* out, double* outCov, std::size_t m,
+                        std::size_t stride = 0);
+
+/** \brief relativePosesBatch, with the elements split by a policy */
+void relativePosesBatch(const common::ExecutionPolicy& policy, const double* T,
+                        const double* cov, std::size_t numPoses,
+                        const std::size_t* pairs, double* out, double* outCov,
+                        std::size_t m, std::size_t stride = 0);
+
+/**
+ * \brief Computes out_i = vec2jac(xi_i) * v_i for n elements, without forming
+ * the matrices (see se3::applyJac)
+ * \param[in] xi The algebra vectors, 6 rows
+ * \param[in] v The vectors to multiply, 6 rows
+ * \param[out] out The products, 6 rows
+ * \param[in] n Number of elements
+ * \param[in] stride Distance between rows, n if 0
+ */
+void applyJacBatch(const double* xi, const double* v, double* out,
+                   std::size_t n, std::size_t stride = 0);
+
+/** \brief applyJacBatch, with the elements split by a policy */
+void applyJacBatch(const common::ExecutionPolicy& policy, const double* xi,
+                   const double* v, double* out, std::size_t n,
+                   std::size_t stride = 0);
+
+/**
+ * \brief Computes out_i = vec2jac(xi_i)^T * v_i for n elements (see
+ * se3::applyJacTranspose); the arguments are as in applyJacBatch
+ */
+void applyJacTransposeBatch(const double* xi, const double* v, double* out,
+                            std::size_t n, std::size_t stride = 0);
+
+/** \brief applyJacTransposeBatch, with the elements split by a policy */
+void applyJacTransposeBatch(const common::ExecutionPolicy& policy,
+                            const double* xi, const double* v, double* out,
+                            std::size_t n, std::size_t stride = 0);
+
+/**
+ * \brief Computes out_i = vec2jacinv(xi_i) * v_i for n elements (see
+ * se3::applyJacInv); the arguments are as in applyJacBatch
+ */
+void applyJacInvBatch(const double* xi, const double* v, double* out,
+                      std::size_t n, std::size_t stride = 0);
+
+/** \brief applyJacInvBatch, with the elements split by a policy */
+void applyJacInvBatch(const common::ExecutionPolicy& policy, const double* xi,
+                      const double* v, double* out, std::size_t n,
+                      std::size_t stride = 0);
+
+/**
+ * \brief Computes out_i = Ad(T_i) * v_i for n elements, without forming the
+ * adjoint matrices
+ * \param[in] T The transformations, 12 rows
+ * \param[in] v The vectors to multiply, 6 rows
+ * \param[out] out The products, 6 rows
+ * \param[in] n Number of elements
+ * \param[in] stride Distance between rows, n if 0
+ */
+void applyAdjointBatch(const double* T, const double* v, double* out,
+                       std::size_t n, std::size_t stride = 0);
+
+/** \brief applyAdjointBatch, with the elements split by a policy */
+void applyAdjointBatch(const common::ExecutionPolicy& policy, const double* T,
+                       const double* v, double* out, std::size_t n,
+                       std::size_t stride = 0);
+
+/**
+ * \brief Computes out_i = curlyhat(xi_i) * v_i for n elements (see
+ * se3::applyCurlyhat); the arguments are as in applyJacBatch
+ */
+void applyCurlyhatBatch(const double* xi, const double* v, double* out,
+                        std::size_t n, std::size_t stride = 0);
+
+/** \brief applyCurlyhatBatch, with the elements split by a policy */
+void applyCurlyhatBatch(const common::ExecutionPolicy& policy, const double* xi,
+                        const double* v, double* out, std::size_t n,
+                        std::size_t stride = 0);
+
+/**
+ * \brief Interpolates one pair of transformations at n parameters,
+ * T_k = T_0 * exp(alpha_k * log(T_0^-1 * T_1)), as se3::interpolate does but
+ * without reprojecting the results. The logarithm is computed once, and each
+ * T_k costs one sine and one cosine.
+ * \param[in] T_0 The transformation at alpha = 0
+ * \param[in] T_1 The transformation at alpha = 1
+ * \param[in] alpha The interpolation parameters, 1 row; extrapolates outside
+ * [0, 1]
+ * \param[out] T The interpolated transformations, 12 rows
+ * \param[in] n Number of elements
+ * \param[in] stride Distance between rows, n if 0
+ */
+void interpolateBatch(const Transformation& T_0, const Transformation& T_1,
+                      const double* alpha, double* T, std::size_t n,
+                      std::size_t stride = 0);
+
+/** \brief interpolateBatch, with the elements split by a policy */
+void interpolateBatch(const common::ExecutionPolicy& policy,
+                      const Transformation& T_0, const Transformation& T_1,
+                      const double* alpha, double* T, std::size_t n,
+                      std::size_t stride = 0);
+
+}  // namespace se3
+}  // namespace lgmath
@@ -0,0 +1,163 @@
+/**
+ * \file CachedTransformation.hpp
+ * \brief Header file for a transformation class that caches its log map and
+ * adjoint.
+ * \details The Lie algebra vector and the 6x6 adjoint are computed on first
+ * use and kept until the transformation is modified, for callers such as
+ * pose-graph edges that query them repeatedly on an unchanged pose. The cache
+ * makes the class several times larger and every modification clears it, so
+ * only use this class if the same transformation is queried more than once
+ * between modifications.
+ *
+ vec() and adjoint() hide the non-virtual methods of Transformation rather
+ * than override them, as they return the cached entries by reference, so a
+ * CachedTransformation used through a Transformation reference (e.g. a const
+ * Transformation& argument) computes them every time. The methods that modify
+ * the transformation, reproject() and the operators *=, /= and =, are
+ * virtual and always clear the cache.
+ *
+ * Const methods may be called concurrently from several threads: the first
+ * reader claims and fills an entry, readers that arrive meanwhile wait for it,
+ * and later readers see it through a single acquire load, without locking. As
+ * for the Eigen and standard containers, modifying a transformation while it
+ * is being read is a data race.
+ *
+ * \author ASRL
+ */
+#pragma once
+
+#include <atomic>
+
+#include <Eigen/Core>
+
+#include <lgmath/se3/Transformation.hpp>
+
+namespace lgmath {
+namespace se3 {
+
+class CachedTransformation : public Transformation {
+ public:
+  /**
+   * \brief The cached Lie algebra vector, unaligned as Matrix34d, so that the
+   * layout does not depend on the instruction set flags
+   */
+  typedef Eigen::Matrix<double, 6, 1, Eigen::DontAlign> Vector6d;
+
+  /** \brief The cached adjoint, unaligned as Vector6d */
+  typedef Eigen::Matrix<double, 6, 6, Eigen::DontAlign> Matrix6d;
+
+  /** \brief Default constructor */
+  CachedTransformation();
+
+  /** \brief Copy constructor, copies the filled cache entries */
+  CachedTransformation(const CachedTransformation& T);
+
+  /** \brief Move constructor, copies the filled cache entries */
+  CachedTransformation(CachedTransformation&& T) noexcept;
+
+  /** \brief Copy constructor from basic Transformation */
+  CachedTransformation(const Transformation& T);
+
+  /** \brief Move constructor from basic Transformation */
+  CachedTransformation(Transformation&& T);
+
+  /** \brief Constructor */
+  explicit CachedTransformation(const Eigen::Matrix4d& T);
+
+  /**
+   * \brief Constructor.
+   * The transformation will be T_ba = [C_ba, -C_ba*r_ba_ina; 0 0 0 1]
+   */
+  explicit CachedTransformation(const Eigen::Matrix3d& C_ba,
+                                const Eigen::Vector3d& r_ba_ina);
+
+  /**
+   * \brief Constructor.
+   * The transformation will be T_ba = vec2tran(xi_ab)
+   */
+  explicit CachedTransformation(const Eigen::Matrix<double, 6, 1>& xi_ab,
+                                unsigned int numTerms = 0);
+
+  /** \brief Destructor. Default implementation. */
+  ~CachedTransformation() override = default;
+
+  /** \brief Copy assignment operator, copies the filled cache entries */
+  CachedTransformation& operator=(const CachedTransformation& T);
+
+  /** \brief Move assignment operator, copies the filled cache entries */
+  CachedTransformation& operator=(CachedTransformation&& T) noexcept;
+
+  /** \brief Copy assignment operator from basic Transform, clears the cache */
+  CachedTransformation& operator=(const Transformation& T) noexcept override;
+
+  /** \brief Move assignment operator from basic Transform, clears the cache */
+  CachedTransformation& operator=(Transformation&& T) noexcept override;
+
+  /**
+   * \brief Get the corresponding Lie algebra using the logarithmic map,
+   * computed on first use; the reference is valid until T is modified
+   */
+  const Vector6d& vec() const;
+
+  /**
+   * \brief Get the 6x6 adjoint transformation matrix, computed on first use;
+   * the reference is valid until T is modified
+   */
+  const Matrix6d& adjoint() const;
+
+  /** \brief Get the inverse matrix, with an empty cache */
+  CachedTransformation inverse() const;
+
+  /**
+   * \brief Reproject the transformation matrix back onto SE(3), and clear the
+   * cache
+   */
+  void reproject(bool force = true) override;
+
+  /** \brief In-place right-hand side multiply T_rhs, clears the cache */
+  CachedTransformation& operator*=(const Transformation& T_rhs) override;
+
+  /**
+   * \brief In-place right-hand side multiply the inverse of T_rhs, clears the
+   * cache
+   */
+  CachedTransformation& operator/=(const Transformation& T_rhs) override;
+
+  /** \brief Returns whether vec() is cached */
+  bool vecCached() const;
+
+  /** \brief Returns whether adjoint() is cached */
+  bool adjointCached() const;
+
+  /** \brief Clears the cache, must not race with const methods */
+  void clearCache();
+
+ private:
+  /** \brief States of a cache entry */
+  enum EntryState { EMPTY = 0, FILLING, FILLED };
+
+  /**
+   * \brief Claims an empty entry for the calling reader and returns true, or
+   * waits until another reader has filled it and returns false; if that
+   * reader throws, the entry is empty again and is claimed anew
+   */
+  static bool beginFill(std::atomic<int>* state);
+
+  /** \brief Copies the filled cache entries of T, which may be read */
+  void copyCache(const CachedTransformation& T);
+
+  /** \brief Cached Lie algebra vector, valid if vecState_ is FILLED */
+  mutable Vector6d vec_;
+
+  /** \brief Cached adjoint, valid if adjointState_ is FILLED */
+  mutable Matrix6d adjoint_;
+
+  /** \brief State of vec_, set to FILLED with release after filling it */
+  mutable std::atomic<int> vecState_;
+
+  /** \brief State of adjoint_, set to FILLED with release after filling it */
+  mutable std::atomic<int> adjointState_;
+};
+
+}  // namespace se3
+}  // namespace lgmath
@@ -0,0 +1,123 @@
+/**
+ * \file Deskew.hpp
+ * \brief Header file for the motion compensation (de-skew) of the points of a
+ * scan.
+ * \details A spinning lidar measures each point of a scan from a different
+ * pose. Deskew moves each point, measured in the sensor frame at its time t,
+ * through the pose T(t) of that frame along a constant-velocity motion, e.g.
+ * into the sensor frame at the start of the scan when T(t_start) is the
+ * identity and T(t_end) the motion of the sensor over the scan.
+ *
+ * The exact pose of every point costs an exponential map per point. Instead,
+ * the scan duration is split into K buckets whose bounding knots lie on the
+ * geodesic, and within a bucket the pose is blended linearly between its two
+ * knots: a few multiply-adds per point, vectorized over the consecutive
+ * points of a bucket. For a point at range d, the blend is off by about
+ * d * delta^2 / 8, plus a similar term for the translation, where delta is the
+ * rotation of the sensor over one bucket: the error falls as 1 / K^2.
+ *
+ * \author ASRL
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <lgmath/se3/Transformation.hpp>
+
+namespace lgmath {
+namespace common {
+class ExecutionPolicy;
+}  // namespace common
+
+namespace se3 {
+
+class Deskew {
+ public:
+  /**
+   * \brief Constructor from the poses at the start and the end of the scan
+   * \param[in] T_start The pose at t_start
+   * \param[in] T_end The pose at t_end, reached along the geodesic
+   * \param[in] t_start The start time
+   * \param[in] t_end The end time
+   * \param[in] numKnots Number of buckets K, which trades accuracy for the
+   * cost of the knots
+   * \throws std::invalid_argument If t_end <= t_start or numKnots is 0
+   */
+  Deskew(const Transformation& T_start, const Transformation& T_end,
+         double t_start, double t_end, std::size_t numKnots = 16);
+
+  /**
+   * \brief Constructor from the pose at the start of the scan and a constant
+   * velocity, T(t) = T_start * exp((t - t_start) * varpi)
+   * \param[in] T_start The pose at t_start
+   * \param[in] varpi The velocity (rho, aaxis) per unit of time, as an se3
+   * algebra vector
+   * \param[in] t_start The start time
+   * \param[in] t_end The end time
+   * \param[in] numKnots Number of buckets K
+   * \throws std::invalid_argument If t_end <= t_start or numKnots is 0
+   */
+  Deskew(const Transformation& T_start,
+         const Eigen::Matrix<double, 6, 1>& varpi, double t_start,
+         double t_end, std::size_t numKnots = 16);
+
+  /** \brief Number of buckets */
+  std::size_t numKnots() const { return numKnots_; }
+
+  /** \brief The exact pose at time t */
+  Transformation pose(double t) const;
+
+  /**
+   * \brief De-skews n points, p_out_i = T(t_i) * p_i, with the pose blended
+   * within the bucket of t_i. Times outside [t_start, t_end] extrapolate from
+   * the first or last bucket. Points in time order keep the buckets long,
+   * but any order is correct.
+   * \param[in] t The times of the points, 1 row
+   * \param[in] p The points, 3 rows as in se3/Batch.hpp
+   * \param[out] out The de-skewed points, 3 rows; may alias p
+   * \param[in] n Number of points
+   * \param[in] stride Distance between the rows of p and out, n if 0
+   */
+  void apply(const double* t, const double* p, double* out, std::size_t n,
+             std::size_t stride = 0) const;
+
+  /** \brief apply, with the points split by a policy */
+  void apply(const common::ExecutionPolicy& policy, const double* t,
+             const double* p, double* out, std::size_t n,
+             std::size_t stride = 0) const;
+
+  /** \brief De-skews the points of the columns of p, at the times t */
+  Eigen::Matrix3Xd apply(const Eigen::VectorXd& t,
+                         const Eigen::Matrix3Xd& p) const;
+
+ private:
+  /** \brief Computes the knots */
+  void computeKnots();
+
+  /** \brief The pose at t_start */
+  Transformation T_start_;
+
+  /** \brief The motion over the scan, log(T_start^-1 * T_end) */
+  Eigen::Matrix<double, 6, 1> xi_;
+
+  /** \brief The start time */
+  double t_start_;
+
+  /** \brief The end time */
+  double t_end_;
+
+  /** \brief Number of buckets */
+  std::size_t numKnots_;
+
+  /**
+   * \brief Per bucket, the 12 entries of its first knot and the 12
+   * differences to the next knot, in the row order of se3/Batch.hpp
+   */
+  std::vector<double> knots_;
+};
+
+}  // namespace se3
+}  // namespace lgmath
@@ -0,0 +1,203 @@
+/**
+ * \file GaussianProcess.hpp
+ * \brief Header file for Gaussian process priors on SE3 trajectories.
+ * \details The white-noise-on-acceleration (WNOA) prior models the pose T(t)
+ * and the body velocity varpi(t), dT/dt = varpi^ * T, of a trajectory. Between
+ * two knots (t_1, T_1, varpi_1) and (t_2, T_2, varpi_2), the local variable
+ * xi(t) = log(T(t) * T_1^-1) and its derivative J(xi)^-1 * varpi(t) follow a
+ * linear GP with transition Phi and process noise Q, so that at t_1 + tau
+ *
+ *   gamma(tau) = Lambda(tau) * gamma_1 + Psi(tau) * gamma_2,
+ *
+ * with gamma_1 = [0; varpi_1], gamma_2 = [xi_21; J(xi_21)^-1 * varpi_2],
+ * xi_21 = log(T_2 * T_1^-1), Psi(tau) = Q(tau) * Phi(dt - tau)^T * Q(dt)^-1
+ * and Lambda(tau) = Phi(tau) - Psi(tau) * Phi(dt). Both are 2x2 blocks of
+ * multiples of the identity, independent of the power spectral density Qc.
+ *
+ * The white-noise-on-jerk (WNOJ) prior adds the acceleration to the state; its
+ * transition and process noise are given for the estimator.
+ *
+ * The Jacobians use left perturbations of the knots, T_k <- exp(delta^) * T_k
+ * and varpi_k <- varpi_k + delta, and the first-order approximations
+ * J(xi) * v ~ v - 0.5 * curlyhat(v) * xi and
+ * J(xi)^-1 * v ~ v + 0.5 * curlyhat(v) * xi for the derivatives of the
+ * se3 Jacobians, as is usual for these priors; their error grows with the
+ * motion over the interval.
+ *
+ * \author ASRL
+ */
+#pragma once
+
+#include <cstddef>
+
+#include <Eigen/Core>
+
+#include <lgmath/se3/Transformation.hpp>
+
+namespace lgmath {
+namespace common {
+class ExecutionPolicy;
+}  // namespace common
+
+namespace se3 {
+namespace gp {
+
+/** \brief Transition matrix of the WNOA prior, [I, dt * I; 0, I] */
+Eigen::Matrix<double, 12, 12> wnoaTransition(double dt);
+
+/** \brief Process noise of the WNOA prior over dt, for the density Qc */
+Eigen::Matrix<double, 12, 12> wnoaQ(double dt,
+                                    const Eigen::Matrix<double, 6, 6>& Qc);
+
+/**
+ * \brief Inverse of the process noise of the WNOA prior, in closed form
+ * \throws std::invalid_argument If dt <= 0
+ */
+Eigen::Matrix<double, 12, 12> wnoaQinv(double dt,
+                                       const Eigen::Matrix<double, 6, 6>& Qc);
+
+/**
+ * \brief Transition matrix of the WNOJ prior on (xi, xi', xi''),
+ * [I, dt * I, dt^2 / 2 * I; 0, I, dt * I; 0, 0, I]
+ */
+Eigen::Matrix<double, 18, 18> wnojTransition(double dt);
+
+/** \brief Process noise of the WNOJ prior over dt, for the density Qc */
+Eigen::Matrix<double, 18, 18> wnojQ(double dt,
+                                    const Eigen::Matrix<double, 6, 6>& Qc);
+
+/**
+ * \brief Inverse of the process noise of the WNOJ prior, in closed form
+ * \throws std::invalid_argument If dt <= 0
+ */
+Eigen::Matrix<double, 18, 18> wnojQinv(double dt,
+                                       const Eigen::Matrix<double, 6, 6>& Qc);
+
+/** \brief A knot of a WNOA trajectory */
+struct Knot {
+  /** \brief The time of the knot */
+  double time;
+
+  /** \brief The pose */
+  Transformation T;
+
+  /** \brief The body velocity, dT/dt = varpi^ * T */
+  Eigen::Matrix<double, 6, 1> varpi;
+};
+
+/**
+ * \brief Interpolation of the WNOA prior between two knots, which caches the
+ * quantities of the interval that do not depend on the query time
+ */
+class Interval {
+ public:
+  /**
+   * \brief Constructor
+   * \throws std::invalid_argument If knot2.time <= knot1.time
+   */
+  Interval(const Knot& knot1, const Knot& knot2);
+
+  /** \brief The time of the first knot */
+  double startTime() const { return t1_; }
+
+  /** \brief The time of the second knot */
+  double endTime() const { return t1_ + dt_; }
+
+  /**
+   * \brief The pose at time t; times outside the interval extrapolate the
+   * prior
+   */
+  Transformation pose(double t) const;
+
+  /**
+   * \brief The pose at time t, with its Jacobian
+   * \param[in] t The time
+   * \param[out] jacobian The blocks with respect to [T_1, varpi_1, T_2,
+   * varpi_2]
+   */
+  Transformation pose(double t, Eigen::Matrix<double, 6, 24>* jacobian) const;
+
+  /** \brief The body velocity at time t */
+  Eigen::Matrix<double, 6, 1> velocity(double t) const;
+
+  /** \brief The body velocity at time t, with its Jacobian as for pose */
+  Eigen::Matrix<double, 6, 1> velocity(
+      double t, Eigen::Matrix<double, 6, 24>* jacobian) const;
+
+  /**
+   * \brief The covariance of the left perturbations of the pose and of the
+   * velocity at time t, [T; varpi]
+   * \param[in] t The time
+   * \param[in] knotCov The joint covariance of [T_1, varpi_1, T_2, varpi_2]
+   * \param[in] Qc The power spectral density of the prior
+   * \details The knot covariance is carried through the Jacobians, to which
+   * the prior adds its uncertainty between the knots,
+   * Q(tau) - Psi(tau) * Q(dt) * Psi(tau)^T, zero at the knots.
+   */
+  Eigen::Matrix<double, 12, 12> covariance(
+      double t, const Eigen::Matrix<double, 24, 24>& knotCov,
+      const Eigen::Matrix<double, 6, 6>& Qc) const;
+
+  /**
+   * \brief The poses and velocities at n times, in the batch layouts of
+   * se3/Batch.hpp
+   * \param[in] t The times, 1 row
+   * \param[out] T The poses, 12 rows
+   * \param[out] varpi The velocities, 6 rows, or null to skip them
+   * \param[in] n Number of times
+   * \param[in] stride Distance between the rows of T and varpi, n if 0
+   */
+  void states(const double* t, double* T, double* varpi, std::size_t n,
+              std::size_t stride = 0) const;
+
+  /** \brief states, with the times split by a policy */
+  void states(const common::ExecutionPolicy& policy, const double* t,
+              double* T, double* varpi, std::size_t n,
+              std::size_t stride = 0) const;
+
+ private:
+  /**
+   * \brief The cached vectors, unaligned as Transformation::Matrix34d, so
+   * that the layout does not depend on the instruction set flags
+   */
+  typedef Eigen::Matrix<double, 6, 1, Eigen::DontAlign> Vector6d;
+
+  /** \brief The cached matrices, unaligned as Vector6d */
+  typedef Eigen::Matrix<double, 6, 6, Eigen::DontAlign> Matrix6d;
+
+  /** \brief Computes the local state xi and its derivative at time t */
+  void local(double t, Eigen::Matrix<double, 6, 1>* xi,
+             Eigen::Matrix<double, 6, 1>* dxi, Eigen::Matrix2d* lambda,
+             Eigen::Matrix2d* psi) const;
+
+  /** \brief The time of the first knot */
+  double t1_;
+
+  /** \brief The length of the interval */
+  double dt_;
+
+  /** \brief The pose of the first knot */
+  Transformation T1_;
+
+  /** \brief The velocity of the first knot */
+  Vector6d varpi1_;
+
+  /** \brief xi_21 = log(T_2 * T_1^-1) */
+  Vector6d xi21_;
+
+  /** \brief J(xi_21)^-1 * varpi_2, the derivative of xi at the second knot */
+  Vector6d dxi2_;
+
+  /** \brief Ad(T_2 * T_1^-1) */
+  Matrix6d Ad21_;
+
+  /** \brief J(xi_21)^-1 */
+  Matrix6d J21inv_;
+
+  /** \brief 0.5 * curlyhat(varpi_2) */
+  Matrix6d halfCurlyhat2_;
+};
+
+}  // namespace gp
+}  // namespace se3
+}  // namespace lgmath
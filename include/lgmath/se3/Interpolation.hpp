@@ -0,0 +1,46 @@
+/**
+ * \file Interpolation.hpp
+ * \brief Header file for the geodesic interpolation of transformations.
+ * \details The pose at alpha along the geodesic from T_0 (alpha = 0) to T_1
+ * (alpha = 1) is T_0 * exp(alpha * log(T_0^-1 * T_1)); values of alpha
+ * outside [0, 1] extrapolate along the same constant-velocity motion. To
+ * interpolate one pose pair at many values of alpha, e.g. at the timestamps
+ * of the points of a lidar scan, see se3::interpolateBatch, which computes
+ * the logarithm once.
+ *
+ * \author ASRL
+ */
+#pragma once
+
+#include <lgmath/se3/Transformation.hpp>
+#include <lgmath/se3/TransformationWithCovariance.hpp>
+
+namespace lgmath {
+namespace se3 {
+
+/**
+ * \brief Interpolates between two transformations along the geodesic,
+ * T_0 * exp(alpha * log(T_0^-1 * T_1))
+ * \param[in] T_0 The transformation at alpha = 0
+ * \param[in] T_1 The transformation at alpha = 1
+ * \param[in] alpha The interpolation parameter; extrapolates outside [0, 1]
+ */
+Transformation interpolate(const Transformation& T_0,
+                           const Transformation& T_1, double alpha);
+
+/**
+ * \brief Interpolates between two transformations and their covariances.
+ * \details The covariance is propagated to first order, assuming that the
+ * errors of T_0 and T_1 are independent: with xi = log(T_1 * T_0^-1),
+ * A = alpha * J(alpha * xi) * J(xi)^-1 and
+ * B = Ad(exp(alpha * xi)) - A * Ad(T_1 * T_0^-1),
+ * cov = A * cov_1 * A^T + B * cov_0 * B^T, which is cov_0 at alpha = 0 and
+ * cov_1 at alpha = 1. As for the composition operators, the covariance of the
+ * result is only set if both covariances are set.
+ */
+TransformationWithCovariance interpolate(
+    const TransformationWithCovariance& T_0,
+    const TransformationWithCovariance& T_1, double alpha);
+
+}  // namespace se3
+}  // namespace lgmath
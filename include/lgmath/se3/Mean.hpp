@@ -0,0 +1,57 @@
+/**
+ * \file Mean.hpp
+ * \brief Header file for the weighted means of transformations.
+ * \details As for so3::mean: the Karcher (Frechet) mean minimizes
+ * sum_i w_i * |log(T_i * T^-1)|^2 by Gauss-Newton iterations
+ * T <- exp(delta^) * T, started from the chordal mean, whose rotation is the
+ * projected weighted sum of the rotations and whose translation is the
+ * weighted mean of the translations r_ab_inb. The sums over the
+ * transformations are split by an execution policy into fixed blocks, so that
+ * the mean is bitwise the same on any executor.
+ *
+ * \author ASRL
+ */
+#pragma once
+
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <lgmath/se3/Transformation.hpp>
+#include <lgmath/so3/Mean.hpp>
+
+namespace lgmath {
+namespace common {
+class ExecutionPolicy;
+}  // namespace common
+
+namespace se3 {
+
+using so3::MeanMethod;
+
+/**
+ * \brief Weighted mean of transformations
+ * \param[in] transformations The transformations
+ * \param[in] weights One non-negative weight per transformation, or empty for
+ * equal weights
+ * \param[in] method The mean
+ * \param[out] spread If not null, the weighted covariance of the
+ * log(T_i * T^-1) about the mean T, e.g. as the covariance of the mean of
+ * hypotheses
+ * \throws std::invalid_argument If there are no transformations, the weights
+ * do not match them or are negative, or their sum is not positive
+ */
+Transformation mean(const std::vector<Transformation>& transformations,
+                    const std::vector<double>& weights = {},
+                    MeanMethod method = MeanMethod::KARCHER,
+                    Eigen::Matrix<double, 6, 6>* spread = nullptr);
+
+/** \brief mean, with the sums split by a policy */
+Transformation mean(const common::ExecutionPolicy& policy,
+                    const std::vector<Transformation>& transformations,
+                    const std::vector<double>& weights = {},
+                    MeanMethod method = MeanMethod::KARCHER,
+                    Eigen::Matrix<double, 6, 6>* spread = nullptr);
+
+}  // namespace se3
+}  // namespace lgmath
@@ -307,5 +307,43 @@ Eigen::Matrix<double, 6, 6> vec2jacinv(const Eigen::Vector3d& rho_ba,
 Eigen::Matrix<double, 6, 6> vec2jacinv(const Eigen::Matrix<double, 6, 1>& xi_ba,
                                        unsigned int numTerms = 0);
 
+/**
+ * \brief Computes curlyhat(xi) * v without forming the 6x6 matrix
+ * \details
+ * curlyhat(xi) * v = [aaxis x v_rho + rho x v_aaxis; aaxis x v_aaxis]
+ */
+Eigen::Matrix<double, 6, 1> applyCurlyhat(const Eigen::Matrix<double, 6, 1>& xi,
+                                          const Eigen::Matrix<double, 6, 1>& v);
+
+/**
+ * \brief Computes vec2jac(xi_ba) * v without forming the 6x6 matrix
+ * \details
+ * The so3 Jacobian and the Q matrix are applied as sums of cross products,
+ * with the scalar coefficients of vec2Q; the result matches vec2jac, including
+ * its small angle case.
+ */
+Eigen::Matrix<double, 6, 1> applyJac(const Eigen::Matrix<double, 6, 1>& xi_ba,
+                                     const Eigen::Matrix<double, 6, 1>& v);
+
+/**
+ * \brief Computes vec2jac(xi_ba)^T * v without forming the 6x6 matrix
+ * \details
+ * Uses J(rho, aaxis)^T = [J(-aaxis), 0; Q(-rho, -aaxis), J(-aaxis)], where the
+ * 3x3 blocks are the so3 Jacobian and the Q matrix of vec2Q.
+ */
+Eigen::Matrix<double, 6, 1> applyJacTranspose(
+    const Eigen::Matrix<double, 6, 1>& xi_ba,
+    const Eigen::Matrix<double, 6, 1>& v);
+
+/**
+ * \brief Computes vec2jacinv(xi_ba) * v without forming the 6x6 matrix
+ * \details
+ * With c = J^-1 * v_aaxis, the result is [J^-1 * (v_rho - Q * c); c], where J
+ * is the so3 Jacobian; the result matches vec2jacinv.
+ */
+Eigen::Matrix<double, 6, 1> applyJacInv(
+    const Eigen::Matrix<double, 6, 1>& xi_ba,
+    const Eigen::Matrix<double, 6, 1>& v);
+
 }  // namespace se3
 }  // namespace lgmath
@@ -0,0 +1,147 @@
+/**
+ * \file PoseArray.hpp
+ * \brief Header file for a structure of arrays container of transformations.
+ * \details A std::vector<Transformation> stores each pose with its vtable
+ * pointer, so that a sweep over one component (e.g. the translations) loads
+ * every cache line of every pose, and the compiler cannot vectorize across
+ * poses. PoseArray stores each of the 12 entries of the 3x4 poses [C_ba | r]
+ * in its own array instead: the nine rotation entries and the three
+ * translation entries are separate rows of the batch layout of
+ * se3/Batch.hpp, each aligned to a cache line. The batch operations below use
+ * the kernels of Batch.hpp, and data() and stride() give direct access to
+ * the rows for the other batch functions.
+ *
+ * Unlike the Transformation operators, the batch operations do not reproject
+ * their results onto SE(3).
+ *
+ * \author ASRL
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <lgmath/se3/Batch.hpp>
+#include <lgmath/se3/Transformation.hpp>
+
+namespace lgmath {
+namespace se3 {
+
+class PoseArray {
+ public:
+  /** \brief One 6-vector per column */
+  typedef Eigen::Matrix<double, 6, Eigen::Dynamic> Matrix6Xd;
+
+  /** \brief Constructs n identity transformations */
+  explicit PoseArray(std::size_t n = 0);
+
+  /** \brief Copies the transformations of a vector */
+  explicit PoseArray(const std::vector<Transformation>& poses);
+
+  /**
+   * \brief Constructor.
+   * Transformation i will be T_ba = vec2tran(xi_ab.col(i))
+   */
+  explicit PoseArray(const Matrix6Xd& xi_ab);
+
+  /** \brief Destructor. Default implementation. */
+  virtual ~PoseArray() = default;
+
+  /** \brief Number of transformations */
+  std::size_t size() const { return size_; }
+
+  /** \brief Whether there are no transformations */
+  bool empty() const { return size_ == 0; }
+
+  /**
+   * \brief Distance between the rows of data(), the size rounded up to a
+   * whole number of cache lines
+   */
+  std::size_t stride() const { return stride_; }
+
+  /**
+   * \brief Changes the number of transformations, keeping the first ones; new
+   * transformations are the identity. The rows move, so this invalidates
+   * data().
+   */
+  void resize(std::size_t n);
+
+  /** \brief The 12 rows of the poses, in the layout of se3/Batch.hpp */
+  double* data() { return reinterpret_cast<double*>(storage_.data()); }
+  const double* data() const {
+    return reinterpret_cast<const double*>(storage_.data());
+  }
+
+  /** \brief Gets transformation i */
+  Transformation operator[](std::size_t i) const;
+
+  /** \brief Gets transformation i, with a bounds check */
+  Transformation at(std::size_t i) const;
+
+  /** \brief Sets transformation i */
+  void set(std::size_t i, const Transformation& T_ba);
+
+  /** \brief Copies the transformations to a vector */
+  std::vector<Transformation> transformations() const;
+
+  /**
+   * \brief Get the corresponding Lie algebra vectors using the logarithmic
+   * map, one per column
+   */
+  Matrix6Xd vec() const;
+
+  /** \brief Gets the inverse of each transformation */
+  PoseArray inverse() const;
+
+  /**
+   * \brief Computes Ad(T_i) * v.col(i) for each transformation, without
+   * forming the adjoint matrices
+   */
+  Matrix6Xd applyAdjoint(const Matrix6Xd& v) const;
+
+  /**
+   * \brief Transforms one point per transformation, p_b.col(i) = T_i *
+   * p_a.col(i)
+   */
+  Eigen::Matrix3Xd transformPoints(const Eigen::Matrix3Xd& p_a) const;
+
+  /** \brief In-place element-wise right-hand side multiply T_rhs */
+  PoseArray& operator*=(const PoseArray& T_rhs);
+
+  /** \brief Element-wise right-hand side multiply T_rhs */
+  PoseArray operator*(const PoseArray& T_rhs) const;
+
+ protected:
+  /** \brief Constructs n identity transformations with extra zero rows */
+  PoseArray(std::size_t n, std::size_t extraRows);
+
+  /** \brief Pointer to row k, which may be one of the extra rows */
+  double* row(std::size_t k) { return data() + k * stride_; }
+  const double* row(std::size_t k) const { return data() + k * stride_; }
+
+  /** \brief Throws std::invalid_argument if rhs has another size */
+  void checkSize(const PoseArray& rhs, const char* function) const;
+
+ private:
+  /** \brief Storage unit, so that every row starts on a cache line */
+  struct alignas(64) CacheLine {
+    double values[8];
+  };
+
+  /** \brief Number of rows, 12 for the poses and any extra rows */
+  std::size_t rows_;
+
+  /** \brief Number of transformations */
+  std::size_t size_;
+
+  /** \brief Distance between rows */
+  std::size_t stride_;
+
+  /** \brief The rows, stride_ doubles each */
+  std::vector<CacheLine> storage_;
+};
+
+}  // namespace se3
+}  // namespace lgmath
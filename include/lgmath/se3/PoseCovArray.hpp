@@ -0,0 +1,110 @@
+/**
+ * \file PoseCovArray.hpp
+ * \brief Header file for a structure of arrays container of transformations
+ * with covariances.
+ * \details Extends PoseArray with the 21 entries of the upper triangle of each
+ * 6x6 covariance (as in io::packCovariance), each stored in its own aligned
+ * array after the rows of the poses. The batch operations propagate the
+ * covariances as TransformationWithCovariance does, without reprojecting the
+ * poses. Every element has a covariance: new elements have a zero covariance,
+ * and elements without one cannot be set.
+ *
+ * The rows of the poses and of the covariances share the storage of a
+ * PoseArray, but the inheritance is private: the operations of PoseArray
+ * that change or replace the poses are not virtual, and through a PoseArray
+ * reference they would leave the covariances stale. Only the operations that
+ * cannot are made public again; poses() copies the poses out.
+ *
+ * \author ASRL
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <lgmath/se3/PoseArray.hpp>
+#include <lgmath/se3/TransformationWithCovariance.hpp>
+
+namespace lgmath {
+namespace se3 {
+
+class PoseCovArray : private PoseArray {
+ public:
+  using PoseArray::Matrix6Xd;
+
+  using PoseArray::applyAdjoint;
+  using PoseArray::data;
+  using PoseArray::empty;
+  using PoseArray::resize;
+  using PoseArray::size;
+  using PoseArray::stride;
+  using PoseArray::transformPoints;
+  using PoseArray::vec;
+
+  /** \brief Constructs n identity transformations with zero covariances */
+  explicit PoseCovArray(std::size_t n = 0);
+
+  /**
+   * \brief Copies the transformations of a vector
+   * \throws std::logic_error If a covariance is not set
+   */
+  explicit PoseCovArray(
+      const std::vector<TransformationWithCovariance>& poses);
+
+  /** \brief Copies transformations, with one covariance for all of them */
+  PoseCovArray(const PoseArray& poses,
+               const Eigen::Matrix<double, 6, 6>& covariance);
+
+  /** \brief Destructor. Default implementation. */
+  ~PoseCovArray() override = default;
+
+  /**
+   * \brief The 21 rows of the packed covariances, in the layout of
+   * se3/Batch.hpp; they follow the rows of data()
+   */
+  double* covarianceData() { return row(BATCH_POSE_ROWS); }
+  const double* covarianceData() const { return row(BATCH_POSE_ROWS); }
+
+  /** \brief Gets transformation i with its covariance */
+  TransformationWithCovariance operator[](std::size_t i) const;
+
+  /** \brief Gets transformation i with its covariance, with a bounds check */
+  TransformationWithCovariance at(std::size_t i) const;
+
+  /**
+   * \brief Sets transformation i and its covariance
+   * \throws std::logic_error If the covariance of T_ba is not set
+   */
+  void set(std::size_t i, const TransformationWithCovariance& T_ba);
+
+  /** \brief Copies the transformations, without their covariances */
+  PoseArray poses() const;
+
+  /** \brief Gets covariance i */
+  Eigen::Matrix<double, 6, 6> cov(std::size_t i) const;
+
+  /** \brief Sets covariance i */
+  void setCovariance(std::size_t i,
+                     const Eigen::Matrix<double, 6, 6>& covariance);
+
+  /** \brief Copies the transformations to a vector */
+  std::vector<TransformationWithCovariance> transformations() const;
+
+  /** \brief Gets the inverse of each transformation, with its covariance */
+  PoseCovArray inverse() const;
+
+  /**
+   * \brief In-place element-wise right-hand side multiply T_rhs, with
+   * cov = cov + Ad(T) * cov_rhs * Ad(T)^T as in
+   * TransformationWithCovariance::operator*=
+   */
+  PoseCovArray& operator*=(const PoseCovArray& T_rhs);
+
+  /** \brief Element-wise right-hand side multiply T_rhs */
+  PoseCovArray operator*(const PoseCovArray& T_rhs) const;
+};
+
+}  // namespace se3
+}  // namespace lgmath
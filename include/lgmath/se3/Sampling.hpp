@@ -0,0 +1,56 @@
+/**
+ * \file Sampling.hpp
+ * \brief Header file for drawing poses from a TransformationWithCovariance.
+ * \details The samples are T_k = exp(xi_k^) * T, with xi_k ~ N(0, cov()) the
+ * left perturbation of TransformationWithCovariance. The covariance is
+ * factored once, as cov() = L * L^T, and xi_k = L * z_k is formed from blocks
+ * of standard normal z_k (Box-Muller), which the batch exponential map of
+ * Batch.hpp turns into poses. The samples are written in the batch layout,
+ * 12 rows, e.g. to the data() of a PoseArray.
+ *
+ * With an execution policy, each fixed block of samples draws from its own
+ * generator, seeded from the seed and the block index, so that the streams
+ * are independent and the samples do not depend on the executor.
+ *
+ * \author ASRL
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+
+#include <lgmath/se3/TransformationWithCovariance.hpp>
+
+namespace lgmath {
+namespace common {
+class ExecutionPolicy;
+}  // namespace common
+
+namespace se3 {
+
+/**
+ * \brief Draws K poses about T, with its covariance
+ * \param[in] T The mean and covariance, which must be positive semi-definite
+ * \param[in] K Number of samples
+ * \param[in,out] rng The random number generator
+ * \param[out] out The samples, 12 rows
+ * \param[in] stride Distance between rows, K if 0
+ * \throws std::logic_error If T has no covariance
+ * \throws std::invalid_argument If the covariance is not positive
+ * semi-definite, out is null or the stride is less than K
+ */
+void sample(const TransformationWithCovariance& T, std::size_t K,
+            std::mt19937_64& rng, double* out, std::size_t stride = 0);
+
+/**
+ * \brief sample, with the samples split by a policy
+ * \param[in] seed Seeds the generators of the blocks of samples; the same
+ * seed gives the same samples with any policy
+ */
+void sample(const common::ExecutionPolicy& policy,
+            const TransformationWithCovariance& T, std::size_t K,
+            std::uint64_t seed, double* out, std::size_t stride = 0);
+
+}  // namespace se3
+}  // namespace lgmath
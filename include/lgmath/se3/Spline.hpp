@@ -0,0 +1,152 @@
+/**
+ * \file Spline.hpp
+ * \brief Header file for cumulative cubic B-spline trajectories on SE3.
+ * \details The control poses T_0, ..., T_N-1 are spaced dt apart in time from
+ * t0. Segment k covers [t0 + k * dt, t0 + (k + 1) * dt] and, at the fraction u
+ * of it, has the pose
+ *
+ *   T(u) = exp(b_3(u) * d_3) * exp(b_2(u) * d_2) * exp(b_1(u) * d_1) * T_k,
+ *
+ * with d_j = log(T_k+j * T_k+j-1^-1) and the cumulative basis functions
+ * b_1 = (5 + 3u - 3u^2 + u^3) / 6, b_2 = (1 + 3u + 3u^2 - 2u^3) / 6 and
+ * b_3 = u^3 / 6. The spline is defined on [t0, t0 + (N - 3) * dt] and is twice
+ * continuously differentiable. The velocity varpi and acceleration are those
+ * of dT/dt = varpi^ * T, so that control poses on a constant velocity motion,
+ * T_k = exp(k * dt * varpi) * T_0, give back varpi and a zero acceleration.
+ *
+ * The logarithms d_j are kept with the control poses; batch evaluation at many
+ * times also reuses the exponential map coefficients of each segment (see
+ * se3::interpolateBatch), so that a query costs three sines and cosines and a
+ * few multiply-adds.
+ *
+ * \author ASRL
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <lgmath/se3/PoseArray.hpp>
+#include <lgmath/se3/Transformation.hpp>
+
+namespace lgmath {
+namespace common {
+class ExecutionPolicy;
+}  // namespace common
+
+namespace se3 {
+
+class Spline {
+ public:
+  /**
+   * \brief Constructor of a spline without control poses
+   * \param[in] t0 The time of the first segment start
+   * \param[in] dt The time between control poses
+   * \throws std::invalid_argument If dt <= 0
+   */
+  Spline(double t0, double dt);
+
+  /**
+   * \brief Constructor from control poses
+   * \throws std::invalid_argument If dt <= 0
+   */
+  Spline(double t0, double dt, const std::vector<Transformation>& controlPoses);
+
+  /** \brief The start time of the spline */
+  double startTime() const { return t0_; }
+
+  /** \brief The end time of the spline, t0 + (N - 3) * dt */
+  double endTime() const;
+
+  /** \brief The time between control poses */
+  double knotSpacing() const { return dt_; }
+
+  /** \brief Number of control poses */
+  std::size_t numControlPoses() const { return controlPoses_.size(); }
+
+  /**
+   * \brief Gets a control pose
+   * \throws std::out_of_range If i is not a control pose
+   */
+  const Transformation& controlPose(std::size_t i) const;
+
+  /**
+   * \brief Sets a control pose, which changes up to 4 segments
+   * \throws std::out_of_range If i is not a control pose
+   */
+  void setControlPose(std::size_t i, const Transformation& T);
+
+  /** \brief Appends a control pose, which extends the spline by dt */
+  void addControlPose(const Transformation& T);
+
+  /**
+   * \brief The pose at time t
+   * \throws std::logic_error If there are less than 4 control poses
+   * \throws std::out_of_range If t is outside [startTime, endTime]
+   */
+  Transformation pose(double t) const;
+
+  /**
+   * \brief The pose at time t, with its Jacobians with respect to the 4
+   * control poses of the segment of t.
+   * \details With left perturbations T_first+k <- exp(delta_k^) * T_first+k
+   * of the control poses, the pose moves to exp(epsilon^) * T(t), with
+   * epsilon = sum_k J_k * delta_k to first order.
+   * \param[in] t The time
+   * \param[out] jacobians The blocks [J_0, J_1, J_2, J_3]
+   * \param[out] first The index of the control pose of J_0
+   */
+  Transformation pose(double t, Eigen::Matrix<double, 6, 24>* jacobians,
+                      std::size_t* first) const;
+
+  /** \brief The velocity varpi at time t, dT/dt = varpi^ * T */
+  Eigen::Matrix<double, 6, 1> velocity(double t) const;
+
+  /** \brief The time derivative of the velocity at time t */
+  Eigen::Matrix<double, 6, 1> acceleration(double t) const;
+
+  /**
+   * \brief The poses at n times, in the batch layout of se3/Batch.hpp.
+   * Consecutive times in the same segment share its coefficients, so sorted
+   * times are the fast case, but any order is correct.
+   * \param[in] t The times, 1 row
+   * \param[out] T The poses, 12 rows
+   * \param[in] n Number of times
+   * \param[in] stride Distance between the rows of T, n if 0
+   * \throws std::out_of_range If a time is outside [startTime, endTime]
+   */
+  void poses(const double* t, double* T, std::size_t n,
+             std::size_t stride = 0) const;
+
+  /** \brief poses, with the times split by a policy */
+  void poses(const common::ExecutionPolicy& policy, const double* t, double* T,
+             std::size_t n, std::size_t stride = 0) const;
+
+  /** \brief The poses at the times t */
+  PoseArray poses(const Eigen::VectorXd& t) const;
+
+ private:
+  /**
+   * \brief Gets the segment of t and the fraction u of it
+   * \throws std::logic_error If there are less than 4 control poses
+   * \throws std::out_of_range If t is outside [startTime, endTime]
+   */
+  std::size_t segment(double t, double* u) const;
+
+  /** \brief The time of the first segment start */
+  double t0_;
+
+  /** \brief The time between control poses */
+  double dt_;
+
+  /** \brief The control poses */
+  std::vector<Transformation> controlPoses_;
+
+  /** \brief Per control pose k > 0, log(T_k * T_k-1^-1); zero for k = 0 */
+  std::vector<Eigen::Matrix<double, 6, 1>> logs_;
+};
+
+}  // namespace se3
+}  // namespace lgmath
@@ -15,6 +15,21 @@ namespace se3 {
 
 class Transformation {
  public:
+  /**
+   * \brief The top 3x4 block [C_ba | r_ab_inb], stored column by column.
+   * Unaligned, as the 96 bytes of Eigen::Matrix<double, 3, 4> would otherwise
+   * be 16- or 32-byte aligned depending on the instruction set flags, and the
+   * inline accessors of callers built with other flags than the library would
+   * read the wrong offset
+   */
+  typedef Eigen::Matrix<double, 3, 4, Eigen::DontAlign> Matrix34d;
+
+  /** \brief Read-only view of the rotation, the first 9 stored doubles */
+  typedef Eigen::Map<const Eigen::Matrix3d> RotationMap;
+
+  /** \brief Read-only view of the translation, the last 3 stored doubles */
+  typedef Eigen::Map<const Eigen::Vector3d> TranslationMap;
+
   /** \brief Default constructor */
   Transformation();
 
@@ -27,6 +42,16 @@ class Transformation {
   /** \brief Copy constructor (from Eigen) */
   explicit Transformation(const Eigen::Matrix4d& T);
 
+  /**
+   * \brief Copy constructor (from Eigen), with optional reprojection.
+   * \param[in] reproj Setting reproj to false skips the reprojection onto
+   * SE(3); only do this if T is already known to be a valid transformation.
+   */
+  explicit Transformation(const Eigen::Matrix4d& T, bool reproj);
+
+  /** \brief Constructor from an Eigen isometry, with reprojection */
+  explicit Transformation(const Eigen::Isometry3d& T_ba);
+
   /**
    * \brief Constructor.
    * The transformation will be T_ba = [C_ba, -C_ba*r_ba_ina; 0 0 0 1]
@@ -56,14 +81,37 @@ class Transformation {
   /** \brief Gets basic matrix representation of the transformation */
   Eigen::Matrix4d matrix() const;
 
-  /** \brief Gets the underlying rotation matrix */
-  const Eigen::Matrix3d& C_ba() const;
+  /** \brief Gets the stored top 3x4 block [C_ba | r_ab_inb], without a copy */
+  const Matrix34d& matrix34() const { return T_ba_; }
+
+  /**
+   * \brief Gets the 12 stored doubles, column-major [C_ba | r_ab_inb], e.g. to
+   * wrap in a ConstTransformationMap with PoseLayout::COL_MAJOR_3X4
+   */
+  const double* data() const { return T_ba_.data(); }
+
+  /** \brief Gets the transformation as an Eigen isometry */
+  Eigen::Isometry3d isometry() const;
+
+  /** \brief Gets the underlying rotation matrix, mapped in place */
+  RotationMap C_ba() const& { return RotationMap(T_ba_.data()); }
+
+  /**
+   * \brief Gets a copy of the rotation matrix of a temporary, e.g.
+   * T.inverse().C_ba(), which a map would outlive
+   */
+  Eigen::Matrix3d C_ba() const&& { return RotationMap(T_ba_.data()); }
 
   /** \brief Gets r_ba_ina = -C_ba.transpose() * r_ab_inb */
   Eigen::Vector3d r_ba_ina() const;
 
-  /** \brief Gets the underlying r_ab_inb vector. */
-  const Eigen::Vector3d& r_ab_inb() const;
+  /** \brief Gets the underlying r_ab_inb vector, mapped in place */
+  TranslationMap r_ab_inb() const& { return TranslationMap(T_ba_.data() + 9); }
+
+  /** \brief Gets a copy of the r_ab_inb vector of a temporary, as C_ba() */
+  Eigen::Vector3d r_ab_inb() const&& {
+    return TranslationMap(T_ba_.data() + 9);
+  }
 
   /** \brief Get the corresponding Lie algebra using the logarithmic map */
   Eigen::Matrix<double, 6, 1> vec() const;
@@ -80,7 +128,7 @@ class Transformation {
    * that only happens if the determinant is of the rotation matrix is poor;
    * this is more efficient than always performing it.
    */
-  void reproject(bool force = true);
+  virtual void reproject(bool force = true);
 
   /** \brief In-place right-hand side multiply T_rhs */
   virtual Transformation& operator*=(const Transformation& T_rhs);
@@ -98,13 +146,50 @@ class Transformation {
   Eigen::Vector4d operator*(const Eigen::Ref<const Eigen::Vector4d>& p_a) const;
 
  private:
-  /** \brief Rotation matrix from a to b */
-  Eigen::Matrix3d C_ba_;
-
-  /** \brief Translation vector from b to a, expressed in frame b */
-  Eigen::Vector3d r_ab_inb_;
+  /**
+   * \brief The top 3x4 block [C_ba | r_ab_inb], so that the rotation from a to
+   * b and the translation from b to a in frame b are contiguous
+   */
+  Matrix34d T_ba_;
 };
 
+/**
+ * \brief Composes two transformations and computes the Jacobians of the
+ * product, T_12 = T_1 * T_2, in one pass.
+ * \details The Jacobians are with respect to left perturbations,
+ * T = exp(delta^) * T, so that J_1 = 1 and J_2 = Ad(T_1); the product and J_2
+ * are computed from the same loads of T_1. Any of the outputs may be null to
+ * skip it, and T_12 may alias T_1 or T_2.
+ * \param[in] reproj Setting reproj to false skips the reprojection of T_12
+ * onto SE(3), which operator* always does
+ */
+void composeWithJacobians(const Transformation& T_1, const Transformation& T_2,
+                          Transformation* T_12,
+                          Eigen::Matrix<double, 6, 6>* J_1,
+                          Eigen::Matrix<double, 6, 6>* J_2,
+                          bool reproj = true);
+
+/**
+ * \brief Inverts a transformation and computes the Jacobian of the inverse
+ * with respect to a left perturbation of T, J = -Ad(T^-1), in one pass.
+ * \details Either output may be null to skip it, and T_inv may alias T.
+ * \param[in] reproj Setting reproj to false skips the reprojection of T_inv
+ * onto SE(3), which inverse() always does
+ */
+void inverseWithJacobian(const Transformation& T, Transformation* T_inv,
+                         Eigen::Matrix<double, 6, 6>* J, bool reproj = true);
+
+/**
+ * \brief Transforms a point, p_b = T_ba * p_a, and computes the Jacobians with
+ * respect to the point, J_p = C_ba, and to a left perturbation of T_ba,
+ * J_T = [1, -p_b^] (the top rows of point2fs(p_b)).
+ * \details Either Jacobian may be null to skip it.
+ */
+Eigen::Vector3d transformPointWithJacobian(const Transformation& T_ba,
+                                           const Eigen::Vector3d& p_a,
+                                           Eigen::Matrix3d* J_p,
+                                           Eigen::Matrix<double, 3, 6>* J_T);
+
 }  // namespace se3
 }  // namespace lgmath
 
@@ -0,0 +1,125 @@
+/**
+ * \file TransformationMap.hpp
+ * \brief Header file for transformation views over external buffers.
+ * \details A ConstTransformationMap reads a transformation in place from a
+ * buffer of doubles in one of the layouts below, and a TransformationMap also
+ * writes it, so that poses held in messages or arrays can be used without
+ * first copying them into an Eigen::Matrix4d. The buffer must outlive the map.
+ *
+ * \author ASRL
+ */
+#pragma once
+
+#include <Eigen/Dense>
+
+#include <lgmath/se3/Transformation.hpp>
+
+namespace lgmath {
+namespace se3 {
+
+/** \brief Layouts of a transformation T_ba in a buffer of doubles */
+enum class PoseLayout {
+  /** \brief The top 3x4 block [C_ba | r_ab_inb] in row-major order */
+  ROW_MAJOR_3X4,
+  /** \brief The top 3x4 block [C_ba | r_ab_inb] in column-major order */
+  COL_MAJOR_3X4,
+  /**
+   * \brief r_ab_inb followed by the unit quaternion of C_ba as (x, y, z, w),
+   * 7 doubles, as in the memory of a geometry_msgs/Pose
+   */
+  TRANSLATION_QUATERNION,
+  /** \brief The algebra vector xi_ab, T_ba = vec2tran(xi_ab) */
+  VECTOR6
+};
+
+/** \brief Gets the number of doubles of a pose layout */
+int poseLayoutSize(PoseLayout layout);
+
+/** \brief Read-only view of a transformation stored in an external buffer */
+class ConstTransformationMap {
+ public:
+  /** \brief Constructor, throws std::invalid_argument if data is null */
+  ConstTransformationMap(const double* data, PoseLayout layout);
+
+  /** \brief Gets the buffer */
+  const double* data() const { return data_; }
+
+  /** \brief Gets the layout of the buffer */
+  PoseLayout layout() const { return layout_; }
+
+  /**
+   * \brief Gets the 4x4 matrix; quaternions are normalized first, and algebra
+   * vectors go through the exponential map
+   */
+  Eigen::Matrix4d matrix() const;
+
+  /** \brief Gets the underlying rotation matrix */
+  Eigen::Matrix3d C_ba() const;
+
+  /** \brief Gets the "forward" translation r_ab_inb */
+  Eigen::Vector3d r_ab_inb() const;
+
+  /** \brief Get the corresponding Lie algebra using the logarithmic map */
+  Eigen::Matrix<double, 6, 1> vec() const;
+
+  /** \brief Copies the pose into a Transformation, without reprojection */
+  Transformation transformation() const;
+
+  /** \brief Get the inverse matrix */
+  Transformation inverse() const;
+
+  /** \brief Get the 6x6 adjoint transformation matrix */
+  Eigen::Matrix<double, 6, 6> adjoint() const;
+
+  /**
+   * \brief Right-hand side multiply T_rhs, reprojecting like Transformation;
+   * use compose() to write the product to a buffer without a Transformation
+   */
+  Transformation operator*(const ConstTransformationMap& T_rhs) const;
+
+  /** \brief Right-hand side multiply T_rhs, reprojecting like Transformation */
+  Transformation operator*(const Transformation& T_rhs) const;
+
+  /** \brief Right-hand side multiply the homogeneous vector p_a */
+  Eigen::Vector4d operator*(const Eigen::Ref<const Eigen::Vector4d>& p_a) const;
+
+ protected:
+  /** \brief The buffer, written through by TransformationMap */
+  const double* data_;
+
+  /** \brief The layout of the buffer */
+  PoseLayout layout_;
+};
+
+/** \brief Read-write view of a transformation stored in an external buffer */
+class TransformationMap : public ConstTransformationMap {
+ public:
+  /** \brief Constructor, throws std::invalid_argument if data is null */
+  TransformationMap(double* data, PoseLayout layout);
+
+  /** \brief Gets the buffer */
+  double* data() const { return const_cast<double*>(data_); }
+
+  /** \brief Writes C_ba and r_ab_inb in the layout of the buffer */
+  void assign(const Eigen::Matrix3d& C_ba, const Eigen::Vector3d& r_ab_inb);
+
+  /** \brief Writes T in the layout of the buffer */
+  TransformationMap& operator=(const Transformation& T);
+
+  /** \brief Writes T, possibly of another layout, into the buffer */
+  TransformationMap& operator=(const ConstTransformationMap& T);
+
+  /** \brief Writes T, possibly of another layout, into the buffer */
+  TransformationMap& operator=(const TransformationMap& T);
+};
+
+/**
+ * \brief Composes two mapped transformations into a third,
+ * T_out = T_lhs * T_rhs; the product is not reprojected, and out may alias lhs
+ * or rhs
+ */
+void compose(const ConstTransformationMap& T_lhs,
+             const ConstTransformationMap& T_rhs, TransformationMap* T_out);
+
+}  // namespace se3
+}  // namespace lgmath
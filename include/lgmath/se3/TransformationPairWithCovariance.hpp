@@ -0,0 +1,87 @@
+/**
+ * \file TransformationPairWithCovariance.hpp
+ * \brief Header file for two transformations with a joint covariance.
+ * \details TransformationWithCovariance composes independent poses. Poses out
+ * of the same estimator, e.g. two poses of a sliding window, are correlated:
+ * their left perturbations xi_1 and xi_2 (T_i = exp(xi_i^) * T_i) have the
+ * joint 12x12 covariance [cov_11, cov_12; cov_21, cov_22]. This class keeps
+ * it, and propagates it through the composition, the relative pose and the
+ * inversion to first order. The products with the adjoints use their
+ * structure, Ad(T) = [C, r^ * C; 0, C], rather than dense 12x12 Jacobians.
+ *
+ * \author ASRL
+ */
+#pragma once
+
+#include <Eigen/Core>
+
+#include <lgmath/se3/Transformation.hpp>
+#include <lgmath/se3/TransformationWithCovariance.hpp>
+
+namespace lgmath {
+namespace se3 {
+
+class TransformationPairWithCovariance {
+ public:
+  /**
+   * \brief The joint covariance of the two perturbations, unaligned as
+   * Transformation::Matrix34d, so that the layout does not depend on the
+   * instruction set flags
+   */
+  typedef Eigen::Matrix<double, 12, 12, Eigen::DontAlign> Matrix12d;
+
+  /** \brief Constructor from the joint covariance */
+  TransformationPairWithCovariance(const Transformation& T_1,
+                                   const Transformation& T_2,
+                                   const Matrix12d& covariance);
+
+  /**
+   * \brief Constructor from the covariances of each pose and the
+   * cross-covariance cov_12 = E[xi_1 * xi_2^T]
+   * \throws std::logic_error If a pose has no covariance
+   */
+  TransformationPairWithCovariance(
+      const TransformationWithCovariance& T_1,
+      const TransformationWithCovariance& T_2,
+      const Eigen::Matrix<double, 6, 6>& crossCovariance);
+
+  /** \brief Gets the first pose, with its marginal covariance */
+  TransformationWithCovariance first() const;
+
+  /** \brief Gets the second pose, with its marginal covariance */
+  TransformationWithCovariance second() const;
+
+  /** \brief Gets the joint covariance */
+  const Matrix12d& cov() const { return covariance_; }
+
+  /**
+   * \brief Gets T_1 * T_2, with covariance
+   * cov_11 + Ad(T_1) * cov_22 * Ad(T_1)^T + cov_12 * Ad(T_1)^T +
+   * Ad(T_1) * cov_21
+   */
+  TransformationWithCovariance compose() const;
+
+  /**
+   * \brief Gets the relative pose T_1 * T_2^-1, as
+   * TransformationWithCovariance::operator/ and relativePosesBatch, with
+   * covariance cov_11 + Ad(T) * cov_22 * Ad(T)^T - cov_12 * Ad(T)^T -
+   * Ad(T) * cov_21, T = T_1 * T_2^-1
+   */
+  TransformationWithCovariance relative() const;
+
+  /** \brief Gets the pair T_1^-1, T_2^-1 with their joint covariance */
+  TransformationPairWithCovariance inverse() const;
+
+ private:
+  /** \brief The first pose */
+  Transformation T_1_;
+
+  /** \brief The second pose */
+  Transformation T_2_;
+
+  /** \brief The joint covariance */
+  Matrix12d covariance_;
+};
+
+}  // namespace se3
+}  // namespace lgmath
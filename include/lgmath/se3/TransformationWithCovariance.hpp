@@ -21,6 +21,12 @@ namespace se3 {
 
 class TransformationWithCovariance : public Transformation {
  public:
+  /**
+   * \brief The covariance, unaligned as Transformation::Matrix34d, so that
+   * the layout does not depend on the instruction set flags
+   */
+  typedef Eigen::Matrix<double, 6, 6, Eigen::DontAlign> Matrix6d;
+
   /** \brief Default constructor */
   TransformationWithCovariance(bool initCovarianceToZero = false);
 
@@ -123,7 +129,7 @@ class TransformationWithCovariance : public Transformation {
   TransformationWithCovariance& operator=(Transformation&& T) noexcept override;
 
   /** \brief Gets the underlying covariance matrix */
-  const Eigen::Matrix<double, 6, 6>& cov() const;
+  const Matrix6d& cov() const;
 
   /** \brief Returns whether or not a covariance has been set. */
   bool covarianceSet() const;
@@ -162,7 +168,7 @@ class TransformationWithCovariance : public Transformation {
 
  private:
   /** \brief Covariance */
-  Eigen::Matrix<double, 6, 6> covariance_;
+  Matrix6d covariance_;
 
   /** \brief Covariance flag */
   bool covarianceSet_;
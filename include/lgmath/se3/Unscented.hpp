@@ -0,0 +1,81 @@
+/**
+ * \file Unscented.hpp
+ * \brief Header file for the unscented transform through SE3 operations.
+ * \details The linearized propagation of TransformationWithCovariance
+ * degrades as the rotational uncertainty grows. These functions propagate the
+ * left perturbations xi ~ N(0, cov()) through an operation by 2n + 1 sigma
+ * points instead, n the dimension of the input perturbations: the mean and
+ * the columns +-sqrt(n + lambda) * L of a factor L * L^T of the covariance,
+ * lambda = alpha^2 * (n + kappa) - n. The covariance is factored once, the
+ * sigma poses exp(xi_i^) * T are built and recombined with the batch
+ * exponential and logarithmic maps of PoseArray, and the output mean is the
+ * weighted Karcher mean of the images, started from the image of the mean.
+ *
+ * The gain over the linearized propagation is in nonlinear functions of the
+ * pose, e.g. T * T or interpolation. Composition and inversion of the left
+ * perturbations are exact for each sigma point, exp(xi^) * T_1 * T_2 =
+ * exp(xi^) * (T_1 * T_2) and T_1 * exp(xi^) * T_2 = exp((Ad(T_1) * xi)^) *
+ * T_1 * T_2, so that unscentedCompose and unscentedInverse agree with
+ * TransformationWithCovariance, and are mostly references for it; the
+ * fourth-order terms of the product of two independent perturbations are
+ * beyond 2n + 1 sigma points.
+ *
+ * \author ASRL
+ */
+#pragma once
+
+#include <functional>
+
+#include <lgmath/se3/TransformationWithCovariance.hpp>
+
+namespace lgmath {
+namespace se3 {
+
+/** \brief The parameters of the sigma points */
+struct UnscentedOptions {
+  /** \brief Spread of the sigma points about the mean */
+  double alpha = 1.0;
+
+  /** \brief Prior knowledge of the distribution, 2 for Gaussians */
+  double beta = 2.0;
+
+  /** \brief Secondary scaling */
+  double kappa = 0.0;
+
+  /** \brief Most Gauss-Newton iterations of the output mean */
+  unsigned int maxIterations = 10;
+};
+
+/**
+ * \brief Propagates T through a function of the pose
+ * \param[in] T The input pose and covariance
+ * \param[in] f The function, called once per sigma point
+ * \param[in] options The sigma points
+ * \throws std::logic_error If T has no covariance
+ * \throws std::invalid_argument If the covariance is not positive
+ * semi-definite, or n + lambda is not positive
+ */
+TransformationWithCovariance unscentedTransform(
+    const TransformationWithCovariance& T,
+    const std::function<Transformation(const Transformation&)>& f,
+    const UnscentedOptions& options = UnscentedOptions());
+
+/**
+ * \brief Propagates T_lhs * T_rhs, the poses independent, as
+ * TransformationWithCovariance::operator* does to first order
+ */
+TransformationWithCovariance unscentedCompose(
+    const TransformationWithCovariance& T_lhs,
+    const TransformationWithCovariance& T_rhs,
+    const UnscentedOptions& options = UnscentedOptions());
+
+/**
+ * \brief Propagates T^-1, as TransformationWithCovariance::inverse does to
+ * first order
+ */
+TransformationWithCovariance unscentedInverse(
+    const TransformationWithCovariance& T,
+    const UnscentedOptions& options = UnscentedOptions());
+
+}  // namespace se3
+}  // namespace lgmath
@@ -0,0 +1,64 @@
+/**
+ * \file Mean.hpp
+ * \brief Header file for the weighted means of rotations.
+ * \details The Karcher (Frechet) mean minimizes the weighted sum of the
+ * squared geodesic distances, sum_i w_i * |log(C_i * C^T)|^2; it is found by
+ * Gauss-Newton iterations C <- exp(delta^) * C, with delta the weighted mean
+ * of the log(C_i * C^T), started from the chordal mean. The chordal mean
+ * minimizes the Frobenius distances instead, in closed form: the weighted
+ * sum of the matrices projected back onto SO3. It is close to the Karcher
+ * mean when the rotations are close to each other.
+ *
+ * The sums over the rotations are split by an execution policy into fixed
+ * blocks, so that the mean is bitwise the same on any executor.
+ *
+ * \author ASRL
+ */
+#pragma once
+
+#include <vector>
+
+#include <Eigen/Core>
+
+#include <lgmath/so3/Rotation.hpp>
+
+namespace lgmath {
+namespace common {
+class ExecutionPolicy;
+}  // namespace common
+
+namespace so3 {
+
+/** \brief How to average */
+enum class MeanMethod {
+  /** \brief The geodesic (Karcher) mean, iterative */
+  KARCHER,
+  /** \brief The chordal mean, in closed form */
+  CHORDAL,
+};
+
+/**
+ * \brief Weighted mean of rotations
+ * \param[in] rotations The rotations
+ * \param[in] weights One non-negative weight per rotation, or empty for equal
+ * weights
+ * \param[in] method The mean
+ * \param[out] spread If not null, the weighted covariance of the
+ * log(C_i * C^T) about the mean C
+ * \throws std::invalid_argument If there are no rotations, the weights do not
+ * match them or are negative, or their sum is not positive
+ */
+Rotation mean(const std::vector<Rotation>& rotations,
+              const std::vector<double>& weights = {},
+              MeanMethod method = MeanMethod::KARCHER,
+              Eigen::Matrix3d* spread = nullptr);
+
+/** \brief mean, with the sums split by a policy */
+Rotation mean(const common::ExecutionPolicy& policy,
+              const std::vector<Rotation>& rotations,
+              const std::vector<double>& weights = {},
+              MeanMethod method = MeanMethod::KARCHER,
+              Eigen::Matrix3d* spread = nullptr);
+
+}  // namespace so3
+}  // namespace lgmath
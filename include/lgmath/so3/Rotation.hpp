@@ -27,6 +27,13 @@ class Rotation {
   /** \brief Copy constructor (from Eigen) */
   explicit Rotation(const Eigen::Matrix3d& C);
 
+  /**
+   * \brief Copy constructor (from Eigen), with optional reprojection.
+   * \param[in] reproj Setting reproj to false skips the reprojection onto
+   * SO(3); only do this if C is already known to be a valid rotation.
+   */
+  explicit Rotation(const Eigen::Matrix3d& C, bool reproj);
+
   /** \brief Constructor. The rotation will be C_ba = vec2rot(aaxis_ab) */
   explicit Rotation(const Eigen::Vector3d& aaxis_ab, unsigned int numTerms = 0);
 
@@ -0,0 +1,112 @@
+/**
+ * \file RotationMap.hpp
+ * \brief Header file for rotation views over external buffers.
+ * \details A ConstRotationMap reads a rotation in place from a buffer of
+ * doubles in one of the layouts below, and a RotationMap also writes it, so
+ * that rotations held in messages or arrays can be used without first copying
+ * them into a Rotation. The buffer must outlive the map.
+ *
+ * \author ASRL
+ */
+#pragma once
+
+#include <Eigen/Dense>
+
+#include <lgmath/so3/Rotation.hpp>
+
+namespace lgmath {
+namespace so3 {
+
+/** \brief Layouts of a rotation C_ba in a buffer of doubles */
+enum class RotationLayout {
+  /** \brief C_ba in row-major order, 9 doubles */
+  ROW_MAJOR_3X3,
+  /** \brief C_ba in column-major order (as Eigen::Matrix3d), 9 doubles */
+  COL_MAJOR_3X3,
+  /** \brief The unit quaternion of C_ba as (x, y, z, w), 4 doubles */
+  QUATERNION,
+  /** \brief The axis-angle vector aaxis_ab, C_ba = vec2rot(aaxis_ab) */
+  VECTOR3
+};
+
+/** \brief Gets the number of doubles of a rotation layout */
+int rotationLayoutSize(RotationLayout layout);
+
+/** \brief Read-only view of a rotation stored in an external buffer */
+class ConstRotationMap {
+ public:
+  /** \brief Constructor, throws std::invalid_argument if data is null */
+  ConstRotationMap(const double* data, RotationLayout layout);
+
+  /** \brief Gets the buffer */
+  const double* data() const { return data_; }
+
+  /** \brief Gets the layout of the buffer */
+  RotationLayout layout() const { return layout_; }
+
+  /**
+   * \brief Gets the rotation matrix; quaternions are normalized first, and
+   * axis-angle vectors go through the exponential map
+   */
+  Eigen::Matrix3d matrix() const;
+
+  /** \brief Get the corresponding Lie algebra using the logarithmic map */
+  Eigen::Vector3d vec() const;
+
+  /** \brief Copies the rotation into a Rotation, without reprojection */
+  Rotation rotation() const;
+
+  /** \brief Get the inverse (transpose) rotation */
+  Rotation inverse() const;
+
+  /**
+   * \brief Right-hand side multiply C_rhs, reprojecting like Rotation; use
+   * compose() to write the product to a buffer without a Rotation
+   */
+  Rotation operator*(const ConstRotationMap& C_rhs) const;
+
+  /** \brief Right-hand side multiply C_rhs, reprojecting like Rotation */
+  Rotation operator*(const Rotation& C_rhs) const;
+
+  /** \brief Right-hand side multiply the point vector p_a */
+  Eigen::Vector3d operator*(const Eigen::Ref<const Eigen::Vector3d>& p_a) const;
+
+ protected:
+  /** \brief The buffer, written through by RotationMap */
+  const double* data_;
+
+  /** \brief The layout of the buffer */
+  RotationLayout layout_;
+};
+
+/** \brief Read-write view of a rotation stored in an external buffer */
+class RotationMap : public ConstRotationMap {
+ public:
+  /** \brief Constructor, throws std::invalid_argument if data is null */
+  RotationMap(double* data, RotationLayout layout);
+
+  /** \brief Gets the buffer */
+  double* data() const { return const_cast<double*>(data_); }
+
+  /** \brief Writes the rotation matrix C_ba in the layout of the buffer */
+  void assign(const Eigen::Matrix3d& C_ba);
+
+  /** \brief Writes C in the layout of the buffer */
+  RotationMap& operator=(const Rotation& C);
+
+  /** \brief Writes C, possibly of another layout, into the buffer */
+  RotationMap& operator=(const ConstRotationMap& C);
+
+  /** \brief Writes C, possibly of another layout, into the buffer */
+  RotationMap& operator=(const RotationMap& C);
+};
+
+/**
+ * \brief Composes two mapped rotations into a third, C_out = C_lhs * C_rhs; the
+ * product is not reprojected, and out may alias lhs or rhs
+ */
+void compose(const ConstRotationMap& C_lhs, const ConstRotationMap& C_rhs,
+             RotationMap* C_out);
+
+}  // namespace so3
+}  // namespace lgmath
@@ -0,0 +1,245 @@
+/**
+ * \file Counters.cpp
+ * \brief Implementation file for the opt-in branch and operation counters.
+ *
+ * \author ASRL
+ */
+#include <lgmath/Counters.hpp>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace lgmath {
+namespace common {
+
+const char* counterName(Counter counter) {
+  switch (counter) {
+    case Counter::SO3_VEC2ROT:
+      return "so3/vec2rot";
+    case Counter::SO3_VEC2ROT_SMALL_ANGLE:
+      return "so3/vec2rot/small_angle";
+    case Counter::SO3_VEC2ROT_SERIES:
+      return "so3/vec2rot/series";
+    case Counter::SO3_ROT2VEC:
+      return "so3/rot2vec";
+    case Counter::SO3_ROT2VEC_NEAR_PI:
+      return "so3/rot2vec/near_pi";
+    case Counter::SO3_ROT2VEC_NEAR_ZERO:
+      return "so3/rot2vec/near_zero";
+    case Counter::SO3_VEC2JAC:
+      return "so3/vec2jac";
+    case Counter::SO3_VEC2JAC_SMALL_ANGLE:
+      return "so3/vec2jac/small_angle";
+    case Counter::SO3_VEC2JAC_SERIES:
+      return "so3/vec2jac/series";
+    case Counter::SO3_VEC2JACINV:
+      return "so3/vec2jacinv";
+    case Counter::SO3_VEC2JACINV_SMALL_ANGLE:
+      return "so3/vec2jacinv/small_angle";
+    case Counter::SO3_VEC2JACINV_SERIES:
+      return "so3/vec2jacinv/series";
+    case Counter::SE3_VEC2TRAN:
+      return "se3/vec2tran";
+    case Counter::SE3_VEC2TRAN_SMALL_ANGLE:
+      return "se3/vec2tran/small_angle";
+    case Counter::SE3_VEC2TRAN_SERIES:
+      return "se3/vec2tran/series";
+    case Counter::SE3_TRAN2VEC:
+      return "se3/tran2vec";
+    case Counter::SE3_TRANAD:
+      return "se3/tranAd";
+    case Counter::SE3_VEC2Q:
+      return "se3/vec2Q";
+    case Counter::SE3_VEC2JAC:
+      return "se3/vec2jac";
+    case Counter::SE3_VEC2JAC_SMALL_ANGLE:
+      return "se3/vec2jac/small_angle";
+    case Counter::SE3_VEC2JAC_SERIES:
+      return "se3/vec2jac/series";
+    case Counter::SE3_VEC2JACINV:
+      return "se3/vec2jacinv";
+    case Counter::SE3_VEC2JACINV_SMALL_ANGLE:
+      return "se3/vec2jacinv/small_angle";
+    case Counter::SE3_VEC2JACINV_SERIES:
+      return "se3/vec2jacinv/series";
+    case Counter::ROTATION_REPROJECT:
+      return "Rotation/reproject";
+    case Counter::ROTATION_REPROJECT_APPLIED:
+      return "Rotation/reproject/applied";
+    case Counter::ROTATION_INVERSE:
+      return "Rotation/inverse";
+    case Counter::ROTATION_COMPOSE:
+      return "Rotation/operator*=";
+    case Counter::ROTATION_COMPOSE_INVERSE:
+      return "Rotation/operator/=";
+    case Counter::TRANSFORMATION_REPROJECT:
+      return "Transformation/reproject";
+    case Counter::TRANSFORMATION_INVERSE:
+      return "Transformation/inverse";
+    case Counter::TRANSFORMATION_COMPOSE:
+      return "Transformation/operator*=";
+    case Counter::TRANSFORMATION_COMPOSE_INVERSE:
+      return "Transformation/operator/=";
+    case Counter::TRANSFORMATION_WITH_COVARIANCE_INVERSE:
+      return "TransformationWithCovariance/inverse";
+    case Counter::TRANSFORMATION_WITH_COVARIANCE_COMPOSE:
+      return "TransformationWithCovariance/operator*=";
+    case Counter::TRANSFORMATION_WITH_COVARIANCE_COMPOSE_INVERSE:
+      return "TransformationWithCovariance/operator/=";
+    case Counter::TRANSFORMATION_WITH_COVARIANCE_COVARIANCE_UNSET:
+      return "TransformationWithCovariance/covariance_unset";
+    case Counter::CACHED_TRANSFORMATION_VEC_HIT:
+      return "CachedTransformation/vec/hit";
+    case Counter::CACHED_TRANSFORMATION_VEC_MISS:
+      return "CachedTransformation/vec/miss";
+    case Counter::CACHED_TRANSFORMATION_ADJOINT_HIT:
+      return "CachedTransformation/adjoint/hit";
+    case Counter::CACHED_TRANSFORMATION_ADJOINT_MISS:
+      return "CachedTransformation/adjoint/miss";
+    case Counter::NUM_COUNTERS:
+      break;
+  }
+  return "";
+}
+
+CounterValues counterDifference(const CounterValues& after,
+                                const CounterValues& before) {
+  CounterValues result;
+  for (std::size_t i = 0; i < NUM_COUNTERS; ++i) {
+    result[i] = after[i] - before[i];
+  }
+  return result;
+}
+
+void printCounters(std::ostream& out, const CounterValues& values) {
+  for (std::size_t i = 0; i < NUM_COUNTERS; ++i) {
+    if (values[i] > 0) {
+      out << counterName(Counter(i)) << ": " << values[i] << std::endl;
+    }
+  }
+}
+
+#ifdef LGMATH_ENABLE_COUNTERS
+
+namespace {
+
+/**
+ * \brief Counters of one thread. Only the owning thread increments them, so
+ * a relaxed load and store suffice; the atomics only make the concurrent
+ * snapshots well defined.
+ */
+typedef std::array<std::atomic<std::uint64_t>, NUM_COUNTERS> ThreadCounters;
+
+/**
+ * \brief Owns the counters of every thread. Blocks are never freed, so that
+ * the counts of exited threads remain in the snapshots; there is one block
+ * per thread that ever counted.
+ */
+class CounterRegistry {
+ public:
+  static CounterRegistry& instance() {
+    static CounterRegistry registry;
+    return registry;
+  }
+
+  ThreadCounters* create() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    blocks_.emplace_back(new ThreadCounters());
+    for (auto& value : *blocks_.back()) {
+      value.store(0, std::memory_order_relaxed);
+    }
+    return blocks_.back().get();
+  }
+
+  CounterValues sum() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CounterValues values;
+    values.fill(0);
+    for (const auto& block : blocks_) {
+      for (std::size_t i = 0; i < NUM_COUNTERS; ++i) {
+        values[i] += (*block)[i].load(std::memory_order_relaxed);
+      }
+    }
+    return values;
+  }
+
+  void reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& block : blocks_) {
+      for (auto& value : *block) {
+        value.store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+
+ private:
+  CounterRegistry() = default;
+
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<ThreadCounters>> blocks_;
+};
+
+/** \brief Gets the counters of the calling thread, created on first use */
+ThreadCounters& threadCounters() {
+  static thread_local ThreadCounters* counters =
+      CounterRegistry::instance().create();
+  return *counters;
+}
+
+}  // namespace
+
+namespace detail {
+
+void incrementCounter(Counter counter) {
+  std::atomic<std::uint64_t>& value = threadCounters()[std::size_t(counter)];
+  value.store(value.load(std::memory_order_relaxed) + 1,
+              std::memory_order_relaxed);
+}
+
+}  // namespace detail
+
+CounterValues counterSnapshot() {
+  const ThreadCounters& counters = threadCounters();
+  CounterValues values;
+  for (std::size_t i = 0; i < NUM_COUNTERS; ++i) {
+    values[i] = counters[i].load(std::memory_order_relaxed);
+  }
+  return values;
+}
+
+CounterValues counterSnapshotAll() { return CounterRegistry::instance().sum(); }
+
+void resetCounters() {
+  for (auto& value : threadCounters()) {
+    value.store(0, std::memory_order_relaxed);
+  }
+}
+
+void resetAllCounters() { CounterRegistry::instance().reset(); }
+
+#else
+
+namespace detail {
+
+void incrementCounter(Counter) {}
+
+}  // namespace detail
+
+CounterValues counterSnapshot() {
+  CounterValues values;
+  values.fill(0);
+  return values;
+}
+
+CounterValues counterSnapshotAll() { return counterSnapshot(); }
+
+void resetCounters() {}
+
+void resetAllCounters() {}
+
+#endif
+
+}  // namespace common
+}  // namespace lgmath
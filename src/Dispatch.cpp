@@ -0,0 +1,133 @@
+/**
+ * \file Dispatch.cpp
+ * \brief Implementation file for the runtime selection of the instruction set
+ * of the batch kernels.
+ *
+ * \author ASRL
+ */
+#include <lgmath/Dispatch.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "se3/BatchKernels.hpp"
+
+namespace lgmath {
+namespace common {
+
+namespace {
+
+/** \brief Returns whether the running CPU supports an instruction set */
+bool cpuSupports(Isa isa) {
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+  __builtin_cpu_init();
+  switch (isa) {
+    case Isa::GENERIC:
+      return true;
+    case Isa::SSE4_2:
+      return __builtin_cpu_supports("sse4.2");
+    case Isa::AVX2:
+      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    case Isa::AVX512:
+      return __builtin_cpu_supports("avx512f") &&
+             __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  }
+  return false;
+#else
+  return isa == Isa::GENERIC;
+#endif
+}
+
+/** \brief Returns whether the kernels of an instruction set were built */
+bool kernelsBuilt(Isa isa) {
+  switch (isa) {
+    case Isa::GENERIC:
+      return se3::detail::genericBatchKernels() != nullptr;
+    case Isa::SSE4_2:
+      return se3::detail::sse42BatchKernels() != nullptr;
+    case Isa::AVX2:
+      return se3::detail::avx2BatchKernels() != nullptr;
+    case Isa::AVX512:
+      return se3::detail::avx512BatchKernels() != nullptr;
+  }
+  return false;
+}
+
+/** \brief The active instruction set, initialized on first use */
+std::atomic<int>& activeIsaStorage() {
+  static std::atomic<int> active(static_cast<int>(detectIsa()));
+  return active;
+}
+
+}  // namespace
+
+const char* isaName(Isa isa) {
+  switch (isa) {
+    case Isa::GENERIC:
+      return "generic";
+    case Isa::SSE4_2:
+      return "sse4.2";
+    case Isa::AVX2:
+      return "avx2";
+    case Isa::AVX512:
+      return "avx512";
+  }
+  return "";
+}
+
+Isa parseIsa(const std::string& name) {
+  for (Isa isa : {Isa::GENERIC, Isa::SSE4_2, Isa::AVX2, Isa::AVX512}) {
+    if (name == isaName(isa)) {
+      return isa;
+    }
+  }
+  throw std::invalid_argument("Unknown instruction set '" + name +
+                              "', expected generic, sse4.2, avx2 or avx512");
+}
+
+bool isaSupported(Isa isa) { return kernelsBuilt(isa) && cpuSupports(isa); }
+
+std::vector<Isa> supportedIsas() {
+  std::vector<Isa> isas;
+  for (Isa isa : {Isa::GENERIC, Isa::SSE4_2, Isa::AVX2, Isa::AVX512}) {
+    if (isaSupported(isa)) {
+      isas.push_back(isa);
+    }
+  }
+  return isas;
+}
+
+Isa detectIsa() {
+  Isa cap = Isa::AVX512;
+  const char* env = std::getenv("LGMATH_ISA");
+  if (env != nullptr) {
+    try {
+      cap = parseIsa(env);
+    } catch (const std::invalid_argument&) {
+      // An unknown name does not cap the selection
+    }
+  }
+  Isa best = Isa::GENERIC;
+  for (Isa isa : supportedIsas()) {
+    if (int(isa) <= int(cap)) {
+      best = isa;
+    }
+  }
+  return best;
+}
+
+Isa activeIsa() {
+  return Isa(activeIsaStorage().load(std::memory_order_relaxed));
+}
+
+void setIsa(Isa isa) {
+  if (!isaSupported(isa)) {
+    throw std::invalid_argument(std::string("Instruction set ") +
+                                isaName(isa) + " is not supported");
+  }
+  activeIsaStorage().store(int(isa), std::memory_order_relaxed);
+}
+
+}  // namespace common
+}  // namespace lgmath
@@ -0,0 +1,224 @@
+/**
+ * \file Parallel.cpp
+ * \brief Implementation file for the executors and execution policies of the
+ * batch functions.
+ *
+ * \author ASRL
+ */
+#include <lgmath/Parallel.hpp>
+
+#include <algorithm>
+
+namespace lgmath {
+namespace common {
+
+namespace {
+
+/** \brief Number of elements per chunk; the tasks are whole chunks */
+const std::size_t CHUNK = 64;
+
+/** \brief Number of tasks per thread with dynamic chunking */
+const std::size_t TASKS_PER_THREAD = 4;
+
+}  // namespace
+
+void SerialExecutor::run(std::size_t numTasks,
+                         const std::function<void(std::size_t)>& task) {
+  for (std::size_t i = 0; i < numTasks; ++i) {
+    task(i);
+  }
+}
+
+ThreadPool::ThreadPool(std::size_t numThreads) : pending_(0), stop_(false) {
+  if (numThreads == 0) {
+    numThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  for (std::size_t w = 1; w < numThreads; ++w) {
+    queues_.emplace_back(new Queue);
+  }
+  try {
+    for (std::size_t w = 0; w < queues_.size(); ++w) {
+      workers_.emplace_back(&ThreadPool::work, this, w);
+    }
+  } catch (...) {
+    {
+      std::lock_guard<std::mutex> lock(wakeMutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+    throw;
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(wakeMutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPool::run(std::size_t numTasks,
+                     const std::function<void(std::size_t)>& task) {
+  if (numTasks <= 1 || queues_.empty()) {
+    SerialExecutor().run(numTasks, task);
+    return;
+  }
+
+  Batch batch;
+  batch.task = &task;
+  batch.remaining = numTasks;
+
+  // Deal contiguous blocks of tasks to the queues; the tasks are counted under
+  // the same lock, so that a worker taking one never sees a negative count
+  {
+    std::lock_guard<std::mutex> lock(wakeMutex_);
+    const std::size_t numQueues = queues_.size();
+    for (std::size_t q = 0; q < numQueues; ++q) {
+      std::lock_guard<std::mutex> queueLock(queues_[q]->mutex);
+      for (std::size_t i = q * numTasks / numQueues;
+           i < (q + 1) * numTasks / numQueues; ++i) {
+        queues_[q]->tasks.push_back(Task{&batch, i});
+      }
+    }
+    pending_ += numTasks;
+  }
+  wake_.notify_all();
+
+  // Help with any queued task until the batch is done; once the queues are
+  // empty, the remaining tasks of the batch are running on other threads
+  Task next;
+  while (take(0, &next)) {
+    execute(next);
+    std::lock_guard<std::mutex> lock(batch.mutex);
+    if (batch.remaining == 0) {
+      break;
+    }
+  }
+  std::unique_lock<std::mutex> lock(batch.mutex);
+  batch.done.wait(lock, [&batch] { return batch.remaining == 0; });
+  if (batch.error) {
+    std::rethrow_exception(batch.error);
+  }
+}
+
+void ThreadPool::work(std::size_t w) {
+  Task next;
+  for (;;) {
+    if (take(w, &next)) {
+      execute(next);
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(wakeMutex_);
+    wake_.wait(lock, [this] { return stop_ || pending_ > 0; });
+    if (stop_ && pending_ == 0) {
+      return;
+    }
+  }
+}
+
+bool ThreadPool::take(std::size_t first, Task* task) {
+  const std::size_t numQueues = queues_.size();
+  bool found = false;
+  for (std::size_t k = 0; k < numQueues && !found; ++k) {
+    Queue& queue = *queues_[(first + k) % numQueues];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+      continue;
+    }
+    // The owner takes from the front, thieves from the back of a block
+    if (k == 0) {
+      *task = queue.tasks.front();
+      queue.tasks.pop_front();
+    } else {
+      *task = queue.tasks.back();
+      queue.tasks.pop_back();
+    }
+    found = true;
+  }
+  if (found) {
+    std::lock_guard<std::mutex> lock(wakeMutex_);
+    --pending_;
+  }
+  return found;
+}
+
+void ThreadPool::execute(const Task& task) {
+  Batch& batch = *task.batch;
+  bool failed;
+  {
+    std::lock_guard<std::mutex> lock(batch.mutex);
+    failed = static_cast<bool>(batch.error);
+  }
+  if (!failed) {
+    try {
+      (*batch.task)(task.index);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(batch.mutex);
+      if (!batch.error) {
+        batch.error = std::current_exception();
+      }
+    }
+  }
+  // The batch lives on the stack of the thread in run(), which may return as
+  // soon as the mutex is released
+  std::lock_guard<std::mutex> lock(batch.mutex);
+  if (--batch.remaining == 0) {
+    batch.done.notify_all();
+  }
+}
+
+Executor& serialExecutor() {
+  static SerialExecutor executor;
+  return executor;
+}
+
+Executor& defaultExecutor() {
+  static ThreadPool pool;
+  return pool;
+}
+
+ExecutionPolicy::ExecutionPolicy() : ExecutionPolicy(defaultExecutor()) {}
+
+ExecutionPolicy::ExecutionPolicy(Executor& executor, Chunking chunking,
+                                 std::size_t grainSize)
+    : executor_(&executor), chunking_(chunking), grainSize_(grainSize) {}
+
+ExecutionPolicy ExecutionPolicy::sequential() {
+  return ExecutionPolicy(serialExecutor());
+}
+
+ExecutionPolicy ExecutionPolicy::parallel() { return ExecutionPolicy(); }
+
+void ExecutionPolicy::forEachRange(
+    std::size_t n, std::size_t defaultGrain,
+    const std::function<void(std::size_t, std::size_t)>& f) const {
+  if (n == 0) {
+    return;
+  }
+  std::size_t range = grainSize_ > 0 ? grainSize_ : defaultGrain;
+  if (chunking_ == Chunking::DYNAMIC) {
+    const std::size_t concurrency = executor_->concurrency();
+    if (concurrency <= 1) {
+      f(0, n);
+      return;
+    }
+    const std::size_t numTasks = TASKS_PER_THREAD * concurrency;
+    range = std::max(range, (n + numTasks - 1) / numTasks);
+  }
+  range = std::max<std::size_t>(1, (range + CHUNK - 1) / CHUNK) * CHUNK;
+
+  const std::size_t numTasks = (n + range - 1) / range;
+  executor_->run(numTasks, [&](std::size_t t) {
+    f(t * range, std::min(n, (t + 1) * range));
+  });
+}
+
+}  // namespace common
+}  // namespace lgmath
@@ -0,0 +1,59 @@
+/**
+ * \file Reduction.hpp
+ * \brief Private header of the deterministic parallel sums.
+ * \details The elements are summed in fixed blocks, whose sums are then added
+ * in block order. The blocks only depend on the number of elements, so that
+ * the result is bitwise the same with any execution policy, unlike sums over
+ * the ranges of the policy.
+ *
+ * \author ASRL
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include <lgmath/Parallel.hpp>
+
+namespace lgmath {
+namespace common {
+namespace detail {
+
+/** \brief Number of elements per block */
+const std::size_t REDUCE_BLOCK = 16;
+
+/** \brief Default grain size of the execution policies, in blocks */
+const std::size_t REDUCE_GRAIN = 64;
+
+/**
+ * \brief Sums f(i) over [0, n)
+ * \param[in] policy Splits the blocks
+ * \param[in] n Number of elements
+ * \param[in] zero The zero of the sum, e.g. for its size
+ * \param[in] f The terms, called concurrently
+ */
+template <typename T, typename F>
+T reduce(const ExecutionPolicy& policy, std::size_t n, const T& zero,
+         const F& f) {
+  const std::size_t numBlocks = (n + REDUCE_BLOCK - 1) / REDUCE_BLOCK;
+  std::vector<T> sums(numBlocks, zero);
+  policy.forEachRange(numBlocks, REDUCE_GRAIN, [&](std::size_t begin,
+                                                   std::size_t end) {
+    for (std::size_t b = begin; b < end; ++b) {
+      const std::size_t last = std::min(n, (b + 1) * REDUCE_BLOCK);
+      for (std::size_t i = b * REDUCE_BLOCK; i < last; ++i) {
+        sums[b] += f(i);
+      }
+    }
+  });
+  T total = zero;
+  for (const T& sum : sums) {
+    total += sum;
+  }
+  return total;
+}
+
+}  // namespace detail
+}  // namespace common
+}  // namespace lgmath
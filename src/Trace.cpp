@@ -0,0 +1,280 @@
+/**
+ * \file Trace.cpp
+ * \brief Implementation file for the tracing of lgmath batch operations.
+ *
+ * \author ASRL
+ */
+#include <lgmath/Trace.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace lgmath {
+namespace common {
+
+namespace detail {
+
+std::atomic<bool> tracingEnabled(false);
+
+}  // namespace detail
+
+namespace {
+
+/**
+ * \brief Ring buffer of the events of one thread. Only the owning thread
+ * writes events; head is published with release semantics so that an export
+ * sees every event before it.
+ */
+struct TraceBuffer {
+  explicit TraceBuffer(std::size_t tid) : tid(tid), owned(true), head(0) {}
+
+  /** \brief Sequential thread id in the exported trace */
+  const std::size_t tid;
+
+  /** \brief Thread name, guarded by the registry mutex */
+  std::string name;
+
+  /** \brief Whether a live thread owns the buffer, guarded by the mutex */
+  bool owned;
+
+  /**
+   * \brief Events, indexed by sequence number modulo the capacity; allocated
+   * by the first event, and resized only under the registry mutex
+   */
+  std::vector<TraceEvent> events;
+
+  /** \brief Number of events ever recorded */
+  std::atomic<std::uint64_t> head;
+};
+
+/**
+ * \brief Owns the buffers of every thread. The buffer of an exited thread
+ * keeps its events for export until clearTrace() frees them; a buffer
+ * without events is reused by the next new thread, so threads that never
+ * record while tracing is enabled hold no events.
+ */
+class TraceRegistry {
+ public:
+  static TraceRegistry& instance() {
+    static TraceRegistry registry;
+    return registry;
+  }
+
+  /** \brief Gets an empty buffer of an exited thread, or a new one */
+  TraceBuffer* acquire() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& buffer : buffers) {
+      if (!buffer->owned && buffer->events.empty()) {
+        buffer->owned = true;
+        buffer->name.clear();
+        return buffer.get();
+      }
+    }
+    buffers.emplace_back(new TraceBuffer(buffers.size() + 1));
+    return buffers.back().get();
+  }
+
+  /** \brief Returns the buffer of an exiting thread, freed if it is empty */
+  void release(TraceBuffer* buffer) {
+    std::lock_guard<std::mutex> lock(mutex);
+    buffer->owned = false;
+    if (buffer->head.load(std::memory_order_relaxed) == 0) {
+      std::vector<TraceEvent>().swap(buffer->events);
+    }
+  }
+
+  /** \brief Allocates the events of a buffer, on its first event */
+  void allocate(TraceBuffer* buffer) {
+    std::lock_guard<std::mutex> lock(mutex);
+    buffer->events.resize(TRACE_BUFFER_CAPACITY);
+  }
+
+  /** \brief Guards buffers, the thread names and the events */
+  std::mutex mutex;
+
+  std::vector<std::unique_ptr<TraceBuffer>> buffers;
+
+  /** \brief Origin of the exported timestamps, in TscClock ticks */
+  std::atomic<std::uint64_t> origin{0};
+
+ private:
+  TraceRegistry() = default;
+};
+
+/** \brief Holds the buffer of a thread and returns it when the thread exits */
+struct ThreadBuffer {
+  ThreadBuffer() : buffer(TraceRegistry::instance().acquire()) {}
+  ~ThreadBuffer() { TraceRegistry::instance().release(buffer); }
+
+  TraceBuffer* const buffer;
+};
+
+/** \brief Gets the buffer of the calling thread, acquired on first use */
+TraceBuffer& threadBuffer() {
+  static thread_local ThreadBuffer owner;
+  return *owner.buffer;
+}
+
+/** \brief Writes a string as a JSON string literal */
+void writeJsonString(std::ostream& out, const std::string& value) {
+  out << '"';
+  for (char c : value) {
+    if (c == '"' || c == '\\') {
+      out << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c)
+          << std::dec << std::setfill(' ');
+    } else {
+      out << c;
+    }
+  }
+  out << '"';
+}
+
+/** \brief Converts a tick count relative to the origin to microseconds */
+double toMicroseconds(std::uint64_t ticks, std::uint64_t origin) {
+  const double ns = ticks >= origin ? TscClock::toNanoseconds(ticks - origin)
+                                    : -TscClock::toNanoseconds(origin - ticks);
+  return 1e-3 * ns;
+}
+
+}  // namespace
+
+namespace detail {
+
+void recordTraceEvent(const TraceEvent& event) {
+  TraceBuffer& buffer = threadBuffer();
+  if (buffer.events.empty()) {
+    TraceRegistry::instance().allocate(&buffer);
+  }
+  const std::uint64_t head = buffer.head.load(std::memory_order_relaxed);
+  buffer.events[head % TRACE_BUFFER_CAPACITY] = event;
+  buffer.head.store(head + 1, std::memory_order_release);
+}
+
+}  // namespace detail
+
+void setTracingEnabled(bool enabled) {
+  if (enabled) {
+    // Calibrate the clock now rather than in the first export
+    TscClock::nanosecondsPerTick();
+    std::uint64_t unset = 0;
+    TraceRegistry::instance().origin.compare_exchange_strong(unset,
+                                                             TscClock::now());
+  }
+  detail::tracingEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+void setTraceThreadName(const std::string& name) {
+  TraceBuffer& buffer = threadBuffer();
+  std::lock_guard<std::mutex> lock(TraceRegistry::instance().mutex);
+  buffer.name = name;
+}
+
+void clearTrace() {
+  TraceRegistry& registry = TraceRegistry::instance();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  for (auto& buffer : registry.buffers) {
+    buffer->head.store(0, std::memory_order_relaxed);
+    if (!buffer->owned) {
+      std::vector<TraceEvent>().swap(buffer->events);
+    }
+  }
+}
+
+std::size_t traceEventCount() {
+  TraceRegistry& registry = TraceRegistry::instance();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  std::size_t count = 0;
+  for (auto& buffer : registry.buffers) {
+    count +=
+        std::min<std::uint64_t>(buffer->head.load(), TRACE_BUFFER_CAPACITY);
+  }
+  return count;
+}
+
+std::size_t traceBufferBytes() {
+  TraceRegistry& registry = TraceRegistry::instance();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  std::size_t bytes = 0;
+  for (auto& buffer : registry.buffers) {
+    bytes += buffer->events.capacity() * sizeof(TraceEvent);
+  }
+  return bytes;
+}
+
+std::size_t traceEventsDropped() {
+  TraceRegistry& registry = TraceRegistry::instance();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  std::size_t dropped = 0;
+  for (auto& buffer : registry.buffers) {
+    const std::uint64_t head = buffer->head.load();
+    if (head > TRACE_BUFFER_CAPACITY) {
+      dropped += head - TRACE_BUFFER_CAPACITY;
+    }
+  }
+  return dropped;
+}
+
+void writeChromeTrace(std::ostream& out) {
+  TraceRegistry& registry = TraceRegistry::instance();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  const std::uint64_t origin = registry.origin.load();
+
+  const std::ios::fmtflags flags = out.flags();
+  const std::streamsize precision = out.precision();
+  out << std::fixed << std::setprecision(3);
+  out << "{\"traceEvents\":[";
+  bool first = true;
+  for (const auto& buffer : registry.buffers) {
+    const std::uint64_t head = buffer->head.load(std::memory_order_acquire);
+    if (head == 0 && buffer->name.empty()) {
+      continue;
+    }
+    if (!buffer->name.empty()) {
+      out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\","
+          << "\"pid\":1,\"tid\":" << buffer->tid << ",\"args\":{\"name\":";
+      writeJsonString(out, buffer->name);
+      out << "}}";
+      first = false;
+    }
+    const std::uint64_t begin =
+        head > TRACE_BUFFER_CAPACITY ? head - TRACE_BUFFER_CAPACITY : 0;
+    for (std::uint64_t i = begin; i < head; ++i) {
+      const TraceEvent& event = buffer->events[i % TRACE_BUFFER_CAPACITY];
+      out << (first ? "" : ",") << "\n{\"name\":";
+      writeJsonString(out, event.name);
+      out << ",\"cat\":\"lgmath\",\"ph\":\"X\",\"ts\":"
+          << toMicroseconds(event.begin, origin) << ",\"dur\":"
+          << 1e-3 * TscClock::toNanoseconds(event.end - event.begin)
+          << ",\"pid\":1,\"tid\":" << buffer->tid;
+      if (event.count > 0) {
+        out << ",\"args\":{\"count\":" << event.count << "}";
+      }
+      out << "}";
+      first = false;
+    }
+  }
+  out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+  out.flags(flags);
+  out.precision(precision);
+}
+
+void writeChromeTrace(const std::string& path) {
+  std::ofstream out(path);
+  if (!out) {
+    throw std::runtime_error("Could not open " + path + " for the trace");
+  }
+  writeChromeTrace(out);
+  if (!out) {
+    throw std::runtime_error("Could not write the trace to " + path);
+  }
+}
+
+}  // namespace common
+}  // namespace lgmath
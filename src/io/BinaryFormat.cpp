@@ -0,0 +1,283 @@
+/**
+ * \file BinaryFormat.cpp
+ * \brief Implementation file for the fixed-layout binary encoding of lgmath
+ * types.
+ *
+ * \author ASRL
+ */
+#include <lgmath/io/BinaryFormat.hpp>
+
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace lgmath {
+namespace io {
+
+namespace {
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+constexpr bool HOST_IS_LITTLE_ENDIAN = false;
+#else
+constexpr bool HOST_IS_LITTLE_ENDIAN = true;
+#endif
+
+/** \brief Writes count doubles as little-endian */
+void storeDoubles(const double* values, std::size_t count,
+                  unsigned char* out) {
+  if (HOST_IS_LITTLE_ENDIAN) {
+    std::memcpy(out, values, count * sizeof(double));
+    return;
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    std::uint64_t bits;
+    std::memcpy(&bits, values + i, sizeof(double));
+    for (std::size_t b = 0; b < sizeof(double); ++b) {
+      out[i * sizeof(double) + b] = (unsigned char)(bits >> (8 * b));
+    }
+  }
+}
+
+/** \brief Reads count little-endian doubles */
+void loadDoubles(const unsigned char* in, std::size_t count, double* values) {
+  if (HOST_IS_LITTLE_ENDIAN) {
+    std::memcpy(values, in, count * sizeof(double));
+    return;
+  }
+  for (std::size_t i = 0; i < count; ++i) {
+    std::uint64_t bits = 0;
+    for (std::size_t b = 0; b < sizeof(double); ++b) {
+      bits |= std::uint64_t(in[i * sizeof(double) + b]) << (8 * b);
+    }
+    std::memcpy(values + i, &bits, sizeof(double));
+  }
+}
+
+/** \brief Writes the record header */
+void storeHeader(RecordType type, std::uint8_t flags, unsigned char* out) {
+  std::memset(out, 0, RECORD_HEADER_SIZE);
+  out[0] = BINARY_FORMAT_VERSION;
+  out[1] = static_cast<std::uint8_t>(type);
+  out[2] = flags;
+}
+
+/** \brief Checks the record header and size, returns the record type */
+RecordType checkHeader(const unsigned char* buffer, std::size_t size) {
+  if (buffer == NULL) {
+    throw std::invalid_argument("Null pointer buffer in lgmath::io");
+  }
+  if (size < RECORD_HEADER_SIZE) {
+    throw std::invalid_argument("Buffer too small for an lgmath record header");
+  }
+  if (buffer[0] != BINARY_FORMAT_VERSION) {
+    throw std::invalid_argument("Unsupported lgmath binary format version");
+  }
+  const RecordType type = static_cast<RecordType>(buffer[1]);
+  std::size_t required = 0;
+  switch (type) {
+    case RecordType::ROTATION:
+      required = ROTATION_RECORD_SIZE;
+      break;
+    case RecordType::TRANSFORMATION:
+      required = TRANSFORMATION_RECORD_SIZE;
+      break;
+    case RecordType::TRANSFORMATION_WITH_COVARIANCE:
+      required = TRANSFORMATION_WITH_COVARIANCE_RECORD_SIZE;
+      break;
+    default:
+      throw std::invalid_argument("Unknown lgmath binary record type");
+  }
+  if (size < required) {
+    throw std::invalid_argument("Buffer too small for the lgmath record");
+  }
+  return type;
+}
+
+/** \brief Checks that the output buffer can hold the record */
+void checkOutput(const unsigned char* buffer, std::size_t size,
+                 std::size_t required) {
+  if (buffer == NULL) {
+    throw std::invalid_argument("Null pointer buffer in lgmath::io::encode");
+  }
+  if (size < required) {
+    throw std::invalid_argument("Buffer too small in lgmath::io::encode");
+  }
+}
+
+/** \brief Checks that the host can map the payload in place */
+void checkViewSupported() {
+  if (!HOST_IS_LITTLE_ENDIAN) {
+    throw std::runtime_error(
+        "lgmath::io views require a little-endian host, use decode instead");
+  }
+}
+
+/** \brief Writes the 3x4 row-major pose block */
+void storePose(const se3::Transformation& T, unsigned char* out) {
+  Eigen::Matrix<double, 3, 4, Eigen::RowMajor> T_ba;
+  T_ba.leftCols<3>() = T.C_ba();
+  T_ba.rightCols<1>() = T.r_ab_inb();
+  storeDoubles(T_ba.data(), 12, out);
+}
+
+/** \brief Reads the 3x4 row-major pose block */
+Eigen::Matrix4d loadPose(const unsigned char* in) {
+  Eigen::Matrix<double, 3, 4, Eigen::RowMajor> T_ba;
+  loadDoubles(in, 12, T_ba.data());
+  Eigen::Matrix4d T = Eigen::Matrix4d::Identity();
+  T.topRows<3>() = T_ba;
+  return T;
+}
+
+}  // namespace
+
+Eigen::Matrix<double, 21, 1> packCovariance(
+    const Eigen::Matrix<double, 6, 6>& covariance) {
+  Eigen::Matrix<double, 21, 1> packed;
+  int k = 0;
+  for (int i = 0; i < 6; ++i) {
+    for (int j = i; j < 6; ++j) {
+      packed(k++) = covariance(i, j);
+    }
+  }
+  return packed;
+}
+
+Eigen::Matrix<double, 6, 6> unpackCovariance(
+    const Eigen::Ref<const Eigen::Matrix<double, 21, 1>>& packed) {
+  Eigen::Matrix<double, 6, 6> covariance;
+  int k = 0;
+  for (int i = 0; i < 6; ++i) {
+    for (int j = i; j < 6; ++j) {
+      covariance(i, j) = covariance(j, i) = packed(k++);
+    }
+  }
+  return covariance;
+}
+
+std::size_t encode(const so3::Rotation& C, unsigned char* buffer,
+                   std::size_t size) {
+  checkOutput(buffer, size, ROTATION_RECORD_SIZE);
+  storeHeader(RecordType::ROTATION, 0, buffer);
+  const Eigen::Matrix<double, 3, 3, Eigen::RowMajor> C_ba = C.matrix();
+  storeDoubles(C_ba.data(), 9, buffer + RECORD_HEADER_SIZE);
+  return ROTATION_RECORD_SIZE;
+}
+
+std::size_t encode(const se3::Transformation& T, unsigned char* buffer,
+                   std::size_t size) {
+  checkOutput(buffer, size, TRANSFORMATION_RECORD_SIZE);
+  storeHeader(RecordType::TRANSFORMATION, 0, buffer);
+  storePose(T, buffer + RECORD_HEADER_SIZE);
+  return TRANSFORMATION_RECORD_SIZE;
+}
+
+std::size_t encode(const se3::TransformationWithCovariance& T,
+                   unsigned char* buffer, std::size_t size) {
+  checkOutput(buffer, size, TRANSFORMATION_WITH_COVARIANCE_RECORD_SIZE);
+  const bool covarianceSet = T.covarianceSet();
+  storeHeader(RecordType::TRANSFORMATION_WITH_COVARIANCE,
+              covarianceSet ? FLAG_COVARIANCE_SET : 0, buffer);
+  storePose(T, buffer + RECORD_HEADER_SIZE);
+  const Eigen::Matrix<double, 21, 1> packed =
+      covarianceSet ? packCovariance(T.cov())
+                    : Eigen::Matrix<double, 21, 1>::Zero().eval();
+  storeDoubles(packed.data(), PACKED_COVARIANCE_SIZE,
+               buffer + TRANSFORMATION_RECORD_SIZE);
+  return TRANSFORMATION_WITH_COVARIANCE_RECORD_SIZE;
+}
+
+so3::Rotation decodeRotation(const unsigned char* buffer, std::size_t size) {
+  if (checkHeader(buffer, size) != RecordType::ROTATION) {
+    throw std::invalid_argument("lgmath record is not a rotation");
+  }
+  Eigen::Matrix<double, 3, 3, Eigen::RowMajor> C_ba;
+  loadDoubles(buffer + RECORD_HEADER_SIZE, 9, C_ba.data());
+  return so3::Rotation(Eigen::Matrix3d(C_ba), false);
+}
+
+se3::Transformation decodeTransformation(const unsigned char* buffer,
+                                         std::size_t size) {
+  if (checkHeader(buffer, size) == RecordType::ROTATION) {
+    throw std::invalid_argument("lgmath record is not a transformation");
+  }
+  return se3::Transformation(loadPose(buffer + RECORD_HEADER_SIZE), false);
+}
+
+se3::TransformationWithCovariance decodeTransformationWithCovariance(
+    const unsigned char* buffer, std::size_t size) {
+  if (checkHeader(buffer, size) != RecordType::TRANSFORMATION_WITH_COVARIANCE) {
+    throw std::invalid_argument(
+        "lgmath record is not a transformation with covariance");
+  }
+  se3::Transformation T(loadPose(buffer + RECORD_HEADER_SIZE), false);
+  if (!(buffer[2] & FLAG_COVARIANCE_SET)) {
+    return se3::TransformationWithCovariance(std::move(T), false);
+  }
+  Eigen::Matrix<double, 21, 1> packed;
+  loadDoubles(buffer + TRANSFORMATION_RECORD_SIZE, PACKED_COVARIANCE_SIZE,
+              packed.data());
+  return se3::TransformationWithCovariance(T, unpackCovariance(packed));
+}
+
+RotationView::RotationView(const unsigned char* buffer, std::size_t size) {
+  checkViewSupported();
+  if (checkHeader(buffer, size) != RecordType::ROTATION) {
+    throw std::invalid_argument("lgmath record is not a rotation");
+  }
+  data_ = reinterpret_cast<const double*>(buffer + RECORD_HEADER_SIZE);
+}
+
+so3::Rotation RotationView::rotation() const {
+  return so3::Rotation(Eigen::Matrix3d(matrix()), false);
+}
+
+TransformationView::TransformationView(const unsigned char* buffer,
+                                       std::size_t size) {
+  checkViewSupported();
+  if (checkHeader(buffer, size) == RecordType::ROTATION) {
+    throw std::invalid_argument("lgmath record is not a transformation");
+  }
+  data_ = reinterpret_cast<const double*>(buffer + RECORD_HEADER_SIZE);
+}
+
+Eigen::Matrix4d TransformationView::matrix() const {
+  Eigen::Matrix4d T_ba = Eigen::Matrix4d::Identity();
+  T_ba.topRows<3>() = matrix34();
+  return T_ba;
+}
+
+se3::Transformation TransformationView::transformation() const {
+  return se3::Transformation(matrix(), false);
+}
+
+TransformationWithCovarianceView::TransformationWithCovarianceView(
+    const unsigned char* buffer, std::size_t size)
+    : TransformationView(buffer, size),
+      covarianceSet_(buffer[2] & FLAG_COVARIANCE_SET) {
+  if (static_cast<RecordType>(buffer[1]) !=
+      RecordType::TRANSFORMATION_WITH_COVARIANCE) {
+    throw std::invalid_argument(
+        "lgmath record is not a transformation with covariance");
+  }
+}
+
+Eigen::Matrix<double, 6, 6> TransformationWithCovarianceView::cov() const {
+  if (!covarianceSet_) {
+    throw std::logic_error(
+        "Covariance accessed before being set.  "
+        "The record was encoded without a covariance.");
+  }
+  return unpackCovariance(packedCov());
+}
+
+se3::TransformationWithCovariance
+TransformationWithCovarianceView::transformationWithCovariance() const {
+  if (!covarianceSet_) {
+    return se3::TransformationWithCovariance(transformation(), false);
+  }
+  return se3::TransformationWithCovariance(transformation(), cov());
+}
+
+}  // namespace io
+}  // namespace lgmath
@@ -0,0 +1,480 @@
+/**
+ * \file TrajectoryCodec.cpp
+ * \brief Implementation file for a lossy, Lie-algebra delta codec for
+ * trajectories.
+ *
+ * \author ASRL
+ */
+#include <lgmath/io/TrajectoryCodec.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include <lgmath/Trace.hpp>
+#include <lgmath/io/BinaryFormat.hpp>
+
+namespace lgmath {
+namespace io {
+
+namespace {
+
+/** \brief Magic bytes at the start of every compressed trajectory */
+const char CODEC_MAGIC[8] = {'L', 'G', 'M', 'C', 'O', 'D', 'E', 'C'};
+
+/** \brief Size of the block header: payload bytes and pose count */
+const std::size_t BLOCK_HEADER_SIZE = 8;
+
+/** \brief Longest unary prefix of a Rice code before the escape code */
+const unsigned int RICE_ESCAPE = 24;
+
+/** \brief Rice coder sample count at which the running sums are halved */
+const std::uint64_t RICE_RESET = 64;
+
+/** \brief Largest Rice parameter, and largest value added to the sums */
+const unsigned int RICE_MAX_PARAMETER = 40;
+const std::uint64_t RICE_MAX_SAMPLE = std::uint64_t(1) << RICE_MAX_PARAMETER;
+
+/** \brief Largest quantized increment component, well inside int64 */
+const double MAX_QUANTIZED = 1e15;
+
+void storeU32(std::uint32_t value, unsigned char* out) {
+  for (unsigned int b = 0; b < 4; ++b) {
+    out[b] = (unsigned char)(value >> (8 * b));
+  }
+}
+
+std::uint32_t loadU32(const unsigned char* in) {
+  std::uint32_t value = 0;
+  for (unsigned int b = 0; b < 4; ++b) {
+    value |= std::uint32_t(in[b]) << (8 * b);
+  }
+  return value;
+}
+
+void storeDouble(double value, unsigned char* out) {
+  std::uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  storeU32(std::uint32_t(bits), out);
+  storeU32(std::uint32_t(bits >> 32), out + 4);
+}
+
+double loadDouble(const unsigned char* in) {
+  const std::uint64_t bits =
+      std::uint64_t(loadU32(in)) | (std::uint64_t(loadU32(in + 4)) << 32);
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+/** \brief Throws if the options cannot be used to encode */
+void checkOptions(const TrajectoryCodecOptions& options) {
+  if (!(options.translationTolerance > 0.0) ||
+      !(options.rotationTolerance > 0.0) ||
+      !std::isfinite(options.translationTolerance) ||
+      !std::isfinite(options.rotationTolerance)) {
+    throw std::invalid_argument("Codec tolerances must be positive");
+  }
+  if (options.keyframeInterval == 0) {
+    throw std::invalid_argument("Codec keyframe interval must be positive");
+  }
+}
+
+/** \brief Quantization steps, so that the rounding error is the tolerance */
+Eigen::Matrix<double, 6, 1> quantizationSteps(
+    const TrajectoryCodecOptions& options) {
+  Eigen::Matrix<double, 6, 1> steps;
+  steps.head<3>().setConstant(2.0 * options.translationTolerance);
+  steps.tail<3>().setConstant(2.0 * options.rotationTolerance);
+  return steps;
+}
+
+/** \brief Parses the stream header */
+TrajectoryCodecOptions parseHeader(const unsigned char* header) {
+  if (std::memcmp(header, CODEC_MAGIC, sizeof(CODEC_MAGIC)) != 0) {
+    throw std::invalid_argument("Not an lgmath compressed trajectory");
+  }
+  if (header[8] != TRAJECTORY_CODEC_VERSION) {
+    throw std::invalid_argument(
+        "Unsupported lgmath compressed trajectory version");
+  }
+  TrajectoryCodecOptions options;
+  options.keyframeInterval = loadU32(header + 12);
+  options.translationTolerance = loadDouble(header + 16);
+  options.rotationTolerance = loadDouble(header + 24);
+  checkOptions(options);
+  return options;
+}
+
+void resetRice(detail::RiceState* rice) {
+  rice->sum.fill(4);
+  rice->count = 1;
+}
+
+/** \brief Smallest k such that count * 2^k >= sum (as in LOCO-I) */
+unsigned int riceParameter(const detail::RiceState& rice, unsigned int c) {
+  unsigned int k = 0;
+  while ((rice.count << k) < rice.sum[c] && k < RICE_MAX_PARAMETER) {
+    ++k;
+  }
+  return k;
+}
+
+void updateRice(detail::RiceState* rice, unsigned int c, std::uint64_t u) {
+  rice->sum[c] += std::min(u, RICE_MAX_SAMPLE);
+  if (c == 5 && ++rice->count == RICE_RESET) {
+    // Forget old statistics so the coder follows changes in motion
+    rice->count /= 2;
+    for (std::uint64_t& sum : rice->sum) {
+      sum /= 2;
+    }
+  }
+}
+
+std::uint64_t zigzag(std::int64_t value) {
+  return (std::uint64_t(value) << 1) ^ std::uint64_t(value >> 63);
+}
+
+std::int64_t unzigzag(std::uint64_t value) {
+  return std::int64_t(value >> 1) ^ -std::int64_t(value & 1);
+}
+
+/** \brief Appends bits most-significant first */
+class BitWriter {
+ public:
+  BitWriter(std::vector<unsigned char>* out, std::uint64_t* bits,
+            unsigned int* numBits)
+      : out_(out), bits_(bits), numBits_(numBits) {}
+
+  /** \brief Writes the n <= 32 low bits of value */
+  void write(std::uint64_t value, unsigned int n) {
+    *bits_ = (*bits_ << n) | (value & ((std::uint64_t(1) << n) - 1));
+    *numBits_ += n;
+    while (*numBits_ >= 8) {
+      *numBits_ -= 8;
+      out_->push_back((unsigned char)(*bits_ >> *numBits_));
+    }
+  }
+
+  /** \brief Writes value with Rice parameter k */
+  void writeRice(std::uint64_t value, unsigned int k) {
+    const std::uint64_t q = value >> k;
+    if (q < RICE_ESCAPE) {
+      write((((std::uint64_t(1) << q) - 1) << 1), unsigned(q) + 1);
+      writeLong(value, k);
+    } else {
+      write((std::uint64_t(1) << RICE_ESCAPE) - 1, RICE_ESCAPE);
+      writeLong(value, 64);
+    }
+  }
+
+  /** \brief Pads the last byte with zeros */
+  void align() {
+    if (*numBits_ > 0) {
+      write(0, 8 - *numBits_);
+    }
+  }
+
+ private:
+  /** \brief Writes the n <= 64 low bits of value */
+  void writeLong(std::uint64_t value, unsigned int n) {
+    if (n > 32) {
+      write(value >> 32, n - 32);
+      n = 32;
+    }
+    write(value, n);
+  }
+
+  std::vector<unsigned char>* out_;
+  std::uint64_t* bits_;
+  unsigned int* numBits_;
+};
+
+/** \brief Reads 64 bits starting at bit, zero past the end of the data */
+std::uint64_t peek(const detail::BlockCursor& cursor) {
+  const std::size_t byte = cursor.bit / 8;
+  std::uint64_t word = 0;
+  for (std::size_t b = 0; b < 8; ++b) {
+    word <<= 8;
+    if (byte + b < cursor.size) {
+      word |= cursor.data[byte + b];
+    }
+  }
+  return word << (cursor.bit % 8);
+}
+
+/** \brief Reads n <= 32 bits */
+std::uint64_t readBits(detail::BlockCursor* cursor, unsigned int n) {
+  if (n == 0) {
+    return 0;
+  }
+  const std::uint64_t value = peek(*cursor) >> (64 - n);
+  cursor->bit += n;
+  return value;
+}
+
+std::uint64_t readLong(detail::BlockCursor* cursor, unsigned int n) {
+  std::uint64_t value = 0;
+  if (n > 32) {
+    value = readBits(cursor, n - 32) << 32;
+    n = 32;
+  }
+  return value | readBits(cursor, n);
+}
+
+std::uint64_t readRice(detail::BlockCursor* cursor, unsigned int k) {
+  const std::uint64_t inverted = ~peek(*cursor);
+  unsigned int q = inverted == 0 ? 64 : __builtin_clzll(inverted);
+  if (q >= RICE_ESCAPE) {
+    cursor->bit += RICE_ESCAPE;
+    return readLong(cursor, 64);
+  }
+  cursor->bit += q + 1;
+  return (std::uint64_t(q) << k) | readLong(cursor, k);
+}
+
+/** \brief Starts decoding the block whose header is at block */
+void beginBlock(const unsigned char* block, detail::BlockCursor* cursor) {
+  const std::size_t payload = loadU32(block);
+  cursor->poses = loadU32(block + 4);
+  if (payload < TRANSFORMATION_RECORD_SIZE || cursor->poses == 0) {
+    throw std::invalid_argument("Corrupt compressed trajectory block");
+  }
+  cursor->T = decodeTransformation(block + BLOCK_HEADER_SIZE,
+                                   TRANSFORMATION_RECORD_SIZE);
+  cursor->data = block + BLOCK_HEADER_SIZE + TRANSFORMATION_RECORD_SIZE;
+  cursor->size = payload - TRANSFORMATION_RECORD_SIZE;
+  cursor->bit = 0;
+  cursor->decoded = 1;
+  cursor->prevQ.fill(0);
+  resetRice(&cursor->rice);
+}
+
+/** \brief Decodes the next increment of the block and applies it */
+void decodeIncrement(const Eigen::Matrix<double, 6, 1>& steps,
+                     detail::BlockCursor* cursor) {
+  Eigen::Matrix<double, 6, 1> xi;
+  for (unsigned int c = 0; c < 6; ++c) {
+    const std::uint64_t u =
+        readRice(cursor, riceParameter(cursor->rice, c));
+    updateRice(&cursor->rice, c, u);
+    cursor->prevQ[c] += unzigzag(u);
+    xi(c) = double(cursor->prevQ[c]) * steps(c);
+  }
+  if (cursor->bit > 8 * cursor->size) {
+    throw std::invalid_argument("Truncated compressed trajectory block");
+  }
+  cursor->T = se3::Transformation(xi) * cursor->T;
+  ++cursor->decoded;
+}
+
+}  // namespace
+
+double TrajectoryCodecStats::compressionRatio() const {
+  return compressedBytes == 0 ? 0.0 : double(rawBytes) / compressedBytes;
+}
+
+double TrajectoryCodecStats::rmsTranslationError() const {
+  return poses == 0 ? 0.0 : std::sqrt(sumSqTranslationError / poses);
+}
+
+double TrajectoryCodecStats::rmsRotationError() const {
+  return poses == 0 ? 0.0 : std::sqrt(sumSqRotationError / poses);
+}
+
+TrajectoryEncoder::TrajectoryEncoder(std::ostream& out,
+                                     const TrajectoryCodecOptions& options)
+    : out_(out),
+      options_(options),
+      bits_(0),
+      numBits_(0),
+      blockPoses_(0),
+      finished_(false) {
+  checkOptions(options_);
+  steps_ = quantizationSteps(options_);
+  prevQ_.fill(0);
+  resetRice(&rice_);
+
+  unsigned char header[TRAJECTORY_CODEC_HEADER_SIZE] = {0};
+  std::memcpy(header, CODEC_MAGIC, sizeof(CODEC_MAGIC));
+  header[8] = TRAJECTORY_CODEC_VERSION;
+  storeU32(options_.keyframeInterval, header + 12);
+  storeDouble(options_.translationTolerance, header + 16);
+  storeDouble(options_.rotationTolerance, header + 24);
+  out_.write(reinterpret_cast<const char*>(header), sizeof(header));
+  stats_.compressedBytes = sizeof(header);
+}
+
+TrajectoryEncoder::~TrajectoryEncoder() {
+  try {
+    this->finish();
+  } catch (...) {
+    // The stream is left truncated at the last complete block
+  }
+}
+
+void TrajectoryEncoder::push(const se3::Transformation& T) {
+  if (finished_) {
+    throw std::logic_error("Cannot push to a finished trajectory encoder");
+  }
+
+  if (blockPoses_ == 0) {
+    // Keyframe, stored exactly
+    block_.assign(BLOCK_HEADER_SIZE + TRANSFORMATION_RECORD_SIZE, 0);
+    encode(T, block_.data() + BLOCK_HEADER_SIZE, TRANSFORMATION_RECORD_SIZE);
+    T_prev_ = decodeTransformation(block_.data() + BLOCK_HEADER_SIZE,
+                                   TRANSFORMATION_RECORD_SIZE);
+    bits_ = 0;
+    numBits_ = 0;
+    prevQ_.fill(0);
+    resetRice(&rice_);
+  } else {
+    // Quantize the increment from the pose the decoder will have, so that
+    // the error does not accumulate
+    const Eigen::Matrix<double, 6, 1> xi = (T / T_prev_).vec();
+    if (!xi.allFinite()) {
+      throw std::invalid_argument("Cannot encode a non-finite pose");
+    }
+    BitWriter writer(&block_, &bits_, &numBits_);
+    Eigen::Matrix<double, 6, 1> xi_hat;
+    for (unsigned int c = 0; c < 6; ++c) {
+      if (std::abs(xi(c) / steps_(c)) > MAX_QUANTIZED) {
+        throw std::invalid_argument(
+            "Pose increment is too large for the codec tolerance");
+      }
+      const std::int64_t q = std::llround(xi(c) / steps_(c));
+      const std::uint64_t u = zigzag(q - prevQ_[c]);
+      writer.writeRice(u, riceParameter(rice_, c));
+      updateRice(&rice_, c, u);
+      prevQ_[c] = q;
+      xi_hat(c) = double(q) * steps_(c);
+    }
+    T_prev_ = se3::Transformation(xi_hat) * T_prev_;
+  }
+
+  // Reconstruction error
+  const Eigen::Matrix<double, 6, 1> error = (T_prev_ / T).vec();
+  const double translationError = error.head<3>().norm();
+  const double rotationError = error.tail<3>().norm();
+  stats_.poses++;
+  stats_.rawBytes += 12 * sizeof(double);
+  stats_.maxTranslationError =
+      std::max(stats_.maxTranslationError, translationError);
+  stats_.maxRotationError = std::max(stats_.maxRotationError, rotationError);
+  stats_.sumSqTranslationError += translationError * translationError;
+  stats_.sumSqRotationError += rotationError * rotationError;
+
+  if (++blockPoses_ == options_.keyframeInterval) {
+    this->flushBlock();
+  }
+}
+
+void TrajectoryEncoder::finish() {
+  if (finished_) {
+    return;
+  }
+  finished_ = true;
+  if (blockPoses_ > 0) {
+    this->flushBlock();
+  }
+  out_.flush();
+}
+
+void TrajectoryEncoder::flushBlock() {
+  LGMATH_TRACE_SCOPE("io/TrajectoryEncoder/flushBlock", blockPoses_);
+  BitWriter(&block_, &bits_, &numBits_).align();
+  storeU32(std::uint32_t(block_.size() - BLOCK_HEADER_SIZE), block_.data());
+  storeU32(blockPoses_, block_.data() + 4);
+  out_.write(reinterpret_cast<const char*>(block_.data()), block_.size());
+  if (!out_) {
+    throw std::runtime_error("Could not write compressed trajectory");
+  }
+  stats_.compressedBytes += block_.size();
+  blockPoses_ = 0;
+}
+
+TrajectoryDecoder::TrajectoryDecoder(std::istream& in) : in_(in) {
+  unsigned char header[TRAJECTORY_CODEC_HEADER_SIZE];
+  in_.read(reinterpret_cast<char*>(header), sizeof(header));
+  if (in_.gcount() != std::streamsize(sizeof(header))) {
+    throw std::invalid_argument("Not an lgmath compressed trajectory");
+  }
+  options_ = parseHeader(header);
+  steps_ = quantizationSteps(options_);
+  cursor_.poses = 0;
+  cursor_.decoded = 0;
+}
+
+bool TrajectoryDecoder::next(se3::Transformation* T) {
+  if (cursor_.decoded == cursor_.poses) {
+    // Read the next block
+    block_.resize(BLOCK_HEADER_SIZE);
+    in_.read(reinterpret_cast<char*>(block_.data()), BLOCK_HEADER_SIZE);
+    if (in_.gcount() == 0) {
+      return false;
+    }
+    if (in_.gcount() != std::streamsize(BLOCK_HEADER_SIZE)) {
+      throw std::invalid_argument("Truncated compressed trajectory");
+    }
+    const std::size_t payload = loadU32(block_.data());
+    block_.resize(BLOCK_HEADER_SIZE + payload);
+    in_.read(reinterpret_cast<char*>(block_.data() + BLOCK_HEADER_SIZE),
+             payload);
+    if (in_.gcount() != std::streamsize(payload)) {
+      throw std::invalid_argument("Truncated compressed trajectory");
+    }
+    beginBlock(block_.data(), &cursor_);
+  } else {
+    decodeIncrement(steps_, &cursor_);
+  }
+  *T = cursor_.T;
+  return true;
+}
+
+CompressedTrajectory::CompressedTrajectory(const unsigned char* data,
+                                           std::size_t size)
+    : data_(data), size_(0) {
+  if (data == nullptr || size < TRAJECTORY_CODEC_HEADER_SIZE) {
+    throw std::invalid_argument("Not an lgmath compressed trajectory");
+  }
+  options_ = parseHeader(data);
+  steps_ = quantizationSteps(options_);
+
+  // Index the blocks; all but the last hold exactly keyframeInterval poses,
+  // so the block of a pose is found by division
+  std::size_t offset = TRAJECTORY_CODEC_HEADER_SIZE;
+  while (offset < size) {
+    if (size - offset < BLOCK_HEADER_SIZE ||
+        size - offset - BLOCK_HEADER_SIZE < loadU32(data + offset)) {
+      throw std::invalid_argument("Truncated compressed trajectory");
+    }
+    const std::uint32_t poses = loadU32(data + offset + 4);
+    if (!blocks_.empty() && size_ % options_.keyframeInterval != 0) {
+      throw std::invalid_argument("Corrupt compressed trajectory block");
+    }
+    if (poses == 0 || poses > options_.keyframeInterval) {
+      throw std::invalid_argument("Corrupt compressed trajectory block");
+    }
+    blocks_.push_back(offset);
+    size_ += poses;
+    offset += BLOCK_HEADER_SIZE + loadU32(data + offset);
+  }
+}
+
+se3::Transformation CompressedTrajectory::at(std::size_t i) const {
+  if (i >= size_) {
+    throw std::out_of_range("Compressed trajectory index out of range");
+  }
+  const std::size_t index = i % options_.keyframeInterval;
+  LGMATH_TRACE_SCOPE("io/CompressedTrajectory/at", index + 1);
+  detail::BlockCursor cursor;
+  beginBlock(data_ + blocks_[i / options_.keyframeInterval], &cursor);
+  while (cursor.decoded <= index) {
+    decodeIncrement(steps_, &cursor);
+  }
+  return cursor.T;
+}
+
+}  // namespace io
+}  // namespace lgmath
@@ -0,0 +1,303 @@
+/**
+ * \file TrajectoryStore.cpp
+ * \brief Implementation file for an append-only, memory-mapped trajectory
+ * file.
+ *
+ * \author ASRL
+ */
+#include <lgmath/io/TrajectoryStore.hpp>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <lgmath/Trace.hpp>
+
+namespace lgmath {
+namespace io {
+
+namespace {
+
+/** \brief Magic bytes at the start of every trajectory file */
+const char TRAJECTORY_MAGIC[8] = {'L', 'G', 'M', 'T', 'R', 'A', 'J', '\0'};
+
+/** \brief Byte offsets of the header fields */
+const std::size_t VERSION_OFFSET = 8;
+const std::size_t RECORD_SIZE_OFFSET = 12;
+const std::size_t COUNT_OFFSET = 16;
+
+/** \brief Number of records to grow the file by at least */
+const std::size_t MIN_GROWTH = 4096;
+
+std::runtime_error systemError(const std::string& what,
+                               const std::string& path) {
+  return std::runtime_error(what + " '" + path + "': " + std::strerror(errno));
+}
+
+/** \brief The record count, written by the writer after each append */
+std::uint64_t* countField(unsigned char* data) {
+  return reinterpret_cast<std::uint64_t*>(data + COUNT_OFFSET);
+}
+
+const std::uint64_t* countField(const unsigned char* data) {
+  return reinterpret_cast<const std::uint64_t*>(data + COUNT_OFFSET);
+}
+
+/** \brief Throws if the header does not describe a trajectory file */
+void checkHeader(const unsigned char* data, const std::string& path) {
+  std::uint32_t version, recordSize;
+  std::memcpy(&version, data + VERSION_OFFSET, sizeof(version));
+  std::memcpy(&recordSize, data + RECORD_SIZE_OFFSET, sizeof(recordSize));
+  if (std::memcmp(data, TRAJECTORY_MAGIC, sizeof(TRAJECTORY_MAGIC)) != 0) {
+    throw std::runtime_error("Not an lgmath trajectory file '" + path + "'");
+  }
+  if (version != TRAJECTORY_FORMAT_VERSION ||
+      recordSize != TRAJECTORY_RECORD_SIZE) {
+    throw std::runtime_error("Unsupported lgmath trajectory file version '" +
+                             path + "'");
+  }
+}
+
+std::size_t fileSize(int fd, const std::string& path) {
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    throw systemError("Could not stat trajectory file", path);
+  }
+  return std::size_t(st.st_size);
+}
+
+}  // namespace
+
+TrajectoryWriter::TrajectoryWriter(const std::string& path,
+                                   std::size_t reserve)
+    : path_(path),
+      fd_(-1),
+      data_(nullptr),
+      mapped_(0),
+      count_(0),
+      lastTimestamp_(0) {
+  fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd_ < 0) {
+    throw systemError("Could not open trajectory file", path);
+  }
+  if (flock(fd_, LOCK_EX | LOCK_NB) != 0) {
+    ::close(fd_);
+    throw systemError("Trajectory file is already open for writing", path);
+  }
+
+  const std::size_t size = fileSize(fd_, path);
+  if (size == 0) {
+    // New file, write the header (the count field starts at zero)
+    unsigned char header[TRAJECTORY_HEADER_SIZE] = {0};
+    std::memcpy(header, TRAJECTORY_MAGIC, sizeof(TRAJECTORY_MAGIC));
+    std::memcpy(header + VERSION_OFFSET, &TRAJECTORY_FORMAT_VERSION,
+                sizeof(std::uint32_t));
+    const std::uint32_t recordSize = TRAJECTORY_RECORD_SIZE;
+    std::memcpy(header + RECORD_SIZE_OFFSET, &recordSize, sizeof(recordSize));
+    if (pwrite(fd_, header, sizeof(header), 0) != ssize_t(sizeof(header))) {
+      ::close(fd_);
+      throw systemError("Could not write trajectory file header", path);
+    }
+  } else if (size < TRAJECTORY_HEADER_SIZE) {
+    ::close(fd_);
+    throw std::runtime_error("Not an lgmath trajectory file '" + path + "'");
+  }
+
+  try {
+    this->reserve(reserve);
+    checkHeader(data_, path_);
+    count_ = __atomic_load_n(countField(data_), __ATOMIC_ACQUIRE);
+    if (count_ > 0) {
+      std::memcpy(&lastTimestamp_,
+                  data_ + TRAJECTORY_HEADER_SIZE +
+                      (count_ - 1) * TRAJECTORY_RECORD_SIZE,
+                  sizeof(lastTimestamp_));
+    }
+  } catch (...) {
+    if (data_ != nullptr) {
+      munmap(data_, mapped_);
+    }
+    ::close(fd_);
+    throw;
+  }
+}
+
+TrajectoryWriter::~TrajectoryWriter() {
+  munmap(data_, mapped_);
+  // Drop the preallocated space; readers never look past the record count,
+  // so the file is still valid if this fails
+  const int result = ftruncate(
+      fd_, off_t(TRAJECTORY_HEADER_SIZE + count_ * TRAJECTORY_RECORD_SIZE));
+  (void)result;
+  ::close(fd_);
+}
+
+void TrajectoryWriter::reserve(std::size_t count) {
+  const std::size_t required =
+      TRAJECTORY_HEADER_SIZE + count * TRAJECTORY_RECORD_SIZE;
+  if (data_ != nullptr && required <= mapped_) {
+    return;
+  }
+  LGMATH_TRACE_SCOPE("io/TrajectoryWriter/grow", count);
+  std::size_t length = std::max(required, fileSize(fd_, path_));
+  if (data_ != nullptr) {
+    // Grow geometrically so that appends are amortized O(1)
+    length = std::max(length, mapped_ + std::max(mapped_ / 2,
+                                                 MIN_GROWTH *
+                                                     TRAJECTORY_RECORD_SIZE));
+  }
+  if (length > fileSize(fd_, path_) && ftruncate(fd_, off_t(length)) != 0) {
+    throw systemError("Could not grow trajectory file", path_);
+  }
+  void* mapping =
+      mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  if (mapping == MAP_FAILED) {
+    throw systemError("Could not map trajectory file", path_);
+  }
+  if (data_ != nullptr) {
+    munmap(data_, mapped_);
+  }
+  data_ = static_cast<unsigned char*>(mapping);
+  mapped_ = length;
+}
+
+void TrajectoryWriter::append(std::int64_t timestamp,
+                              const se3::TransformationWithCovariance& T) {
+  if (count_ > 0 && timestamp <= lastTimestamp_) {
+    throw std::invalid_argument(
+        "Trajectory timestamps must be strictly increasing");
+  }
+  this->reserve(count_ + 1);
+
+  // Write the record, then publish it to the readers
+  unsigned char* record =
+      data_ + TRAJECTORY_HEADER_SIZE + count_ * TRAJECTORY_RECORD_SIZE;
+  std::memcpy(record, &timestamp, sizeof(timestamp));
+  encode(T, record + sizeof(timestamp),
+         TRANSFORMATION_WITH_COVARIANCE_RECORD_SIZE);
+  ++count_;
+  lastTimestamp_ = timestamp;
+  __atomic_store_n(countField(data_), std::uint64_t(count_), __ATOMIC_RELEASE);
+}
+
+void TrajectoryWriter::append(std::int64_t timestamp,
+                              const se3::Transformation& T) {
+  this->append(timestamp, se3::TransformationWithCovariance(T));
+}
+
+void TrajectoryWriter::flush() {
+  LGMATH_TRACE_SCOPE("io/TrajectoryWriter/flush", count_);
+  if (msync(data_, TRAJECTORY_HEADER_SIZE + count_ * TRAJECTORY_RECORD_SIZE,
+            MS_SYNC) != 0) {
+    throw systemError("Could not flush trajectory file", path_);
+  }
+}
+
+TrajectoryReader::TrajectoryReader(const std::string& path)
+    : path_(path), fd_(-1), data_(nullptr), mapped_(0), count_(0) {
+  fd_ = ::open(path.c_str(), O_RDONLY);
+  if (fd_ < 0) {
+    throw systemError("Could not open trajectory file", path);
+  }
+  try {
+    const std::size_t size = fileSize(fd_, path);
+    if (size < TRAJECTORY_HEADER_SIZE) {
+      throw std::runtime_error("Not an lgmath trajectory file '" + path + "'");
+    }
+    this->map(size);
+    checkHeader(data_, path_);
+    this->refresh();
+  } catch (...) {
+    if (data_ != nullptr) {
+      munmap(const_cast<unsigned char*>(data_), mapped_);
+    }
+    ::close(fd_);
+    throw;
+  }
+}
+
+TrajectoryReader::~TrajectoryReader() {
+  munmap(const_cast<unsigned char*>(data_), mapped_);
+  ::close(fd_);
+}
+
+void TrajectoryReader::map(std::size_t length) {
+  void* mapping = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd_, 0);
+  if (mapping == MAP_FAILED) {
+    throw systemError("Could not map trajectory file", path_);
+  }
+  // Lookups jump around the file, so do not read ahead
+  madvise(mapping, length, MADV_RANDOM);
+  if (data_ != nullptr) {
+    munmap(const_cast<unsigned char*>(data_), mapped_);
+  }
+  data_ = static_cast<const unsigned char*>(mapping);
+  mapped_ = length;
+}
+
+std::size_t TrajectoryReader::refresh() {
+  const std::size_t count =
+      __atomic_load_n(countField(data_), __ATOMIC_ACQUIRE);
+  const std::size_t required =
+      TRAJECTORY_HEADER_SIZE + count * TRAJECTORY_RECORD_SIZE;
+  if (required > mapped_) {
+    // The writer grows the file before publishing, so it is large enough
+    this->map(fileSize(fd_, path_));
+  }
+  count_ = count;
+  return count_;
+}
+
+std::int64_t TrajectoryReader::timestamp(std::size_t i) const {
+  std::int64_t t;
+  std::memcpy(&t, record(i), sizeof(t));
+  return t;
+}
+
+TrajectoryReader::Record TrajectoryReader::operator[](std::size_t i) const {
+  return Record{timestamp(i),
+                TransformationWithCovarianceView(
+                    record(i) + sizeof(std::int64_t),
+                    TRANSFORMATION_WITH_COVARIANCE_RECORD_SIZE)};
+}
+
+TrajectoryReader::Record TrajectoryReader::at(std::size_t i) const {
+  if (i >= count_) {
+    throw std::out_of_range("Trajectory record index out of range");
+  }
+  return (*this)[i];
+}
+
+TrajectoryReader::const_iterator TrajectoryReader::lowerBound(
+    std::int64_t t) const {
+  // Binary search on the timestamps, touching O(log n) pages
+  std::size_t first = 0, count = count_;
+  while (count > 0) {
+    const std::size_t step = count / 2;
+    if (timestamp(first + step) < t) {
+      first += step + 1;
+      count -= step + 1;
+    } else {
+      count = step;
+    }
+  }
+  return const_iterator(this, first);
+}
+
+TrajectoryReader::const_iterator TrajectoryReader::find(std::int64_t t) const {
+  const_iterator it = lowerBound(t);
+  if (it != end() && timestamp(it.index()) != t) {
+    return end();
+  }
+  return it;
+}
+
+}  // namespace io
+}  // namespace lgmath
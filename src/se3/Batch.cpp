@@ -0,0 +1,485 @@
+/**
+ * \file Batch.cpp
+ * \brief Implementation file for the SE3 batch kernels.
+ * \details Checks the arguments and dispatches to the kernels of the active
+ * instruction set.
+ *
+ * \author ASRL
+ */
+#include <lgmath/se3/Batch.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <lgmath/Dispatch.hpp>
+#include <lgmath/Parallel.hpp>
+#include <lgmath/Trace.hpp>
+#include <lgmath/so3/Operations.hpp>
+
+#include "BatchKernels.hpp"
+
+namespace lgmath {
+namespace se3 {
+
+namespace detail {
+
+const BatchKernels& batchKernels() {
+  switch (common::activeIsa()) {
+    case common::Isa::SSE4_2:
+      return *sse42BatchKernels();
+    case common::Isa::AVX2:
+      return *avx2BatchKernels();
+    case common::Isa::AVX512:
+      return *avx512BatchKernels();
+    default:
+      return *genericBatchKernels();
+  }
+}
+
+void interpolationCoefficients(const Transformation& T_0,
+                               const double* xi_data, double* coeffs) {
+  // With xi = (rho, phi * u) and K = u^, exp(alpha * xi)
+  // is [I + sin * K + (1 - cos) * K^2 | J * alpha * rho], where
+  // J * alpha * rho = alpha * (rho + K^2 * rho) - sin / phi * K^2 * rho
+  // + (1 - cos) / phi * K * rho, with sin and cos of alpha * phi (see
+  // so3::vec2jac); premultiplied by T_0, these are the coefficients of
+  // T = A + alpha * B + sin * S + (1 - cos) * V
+  const Eigen::Map<const Eigen::Matrix<double, 6, 1>> xi(xi_data);
+  const Eigen::Vector3d rho = xi.head<3>();
+  const double phi = xi.tail<3>().norm();
+  const Eigen::Matrix3d C_0 = T_0.C_ba();
+  typedef Eigen::Matrix<double, 3, 4, Eigen::RowMajor> Matrix34r;
+  Eigen::Map<Matrix34r> A(coeffs), B(coeffs + 12), S(coeffs + 24),
+      V(coeffs + 36);
+  A << C_0, T_0.r_ab_inb();
+  B.setZero();
+  S.setZero();
+  V.setZero();
+  coeffs[48] = phi;
+  if (phi < 1e-12) {
+    // If angle is very small, rotation is Identity
+    B.col(3) = C_0 * rho;
+  } else {
+    const Eigen::Matrix3d K = so3::hat(xi.tail<3>() / phi);
+    const Eigen::Matrix3d K2 = K * K;
+    B.col(3) = C_0 * (rho + K2 * rho);
+    S.leftCols<3>() = C_0 * K;
+    S.col(3) = -C_0 * K2 * rho / phi;
+    V.leftCols<3>() = C_0 * K2;
+    V.col(3) = C_0 * K * rho / phi;
+  }
+}
+
+}  // namespace detail
+
+namespace {
+
+/**
+ * \brief Default grain sizes of the execution policies: the number of elements
+ * that take tens of microseconds, for the kernels of a few arithmetic
+ * operations per element and for those with trigonometric functions or
+ * covariances respectively
+ */
+const std::size_t LIGHT_GRAIN = 1 << 14;
+const std::size_t HEAVY_GRAIN = 1 << 11;
+
+/** \brief Checks the buffers and gets the stride */
+std::size_t checkBatch(const void* in, const void* out, std::size_t n,
+                       std::size_t stride, const char* function) {
+  if (n > 0 && (in == nullptr || out == nullptr)) {
+    throw std::invalid_argument(std::string("Null pointer in ") + function);
+  }
+  if (stride == 0) {
+    return n;
+  }
+  if (stride < n) {
+    throw std::invalid_argument(std::string("Stride is less than n in ") +
+                                function);
+  }
+  return stride;
+}
+
+/** \brief Logarithm of the rotation of pose i, near pi */
+void nearPiLog(const double* T, std::size_t stride, std::size_t i,
+               double* aaxis) {
+  Eigen::Matrix3d C_ba;
+  for (int row = 0; row < 3; ++row) {
+    for (int col = 0; col < 3; ++col) {
+      C_ba(row, col) = T[(4 * row + col) * stride + i];
+    }
+  }
+  const Eigen::Vector3d result = so3::rot2vec(C_ba);
+  for (int row = 0; row < 3; ++row) {
+    aaxis[row] = result(row);
+  }
+}
+
+}  // namespace
+
+void vec2tranBatch(const double* xi, double* T, std::size_t n,
+                   std::size_t stride) {
+  vec2tranBatch(common::ExecutionPolicy::sequential(), xi, T, n, stride);
+}
+
+void vec2tranBatch(const common::ExecutionPolicy& policy, const double* xi,
+                   double* T, std::size_t n, std::size_t stride) {
+  stride = checkBatch(xi, T, n, stride, "vec2tranBatch");
+  LGMATH_TRACE_SCOPE("se3/vec2tranBatch", n);
+  const detail::BatchKernels& kernels = detail::batchKernels();
+  policy.forEachRange(n, HEAVY_GRAIN, [&](std::size_t begin, std::size_t end) {
+    kernels.vec2tran(xi, T, stride, begin, end);
+  });
+}
+
+void tran2vecBatch(const double* T, double* xi, std::size_t n,
+                   std::size_t stride) {
+  tran2vecBatch(common::ExecutionPolicy::sequential(), T, xi, n, stride);
+}
+
+void tran2vecBatch(const common::ExecutionPolicy& policy, const double* T,
+                   double* xi, std::size_t n, std::size_t stride) {
+  stride = checkBatch(T, xi, n, stride, "tran2vecBatch");
+  LGMATH_TRACE_SCOPE("se3/tran2vecBatch", n);
+  const detail::BatchKernels& kernels = detail::batchKernels();
+  policy.forEachRange(n, HEAVY_GRAIN, [&](std::size_t begin, std::size_t end) {
+    kernels.tran2vec(T, xi, stride, begin, end, nearPiLog);
+  });
+}
+
+void transformPointsBatch(const Transformation& T_ba, const double* p_a,
+                          double* p_b, std::size_t n, std::size_t stride) {
+  transformPointsBatch(common::ExecutionPolicy::sequential(), T_ba, p_a, p_b,
+                       n, stride);
+}
+
+void transformPointsBatch(const common::ExecutionPolicy& policy,
+                          const Transformation& T_ba, const double* p_a,
+                          double* p_b, std::size_t n, std::size_t stride) {
+  stride = checkBatch(p_a, p_b, n, stride, "transformPointsBatch");
+  LGMATH_TRACE_SCOPE("se3/transformPointsBatch", n);
+  const Eigen::Matrix<double, 3, 4, Eigen::RowMajor> T =
+      T_ba.matrix().topRows<3>();
+  const detail::BatchKernels& kernels = detail::batchKernels();
+  policy.forEachRange(n, LIGHT_GRAIN, [&](std::size_t begin, std::size_t end) {
+    kernels.transformPoints(T.data(), p_a, p_b, stride, begin, end);
+  });
+}
+
+void transformPointsBatch(const double* T, const double* p_a, double* p_b,
+                          std::size_t n, std::size_t stride) {
+  transformPointsBatch(common::ExecutionPolicy::sequential(), T, p_a, p_b, n,
+                       stride);
+}
+
+void transformPointsBatch(const common::ExecutionPolicy& policy,
+                          const double* T, const double* p_a, double* p_b,
+                          std::size_t n, std::size_t stride) {
+  stride = checkBatch(p_a, p_b, n, stride, "transformPointsBatch");
+  if (n > 0 && T == nullptr) {
+    throw std::invalid_argument("Null pointer in transformPointsBatch");
+  }
+  LGMATH_TRACE_SCOPE("se3/transformPointsBatch", n);
+  const detail::BatchKernels& kernels = detail::batchKernels();
+  policy.forEachRange(n, LIGHT_GRAIN, [&](std::size_t begin, std::size_t end) {
+    kernels.transformPointsPerPose(T, p_a, p_b, stride, begin, end);
+  });
+}
+
+void propagateCovarianceBatch(const double* T, const double* cov, double* out,
+                              std::size_t n, std::size_t stride) {
+  propagateCovarianceBatch(common::ExecutionPolicy::sequential(), T, cov, out,
+                           n, stride);
+}
+
+void propagateCovarianceBatch(const common::ExecutionPolicy& policy,
+                              const double* T, const double* cov, double* out,
+                              std::size_t n, std::size_t stride) {
+  stride = checkBatch(cov, out, n, stride, "propagateCovarianceBatch");
+  if (n > 0 && T == nullptr) {
+    throw std::invalid_argument("Null pointer in propagateCovarianceBatch");
+  }
+  LGMATH_TRACE_SCOPE("se3/propagateCovarianceBatch", n);
+  const detail::BatchKernels& kernels = detail::batchKernels();
+  policy.forEachRange(n, HEAVY_GRAIN, [&](std::size_t begin, std::size_t end) {
+    kernels.propagateCovariance(T, stride, cov, out, stride, begin, end);
+  });
+}
+
+void composeBatch(const double* lhs, const double* rhs, double* out,
+                  std::size_t n, std::size_t stride) {
+  composeBatch(common::ExecutionPolicy::sequential(), lhs, rhs, out, n,
+               stride);
+}
+
+void composeBatch(const common::ExecutionPolicy& policy, const double* lhs,
+                  const double* rhs, double* out, std::size_t n,
+                  std::size_t stride) {
+  stride = checkBatch(lhs, out, n, stride, "composeBatch");
+  if (n > 0 && rhs == nullptr) {
+    throw std::invalid_argument("Null pointer in composeBatch");
+  }
+  LGMATH_TRACE_SCOPE("se3/composeBatch", n);
+  const detail::BatchKernels& kernels = detail::batchKernels();
+  policy.forEachRange(n, LIGHT_GRAIN, [&](std::size_t begin, std::size_t end) {
+    kernels.compose(lhs, rhs, out, stride, begin, end);
+  });
+}
+
+void inverseBatch(const double* T, double* out, std::size_t n,
+                  std::size_t stride) {
+  inverseBatch(common::ExecutionPolicy::sequential(), T, out, n, stride);
+}
+
+void inverseBatch(const common::ExecutionPolicy& policy, const double* T,
+                  double* out, std::size_t n, std::size_t stride) {
+  stride = checkBatch(T, out, n, stride, "inverseBatch");
+  LGMATH_TRACE_SCOPE("se3/inverseBatch", n);
+  const detail::BatchKernels& kernels = detail::batchKernels();
+  policy.forEachRange(n, LIGHT_GRAIN, [&](std::size_t begin, std::size_t end) {
+    kernels.inverse(T, out, stride, begin, end);
+  });
+}
+
+void inverseBatch(const double* T, const double* cov, double* out,
+                  double* outCov, std::size_t n, std::size_t stride) {
+  inverseBatch(common::ExecutionPolicy::sequential(), T, cov, out, outCov, n,
+               stride);
+}
+
+void inverseBatch(const common::ExecutionPolicy& policy, const double* T,
+                  const double* cov, double* out, double* outCov, std::size_t n,
+                  std::size_t stride) {
+  stride = checkBatch(T, out, n, stride, "inverseBatch");
+  checkBatch(cov, outCov, n, stride, "inverseBatch");
+  LGMATH_TRACE_SCOPE("se3/inverseBatch", n);
+  // Ad(T^-1) * cov * Ad(T^-1)^T, as in TransformationWithCovariance::inverse
+  const detail::BatchKernels& kernels = detail::batchKernels();
+  policy.forEachRange(n, HEAVY_GRAIN, [&](std::size_t begin, std::size_t end) {
+    kernels.inverse(T, out, stride, begin, end);
+    kernels.propagateCovariance(out, stride, cov, outCov, stride, begin, end);
+  });
+}
+
+namespace {
+
+/** \brief Number of pairs whose covariances are gathered at once */
+const std::size_t COVARIANCE_BLOCK = 256;
+
+/** \brief Checks the arguments of a relative pose batch and gets the stride */
+std::size_t checkPairs(const double* T, std::size_t numPoses,
+                       const std::size_t* pairs, const double* out,
+                       std::size_t m, std::size_t stride,
+                       const char* function) {
+  if (m > 0 && T == nullptr) {
+    throw std::invalid_argument(std::string("Null pointer in ") + function);
+  }
+  stride = checkBatch(pairs, out, m, stride, function);
+  for (std::size_t k = 0; k < m; ++k) {
+    if (pairs[k] >= numPoses || pairs[stride + k] >= numPoses) {
+      throw std::invalid_argument(std::string("Pose index of pair ") +
+                                  std::to_string(k) + " out of range in " +
+                                  function);
+    }
+  }
+  return stride;
+}
+
+}  // namespace
+
+void relativePosesBatch(const double* T, std::size_t numPoses,
+                        const std::size_t* pairs, double* out, std::size_t m,
+                        std::size_t stride) {
+  relativePosesBatch(common::ExecutionPolicy(), T, numPoses, pairs, out, m,
+                     stride);
+}
+
+void relativePosesBatch(const common::ExecutionPolicy& policy, const double* T,
+                        std::size_t numPoses, const std::size_t* pairs,
+                        double* out, std::size_t m, std::size_t stride) {
+  stride = checkPairs(T, numPoses, pairs, out, m, stride, "relativePosesBatch");
+  LGMATH_TRACE_SCOPE("se3/relativePosesBatch", m);
+  const detail::BatchKernels& kernels = detail::batchKernels();
+  policy.forEachRange(m, LIGHT_GRAIN, [&](std::size_t begin, std::size_t end) {
+    kernels.relativePoses(T, numPoses, pairs, out, stride, begin, end);
+  });
+}
+
+void relativePosesBatch(const double* T, const double* cov,
+                        std::size_t numPoses, const std::size_t* pairs,
+                        double* out, double* outCov, std::size_t m,
+                        std::size_t stride) {
+  relativePosesBatch(common::ExecutionPolicy(), T, cov, numPoses, pairs, out,
+                     outCov, m, stride);
+}
+
+void relativePosesBatch(const common::ExecutionPolicy& policy, const double* T,
+                        const double* cov, std::size_t numPoses,
+                        const std::size_t* pairs, double* out, double* outCov,
+                        std::size_t m, std::size_t stride) {
+  stride = checkPairs(T, numPoses, pairs, out, m, stride, "relativePosesBatch");
+  if (m > 0 && (cov == nullptr || outCov == nullptr)) {
+    throw std::invalid_argument("Null pointer in relativePosesBatch");
+  }
+  LGMATH_TRACE_SCOPE("se3/relativePosesBatch", m);
+  const detail::BatchKernels& kernels = detail::batchKernels();
+  policy.forEachRange(m, HEAVY_GRAIN, [&](std::size_t begin, std::size_t end) {
+    kernels.relativePoses(T, numPoses, pairs, out, stride, begin, end);
+
+    // cov_i + Ad(T_k) * cov_j * Ad(T_k)^T, as in
+    // TransformationWithCovariance::operator/=; the covariances of the poses
+    // j of a block are gathered to propagate them through the relative poses
+    std::vector<double> block(BATCH_COVARIANCE_ROWS * COVARIANCE_BLOCK);
+    for (std::size_t first = begin; first < end; first += COVARIANCE_BLOCK) {
+      const std::size_t n = std::min(end - first, COVARIANCE_BLOCK);
+      const std::size_t* i = pairs + first;
+      const std::size_t* j = pairs + stride + first;
+      for (std::size_t row = 0; row < BATCH_COVARIANCE_ROWS; ++row) {
+        const double* cov_row = cov + row * numPoses;
+        double* block_row = block.data() + row * COVARIANCE_BLOCK;
+        for (std::size_t k = 0; k < n; ++k) {
+          block_row[k] = cov_row[j[k]];
+        }
+      }
+      kernels.propagateCovariance(out + first, stride, block.data(),
+                                  block.data(), COVARIANCE_BLOCK, 0, n);
+      for (std::size_t row = 0; row < BATCH_COVARIANCE_ROWS; ++row) {
+        const double* cov_row = cov + row * numPoses;
+        const double* block_row = block.data() + row * COVARIANCE_BLOCK;
+        double* out_row = outCov + row * stride + first;
+        for (std::size_t k = 0; k < n; ++k) {
+          out_row[k] = cov_row[i[k]] + block_row[k];
+        }
+      }
+    }
+  });
+}
+
+namespace {
+
+/** \brief Checks the arguments of a Jacobian product and gets the stride */
+std::size_t checkJacobianBatch(const double* xi, const double* v,
+                               const double* out, std::size_t n,
+                               std::size_t stride, const char* function) {
+  if (n > 0 && v == nullptr) {
+    throw std::invalid_argument(std::string("Null pointer in ") + function);
+  }
+  return checkBatch(xi, out, n, stride, function);
+}
+
+}  // namespace
+
+void applyJacBatch(const double* xi, const double* v, double* out,
+                   std::size_t n, std::size_t stride) {
+  applyJacBatch(common::ExecutionPolicy::sequential(), xi, v, out, n, stride);
+}
+
+void applyJacBatch(const common::ExecutionPolicy& policy, const double* xi,
+                   const double* v, double* out, std::size_t n,
+                   std::size_t stride) {
+  stride = checkJacobianBatch(xi, v, out, n, stride, "applyJacBatch");
+  LGMATH_TRACE_SCOPE("se3/applyJacBatch", n);
+  const detail::BatchKernels& kernels = detail::batchKernels();
+  policy.forEachRange(n, HEAVY_GRAIN, [&](std::size_t begin, std::size_t end) {
+    kernels.applyJac(xi, v, out, stride, begin, end,
+                     detail::JacobianProduct::JAC);
+  });
+}
+
+void applyJacTransposeBatch(const double* xi, const double* v, double* out,
+                            std::size_t n, std::size_t stride) {
+  applyJacTransposeBatch(common::ExecutionPolicy::sequential(), xi, v, out, n,
+                         stride);
+}
+
+void applyJacTransposeBatch(const common::ExecutionPolicy& policy,
+                            const double* xi, const double* v, double* out,
+                            std::size_t n, std::size_t stride) {
+  stride = checkJacobianBatch(xi, v, out, n, stride, "applyJacTransposeBatch");
+  LGMATH_TRACE_SCOPE("se3/applyJacTransposeBatch", n);
+  const detail::BatchKernels& kernels = detail::batchKernels();
+  policy.forEachRange(n, HEAVY_GRAIN, [&](std::size_t begin, std::size_t end) {
+    kernels.applyJac(xi, v, out, stride, begin, end,
+                     detail::JacobianProduct::JAC_TRANSPOSE);
+  });
+}
+
+void applyJacInvBatch(const double* xi, const double* v, double* out,
+                      std::size_t n, std::size_t stride) {
+  applyJacInvBatch(common::ExecutionPolicy::sequential(), xi, v, out, n,
+                   stride);
+}
+
+void applyJacInvBatch(const common::ExecutionPolicy& policy, const double* xi,
+                      const double* v, double* out, std::size_t n,
+                      std::size_t stride) {
+  stride = checkJacobianBatch(xi, v, out, n, stride, "applyJacInvBatch");
+  LGMATH_TRACE_SCOPE("se3/applyJacInvBatch", n);
+  const detail::BatchKernels& kernels = detail::batchKernels();
+  policy.forEachRange(n, HEAVY_GRAIN, [&](std::size_t begin, std::size_t end) {
+    kernels.applyJac(xi, v, out, stride, begin, end,
+                     detail::JacobianProduct::JAC_INVERSE);
+  });
+}
+
+void applyAdjointBatch(const double* T, const double* v, double* out,
+                       std::size_t n, std::size_t stride) {
+  applyAdjointBatch(common::ExecutionPolicy::sequential(), T, v, out, n,
+                    stride);
+}
+
+void applyAdjointBatch(const common::ExecutionPolicy& policy, const double* T,
+                       const double* v, double* out, std::size_t n,
+                       std::size_t stride) {
+  stride = checkJacobianBatch(T, v, out, n, stride, "applyAdjointBatch");
+  LGMATH_TRACE_SCOPE("se3/applyAdjointBatch", n);
+  const detail::BatchKernels& kernels = detail::batchKernels();
+  policy.forEachRange(n, LIGHT_GRAIN, [&](std::size_t begin, std::size_t end) {
+    kernels.applyAdjoint(T, v, out, stride, begin, end);
+  });
+}
+
+void applyCurlyhatBatch(const double* xi, const double* v, double* out,
+                        std::size_t n, std::size_t stride) {
+  applyCurlyhatBatch(common::ExecutionPolicy::sequential(), xi, v, out, n,
+                     stride);
+}
+
+void applyCurlyhatBatch(const common::ExecutionPolicy& policy,
+                        const double* xi, const double* v, double* out,
+                        std::size_t n, std::size_t stride) {
+  stride = checkJacobianBatch(xi, v, out, n, stride, "applyCurlyhatBatch");
+  LGMATH_TRACE_SCOPE("se3/applyCurlyhatBatch", n);
+  const detail::BatchKernels& kernels = detail::batchKernels();
+  policy.forEachRange(n, LIGHT_GRAIN, [&](std::size_t begin, std::size_t end) {
+    kernels.applyCurlyhat(xi, v, out, stride, begin, end);
+  });
+}
+
+void interpolateBatch(const Transformation& T_0, const Transformation& T_1,
+                      const double* alpha, double* T, std::size_t n,
+                      std::size_t stride) {
+  interpolateBatch(common::ExecutionPolicy::sequential(), T_0, T_1, alpha, T,
+                   n, stride);
+}
+
+void interpolateBatch(const common::ExecutionPolicy& policy,
+                      const Transformation& T_0, const Transformation& T_1,
+                      const double* alpha, double* T, std::size_t n,
+                      std::size_t stride) {
+  stride = checkBatch(alpha, T, n, stride, "interpolateBatch");
+  LGMATH_TRACE_SCOPE("se3/interpolateBatch", n);
+
+  double coeffs[49];
+  const Eigen::Matrix<double, 6, 1> xi = (T_0.inverse() * T_1).vec();
+  detail::interpolationCoefficients(T_0, xi.data(), coeffs);
+
+  const detail::BatchKernels& kernels = detail::batchKernels();
+  policy.forEachRange(n, HEAVY_GRAIN, [&](std::size_t begin, std::size_t end) {
+    kernels.interpolate(coeffs, alpha, T, stride, begin, end);
+  });
+}
+
+}  // namespace se3
+}  // namespace lgmath
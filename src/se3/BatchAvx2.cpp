@@ -0,0 +1,30 @@
+/**
+ * \file BatchAvx2.cpp
+ * \brief Batch kernels for AVX2.
+ * \details Compiled with the AVX2 flags (see CMakeLists.txt); empty when the
+ * compiler does not target x86.
+ *
+ * \author ASRL
+ */
+#if defined(__AVX2__)
+#define LGMATH_BATCH_ISA avx2
+#include "BatchKernelsImpl.hpp"
+#else
+#include "BatchKernels.hpp"
+#endif
+
+namespace lgmath {
+namespace se3 {
+namespace detail {
+
+const BatchKernels* avx2BatchKernels() {
+#if defined(__AVX2__)
+  return &avx2::KERNELS;
+#else
+  return nullptr;
+#endif
+}
+
+}  // namespace detail
+}  // namespace se3
+}  // namespace lgmath
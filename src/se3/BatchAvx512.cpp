@@ -0,0 +1,30 @@
+/**
+ * \file BatchAvx512.cpp
+ * \brief Batch kernels for AVX-512.
+ * \details Compiled with the AVX-512 flags (see CMakeLists.txt); empty when the
+ * compiler does not target x86.
+ *
+ * \author ASRL
+ */
+#if defined(__AVX512F__)
+#define LGMATH_BATCH_ISA avx512
+#include "BatchKernelsImpl.hpp"
+#else
+#include "BatchKernels.hpp"
+#endif
+
+namespace lgmath {
+namespace se3 {
+namespace detail {
+
+const BatchKernels* avx512BatchKernels() {
+#if defined(__AVX512F__)
+  return &avx512::KERNELS;
+#else
+  return nullptr;
+#endif
+}
+
+}  // namespace detail
+}  // namespace se3
+}  // namespace lgmath
@@ -0,0 +1,18 @@
+/**
+ * \file BatchGeneric.cpp
+ * \brief Batch kernels for the baseline instruction set of the target.
+ *
+ * \author ASRL
+ */
+#define LGMATH_BATCH_ISA generic
+#include "BatchKernelsImpl.hpp"
+
+namespace lgmath {
+namespace se3 {
+namespace detail {
+
+const BatchKernels* genericBatchKernels() { return &generic::KERNELS; }
+
+}  // namespace detail
+}  // namespace se3
+}  // namespace lgmath
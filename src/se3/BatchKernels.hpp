@@ -0,0 +1,141 @@
+/**
+ * \file BatchKernels.hpp
+ * \brief Private header of the instruction-set specific batch kernels.
+ * \details Every kernel processes the elements [begin, end) of structure of
+ * arrays buffers with a common stride, see se3/Batch.hpp for the layouts.
+ * BatchKernelsImpl.hpp holds their single implementation, which is compiled
+ * once per instruction set in its own translation unit.
+ *
+ * \author ASRL
+ */
+#pragma once
+
+#include <cstddef>
+
+namespace lgmath {
+namespace se3 {
+
+class Transformation;
+
+namespace detail {
+
+/**
+ * \brief Computes the rotation vector of pose i when its angle is near pi,
+ * where the closed form of the logarithm is ill-conditioned
+ */
+typedef void (*NearPiLog)(const double* T, std::size_t stride, std::size_t i,
+                          double* aaxis);
+
+/** \brief Which product with the se3 Jacobian applyJac computes */
+enum class JacobianProduct { JAC, JAC_TRANSPOSE, JAC_INVERSE };
+
+/** \brief The batch kernels of one instruction set */
+struct BatchKernels {
+  /** \brief Exponential map, xi (6 rows) to T (12 rows) */
+  void (*vec2tran)(const double* xi, double* T, std::size_t stride,
+                   std::size_t begin, std::size_t end);
+
+  /** \brief Logarithmic map, T (12 rows) to xi (6 rows) */
+  void (*tran2vec)(const double* T, double* xi, std::size_t stride,
+                   std::size_t begin, std::size_t end, NearPiLog nearPiLog);
+
+  /** \brief Transforms points (3 rows) by one pose (12 doubles) */
+  void (*transformPoints)(const double* T, const double* p, double* out,
+                          std::size_t stride, std::size_t begin,
+                          std::size_t end);
+
+  /** \brief Transforms points (3 rows) each by its own pose (12 rows) */
+  void (*transformPointsPerPose)(const double* T, const double* p,
+                                 double* out, std::size_t stride,
+                                 std::size_t begin, std::size_t end);
+
+  /**
+   * \brief Ad(T) * cov * Ad(T)^T, T (12 rows) with its own stride, packed cov
+   * (21 rows)
+   */
+  void (*propagateCovariance)(const double* T, std::size_t poseStride,
+                              const double* cov, double* out,
+                              std::size_t stride, std::size_t begin,
+                              std::size_t end);
+
+  /** \brief Composition lhs * rhs, all 12 rows */
+  void (*compose)(const double* lhs, const double* rhs, double* out,
+                  std::size_t stride, std::size_t begin, std::size_t end);
+
+  /** \brief Inverse of T, all 12 rows */
+  void (*inverse)(const double* T, double* out, std::size_t stride,
+                  std::size_t begin, std::size_t end);
+
+  /**
+   * \brief T_i * T_j^-1 for the index pairs (2 rows), gathered from T (12
+   * rows) with its own stride, to out (12 rows)
+   */
+  void (*relativePoses)(const double* T, std::size_t poseStride,
+                        const std::size_t* pairs, double* out,
+                        std::size_t stride, std::size_t begin,
+                        std::size_t end);
+
+  /** \brief J(xi) * v, J(xi)^T * v or J(xi)^-1 * v, all 6 rows */
+  void (*applyJac)(const double* xi, const double* v, double* out,
+                   std::size_t stride, std::size_t begin, std::size_t end,
+                   JacobianProduct product);
+
+  /** \brief Ad(T) * v, T (12 rows), v and out (6 rows) */
+  void (*applyAdjoint)(const double* T, const double* v, double* out,
+                       std::size_t stride, std::size_t begin,
+                       std::size_t end);
+
+  /** \brief curlyhat(xi) * v, all 6 rows */
+  void (*applyCurlyhat)(const double* xi, const double* v, double* out,
+                        std::size_t stride, std::size_t begin,
+                        std::size_t end);
+
+  /**
+   * \brief Interpolation of one pose pair at the alpha (1 row) to T (12
+   * rows), from the 49 coefficients of interpolationCoefficients
+   */
+  void (*interpolate)(const double* coeffs, const double* alpha, double* T,
+                      std::size_t stride, std::size_t begin, std::size_t end);
+
+  /**
+   * \brief De-skews points (3 rows) at the times t (1 row), with the numKnots
+   * buckets of 24 doubles of Deskew starting at t0, rate buckets per unit of
+   * time
+   */
+  void (*deskew)(const double* knots, std::size_t numKnots, double t0,
+                 double rate, const double* t, const double* p, double* out,
+                 std::size_t stride, std::size_t begin, std::size_t end);
+
+  /**
+   * \brief Poses (12 rows) of one segment of a Spline at the times t (1 row),
+   * from the 3 * 49 coefficients of its factors, for the segment starting at
+   * t0 and rate segments per unit of time
+   */
+  void (*spline)(const double* coeffs, double t0, double rate,
+                 const double* t, double* T, std::size_t stride,
+                 std::size_t begin, std::size_t end);
+};
+
+/**
+ * \brief Fills the 49 coefficients of the interpolate kernel for
+ * T_0 * exp(alpha * xi), xi the 6 entries of an se3 algebra vector; defined
+ * with the batch functions, as it uses Eigen
+ */
+void interpolationCoefficients(const Transformation& T_0, const double* xi,
+                               double* coeffs);
+
+/**
+ * \brief Gets the kernels of an instruction set, null if they were not built
+ * (the compiler does not target x86)
+ */
+const BatchKernels* genericBatchKernels();
+const BatchKernels* sse42BatchKernels();
+const BatchKernels* avx2BatchKernels();
+const BatchKernels* avx512BatchKernels();
+
+/** \brief Gets the kernels of the active instruction set */
+const BatchKernels& batchKernels();
+
+}  // namespace detail
+}  // namespace se3
+}  // namespace lgmath
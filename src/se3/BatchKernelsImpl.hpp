@@ -0,0 +1,717 @@
+/**
+ * \file BatchKernelsImpl.hpp
+ * \brief Implementation of the batch kernels, included once per instruction
+ * set.
+ * \details The including translation unit defines LGMATH_BATCH_ISA, the
+ * namespace of its variant, and is compiled with the flags of its instruction
+ * set. Everything here must stay in that namespace and must not use inline
+ * functions or templates shared with other translation units (Eigen, the
+ * standard containers or algorithms): the linker keeps one copy of such
+ * functions, which could then be an AVX-512 copy called on a CPU without
+ * AVX-512.
+ *
+ * The kernels work on chunks of elements. The transcendental functions are
+ * evaluated per element in a first pass; the second pass is branch-free
+ * arithmetic over the chunk, which the compiler vectorizes for the target
+ * instruction set.
+ *
+ * \author ASRL
+ */
+#ifndef LGMATH_BATCH_ISA
+#error "Define LGMATH_BATCH_ISA before including BatchKernelsImpl.hpp"
+#endif
+
+#include <cmath>
+#include <cstddef>
+
+#include "BatchKernels.hpp"
+
+#if defined(__clang__)
+#define LGMATH_BATCH_IVDEP _Pragma("clang loop vectorize(assume_safety)")
+#elif defined(__GNUC__)
+#define LGMATH_BATCH_IVDEP _Pragma("GCC ivdep")
+#else
+#define LGMATH_BATCH_IVDEP
+#endif
+
+namespace lgmath {
+namespace se3 {
+namespace detail {
+namespace LGMATH_BATCH_ISA {
+namespace {
+
+/** \brief Number of elements per chunk */
+const std::size_t CHUNK = 64;
+
+/** \brief Row of the 3x4 row-major pose element (row, col) */
+inline std::size_t poseRow(std::size_t row, std::size_t col) {
+  return 4 * row + col;
+}
+
+void vec2tran(const double* xi, double* T, std::size_t stride,
+              std::size_t begin, std::size_t end) {
+  // C = I + a1 * [w]x + a2 * [w]x^2 and J = I + b1 * [w]x + b2 * [w]x^2, so
+  // that r = J * rho (see so3::vec2rot and so3::vec2jac)
+  double a1[CHUNK], a2[CHUNK], b1[CHUNK], b2[CHUNK];
+  for (std::size_t first = begin; first < end; first += CHUNK) {
+    const std::size_t last = end - first < CHUNK ? end : first + CHUNK;
+
+    for (std::size_t i = first; i < last; ++i) {
+      const std::size_t j = i - first;
+      const double w0 = xi[3 * stride + i];
+      const double w1 = xi[4 * stride + i];
+      const double w2 = xi[5 * stride + i];
+      const double phi2 = w0 * w0 + w1 * w1 + w2 * w2;
+      const double phi = std::sqrt(phi2);
+      if (phi < 1e-12) {
+        // If angle is very small, rotation is Identity
+        a1[j] = a2[j] = b1[j] = b2[j] = 0.0;
+      } else {
+        const double s = std::sin(phi);
+        const double c = std::cos(phi);
+        a1[j] = s / phi;
+        a2[j] = (1.0 - c) / phi2;
+        b1[j] = a2[j];
+        b2[j] = (phi - s) / (phi2 * phi);
+      }
+    }
+
+    LGMATH_BATCH_IVDEP
+    for (std::size_t i = first; i < last; ++i) {
+      const std::size_t j = i - first;
+      const double r0 = xi[0 * stride + i];
+      const double r1 = xi[1 * stride + i];
+      const double r2 = xi[2 * stride + i];
+      const double w0 = xi[3 * stride + i];
+      const double w1 = xi[4 * stride + i];
+      const double w2 = xi[5 * stride + i];
+
+      // [w]x^2 = w * w^T - |w|^2 * I
+      const double phi2 = w0 * w0 + w1 * w1 + w2 * w2;
+      const double q00 = w0 * w0 - phi2, q11 = w1 * w1 - phi2,
+                   q22 = w2 * w2 - phi2;
+      const double q01 = w0 * w1, q02 = w0 * w2, q12 = w1 * w2;
+
+      T[poseRow(0, 0) * stride + i] = 1.0 + a2[j] * q00;
+      T[poseRow(0, 1) * stride + i] = -a1[j] * w2 + a2[j] * q01;
+      T[poseRow(0, 2) * stride + i] = a1[j] * w1 + a2[j] * q02;
+      T[poseRow(1, 0) * stride + i] = a1[j] * w2 + a2[j] * q01;
+      T[poseRow(1, 1) * stride + i] = 1.0 + a2[j] * q11;
+      T[poseRow(1, 2) * stride + i] = -a1[j] * w0 + a2[j] * q12;
+      T[poseRow(2, 0) * stride + i] = -a1[j] * w1 + a2[j] * q02;
+      T[poseRow(2, 1) * stride + i] = a1[j] * w0 + a2[j] * q12;
+      T[poseRow(2, 2) * stride + i] = 1.0 + a2[j] * q22;
+
+      const double J00 = 1.0 + b2[j] * q00, J11 = 1.0 + b2[j] * q11,
+                   J22 = 1.0 + b2[j] * q22;
+      const double J01 = -b1[j] * w2 + b2[j] * q01,
+                   J10 = b1[j] * w2 + b2[j] * q01;
+      const double J02 = b1[j] * w1 + b2[j] * q02,
+                   J20 = -b1[j] * w1 + b2[j] * q02;
+      const double J12 = -b1[j] * w0 + b2[j] * q12,
+                   J21 = b1[j] * w0 + b2[j] * q12;
+      T[poseRow(0, 3) * stride + i] = J00 * r0 + J01 * r1 + J02 * r2;
+      T[poseRow(1, 3) * stride + i] = J10 * r0 + J11 * r1 + J12 * r2;
+      T[poseRow(2, 3) * stride + i] = J20 * r0 + J21 * r1 + J22 * r2;
+    }
+  }
+}
+
+void tran2vec(const double* T, double* xi, std::size_t stride,
+              std::size_t begin, std::size_t end, NearPiLog nearPiLog) {
+  // rho = Jinv * r, with Jinv = g * I + e * w * w^T - 0.5 * [w]x (see
+  // so3::vec2jacinv)
+  double g[CHUNK], e[CHUNK];
+  for (std::size_t first = begin; first < end; first += CHUNK) {
+    const std::size_t last = end - first < CHUNK ? end : first + CHUNK;
+
+    // Rotation vector, as in so3::rot2vec
+    for (std::size_t i = first; i < last; ++i) {
+      const std::size_t j = i - first;
+      const double trace = T[poseRow(0, 0) * stride + i] +
+                           T[poseRow(1, 1) * stride + i] +
+                           T[poseRow(2, 2) * stride + i];
+      double cosphi = 0.5 * (trace - 1.0);
+      cosphi = cosphi < -1.0 ? -1.0 : (cosphi > 1.0 ? 1.0 : cosphi);
+      const double phi = std::acos(cosphi);
+      const double sinphi = std::sin(phi);
+      double w[3];
+      if (std::fabs(sinphi) > 1e-9) {
+        // General case, angle is NOT near 0, pi, or 2*pi
+        const double k = 0.5 * phi / sinphi;
+        w[0] = k * (T[poseRow(2, 1) * stride + i] -
+                    T[poseRow(1, 2) * stride + i]);
+        w[1] = k * (T[poseRow(0, 2) * stride + i] -
+                    T[poseRow(2, 0) * stride + i]);
+        w[2] = k * (T[poseRow(1, 0) * stride + i] -
+                    T[poseRow(0, 1) * stride + i]);
+      } else if (std::fabs(phi) > 1e-9) {
+        // Angle is near pi or 2*pi
+        nearPiLog(T, stride, i, w);
+      } else {
+        // Angle is near zero
+        w[0] = w[1] = w[2] = 0.0;
+      }
+      xi[3 * stride + i] = w[0];
+      xi[4 * stride + i] = w[1];
+      xi[5 * stride + i] = w[2];
+
+      const double phi2 = w[0] * w[0] + w[1] * w[1] + w[2] * w[2];
+      const double phiw = std::sqrt(phi2);
+      if (phiw < 1e-12) {
+        // If angle is very small, the jacobian is Identity
+        g[j] = 1.0;
+        e[j] = 0.0;
+      } else {
+        const double half = 0.5 * phiw;
+        g[j] = half / std::tan(half);
+        e[j] = (1.0 - g[j]) / phi2;
+      }
+    }
+
+    LGMATH_BATCH_IVDEP
+    for (std::size_t i = first; i < last; ++i) {
+      const std::size_t j = i - first;
+      const double r0 = T[poseRow(0, 3) * stride + i];
+      const double r1 = T[poseRow(1, 3) * stride + i];
+      const double r2 = T[poseRow(2, 3) * stride + i];
+      const double w0 = xi[3 * stride + i];
+      const double w1 = xi[4 * stride + i];
+      const double w2 = xi[5 * stride + i];
+      const double wr = e[j] * (w0 * r0 + w1 * r1 + w2 * r2);
+      xi[0 * stride + i] = g[j] * r0 + wr * w0 - 0.5 * (w1 * r2 - w2 * r1);
+      xi[1 * stride + i] = g[j] * r1 + wr * w1 - 0.5 * (w2 * r0 - w0 * r2);
+      xi[2 * stride + i] = g[j] * r2 + wr * w2 - 0.5 * (w0 * r1 - w1 * r0);
+    }
+  }
+}
+
+void transformPoints(const double* T, const double* p, double* out,
+                     std::size_t stride, std::size_t begin,
+                     std::size_t end) {
+  const double C00 = T[0], C01 = T[1], C02 = T[2], r0 = T[3];
+  const double C10 = T[4], C11 = T[5], C12 = T[6], r1 = T[7];
+  const double C20 = T[8], C21 = T[9], C22 = T[10], r2 = T[11];
+  LGMATH_BATCH_IVDEP
+  for (std::size_t i = begin; i < end; ++i) {
+    const double x = p[i];
+    const double y = p[stride + i];
+    const double z = p[2 * stride + i];
+    out[i] = C00 * x + C01 * y + C02 * z + r0;
+    out[stride + i] = C10 * x + C11 * y + C12 * z + r1;
+    out[2 * stride + i] = C20 * x + C21 * y + C22 * z + r2;
+  }
+}
+
+void transformPointsPerPose(const double* T, const double* p, double* out,
+                            std::size_t stride, std::size_t begin,
+                            std::size_t end) {
+  LGMATH_BATCH_IVDEP
+  for (std::size_t i = begin; i < end; ++i) {
+    const double x = p[i];
+    const double y = p[stride + i];
+    const double z = p[2 * stride + i];
+    for (std::size_t row = 0; row < 3; ++row) {
+      out[row * stride + i] = T[poseRow(row, 0) * stride + i] * x +
+                              T[poseRow(row, 1) * stride + i] * y +
+                              T[poseRow(row, 2) * stride + i] * z +
+                              T[poseRow(row, 3) * stride + i];
+    }
+  }
+}
+
+/** \brief Row of the packed upper triangle element (row, col) */
+inline std::size_t covRow(std::size_t row, std::size_t col) {
+  if (row > col) {
+    return covRow(col, row);
+  }
+  // Rows before this one hold 6 + 5 + ... + (7 - row) elements
+  return row * (13 - row) / 2 + (col - row);
+}
+
+void propagateCovariance(const double* T, std::size_t poseStride,
+                         const double* cov, double* out, std::size_t stride,
+                         std::size_t begin, std::size_t end) {
+  // Ad(T) = [C, B; 0, C] with B = [r]x * C; the zero block is never read.
+  // Each product below is an inner loop over the elements of a chunk, so that
+  // it vectorizes.
+  double Ad[6][6][CHUNK], AS[6][6][CHUNK];
+  for (std::size_t first = begin; first < end; first += CHUNK) {
+    const std::size_t last = end - first < CHUNK ? end : first + CHUNK;
+    const std::size_t n = last - first;
+    const double* Tf = T + first;
+    const double* Sf = cov + first;
+    double* outf = out + first;
+
+    for (std::size_t row = 0; row < 3; ++row) {
+      const std::size_t next = (row + 1) % 3, prev = (row + 2) % 3;
+      for (std::size_t col = 0; col < 3; ++col) {
+        const double* C_rc = Tf + poseRow(row, col) * poseStride;
+        const double* C_nc = Tf + poseRow(next, col) * poseStride;
+        const double* C_pc = Tf + poseRow(prev, col) * poseStride;
+        const double* r_n = Tf + poseRow(next, 3) * poseStride;
+        const double* r_p = Tf + poseRow(prev, 3) * poseStride;
+        LGMATH_BATCH_IVDEP
+        for (std::size_t j = 0; j < n; ++j) {
+          Ad[row][col][j] = Ad[row + 3][col + 3][j] = C_rc[j];
+          Ad[row][col + 3][j] = r_n[j] * C_pc[j] - r_p[j] * C_nc[j];
+        }
+      }
+    }
+
+    // Ad * S, skipping the zero block of Ad
+    for (std::size_t row = 0; row < 6; ++row) {
+      const std::size_t m0 = row < 3 ? 0 : 3;
+      for (std::size_t col = 0; col < 6; ++col) {
+        LGMATH_BATCH_IVDEP
+        for (std::size_t j = 0; j < n; ++j) {
+          AS[row][col][j] = 0.0;
+        }
+        for (std::size_t m = m0; m < 6; ++m) {
+          const double* S_mc = Sf + covRow(m, col) * stride;
+          LGMATH_BATCH_IVDEP
+          for (std::size_t j = 0; j < n; ++j) {
+            AS[row][col][j] += Ad[row][m][j] * S_mc[j];
+          }
+        }
+      }
+    }
+
+    // (Ad * S) * Ad^T, upper triangle; cov is not read past this point, so
+    // out may alias it
+    for (std::size_t row = 0; row < 6; ++row) {
+      for (std::size_t col = row; col < 6; ++col) {
+        const std::size_t m0 = col < 3 ? 0 : 3;
+        double* out_rc = outf + covRow(row, col) * stride;
+        LGMATH_BATCH_IVDEP
+        for (std::size_t j = 0; j < n; ++j) {
+          double sum = 0.0;
+          for (std::size_t m = m0; m < 6; ++m) {
+            sum += AS[row][m][j] * Ad[col][m][j];
+          }
+          out_rc[j] = sum;
+        }
+      }
+    }
+  }
+}
+
+void compose(const double* lhs, const double* rhs, double* out,
+             std::size_t stride, std::size_t begin, std::size_t end) {
+  // [C_l * C_r, C_l * r_r + r_l]; all rows of element i are read before any
+  // is written, so out may alias lhs or rhs
+  LGMATH_BATCH_IVDEP
+  for (std::size_t i = begin; i < end; ++i) {
+    double L[3][4], R[3][4];
+    for (std::size_t row = 0; row < 3; ++row) {
+      for (std::size_t col = 0; col < 4; ++col) {
+        L[row][col] = lhs[poseRow(row, col) * stride + i];
+        R[row][col] = rhs[poseRow(row, col) * stride + i];
+      }
+    }
+    for (std::size_t row = 0; row < 3; ++row) {
+      for (std::size_t col = 0; col < 4; ++col) {
+        out[poseRow(row, col) * stride + i] =
+            L[row][0] * R[0][col] + L[row][1] * R[1][col] +
+            L[row][2] * R[2][col] + (col == 3 ? L[row][3] : 0.0);
+      }
+    }
+  }
+}
+
+void inverse(const double* T, double* out, std::size_t stride,
+             std::size_t begin, std::size_t end) {
+  // T^-1 = [C^T, -C^T * r]; all rows of element i are read before any is
+  // written, so out may alias T
+  LGMATH_BATCH_IVDEP
+  for (std::size_t i = begin; i < end; ++i) {
+    double C[3][3], r[3];
+    for (std::size_t row = 0; row < 3; ++row) {
+      for (std::size_t col = 0; col < 3; ++col) {
+        C[row][col] = T[poseRow(row, col) * stride + i];
+      }
+      r[row] = T[poseRow(row, 3) * stride + i];
+    }
+    for (std::size_t row = 0; row < 3; ++row) {
+      for (std::size_t col = 0; col < 3; ++col) {
+        out[poseRow(row, col) * stride + i] = C[col][row];
+      }
+      out[poseRow(row, 3) * stride + i] =
+          -(C[0][row] * r[0] + C[1][row] * r[1] + C[2][row] * r[2]);
+    }
+  }
+}
+
+void relativePoses(const double* T, std::size_t poseStride,
+                   const std::size_t* pairs, double* out, std::size_t stride,
+                   std::size_t begin, std::size_t end) {
+  // T_i * T_j^-1 = [C_i * C_j^T, r_i - C_i * C_j^T * r_j], as in
+  // Transformation::operator/= without the reprojection. The poses are
+  // gathered, so out must not alias T.
+  LGMATH_BATCH_IVDEP
+  for (std::size_t k = begin; k < end; ++k) {
+    const std::size_t i = pairs[k];
+    const std::size_t j = pairs[stride + k];
+    double C_i[3][3], C_j[3][3], r_i[3], r_j[3];
+    for (std::size_t row = 0; row < 3; ++row) {
+      for (std::size_t col = 0; col < 3; ++col) {
+        C_i[row][col] = T[poseRow(row, col) * poseStride + i];
+        C_j[row][col] = T[poseRow(row, col) * poseStride + j];
+      }
+      r_i[row] = T[poseRow(row, 3) * poseStride + i];
+      r_j[row] = T[poseRow(row, 3) * poseStride + j];
+    }
+    for (std::size_t row = 0; row < 3; ++row) {
+      double C[3];
+      for (std::size_t col = 0; col < 3; ++col) {
+        C[col] = C_i[row][0] * C_j[col][0] + C_i[row][1] * C_j[col][1] +
+                 C_i[row][2] * C_j[col][2];
+        out[poseRow(row, col) * stride + k] = C[col];
+      }
+      out[poseRow(row, 3) * stride + k] =
+          r_i[row] - (C[0] * r_j[0] + C[1] * r_j[1] + C[2] * r_j[2]);
+    }
+  }
+}
+
+/** \brief A 3-vector of the second passes, kept in registers */
+struct Vec3 {
+  double x, y, z;
+};
+
+inline Vec3 cross(const Vec3& a, const Vec3& b) {
+  return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+inline Vec3 add(const Vec3& a, const Vec3& b) {
+  return {a.x + b.x, a.y + b.y, a.z + b.z};
+}
+
+inline Vec3 scale(double k, const Vec3& a) {
+  return {k * a.x, k * a.y, k * a.z};
+}
+
+inline double dot(const Vec3& a, const Vec3& b) {
+  return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+/** \brief Loads rows row..row+2 of element i */
+inline Vec3 load(const double* data, std::size_t row, std::size_t stride,
+                 std::size_t i) {
+  return {data[row * stride + i], data[(row + 1) * stride + i],
+          data[(row + 2) * stride + i]};
+}
+
+/** \brief Stores a to rows row..row+2 of element i */
+inline void store(const Vec3& a, double* data, std::size_t row,
+                  std::size_t stride, std::size_t i) {
+  data[row * stride + i] = a.x;
+  data[(row + 1) * stride + i] = a.y;
+  data[(row + 2) * stride + i] = a.z;
+}
+
+/** \brief so3 Jacobian times v, J = I + a1 * p^ + m2 * p^p^ */
+inline Vec3 so3Jac(double a1, double m2, const Vec3& p, const Vec3& v) {
+  const Vec3 pv = cross(p, v);
+  return add(v, add(scale(a1, pv), scale(m2, cross(p, pv))));
+}
+
+/**
+ * \brief Q times v (see se3::vec2Q); with zero coefficients this is the small
+ * angle case, 0.5 * r^ * v
+ */
+inline Vec3 applyQ(double m2, double m3, double m4, const Vec3& r,
+                   const Vec3& p, const Vec3& v) {
+  const Vec3 rv = cross(r, v);
+  const Vec3 pv = cross(p, v);
+  const Vec3 prv = cross(p, rv);
+  const Vec3 rpv = cross(r, pv);
+  const Vec3 prpv = cross(p, rpv);
+  const Vec3 pprv = cross(p, prv);
+  const Vec3 rppv = cross(r, cross(p, pv));
+  const Vec3 prppv = cross(p, rppv);
+  const Vec3 pprpv = cross(p, prpv);
+  return add(add(scale(0.5, rv), scale(m2, add(add(prv, rpv), prpv))),
+             add(scale(-m3, add(add(pprv, rppv), scale(-3.0, prpv))),
+                 scale(-m4, add(prppv, pprpv))));
+}
+
+void applyJac(const double* xi, const double* v, double* out,
+              std::size_t stride, std::size_t begin, std::size_t end,
+              JacobianProduct product) {
+  // Coefficients of the so3 Jacobian (a1, m2), of Q (m2, m3, m4) and of the
+  // so3 inverse Jacobian (g, e); all zero but g = 1 for small angles, which
+  // gives the identity and Q = 0.5 * rho^ as in se3::vec2jac
+  double a1[CHUNK], m2[CHUNK], m3[CHUNK], m4[CHUNK], g[CHUNK], e[CHUNK];
+  for (std::size_t first = begin; first < end; first += CHUNK) {
+    const std::size_t last = end - first < CHUNK ? end : first + CHUNK;
+
+    for (std::size_t i = first; i < last; ++i) {
+      const std::size_t j = i - first;
+      const Vec3 p = load(xi, 3, stride, i);
+      const double ang2 = dot(p, p);
+      const double ang = std::sqrt(ang2);
+      if (ang < 1e-12) {
+        a1[j] = m2[j] = m3[j] = m4[j] = e[j] = 0.0;
+        g[j] = 1.0;
+      } else {
+        const double ang3 = ang2 * ang, ang4 = ang3 * ang, ang5 = ang4 * ang;
+        const double c = std::cos(ang), s = std::sin(ang);
+        a1[j] = (1.0 - c) / ang2;
+        m2[j] = (ang - s) / ang3;
+        m3[j] = (1.0 - 0.5 * ang2 - c) / ang4;
+        m4[j] = 0.5 * (m3[j] - 3 * (ang - s - ang3 / 6) / ang5);
+        g[j] = 0.5 * ang / std::tan(0.5 * ang);
+        e[j] = (1.0 - g[j]) / ang2;
+      }
+    }
+
+    if (product == JacobianProduct::JAC) {
+      LGMATH_BATCH_IVDEP
+      for (std::size_t i = first; i < last; ++i) {
+        const std::size_t j = i - first;
+        const Vec3 r = load(xi, 0, stride, i), p = load(xi, 3, stride, i);
+        const Vec3 u = load(v, 0, stride, i), w = load(v, 3, stride, i);
+        store(add(so3Jac(a1[j], m2[j], p, u),
+                  applyQ(m2[j], m3[j], m4[j], r, p, w)),
+              out, 0, stride, i);
+        store(so3Jac(a1[j], m2[j], p, w), out, 3, stride, i);
+      }
+    } else if (product == JacobianProduct::JAC_TRANSPOSE) {
+      // J(r, p)^T = [J(-p), 0; Q(-r, -p), J(-p)] (see se3::applyJacTranspose)
+      LGMATH_BATCH_IVDEP
+      for (std::size_t i = first; i < last; ++i) {
+        const std::size_t j = i - first;
+        const Vec3 r = scale(-1.0, load(xi, 0, stride, i));
+        const Vec3 p = scale(-1.0, load(xi, 3, stride, i));
+        const Vec3 u = load(v, 0, stride, i), w = load(v, 3, stride, i);
+        store(so3Jac(a1[j], m2[j], p, u), out, 0, stride, i);
+        store(add(applyQ(m2[j], m3[j], m4[j], r, p, u),
+                  so3Jac(a1[j], m2[j], p, w)),
+              out, 3, stride, i);
+      }
+    } else {
+      // J^-1 = [Ji, -Ji * Q * Ji; 0, Ji] with the so3 inverse Jacobian
+      // Ji = g * I + e * p * p^T - 0.5 * p^
+      LGMATH_BATCH_IVDEP
+      for (std::size_t i = first; i < last; ++i) {
+        const std::size_t j = i - first;
+        const Vec3 r = load(xi, 0, stride, i), p = load(xi, 3, stride, i);
+        const Vec3 u = load(v, 0, stride, i), w = load(v, 3, stride, i);
+        const Vec3 c = add(add(scale(g[j], w), scale(e[j] * dot(p, w), p)),
+                           scale(-0.5, cross(p, w)));
+        const Vec3 d =
+            add(u, scale(-1.0, applyQ(m2[j], m3[j], m4[j], r, p, c)));
+        store(add(add(scale(g[j], d), scale(e[j] * dot(p, d), p)),
+                  scale(-0.5, cross(p, d))),
+              out, 0, stride, i);
+        store(c, out, 3, stride, i);
+      }
+    }
+  }
+}
+
+void applyAdjoint(const double* T, const double* v, double* out,
+                  std::size_t stride, std::size_t begin, std::size_t end) {
+  // Ad(T) * [u; w] = [C * u + r^ * C * w; C * w]
+  LGMATH_BATCH_IVDEP
+  for (std::size_t i = begin; i < end; ++i) {
+    const Vec3 u = load(v, 0, stride, i), w = load(v, 3, stride, i);
+    const Vec3 C0 = {T[poseRow(0, 0) * stride + i],
+                     T[poseRow(0, 1) * stride + i],
+                     T[poseRow(0, 2) * stride + i]};
+    const Vec3 C1 = {T[poseRow(1, 0) * stride + i],
+                     T[poseRow(1, 1) * stride + i],
+                     T[poseRow(1, 2) * stride + i]};
+    const Vec3 C2 = {T[poseRow(2, 0) * stride + i],
+                     T[poseRow(2, 1) * stride + i],
+                     T[poseRow(2, 2) * stride + i]};
+    const Vec3 r = {T[poseRow(0, 3) * stride + i],
+                    T[poseRow(1, 3) * stride + i],
+                    T[poseRow(2, 3) * stride + i]};
+    const Vec3 Cu = {dot(C0, u), dot(C1, u), dot(C2, u)};
+    const Vec3 Cw = {dot(C0, w), dot(C1, w), dot(C2, w)};
+    store(add(Cu, cross(r, Cw)), out, 0, stride, i);
+    store(Cw, out, 3, stride, i);
+  }
+}
+
+void applyCurlyhat(const double* xi, const double* v, double* out,
+                   std::size_t stride, std::size_t begin, std::size_t end) {
+  LGMATH_BATCH_IVDEP
+  for (std::size_t i = begin; i < end; ++i) {
+    const Vec3 r = load(xi, 0, stride, i), p = load(xi, 3, stride, i);
+    const Vec3 u = load(v, 0, stride, i), w = load(v, 3, stride, i);
+    store(add(cross(p, u), cross(r, w)), out, 0, stride, i);
+    store(cross(p, w), out, 3, stride, i);
+  }
+}
+
+void interpolate(const double* coeffs, const double* alpha, double* T,
+                 std::size_t stride, std::size_t begin, std::size_t end) {
+  // T = A + alpha * B + sin(theta) * S + (1 - cos(theta)) * V, with
+  // theta = alpha * phi (see interpolateBatch); the half-angle forms keep
+  // 1 - cos(theta) accurate for small angles
+  const double* A = coeffs;
+  const double* B = coeffs + 12;
+  const double* S = coeffs + 24;
+  const double* V = coeffs + 36;
+  const double phi = coeffs[48];
+  double s[CHUNK], v[CHUNK];
+  for (std::size_t first = begin; first < end; first += CHUNK) {
+    const std::size_t last = end - first < CHUNK ? end : first + CHUNK;
+
+    for (std::size_t i = first; i < last; ++i) {
+      const std::size_t j = i - first;
+      const double half = 0.5 * alpha[i] * phi;
+      const double sh = std::sin(half);
+      const double ch = std::cos(half);
+      s[j] = 2.0 * sh * ch;
+      v[j] = 2.0 * sh * sh;
+    }
+
+    for (std::size_t k = 0; k < 12; ++k) {
+      double* row = T + k * stride;
+      LGMATH_BATCH_IVDEP
+      for (std::size_t i = first; i < last; ++i) {
+        const std::size_t j = i - first;
+        row[i] = A[k] + alpha[i] * B[k] + s[j] * S[k] + v[j] * V[k];
+      }
+    }
+  }
+}
+
+void spline(const double* coeffs, double t0, double rate, const double* t,
+            double* T, std::size_t stride, std::size_t begin,
+            std::size_t end) {
+  // T = F_3 * F_2 * F_1, where F_f = A + beta * B + sin * S + (1 - cos) * V
+  // with the 49 coefficients of factor f at its cumulative basis function
+  // beta of the fraction u of the segment (see Spline)
+  double beta[3][CHUNK], s[3][CHUNK], v[3][CHUNK];
+  for (std::size_t first = begin; first < end; first += CHUNK) {
+    const std::size_t last = end - first < CHUNK ? end : first + CHUNK;
+
+    for (std::size_t i = first; i < last; ++i) {
+      const std::size_t j = i - first;
+      const double u = (t[i] - t0) * rate;
+      const double u2 = u * u;
+      const double u3 = u2 * u;
+      beta[0][j] = (5.0 + 3.0 * u - 3.0 * u2 + u3) / 6.0;
+      beta[1][j] = (1.0 + 3.0 * u + 3.0 * u2 - 2.0 * u3) / 6.0;
+      beta[2][j] = u3 / 6.0;
+      for (std::size_t f = 0; f < 3; ++f) {
+        const double half = 0.5 * beta[f][j] * coeffs[49 * f + 48];
+        const double sh = std::sin(half);
+        const double ch = std::cos(half);
+        s[f][j] = 2.0 * sh * ch;
+        v[f][j] = 2.0 * sh * sh;
+      }
+    }
+
+    LGMATH_BATCH_IVDEP
+    for (std::size_t i = first; i < last; ++i) {
+      const std::size_t j = i - first;
+      double P[3][4];
+      for (std::size_t k = 0; k < 12; ++k) {
+        P[k / 4][k % 4] = coeffs[k] + beta[0][j] * coeffs[12 + k] +
+                          s[0][j] * coeffs[24 + k] + v[0][j] * coeffs[36 + k];
+      }
+      for (std::size_t f = 1; f < 3; ++f) {
+        const double* c = coeffs + 49 * f;
+        double F[3][4], Q[3][4];
+        for (std::size_t k = 0; k < 12; ++k) {
+          F[k / 4][k % 4] = c[k] + beta[f][j] * c[12 + k] +
+                            s[f][j] * c[24 + k] + v[f][j] * c[36 + k];
+        }
+        for (std::size_t row = 0; row < 3; ++row) {
+          for (std::size_t col = 0; col < 4; ++col) {
+            Q[row][col] = F[row][0] * P[0][col] + F[row][1] * P[1][col] +
+                          F[row][2] * P[2][col] + (col == 3 ? F[row][3] : 0.0);
+          }
+        }
+        for (std::size_t k = 0; k < 12; ++k) {
+          P[k / 4][k % 4] = Q[k / 4][k % 4];
+        }
+      }
+      for (std::size_t row = 0; row < 3; ++row) {
+        for (std::size_t col = 0; col < 4; ++col) {
+          T[poseRow(row, col) * stride + i] = P[row][col];
+        }
+      }
+    }
+  }
+}
+
+void deskew(const double* knots, std::size_t numKnots, double t0, double rate,
+            const double* t, const double* p, double* out, std::size_t stride,
+            std::size_t begin, std::size_t end) {
+  // In bucket k, T = T_k + beta * (T_k+1 - T_k) for the fraction beta of the
+  // bucket (see Deskew); the points of a run in the same bucket share T_k and
+  // the differences, so that the run vectorizes
+  std::size_t bucket[CHUNK];
+  double beta[CHUNK];
+  for (std::size_t first = begin; first < end; first += CHUNK) {
+    const std::size_t last = end - first < CHUNK ? end : first + CHUNK;
+
+    for (std::size_t i = first; i < last; ++i) {
+      const std::size_t j = i - first;
+      const double u = (t[i] - t0) * rate;
+      std::size_t k = 0;
+      if (u >= double(numKnots)) {
+        k = numKnots - 1;
+      } else if (u >= 1.0) {
+        k = static_cast<std::size_t>(u);
+      }
+      bucket[j] = k;
+      beta[j] = u - double(k);
+    }
+
+    for (std::size_t run = first; run < last;) {
+      const std::size_t k = bucket[run - first];
+      std::size_t stop = run + 1;
+      while (stop < last && bucket[stop - first] == k) {
+        ++stop;
+      }
+      const double* T = knots + 24 * k;
+      const double* D = T + 12;
+
+      LGMATH_BATCH_IVDEP
+      for (std::size_t i = run; i < stop; ++i) {
+        const double b = beta[i - first];
+        const double x = p[i], y = p[stride + i], z = p[2 * stride + i];
+        out[i] = (T[0] + b * D[0]) * x + (T[1] + b * D[1]) * y +
+                 (T[2] + b * D[2]) * z + (T[3] + b * D[3]);
+        out[stride + i] = (T[4] + b * D[4]) * x + (T[5] + b * D[5]) * y +
+                          (T[6] + b * D[6]) * z + (T[7] + b * D[7]);
+        out[2 * stride + i] = (T[8] + b * D[8]) * x + (T[9] + b * D[9]) * y +
+                              (T[10] + b * D[10]) * z + (T[11] + b * D[11]);
+      }
+      run = stop;
+    }
+  }
+}
+
+}  // namespace
+
+/** \brief The kernels of this instruction set */
+const BatchKernels KERNELS = {vec2tran,
+                              tran2vec,
+                              transformPoints,
+                              transformPointsPerPose,
+                              propagateCovariance,
+                              compose,
+                              inverse,
+                              relativePoses,
+                              applyJac,
+                              applyAdjoint,
+                              applyCurlyhat,
+                              interpolate,
+                              deskew,
+                              spline};
+
+}  // namespace LGMATH_BATCH_ISA
+}  // namespace detail
+}  // namespace se3
+}  // namespace lgmath
+
+#undef LGMATH_BATCH_IVDEP
@@ -0,0 +1,30 @@
+/**
+ * \file BatchSse42.cpp
+ * \brief Batch kernels for SSE4.2.
+ * \details Compiled with the SSE4.2 flags (see CMakeLists.txt); empty when the
+ * compiler does not target x86.
+ *
+ * \author ASRL
+ */
+#if defined(__SSE4_2__)
+#define LGMATH_BATCH_ISA sse42
+#include "BatchKernelsImpl.hpp"
+#else
+#include "BatchKernels.hpp"
+#endif
+
+namespace lgmath {
+namespace se3 {
+namespace detail {
+
+const BatchKernels* sse42BatchKernels() {
+#if defined(__SSE4_2__)
+  return &sse42::KERNELS;
+#else
+  return nullptr;
+#endif
+}
+
+}  // namespace detail
+}  // namespace se3
+}  // namespace lgmath
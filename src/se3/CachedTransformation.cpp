@@ -0,0 +1,188 @@
+/**
+ * \file CachedTransformation.cpp
+ * \brief Implementation file for a transformation class that caches its log map
+ * and adjoint.
+ *
+ * \author ASRL
+ */
+#include <lgmath/se3/CachedTransformation.hpp>
+
+#include <thread>
+
+#include <lgmath/Counters.hpp>
+
+namespace lgmath {
+namespace se3 {
+
+CachedTransformation::CachedTransformation()
+    : Transformation(), vecState_(EMPTY), adjointState_(EMPTY) {}
+
+CachedTransformation::CachedTransformation(const CachedTransformation& T)
+    : Transformation(T), vecState_(EMPTY), adjointState_(EMPTY) {
+  copyCache(T);
+}
+
+CachedTransformation::CachedTransformation(CachedTransformation&& T) noexcept
+    : Transformation(T), vecState_(EMPTY), adjointState_(EMPTY) {
+  copyCache(T);
+}
+
+CachedTransformation::CachedTransformation(const Transformation& T)
+    : Transformation(T), vecState_(EMPTY), adjointState_(EMPTY) {}
+
+CachedTransformation::CachedTransformation(Transformation&& T)
+    : Transformation(T), vecState_(EMPTY), adjointState_(EMPTY) {}
+
+CachedTransformation::CachedTransformation(const Eigen::Matrix4d& T)
+    : Transformation(T), vecState_(EMPTY), adjointState_(EMPTY) {}
+
+CachedTransformation::CachedTransformation(const Eigen::Matrix3d& C_ba,
+                                           const Eigen::Vector3d& r_ba_ina)
+    : Transformation(C_ba, r_ba_ina),
+      vecState_(EMPTY),
+      adjointState_(EMPTY) {}
+
+CachedTransformation::CachedTransformation(
+    const Eigen::Matrix<double, 6, 1>& xi_ab, unsigned int numTerms)
+    : Transformation(xi_ab, numTerms),
+      vecState_(EMPTY),
+      adjointState_(EMPTY) {}
+
+CachedTransformation& CachedTransformation::operator=(
+    const CachedTransformation& T) {
+  if (this != &T) {
+    Transformation::operator=(T);
+    copyCache(T);
+  }
+  return *this;
+}
+
+CachedTransformation& CachedTransformation::operator=(
+    CachedTransformation&& T) noexcept {
+  return *this = static_cast<const CachedTransformation&>(T);
+}
+
+CachedTransformation& CachedTransformation::operator=(
+    const Transformation& T) noexcept {
+  Transformation::operator=(T);
+  clearCache();
+  return *this;
+}
+
+CachedTransformation& CachedTransformation::operator=(
+    Transformation&& T) noexcept {
+  Transformation::operator=(T);
+  clearCache();
+  return *this;
+}
+
+const CachedTransformation::Vector6d& CachedTransformation::vec() const {
+  if (vecState_.load(std::memory_order_acquire) == FILLED) {
+    LGMATH_COUNT(CACHED_TRANSFORMATION_VEC_HIT);
+  } else if (beginFill(&vecState_)) {
+    LGMATH_COUNT(CACHED_TRANSFORMATION_VEC_MISS);
+    try {
+      vec_ = Transformation::vec();
+    } catch (...) {
+      // Release the readers waiting for the entry
+      vecState_.store(EMPTY, std::memory_order_release);
+      throw;
+    }
+    vecState_.store(FILLED, std::memory_order_release);
+  } else {
+    LGMATH_COUNT(CACHED_TRANSFORMATION_VEC_HIT);
+  }
+  return vec_;
+}
+
+const CachedTransformation::Matrix6d& CachedTransformation::adjoint() const {
+  if (adjointState_.load(std::memory_order_acquire) == FILLED) {
+    LGMATH_COUNT(CACHED_TRANSFORMATION_ADJOINT_HIT);
+  } else if (beginFill(&adjointState_)) {
+    LGMATH_COUNT(CACHED_TRANSFORMATION_ADJOINT_MISS);
+    try {
+      adjoint_ = Transformation::adjoint();
+    } catch (...) {
+      // Release the readers waiting for the entry
+      adjointState_.store(EMPTY, std::memory_order_release);
+      throw;
+    }
+    adjointState_.store(FILLED, std::memory_order_release);
+  } else {
+    LGMATH_COUNT(CACHED_TRANSFORMATION_ADJOINT_HIT);
+  }
+  return adjoint_;
+}
+
+CachedTransformation CachedTransformation::inverse() const {
+  return CachedTransformation(Transformation::inverse());
+}
+
+void CachedTransformation::reproject(bool force) {
+  Transformation::reproject(force);
+  clearCache();
+}
+
+CachedTransformation& CachedTransformation::operator*=(
+    const Transformation& T_rhs) {
+  Transformation::operator*=(T_rhs);
+  clearCache();
+  return *this;
+}
+
+CachedTransformation& CachedTransformation::operator/=(
+    const Transformation& T_rhs) {
+  Transformation::operator/=(T_rhs);
+  clearCache();
+  return *this;
+}
+
+bool CachedTransformation::vecCached() const {
+  return vecState_.load(std::memory_order_acquire) == FILLED;
+}
+
+bool CachedTransformation::adjointCached() const {
+  return adjointState_.load(std::memory_order_acquire) == FILLED;
+}
+
+void CachedTransformation::clearCache() {
+  vecState_.store(EMPTY, std::memory_order_relaxed);
+  adjointState_.store(EMPTY, std::memory_order_relaxed);
+}
+
+bool CachedTransformation::beginFill(std::atomic<int>* state) {
+  while (true) {
+    int expected = EMPTY;
+    if (state->compare_exchange_strong(expected, FILLING,
+                                       std::memory_order_acquire)) {
+      return true;
+    }
+    // Another reader is filling the entry, which takes a few hundred cycles;
+    // if it throws, the entry is empty again and the loop claims it
+    while (expected == FILLING) {
+      std::this_thread::yield();
+      expected = state->load(std::memory_order_acquire);
+    }
+    if (expected == FILLED) {
+      return false;
+    }
+  }
+}
+
+void CachedTransformation::copyCache(const CachedTransformation& T) {
+  // An entry that T is still filling is left empty here
+  const bool vecCached = T.vecCached();
+  if (vecCached) {
+    vec_ = T.vec_;
+  }
+  vecState_.store(vecCached ? FILLED : EMPTY, std::memory_order_relaxed);
+  const bool adjointCached = T.adjointCached();
+  if (adjointCached) {
+    adjoint_ = T.adjoint_;
+  }
+  adjointState_.store(adjointCached ? FILLED : EMPTY,
+                      std::memory_order_relaxed);
+}
+
+}  // namespace se3
+}  // namespace lgmath
@@ -0,0 +1,53 @@
+/**
+ * \file CovarianceFactor.hpp
+ * \brief Private header of the square-root factors of covariances.
+ *
+ * \author ASRL
+ */
+#pragma once
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include <Eigen/Cholesky>
+#include <Eigen/Core>
+
+namespace lgmath {
+namespace se3 {
+namespace detail {
+
+/**
+ * \brief A factor L * L^T of a covariance: its Cholesky factor, or from its
+ * pivoted LDL^T decomposition if it is only semi-definite
+ * \details The semi-definite case does not use Eigen's SelfAdjointEigenSolver,
+ * whose tridiagonalization makes GCC warn that a temporary may be used
+ * uninitialized (-Wmaybe-uninitialized) in optimized builds.
+ * \param[in] cov The covariance
+ * \param[in] function Name of the caller, for the error message
+ * \throws std::invalid_argument If cov is not positive semi-definite
+ */
+template <int N>
+Eigen::Matrix<double, N, N> covarianceFactor(
+    const Eigen::Matrix<double, N, N>& cov, const char* function) {
+  const Eigen::LLT<Eigen::Matrix<double, N, N>> llt(cov);
+  if (llt.info() == Eigen::Success) {
+    return llt.matrixL();
+  }
+  // cov = P^T * L * D * L^T * P, so the factor is P^T * L * sqrt(D)
+  const Eigen::LDLT<Eigen::Matrix<double, N, N>> ldlt(cov);
+  const Eigen::Matrix<double, N, 1> d = ldlt.vectorD();
+  const double tolerance = 1e-9 * std::max(1.0, d.maxCoeff());
+  if (!d.allFinite() || d.minCoeff() < -tolerance) {
+    throw std::invalid_argument(
+        std::string("Covariance is not positive semi-definite in ") +
+        function);
+  }
+  Eigen::Matrix<double, N, N> factor = ldlt.matrixL();
+  factor *= d.cwiseMax(0.0).cwiseSqrt().asDiagonal();
+  return ldlt.transpositionsP().transpose() * factor;
+}
+
+}  // namespace detail
+}  // namespace se3
+}  // namespace lgmath
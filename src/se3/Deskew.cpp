@@ -0,0 +1,128 @@
+/**
+ * \file Deskew.cpp
+ * \brief Implementation file for the motion compensation (de-skew) of the
+ * points of a scan.
+ *
+ * \author ASRL
+ */
+#include <lgmath/se3/Deskew.hpp>
+
+#include <stdexcept>
+
+#include <lgmath/Parallel.hpp>
+#include <lgmath/Trace.hpp>
+#include <lgmath/se3/Operations.hpp>
+
+#include "BatchKernels.hpp"
+
+namespace lgmath {
+namespace se3 {
+
+namespace {
+
+/** \brief Default grain size of the execution policies */
+const std::size_t DESKEW_GRAIN = 1 << 14;
+
+/** \brief Checks the scan interval and the number of buckets */
+void checkInterval(double t_start, double t_end, std::size_t numKnots) {
+  if (!(t_end > t_start)) {
+    throw std::invalid_argument("Deskew needs t_end > t_start");
+  }
+  if (numKnots == 0) {
+    throw std::invalid_argument("Deskew needs at least one bucket");
+  }
+}
+
+/** \brief A row-major view of rows with a stride, e.g. from the batch layout */
+using RowsMap =
+    Eigen::Map<Eigen::Matrix<double, 3, Eigen::Dynamic, Eigen::RowMajor>, 0,
+               Eigen::OuterStride<>>;
+
+}  // namespace
+
+Deskew::Deskew(const Transformation& T_start, const Transformation& T_end,
+               double t_start, double t_end, std::size_t numKnots)
+    : T_start_(T_start),
+      xi_((T_start.inverse() * T_end).vec()),
+      t_start_(t_start),
+      t_end_(t_end),
+      numKnots_(numKnots) {
+  checkInterval(t_start, t_end, numKnots);
+  computeKnots();
+}
+
+Deskew::Deskew(const Transformation& T_start,
+               const Eigen::Matrix<double, 6, 1>& varpi, double t_start,
+               double t_end, std::size_t numKnots)
+    : T_start_(T_start),
+      xi_((t_end - t_start) * varpi),
+      t_start_(t_start),
+      t_end_(t_end),
+      numKnots_(numKnots) {
+  checkInterval(t_start, t_end, numKnots);
+  computeKnots();
+}
+
+void Deskew::computeKnots() {
+  typedef Eigen::Matrix<double, 3, 4, Eigen::RowMajor> Matrix34r;
+  knots_.resize(24 * numKnots_);
+  Matrix34r previous = T_start_.matrix34();
+  for (std::size_t k = 0; k < numKnots_; ++k) {
+    const double alpha = double(k + 1) / numKnots_;
+    const Matrix34r next =
+        (T_start_.matrix() *
+         vec2tran(Eigen::Matrix<double, 6, 1>(alpha * xi_)))
+            .topRows<3>();
+    Eigen::Map<Matrix34r> knot(knots_.data() + 24 * k);
+    Eigen::Map<Matrix34r> difference(knots_.data() + 24 * k + 12);
+    knot = previous;
+    difference = next - previous;
+    previous = next;
+  }
+}
+
+Transformation Deskew::pose(double t) const {
+  const double alpha = (t - t_start_) / (t_end_ - t_start_);
+  return T_start_ * Transformation(Eigen::Matrix<double, 6, 1>(alpha * xi_));
+}
+
+void Deskew::apply(const double* t, const double* p, double* out,
+                   std::size_t n, std::size_t stride) const {
+  apply(common::ExecutionPolicy::sequential(), t, p, out, n, stride);
+}
+
+void Deskew::apply(const common::ExecutionPolicy& policy, const double* t,
+                   const double* p, double* out, std::size_t n,
+                   std::size_t stride) const {
+  if (n > 0 && (t == nullptr || p == nullptr || out == nullptr)) {
+    throw std::invalid_argument("Null pointer in Deskew::apply");
+  }
+  if (stride == 0) {
+    stride = n;
+  } else if (stride < n) {
+    throw std::invalid_argument("Stride is less than n in Deskew::apply");
+  }
+  LGMATH_TRACE_SCOPE("se3/Deskew::apply", n);
+  const double rate = numKnots_ / (t_end_ - t_start_);
+  const detail::BatchKernels& kernels = detail::batchKernels();
+  policy.forEachRange(n, DESKEW_GRAIN, [&](std::size_t begin, std::size_t end) {
+    kernels.deskew(knots_.data(), numKnots_, t_start_, rate, t, p, out, stride,
+                   begin, end);
+  });
+}
+
+Eigen::Matrix3Xd Deskew::apply(const Eigen::VectorXd& t,
+                               const Eigen::Matrix3Xd& p) const {
+  if (t.size() != p.cols()) {
+    throw std::invalid_argument("Wrong number of times in Deskew::apply");
+  }
+  const std::size_t n = p.cols();
+  std::vector<double> rows(3 * n);
+  RowsMap map(rows.data(), 3, n, Eigen::OuterStride<>(n));
+  map = p;
+  apply(t.data(), rows.data(), rows.data(), n);
+  return map;
+}
+
+}  // namespace se3
+}  // namespace lgmath
@@ -0,0 +1,306 @@
+/**
+ * \file GaussianProcess.cpp
+ * \brief Implementation file for Gaussian process priors on SE3 trajectories.
+ *
+ * \author ASRL
+ */
+#include <lgmath/se3/GaussianProcess.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <lgmath/Parallel.hpp>
+#include <lgmath/Trace.hpp>
+#include <lgmath/se3/Operations.hpp>
+
+#include "BatchKernels.hpp"
+
+namespace lgmath {
+namespace se3 {
+namespace gp {
+
+namespace {
+
+/** \brief Default grain size of the execution policies */
+const std::size_t GP_GRAIN = 1 << 12;
+
+/** \brief Number of times per block of the batch states */
+const std::size_t BLOCK = 256;
+
+/** \brief The Kronecker product a (x) Qc of a scalar matrix with a 6x6 */
+template <int N>
+Eigen::Matrix<double, 6 * N, 6 * N> kron(
+    const Eigen::Matrix<double, N, N>& a,
+    const Eigen::Matrix<double, 6, 6>& Qc) {
+  Eigen::Matrix<double, 6 * N, 6 * N> out;
+  for (int i = 0; i < N; ++i) {
+    for (int j = 0; j < N; ++j) {
+      out.template block<6, 6>(6 * i, 6 * j) = a(i, j) * Qc;
+    }
+  }
+  return out;
+}
+
+/** \brief The scalar blocks of the WNOA process noise */
+Eigen::Matrix2d wnoaScalarQ(double dt) {
+  Eigen::Matrix2d q;
+  q << dt * dt * dt / 3.0, dt * dt / 2.0, dt * dt / 2.0, dt;
+  return q;
+}
+
+/** \brief The scalar blocks of the WNOA transition */
+Eigen::Matrix2d wnoaScalarPhi(double dt) {
+  Eigen::Matrix2d phi;
+  phi << 1.0, dt, 0.0, 1.0;
+  return phi;
+}
+
+/** \brief The scalar blocks of the inverse of the WNOA process noise */
+Eigen::Matrix2d wnoaScalarQinv(double dt) {
+  Eigen::Matrix2d qinv;
+  qinv << 12.0 / (dt * dt * dt), -6.0 / (dt * dt), -6.0 / (dt * dt), 4.0 / dt;
+  return qinv;
+}
+
+/** \brief The interpolation coefficients Lambda and Psi at tau in [0, dt] */
+void coefficients(double tau, double dt, Eigen::Matrix2d* lambda,
+                  Eigen::Matrix2d* psi) {
+  *psi = wnoaScalarQ(tau) * wnoaScalarPhi(dt - tau).transpose() *
+         wnoaScalarQinv(dt);
+  *lambda = wnoaScalarPhi(tau) - *psi * wnoaScalarPhi(dt);
+}
+
+/** \brief Checks the time step of the inverse process noises */
+void checkDt(double dt) {
+  if (!(dt > 0.0)) {
+    throw std::invalid_argument("The process noise inverse needs dt > 0");
+  }
+}
+
+}  // namespace
+
+Eigen::Matrix<double, 12, 12> wnoaTransition(double dt) {
+  return kron<2>(wnoaScalarPhi(dt), Eigen::Matrix<double, 6, 6>::Identity());
+}
+
+Eigen::Matrix<double, 12, 12> wnoaQ(double dt,
+                                    const Eigen::Matrix<double, 6, 6>& Qc) {
+  return kron<2>(wnoaScalarQ(dt), Qc);
+}
+
+Eigen::Matrix<double, 12, 12> wnoaQinv(double dt,
+                                       const Eigen::Matrix<double, 6, 6>& Qc) {
+  checkDt(dt);
+  return kron<2>(wnoaScalarQinv(dt), Qc.inverse());
+}
+
+Eigen::Matrix<double, 18, 18> wnojTransition(double dt) {
+  Eigen::Matrix3d phi;
+  phi << 1.0, dt, 0.5 * dt * dt, 0.0, 1.0, dt, 0.0, 0.0, 1.0;
+  return kron<3>(phi, Eigen::Matrix<double, 6, 6>::Identity());
+}
+
+Eigen::Matrix<double, 18, 18> wnojQ(double dt,
+                                    const Eigen::Matrix<double, 6, 6>& Qc) {
+  const double dt2 = dt * dt, dt3 = dt2 * dt, dt4 = dt3 * dt, dt5 = dt4 * dt;
+  Eigen::Matrix3d q;
+  q << dt5 / 20.0, dt4 / 8.0, dt3 / 6.0,  //
+      dt4 / 8.0, dt3 / 3.0, dt2 / 2.0,    //
+      dt3 / 6.0, dt2 / 2.0, dt;
+  return kron<3>(q, Qc);
+}
+
+Eigen::Matrix<double, 18, 18> wnojQinv(double dt,
+                                       const Eigen::Matrix<double, 6, 6>& Qc) {
+  checkDt(dt);
+  const double dt2 = dt * dt, dt3 = dt2 * dt, dt4 = dt3 * dt, dt5 = dt4 * dt;
+  Eigen::Matrix3d qinv;
+  qinv << 720.0 / dt5, -360.0 / dt4, 60.0 / dt3,  //
+      -360.0 / dt4, 192.0 / dt3, -36.0 / dt2,     //
+      60.0 / dt3, -36.0 / dt2, 9.0 / dt;
+  return kron<3>(qinv, Qc.inverse());
+}
+
+Interval::Interval(const Knot& knot1, const Knot& knot2)
+    : t1_(knot1.time),
+      dt_(knot2.time - knot1.time),
+      T1_(knot1.T),
+      varpi1_(knot1.varpi) {
+  if (!(dt_ > 0.0)) {
+    throw std::invalid_argument("Interval needs knot2.time > knot1.time");
+  }
+  const Transformation T_21 = knot2.T * knot1.T.inverse();
+  xi21_ = T_21.vec();
+  J21inv_ = vec2jacinv(xi21_);
+  dxi2_ = J21inv_ * knot2.varpi;
+  Ad21_ = T_21.adjoint();
+  halfCurlyhat2_ = 0.5 * curlyhat(knot2.varpi);
+}
+
+void Interval::local(double t, Eigen::Matrix<double, 6, 1>* xi,
+                     Eigen::Matrix<double, 6, 1>* dxi, Eigen::Matrix2d* lambda,
+                     Eigen::Matrix2d* psi) const {
+  // gamma_1 = [0; varpi_1], so the first column of Lambda drops out
+  coefficients(t - t1_, dt_, lambda, psi);
+  *xi = (*lambda)(0, 1) * varpi1_ + (*psi)(0, 0) * xi21_ +
+        (*psi)(0, 1) * dxi2_;
+  *dxi = (*lambda)(1, 1) * varpi1_ + (*psi)(1, 0) * xi21_ +
+         (*psi)(1, 1) * dxi2_;
+}
+
+Transformation Interval::pose(double t) const {
+  Eigen::Matrix<double, 6, 1> xi, dxi;
+  Eigen::Matrix2d lambda, psi;
+  local(t, &xi, &dxi, &lambda, &psi);
+  return Transformation(xi) * T1_;
+}
+
+Transformation Interval::pose(double t,
+                              Eigen::Matrix<double, 6, 24>* jacobian) const {
+  if (jacobian == nullptr) {
+    throw std::invalid_argument("Null pointer in Interval::pose");
+  }
+  Eigen::Matrix<double, 6, 1> xi, dxi;
+  Eigen::Matrix2d lambda, psi;
+  local(t, &xi, &dxi, &lambda, &psi);
+  const Transformation T_i1(xi);
+  const Eigen::Matrix<double, 6, 6> J_i1 = vec2jac(xi);
+
+  // T_2 moves xi_21 by J(xi_21)^-1 * delta and T_1 by minus that times
+  // Ad(T_21); T_1 also moves T = exp(xi) * T_1 by Ad(exp(xi)) * delta
+  const Eigen::Matrix<double, 6, 6> W =
+      J_i1 *
+      (psi(0, 0) * Eigen::Matrix<double, 6, 6>::Identity() +
+       psi(0, 1) * halfCurlyhat2_) *
+      J21inv_;
+  jacobian->block<6, 6>(0, 0) = T_i1.adjoint() - W * Ad21_;
+  jacobian->block<6, 6>(0, 6) = lambda(0, 1) * J_i1;
+  jacobian->block<6, 6>(0, 12) = W;
+  jacobian->block<6, 6>(0, 18) = psi(0, 1) * J_i1 * J21inv_;
+  return T_i1 * T1_;
+}
+
+Eigen::Matrix<double, 6, 1> Interval::velocity(double t) const {
+  Eigen::Matrix<double, 6, 1> xi, dxi;
+  Eigen::Matrix2d lambda, psi;
+  local(t, &xi, &dxi, &lambda, &psi);
+  return applyJac(xi, dxi);
+}
+
+Eigen::Matrix<double, 6, 1> Interval::velocity(
+    double t, Eigen::Matrix<double, 6, 24>* jacobian) const {
+  if (jacobian == nullptr) {
+    throw std::invalid_argument("Null pointer in Interval::velocity");
+  }
+  Eigen::Matrix<double, 6, 1> xi, dxi;
+  Eigen::Matrix2d lambda, psi;
+  local(t, &xi, &dxi, &lambda, &psi);
+  const Eigen::Matrix<double, 6, 6> J_i1 = vec2jac(xi);
+
+  // varpi = J(xi) * xi', where xi moves J(xi) * xi' by X = -0.5 *
+  // curlyhat(xi') times its change
+  const Eigen::Matrix<double, 6, 6> X = -0.5 * curlyhat(dxi);
+  const Eigen::Matrix<double, 6, 6> I = Eigen::Matrix<double, 6, 6>::Identity();
+  const Eigen::Matrix<double, 6, 6> W =
+      (J_i1 * (psi(1, 0) * I + psi(1, 1) * halfCurlyhat2_) +
+       X * (psi(0, 0) * I + psi(0, 1) * halfCurlyhat2_)) *
+      J21inv_;
+  jacobian->block<6, 6>(0, 0) = -W * Ad21_;
+  jacobian->block<6, 6>(0, 6) = lambda(1, 1) * J_i1 + lambda(0, 1) * X;
+  jacobian->block<6, 6>(0, 12) = W;
+  jacobian->block<6, 6>(0, 18) = (psi(1, 1) * J_i1 + psi(0, 1) * X) * J21inv_;
+  return J_i1 * dxi;
+}
+
+Eigen::Matrix<double, 12, 12> Interval::covariance(
+    double t, const Eigen::Matrix<double, 24, 24>& knotCov,
+    const Eigen::Matrix<double, 6, 6>& Qc) const {
+  Eigen::Matrix<double, 12, 24> F;
+  Eigen::Matrix<double, 6, 24> jacobian;
+  pose(t, &jacobian);
+  F.topRows<6>() = jacobian;
+  velocity(t, &jacobian);
+  F.bottomRows<6>() = jacobian;
+
+  // The prior uncertainty of the local state, carried to the left
+  // perturbations of the pose and velocity
+  Eigen::Matrix<double, 6, 1> xi, dxi;
+  Eigen::Matrix2d lambda, psi;
+  local(t, &xi, &dxi, &lambda, &psi);
+  const double tau = t - t1_;
+  const Eigen::Matrix2d q =
+      wnoaScalarQ(tau) - psi * wnoaScalarQ(dt_) * psi.transpose();
+  const Eigen::Matrix<double, 6, 6> J_i1 = vec2jac(xi);
+  Eigen::Matrix<double, 12, 12> Xi = Eigen::Matrix<double, 12, 12>::Zero();
+  Xi.block<6, 6>(0, 0) = J_i1;
+  Xi.block<6, 6>(6, 0) = -0.5 * curlyhat(dxi);
+  Xi.block<6, 6>(6, 6) = J_i1;
+  return F * knotCov * F.transpose() +
+         Xi * kron<2>(q, Qc) * Xi.transpose();
+}
+
+void Interval::states(const double* t, double* T, double* varpi, std::size_t n,
+                      std::size_t stride) const {
+  states(common::ExecutionPolicy::sequential(), t, T, varpi, n, stride);
+}
+
+void Interval::states(const common::ExecutionPolicy& policy, const double* t,
+                      double* T, double* varpi, std::size_t n,
+                      std::size_t stride) const {
+  if (n > 0 && (t == nullptr || T == nullptr)) {
+    throw std::invalid_argument("Null pointer in Interval::states");
+  }
+  if (stride == 0) {
+    stride = n;
+  } else if (stride < n) {
+    throw std::invalid_argument("Stride is less than n in Interval::states");
+  }
+  LGMATH_TRACE_SCOPE("se3/gp::Interval::states", n);
+
+  // Per block, the local states in the batch layout, then exp(xi) by the
+  // kernels, times T_1, and J(xi) * xi' for the velocities
+  typedef Eigen::Matrix<double, 3, 4, Eigen::RowMajor> Matrix34r;
+  const Matrix34r T_1 = T1_.matrix34();
+  const detail::BatchKernels& kernels = detail::batchKernels();
+  policy.forEachRange(n, GP_GRAIN, [&](std::size_t begin, std::size_t end) {
+    double xi[6 * BLOCK], dxi[6 * BLOCK], T_i1[12 * BLOCK], v[6 * BLOCK];
+    for (std::size_t first = begin; first < end; first += BLOCK) {
+      const std::size_t m = std::min(BLOCK, end - first);
+      for (std::size_t j = 0; j < m; ++j) {
+        Eigen::Matrix2d lambda, psi;
+        coefficients(t[first + j] - t1_, dt_, &lambda, &psi);
+        for (std::size_t k = 0; k < 6; ++k) {
+          xi[k * BLOCK + j] = lambda(0, 1) * varpi1_(k) +
+                              psi(0, 0) * xi21_(k) + psi(0, 1) * dxi2_(k);
+          dxi[k * BLOCK + j] = lambda(1, 1) * varpi1_(k) +
+                               psi(1, 0) * xi21_(k) + psi(1, 1) * dxi2_(k);
+        }
+      }
+      kernels.vec2tran(xi, T_i1, BLOCK, 0, m);
+      for (std::size_t row = 0; row < 3; ++row) {
+        for (std::size_t col = 0; col < 4; ++col) {
+          const double* a = T_i1 + 4 * row * BLOCK;
+          double* out = T + (4 * row + col) * stride + first;
+          const double b0 = T_1(0, col), b1 = T_1(1, col), b2 = T_1(2, col);
+          const double b3 = col == 3 ? 1.0 : 0.0;
+          for (std::size_t j = 0; j < m; ++j) {
+            out[j] = a[j] * b0 + a[BLOCK + j] * b1 + a[2 * BLOCK + j] * b2 +
+                     a[3 * BLOCK + j] * b3;
+          }
+        }
+      }
+      if (varpi != nullptr) {
+        kernels.applyJac(xi, dxi, v, BLOCK, 0, m,
+                         detail::JacobianProduct::JAC);
+        for (std::size_t k = 0; k < 6; ++k) {
+          std::copy(v + k * BLOCK, v + k * BLOCK + m,
+                    varpi + k * stride + first);
+        }
+      }
+    }
+  });
+}
+
+}  // namespace gp
+}  // namespace se3
+}  // namespace lgmath
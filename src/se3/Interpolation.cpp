@@ -0,0 +1,46 @@
+/**
+ * \file Interpolation.cpp
+ * \brief Implementation file for the geodesic interpolation of
+ * transformations.
+ *
+ * \author ASRL
+ */
+#include <lgmath/se3/Interpolation.hpp>
+
+#include <lgmath/se3/Operations.hpp>
+
+namespace lgmath {
+namespace se3 {
+
+Transformation interpolate(const Transformation& T_0,
+                           const Transformation& T_1, double alpha) {
+  const Eigen::Matrix<double, 6, 1> xi = (T_0.inverse() * T_1).vec();
+  return T_0 * Transformation(Eigen::Matrix<double, 6, 1>(alpha * xi));
+}
+
+TransformationWithCovariance interpolate(
+    const TransformationWithCovariance& T_0,
+    const TransformationWithCovariance& T_1, double alpha) {
+  const Transformation T = interpolate(static_cast<const Transformation&>(T_0),
+                                       static_cast<const Transformation&>(T_1),
+                                       alpha);
+  if (!T_0.covarianceSet() || !T_1.covarianceSet()) {
+    return TransformationWithCovariance(T);
+  }
+
+  // Left perturbations of T_0 and T_1 move xi = log(T_1 * T_0^-1) by
+  // J(xi)^-1 * (d_1 - Ad(T_1 * T_0^-1) * d_0), and T = exp(alpha * xi) * T_0
+  // by alpha * J(alpha * xi) times that, plus Ad(exp(alpha * xi)) * d_0
+  const Eigen::Matrix4d T_10 = T_1.matrix() * T_0.inverse().matrix();
+  const Eigen::Matrix<double, 6, 1> xi = tran2vec(T_10);
+  const Eigen::Matrix<double, 6, 1> xi_alpha = alpha * xi;
+  const Eigen::Matrix<double, 6, 6> A =
+      alpha * vec2jac(xi_alpha) * vec2jacinv(xi);
+  const Eigen::Matrix<double, 6, 6> B =
+      tranAd(vec2tran(xi_alpha)) - A * tranAd(T_10);
+  return TransformationWithCovariance(
+      T, A * T_1.cov() * A.transpose() + B * T_0.cov() * B.transpose());
+}
+
+}  // namespace se3
+}  // namespace lgmath
@@ -0,0 +1,138 @@
+/**
+ * \file Mean.cpp
+ * \brief Implementation file for the weighted means of transformations.
+ *
+ * \author ASRL
+ */
+#include <lgmath/se3/Mean.hpp>
+
+#include <stdexcept>
+
+#include <Eigen/SVD>
+
+#include <lgmath/Parallel.hpp>
+#include <lgmath/se3/Operations.hpp>
+#include <lgmath/so3/Operations.hpp>
+
+#include "../Reduction.hpp"
+
+namespace lgmath {
+namespace se3 {
+
+namespace {
+
+typedef Eigen::Matrix<double, 6, 1> Vector6d;
+typedef Eigen::Matrix<double, 6, 6> Matrix6d;
+typedef Transformation::Matrix34d Matrix34d;
+
+/** \brief Most Gauss-Newton iterations of the Karcher mean */
+const unsigned int MAX_ITERATIONS = 100;
+
+/** \brief Norm of the last Karcher update */
+const double TOLERANCE = 1e-12;
+
+/** \brief Checks the weights, and returns their sum */
+double checkWeights(std::size_t n, const std::vector<double>& weights) {
+  if (n == 0) {
+    throw std::invalid_argument("No transformations to average.");
+  }
+  if (weights.empty()) {
+    return double(n);
+  }
+  if (weights.size() != n) {
+    throw std::invalid_argument("Need one weight per transformation.");
+  }
+  double total = 0.0;
+  for (double w : weights) {
+    if (!(w >= 0.0)) {
+      throw std::invalid_argument("Weights must be non-negative.");
+    }
+    total += w;
+  }
+  if (!(total > 0.0)) {
+    throw std::invalid_argument("Weights must have a positive sum.");
+  }
+  return total;
+}
+
+/** \brief log(T_i * T^-1), from the 3x4 blocks [C | r_ab_inb] */
+Vector6d logDifference(const Matrix34d& T_i, const Matrix34d& T) {
+  const Eigen::Matrix3d C = T_i.leftCols<3>() * T.leftCols<3>().transpose();
+  return tran2vec(C, T_i.col(3) - C * T.col(3));
+}
+
+}  // namespace
+
+Transformation mean(const std::vector<Transformation>& transformations,
+                    const std::vector<double>& weights, MeanMethod method,
+                    Eigen::Matrix<double, 6, 6>* spread) {
+  return mean(common::ExecutionPolicy::sequential(), transformations, weights,
+              method, spread);
+}
+
+Transformation mean(const common::ExecutionPolicy& policy,
+                    const std::vector<Transformation>& transformations,
+                    const std::vector<double>& weights, MeanMethod method,
+                    Eigen::Matrix<double, 6, 6>* spread) {
+  const std::size_t n = transformations.size();
+  const double total = checkWeights(n, weights);
+  auto weight = [&](std::size_t i) {
+    return weights.empty() ? 1.0 : weights[i];
+  };
+
+  // The chordal mean: the projected rotation, and the mean translation
+  const Matrix34d M =
+      common::detail::reduce(policy, n, Matrix34d(Matrix34d::Zero()),
+                             [&](std::size_t i) -> Matrix34d {
+                               return weight(i) *
+                                      transformations[i].matrix34();
+                             }) /
+      total;
+  const Eigen::JacobiSVD<Eigen::Matrix3d> svd(
+      M.leftCols<3>(), Eigen::ComputeFullU | Eigen::ComputeFullV);
+  Eigen::Vector3d diag = Eigen::Vector3d::Ones();
+  diag(2) = (svd.matrixU() * svd.matrixV().transpose()).determinant();
+  Matrix34d T;
+  T.leftCols<3>() =
+      svd.matrixU() * diag.asDiagonal() * svd.matrixV().transpose();
+  T.col(3) = M.col(3);
+
+  // The Karcher mean, T <- exp(delta^) * T
+  if (method == MeanMethod::KARCHER) {
+    for (unsigned int k = 0; k < MAX_ITERATIONS; ++k) {
+      const Vector6d delta =
+          common::detail::reduce(policy, n, Vector6d(Vector6d::Zero()),
+                                 [&](std::size_t i) -> Vector6d {
+                                   return weight(i) *
+                                          logDifference(
+                                              transformations[i].matrix34(),
+                                              T);
+                                 }) /
+          total;
+      const Eigen::Matrix4d dT = vec2tran(delta);
+      const Eigen::Matrix3d dC = dT.topLeftCorner<3, 3>();
+      T.col(3) = dC * T.col(3) + dT.topRightCorner<3, 1>();
+      T.leftCols<3>() = dC * T.leftCols<3>();
+      if (delta.norm() < TOLERANCE) {
+        break;
+      }
+    }
+  }
+
+  if (spread) {
+    *spread = common::detail::reduce(
+                  policy, n, Matrix6d(Matrix6d::Zero()),
+                  [&](std::size_t i) -> Matrix6d {
+                    const Vector6d xi =
+                        logDifference(transformations[i].matrix34(), T);
+                    return weight(i) * xi * xi.transpose();
+                  }) /
+              total;
+  }
+  Eigen::Matrix4d out = Eigen::Matrix4d::Identity();
+  out.topRows<3>() = T;
+  return Transformation(out);
+}
+
+}  // namespace se3
+}  // namespace lgmath
@@ -13,6 +13,7 @@
 
 #include <Eigen/Dense>
 
+#include <lgmath/Counters.hpp>
 #include <lgmath/so3/Operations.hpp>
 
 namespace lgmath {
@@ -67,9 +68,11 @@ void vec2tran_analytical(const Eigen::Vector3d& rho_ba,
     throw std::invalid_argument(
         "Null pointer out_r_ba_ina in vec2tran_analytical");
   }
+  LGMATH_COUNT(SE3_VEC2TRAN);
 
   if (aaxis_ba.norm() < 1e-12) {
     // If angle is very small, rotation is Identity
+    LGMATH_COUNT(SE3_VEC2TRAN_SMALL_ANGLE);
     *out_C_ab = Eigen::Matrix3d::Identity();
     *out_r_ba_ina = rho_ba;
   } else {
@@ -97,6 +100,8 @@ void vec2tran_numerical(const Eigen::Vector3d& rho_ba,
     throw std::invalid_argument(
         "Null pointer out_r_ba_ina in vec2tran_numerical");
   }
+  LGMATH_COUNT(SE3_VEC2TRAN);
+  LGMATH_COUNT(SE3_VEC2TRAN_SERIES);
 
   // Init 4x4 transformation
   Eigen::Matrix4d T_ab = Eigen::Matrix4d::Identity();
@@ -148,6 +153,8 @@ Eigen::Matrix4d vec2tran(const Eigen::Matrix<double, 6, 1>& xi_ba,
 
 Eigen::Matrix<double, 6, 1> tran2vec(const Eigen::Matrix3d& C_ab,
                                      const Eigen::Vector3d& r_ba_ina) {
+  LGMATH_COUNT(SE3_TRAN2VEC);
+
   // Init
   Eigen::Matrix<double, 6, 1> xi_ba;
 
@@ -168,6 +175,7 @@ Eigen::Matrix<double, 6, 1> tran2vec(const Eigen::Matrix4d& T_ab) {
 
 Eigen::Matrix<double, 6, 6> tranAd(const Eigen::Matrix3d& C_ab,
                                    const Eigen::Vector3d& r_ba_ina) {
+  LGMATH_COUNT(SE3_TRANAD);
   Eigen::Matrix<double, 6, 6> adjoint_T_ab =
       Eigen::Matrix<double, 6, 6>::Zero();
   adjoint_T_ab.topLeftCorner<3, 3>() = adjoint_T_ab.bottomRightCorner<3, 3>() =
@@ -182,6 +190,8 @@ Eigen::Matrix<double, 6, 6> tranAd(const Eigen::Matrix4d& T_ab) {
 
 Eigen::Matrix3d vec2Q(const Eigen::Vector3d& rho_ba,
                       const Eigen::Vector3d& aaxis_ba) {
+  LGMATH_COUNT(SE3_VEC2Q);
+
   // Construct scalar terms
   const double ang = aaxis_ba.norm();
   const double ang2 = ang * ang;
@@ -215,9 +225,11 @@ Eigen::Matrix<double, 6, 6> vec2jac(const Eigen::Vector3d& rho_ba,
                                     const Eigen::Vector3d& aaxis_ba) {
   // Init
   Eigen::Matrix<double, 6, 6> J_ab = Eigen::Matrix<double, 6, 6>::Zero();
+  LGMATH_COUNT(SE3_VEC2JAC);
 
   if (aaxis_ba.norm() < 1e-12) {
     // If angle is very small, so3 jacobian is Identity
+    LGMATH_COUNT(SE3_VEC2JAC_SMALL_ANGLE);
     J_ab.topLeftCorner<3, 3>() = J_ab.bottomRightCorner<3, 3>() =
         Eigen::Matrix3d::Identity();
     J_ab.topRightCorner<3, 3>() = 0.5 * so3::hat(rho_ba);
@@ -237,6 +249,8 @@ Eigen::Matrix<double, 6, 6> vec2jac(const Eigen::Matrix<double, 6, 1>& xi_ba,
     return vec2jac(xi_ba.head<3>(), xi_ba.tail<3>());
   } else {
     // Numerical solution (good for testing the analytical solution)
+    LGMATH_COUNT(SE3_VEC2JAC);
+    LGMATH_COUNT(SE3_VEC2JAC_SERIES);
     Eigen::Matrix<double, 6, 6> J_ab = Eigen::Matrix<double, 6, 6>::Identity();
 
     // Incremental variables
@@ -257,9 +271,11 @@ Eigen::Matrix<double, 6, 6> vec2jacinv(const Eigen::Vector3d& rho_ba,
                                        const Eigen::Vector3d& aaxis_ba) {
   // Init
   Eigen::Matrix<double, 6, 6> J66_ab_inv = Eigen::Matrix<double, 6, 6>::Zero();
+  LGMATH_COUNT(SE3_VEC2JACINV);
 
   if (aaxis_ba.norm() < 1e-12) {
     // If angle is very small, so3 jacobian is Identity
+    LGMATH_COUNT(SE3_VEC2JACINV_SMALL_ANGLE);
     J66_ab_inv.topLeftCorner<3, 3>() = J66_ab_inv.bottomRightCorner<3, 3>() =
         Eigen::Matrix3d::Identity();
     J66_ab_inv.topRightCorner<3, 3>() = -0.5 * so3::hat(rho_ba);
@@ -287,6 +303,8 @@ Eigen::Matrix<double, 6, 6> vec2jacinv(const Eigen::Matrix<double, 6, 1>& xi_ba,
     }
 
     // Numerical solution (good for testing the analytical solution)
+    LGMATH_COUNT(SE3_VEC2JACINV);
+    LGMATH_COUNT(SE3_VEC2JACINV_SERIES);
     Eigen::Matrix<double, 6, 6> J_ab = Eigen::Matrix<double, 6, 6>::Identity();
 
     // Incremental variables
@@ -309,5 +327,138 @@ Eigen::Matrix<double, 6, 6> vec2jacinv(const Eigen::Matrix<double, 6, 1>& xi_ba,
   }
 }
 
+namespace {
+
+/** \brief Scalar coefficients of the so3 Jacobian and of the Q matrix */
+struct JacobianCoefficients {
+  /** \brief Whether the angle is small enough to use the identity */
+  bool small;
+  /** \brief (1 - cos(ang)) / ang^2, so3 Jacobian term of aaxis^ */
+  double a1;
+  /** \brief (ang - sin(ang)) / ang^3, also the Q term m2 */
+  double m2;
+  /** \brief Q term m3, as in vec2Q */
+  double m3;
+  /** \brief Q term m4, as in vec2Q */
+  double m4;
+};
+
+JacobianCoefficients jacobianCoefficients(const Eigen::Vector3d& aaxis) {
+  JacobianCoefficients k;
+  const double ang = aaxis.norm();
+  k.small = ang < 1e-12;
+  if (k.small) {
+    k.a1 = k.m2 = k.m3 = k.m4 = 0.0;
+    return k;
+  }
+  const double ang2 = ang * ang;
+  const double ang3 = ang2 * ang;
+  const double ang4 = ang3 * ang;
+  const double ang5 = ang4 * ang;
+  const double cang = cos(ang);
+  const double sang = sin(ang);
+  k.a1 = (1.0 - cang) / ang2;
+  k.m2 = (ang - sang) / ang3;
+  k.m3 = (1.0 - 0.5 * ang2 - cang) / ang4;
+  k.m4 = 0.5 * (k.m3 - 3 * (ang - sang - ang3 / 6) / ang5);
+  return k;
+}
+
+/** \brief so3 Jacobian times v, J = I + a1 * p^ + m2 * p^p^ */
+Eigen::Vector3d applySo3Jac(const JacobianCoefficients& k,
+                            const Eigen::Vector3d& p,
+                            const Eigen::Vector3d& v) {
+  const Eigen::Vector3d pv = p.cross(v);
+  return v + k.a1 * pv + k.m2 * p.cross(pv);
+}
+
+/** \brief Q times v, with the terms of vec2Q applied right to left */
+Eigen::Vector3d applyQ(const JacobianCoefficients& k, const Eigen::Vector3d& r,
+                       const Eigen::Vector3d& p, const Eigen::Vector3d& v) {
+  if (k.small) {
+    return 0.5 * r.cross(v);
+  }
+  const Eigen::Vector3d rv = r.cross(v);
+  const Eigen::Vector3d pv = p.cross(v);
+  const Eigen::Vector3d ppv = p.cross(pv);
+  const Eigen::Vector3d prv = p.cross(rv);
+  const Eigen::Vector3d rpv = r.cross(pv);
+  const Eigen::Vector3d prpv = p.cross(rpv);
+  const Eigen::Vector3d pprv = p.cross(prv);
+  const Eigen::Vector3d rppv = r.cross(ppv);
+  const Eigen::Vector3d prppv = p.cross(rppv);
+  const Eigen::Vector3d pprpv = p.cross(prpv);
+  return 0.5 * rv + k.m2 * (prv + rpv + prpv) -
+         k.m3 * (pprv + rppv - 3 * prpv) - k.m4 * (prppv + pprpv);
+}
+
+/** \brief J * v for the se3 Jacobian J of (r, p), as in vec2jac */
+Eigen::Matrix<double, 6, 1> applySe3Jac(const Eigen::Vector3d& r,
+                                        const Eigen::Vector3d& p,
+                                        const Eigen::Matrix<double, 6, 1>& v) {
+  const JacobianCoefficients k = jacobianCoefficients(p);
+  Eigen::Matrix<double, 6, 1> out;
+  out.head<3>() = applySo3Jac(k, p, v.head<3>()) + applyQ(k, r, p, v.tail<3>());
+  out.tail<3>() = applySo3Jac(k, p, v.tail<3>());
+  return out;
+}
+
+}  // namespace
+
+Eigen::Matrix<double, 6, 1> applyCurlyhat(
+    const Eigen::Matrix<double, 6, 1>& xi,
+    const Eigen::Matrix<double, 6, 1>& v) {
+  Eigen::Matrix<double, 6, 1> out;
+  out.head<3>() = xi.tail<3>().cross(v.head<3>()) +
+                  xi.head<3>().cross(v.tail<3>());
+  out.tail<3>() = xi.tail<3>().cross(v.tail<3>());
+  return out;
+}
+
+Eigen::Matrix<double, 6, 1> applyJac(const Eigen::Matrix<double, 6, 1>& xi_ba,
+                                     const Eigen::Matrix<double, 6, 1>& v) {
+  return applySe3Jac(xi_ba.head<3>(), xi_ba.tail<3>(), v);
+}
+
+Eigen::Matrix<double, 6, 1> applyJacTranspose(
+    const Eigen::Matrix<double, 6, 1>& xi_ba,
+    const Eigen::Matrix<double, 6, 1>& v) {
+  // Transposing reverses each product of hats, and the set of products in J
+  // is closed under reversal; each reversal flips the sign once per factor,
+  // which negating rho and aaxis does too
+  const Eigen::Vector3d r = -xi_ba.head<3>();
+  const Eigen::Vector3d p = -xi_ba.tail<3>();
+  const JacobianCoefficients k = jacobianCoefficients(p);
+  Eigen::Matrix<double, 6, 1> out;
+  out.head<3>() = applySo3Jac(k, p, v.head<3>());
+  out.tail<3>() = applyQ(k, r, p, v.head<3>()) + applySo3Jac(k, p, v.tail<3>());
+  return out;
+}
+
+Eigen::Matrix<double, 6, 1> applyJacInv(
+    const Eigen::Matrix<double, 6, 1>& xi_ba,
+    const Eigen::Matrix<double, 6, 1>& v) {
+  const Eigen::Vector3d r = xi_ba.head<3>();
+  const Eigen::Vector3d p = xi_ba.tail<3>();
+  const JacobianCoefficients k = jacobianCoefficients(p);
+
+  // so3 inverse Jacobian, g * I + (1 - g) / ang^2 * p * p^T - 0.5 * p^, as in
+  // so3::vec2jacinv
+  double g = 1.0, e = 0.0;
+  if (!k.small) {
+    const double ang = p.norm();
+    g = 0.5 * ang / tan(0.5 * ang);
+    e = (1.0 - g) / (ang * ang);
+  }
+  auto applyInv = [&](const Eigen::Vector3d& w) -> Eigen::Vector3d {
+    return g * w + e * p.dot(w) * p - 0.5 * p.cross(w);
+  };
+
+  Eigen::Matrix<double, 6, 1> out;
+  out.tail<3>() = applyInv(v.tail<3>());
+  out.head<3>() = applyInv(v.head<3>() - applyQ(k, r, p, out.tail<3>()));
+  return out;
+}
+
 }  // namespace se3
 }  // namespace lgmath
@@ -0,0 +1,171 @@
+/**
+ * \file PoseArray.cpp
+ * \brief Implementation file for a structure of arrays container of
+ * transformations.
+ *
+ * \author ASRL
+ */
+#include <lgmath/se3/PoseArray.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace lgmath {
+namespace se3 {
+
+namespace {
+
+/** \brief Number of doubles per cache line */
+const std::size_t LINE = 8;
+
+/** \brief Rounds n up to a whole number of cache lines */
+std::size_t roundToLines(std::size_t n) { return (n + LINE - 1) / LINE * LINE; }
+
+/** \brief A row-major view of rows with a stride, e.g. from the batch layout */
+template <int Rows>
+using RowsMap =
+    Eigen::Map<Eigen::Matrix<double, Rows, Eigen::Dynamic, Eigen::RowMajor>, 0,
+               Eigen::OuterStride<>>;
+
+}  // namespace
+
+PoseArray::PoseArray(std::size_t n) : PoseArray(n, 0) {}
+
+PoseArray::PoseArray(std::size_t n, std::size_t extraRows)
+    : rows_(BATCH_POSE_ROWS + extraRows), size_(0), stride_(0) {
+  resize(n);
+}
+
+PoseArray::PoseArray(const std::vector<Transformation>& poses)
+    : PoseArray(poses.size()) {
+  for (std::size_t i = 0; i < size_; ++i) {
+    set(i, poses[i]);
+  }
+}
+
+PoseArray::PoseArray(const Matrix6Xd& xi_ab) : PoseArray(xi_ab.cols()) {
+  std::vector<double> xi(6 * stride_);
+  RowsMap<6>(xi.data(), 6, size_, Eigen::OuterStride<>(stride_)) = xi_ab;
+  vec2tranBatch(xi.data(), data(), size_, stride_);
+}
+
+void PoseArray::resize(std::size_t n) {
+  const std::size_t stride = roundToLines(n);
+  if (stride != stride_) {
+    std::vector<CacheLine> storage(rows_ * stride / LINE);
+    const std::size_t kept = std::min(n, size_);
+    for (std::size_t k = 0; k < rows_; ++k) {
+      const double* from = row(k);
+      std::copy(from, from + kept,
+                reinterpret_cast<double*>(storage.data()) + k * stride);
+    }
+    storage_.swap(storage);
+    stride_ = stride;
+    size_ = kept;
+  }
+
+  // New transformations are the identity, with zero extra rows; the rows past
+  // the size are kept at zero when shrinking
+  for (std::size_t k = 0; k < rows_; ++k) {
+    double* values = row(k);
+    const bool diagonal = k < BATCH_POSE_ROWS && k % 5 == 0;
+    if (n > size_) {
+      std::fill(values + size_, values + n, diagonal ? 1.0 : 0.0);
+    } else {
+      std::fill(values + n, values + size_, 0.0);
+    }
+  }
+  size_ = n;
+}
+
+Transformation PoseArray::operator[](std::size_t i) const {
+  Eigen::Matrix4d T_ba = Eigen::Matrix4d::Identity();
+  for (std::size_t k = 0; k < BATCH_POSE_ROWS; ++k) {
+    T_ba(k / 4, k % 4) = row(k)[i];
+  }
+  return Transformation(T_ba, false);
+}
+
+Transformation PoseArray::at(std::size_t i) const {
+  if (i >= size_) {
+    throw std::out_of_range("Transformation " + std::to_string(i) +
+                            " is out of range in PoseArray of size " +
+                            std::to_string(size_));
+  }
+  return (*this)[i];
+}
+
+void PoseArray::set(std::size_t i, const Transformation& T_ba) {
+  const Transformation::Matrix34d& T = T_ba.matrix34();
+  for (std::size_t k = 0; k < BATCH_POSE_ROWS; ++k) {
+    row(k)[i] = T(k / 4, k % 4);
+  }
+}
+
+std::vector<Transformation> PoseArray::transformations() const {
+  std::vector<Transformation> poses;
+  poses.reserve(size_);
+  for (std::size_t i = 0; i < size_; ++i) {
+    poses.push_back((*this)[i]);
+  }
+  return poses;
+}
+
+PoseArray::Matrix6Xd PoseArray::vec() const {
+  std::vector<double> xi(6 * stride_);
+  tran2vecBatch(data(), xi.data(), size_, stride_);
+  return RowsMap<6>(xi.data(), 6, size_, Eigen::OuterStride<>(stride_));
+}
+
+PoseArray PoseArray::inverse() const {
+  PoseArray T_inv(size_);
+  inverseBatch(data(), T_inv.data(), size_, stride_);
+  return T_inv;
+}
+
+PoseArray::Matrix6Xd PoseArray::applyAdjoint(const Matrix6Xd& v) const {
+  if (static_cast<std::size_t>(v.cols()) != size_) {
+    throw std::invalid_argument("Wrong number of vectors in applyAdjoint");
+  }
+  std::vector<double> rows(6 * stride_);
+  RowsMap<6> map(rows.data(), 6, size_, Eigen::OuterStride<>(stride_));
+  map = v;
+  applyAdjointBatch(data(), rows.data(), rows.data(), size_, stride_);
+  return map;
+}
+
+Eigen::Matrix3Xd PoseArray::transformPoints(const Eigen::Matrix3Xd& p_a) const {
+  if (static_cast<std::size_t>(p_a.cols()) != size_) {
+    throw std::invalid_argument("Wrong number of points in transformPoints");
+  }
+  std::vector<double> rows(3 * stride_);
+  RowsMap<3> map(rows.data(), 3, size_, Eigen::OuterStride<>(stride_));
+  map = p_a;
+  transformPointsBatch(data(), rows.data(), rows.data(), size_, stride_);
+  return map;
+}
+
+PoseArray& PoseArray::operator*=(const PoseArray& T_rhs) {
+  checkSize(T_rhs, "PoseArray::operator*=");
+  composeBatch(data(), T_rhs.data(), data(), size_, stride_);
+  return *this;
+}
+
+PoseArray PoseArray::operator*(const PoseArray& T_rhs) const {
+  checkSize(T_rhs, "PoseArray::operator*");
+  PoseArray T(size_);
+  composeBatch(data(), T_rhs.data(), T.data(), size_, stride_);
+  return T;
+}
+
+void PoseArray::checkSize(const PoseArray& rhs, const char* function) const {
+  if (rhs.size_ != size_) {
+    throw std::invalid_argument(std::string("Sizes ") + std::to_string(size_) +
+                                " and " + std::to_string(rhs.size_) +
+                                " differ in " + function);
+  }
+}
+
+}  // namespace se3
+}  // namespace lgmath
@@ -0,0 +1,132 @@
+/**
+ * \file PoseCovArray.cpp
+ * \brief Implementation file for a structure of arrays container of
+ * transformations with covariances.
+ *
+ * \author ASRL
+ */
+#include <lgmath/se3/PoseCovArray.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <lgmath/io/BinaryFormat.hpp>
+#include <lgmath/se3/Batch.hpp>
+
+namespace lgmath {
+namespace se3 {
+
+PoseCovArray::PoseCovArray(std::size_t n)
+    : PoseArray(n, BATCH_COVARIANCE_ROWS) {}
+
+PoseCovArray::PoseCovArray(
+    const std::vector<TransformationWithCovariance>& poses)
+    : PoseCovArray(poses.size()) {
+  for (std::size_t i = 0; i < size(); ++i) {
+    set(i, poses[i]);
+  }
+}
+
+PoseCovArray::PoseCovArray(const PoseArray& poses,
+                           const Eigen::Matrix<double, 6, 6>& covariance)
+    : PoseCovArray(poses.size()) {
+  const Eigen::Matrix<double, 21, 1> packed =
+      io::packCovariance(covariance);
+  for (std::size_t k = 0; k < BATCH_POSE_ROWS; ++k) {
+    std::copy(poses.data() + k * stride(), poses.data() + k * stride() + size(),
+              row(k));
+  }
+  for (std::size_t k = 0; k < BATCH_COVARIANCE_ROWS; ++k) {
+    std::fill(row(BATCH_POSE_ROWS + k), row(BATCH_POSE_ROWS + k) + size(),
+              packed(k));
+  }
+}
+
+TransformationWithCovariance PoseCovArray::operator[](std::size_t i) const {
+  return TransformationWithCovariance(PoseArray::operator[](i), cov(i));
+}
+
+TransformationWithCovariance PoseCovArray::at(std::size_t i) const {
+  if (i >= size()) {
+    throw std::out_of_range("Transformation " + std::to_string(i) +
+                            " is out of range in PoseCovArray of size " +
+                            std::to_string(size()));
+  }
+  return (*this)[i];
+}
+
+void PoseCovArray::set(std::size_t i,
+                       const TransformationWithCovariance& T_ba) {
+  setCovariance(i, T_ba.cov());
+  PoseArray::set(i, T_ba);
+}
+
+PoseArray PoseCovArray::poses() const {
+  PoseArray poses(size());
+  for (std::size_t k = 0; k < BATCH_POSE_ROWS; ++k) {
+    std::copy(row(k), row(k) + size(), poses.data() + k * stride());
+  }
+  return poses;
+}
+
+Eigen::Matrix<double, 6, 6> PoseCovArray::cov(std::size_t i) const {
+  Eigen::Matrix<double, 21, 1> packed;
+  for (std::size_t k = 0; k < BATCH_COVARIANCE_ROWS; ++k) {
+    packed(k) = row(BATCH_POSE_ROWS + k)[i];
+  }
+  return io::unpackCovariance(packed);
+}
+
+void PoseCovArray::setCovariance(
+    std::size_t i, const Eigen::Matrix<double, 6, 6>& covariance) {
+  const Eigen::Matrix<double, 21, 1> packed =
+      io::packCovariance(covariance);
+  for (std::size_t k = 0; k < BATCH_COVARIANCE_ROWS; ++k) {
+    row(BATCH_POSE_ROWS + k)[i] = packed(k);
+  }
+}
+
+std::vector<TransformationWithCovariance> PoseCovArray::transformations()
+    const {
+  std::vector<TransformationWithCovariance> poses;
+  poses.reserve(size());
+  for (std::size_t i = 0; i < size(); ++i) {
+    poses.push_back((*this)[i]);
+  }
+  return poses;
+}
+
+PoseCovArray PoseCovArray::inverse() const {
+  PoseCovArray T_inv(size());
+  inverseBatch(data(), covarianceData(), T_inv.data(), T_inv.covarianceData(),
+               size(), stride());
+  return T_inv;
+}
+
+PoseCovArray& PoseCovArray::operator*=(const PoseCovArray& T_rhs) {
+  PoseCovArray T = *this * T_rhs;
+  *this = std::move(T);
+  return *this;
+}
+
+PoseCovArray PoseCovArray::operator*(const PoseCovArray& T_rhs) const {
+  checkSize(T_rhs, "PoseCovArray::operator*");
+  PoseCovArray T(size());
+  // cov + Ad(T_lhs) * cov_rhs * Ad(T_lhs)^T, before composing the poses
+  propagateCovarianceBatch(data(), T_rhs.covarianceData(), T.covarianceData(),
+                           size(), stride());
+  for (std::size_t k = 0; k < BATCH_COVARIANCE_ROWS; ++k) {
+    const double* lhs = row(BATCH_POSE_ROWS + k);
+    double* out = T.row(BATCH_POSE_ROWS + k);
+    for (std::size_t i = 0; i < size(); ++i) {
+      out[i] += lhs[i];
+    }
+  }
+  composeBatch(data(), T_rhs.data(), T.data(), size(), stride());
+  return T;
+}
+
+}  // namespace se3
+}  // namespace lgmath
@@ -0,0 +1,154 @@
+/**
+ * \file Sampling.cpp
+ * \brief Implementation file for drawing poses from a
+ * TransformationWithCovariance.
+ *
+ * \author ASRL
+ */
+#include <lgmath/se3/Sampling.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include <lgmath/CommonMath.hpp>
+#include <lgmath/Parallel.hpp>
+#include <lgmath/Trace.hpp>
+
+#include "BatchKernels.hpp"
+#include "CovarianceFactor.hpp"
+
+namespace lgmath {
+namespace se3 {
+
+namespace {
+
+typedef Eigen::Matrix<double, 6, 6> Matrix6d;
+typedef Eigen::Matrix<double, 3, 4, Eigen::RowMajor> Matrix34r;
+
+/** \brief Number of samples per block */
+const std::size_t BLOCK = 256;
+
+/** \brief Number of samples per generator of the policy overload */
+const std::size_t STREAM = 4 * BLOCK;
+
+/** \brief Default grain size of the execution policies */
+const std::size_t SAMPLE_GRAIN = 4 * STREAM;
+
+/**
+ * \brief Writes m samples to out, drawn from rng, in blocks: the uniforms are
+ * drawn in order, 6 per sample, then turned into normals and poses by
+ * vectorizable loops
+ */
+void sampleRange(const Matrix6d& L, const Matrix34r& T, std::size_t m,
+                 std::mt19937_64& rng, double* out, std::size_t stride) {
+  const detail::BatchKernels& kernels = detail::batchKernels();
+  double u[6 * BLOCK], z[6 * BLOCK], xi[6 * BLOCK], T_k[12 * BLOCK];
+  for (std::size_t first = 0; first < m; first += BLOCK) {
+    const std::size_t n = std::min(BLOCK, m - first);
+
+    // Uniforms in (0, 1) from the top 53 bits of the generator
+    for (std::size_t j = 0; j < n; ++j) {
+      for (std::size_t k = 0; k < 6; ++k) {
+        u[k * BLOCK + j] = (double(rng() >> 11) + 0.5) * 0x1p-53;
+      }
+    }
+
+    // Box-Muller, one pair of normals per pair of uniforms
+    for (std::size_t k = 0; k < 3; ++k) {
+      const double* u1 = u + k * BLOCK;
+      const double* u2 = u + (k + 3) * BLOCK;
+      double* z1 = z + k * BLOCK;
+      double* z2 = z + (k + 3) * BLOCK;
+      for (std::size_t j = 0; j < n; ++j) {
+        const double r = std::sqrt(-2.0 * std::log(u1[j]));
+        const double theta = constants::TWO_PI * u2[j];
+        z1[j] = r * std::cos(theta);
+        z2[j] = r * std::sin(theta);
+      }
+    }
+
+    // xi = L * z
+    for (std::size_t k = 0; k < 6; ++k) {
+      double* x = xi + k * BLOCK;
+      std::fill(x, x + n, 0.0);
+      for (std::size_t l = 0; l < 6; ++l) {
+        const double a = L(k, l);
+        if (a == 0.0) {
+          continue;
+        }
+        const double* zl = z + l * BLOCK;
+        for (std::size_t j = 0; j < n; ++j) {
+          x[j] += a * zl[j];
+        }
+      }
+    }
+
+    // exp(xi^) * T
+    kernels.vec2tran(xi, T_k, BLOCK, 0, n);
+    for (std::size_t row = 0; row < 3; ++row) {
+      for (std::size_t col = 0; col < 4; ++col) {
+        const double* a = T_k + 4 * row * BLOCK;
+        double* o = out + (4 * row + col) * stride + first;
+        const double b0 = T(0, col), b1 = T(1, col), b2 = T(2, col);
+        const double b3 = col == 3 ? 1.0 : 0.0;
+        for (std::size_t j = 0; j < n; ++j) {
+          o[j] = a[j] * b0 + a[BLOCK + j] * b1 + a[2 * BLOCK + j] * b2 +
+                 a[3 * BLOCK + j] * b3;
+        }
+      }
+    }
+  }
+}
+
+/** \brief Checks the arguments, and returns the stride */
+std::size_t checkArguments(std::size_t K, const double* out,
+                           std::size_t stride) {
+  if (K > 0 && out == nullptr) {
+    throw std::invalid_argument("Null pointer in sample");
+  }
+  if (stride == 0) {
+    return K;
+  }
+  if (stride < K) {
+    throw std::invalid_argument("Stride is less than K in sample");
+  }
+  return stride;
+}
+
+}  // namespace
+
+void sample(const TransformationWithCovariance& T, std::size_t K,
+            std::mt19937_64& rng, double* out, std::size_t stride) {
+  stride = checkArguments(K, out, stride);
+  LGMATH_TRACE_SCOPE("se3/sample", K);
+  sampleRange(detail::covarianceFactor<6>(T.cov(), "sample"), T.matrix34(), K,
+              rng, out, stride);
+}
+
+void sample(const common::ExecutionPolicy& policy,
+            const TransformationWithCovariance& T, std::size_t K,
+            std::uint64_t seed, double* out, std::size_t stride) {
+  stride = checkArguments(K, out, stride);
+  LGMATH_TRACE_SCOPE("se3/sample", K);
+  const Matrix6d L = detail::covarianceFactor<6>(T.cov(), "sample");
+  const Matrix34r T_ba = T.matrix34();
+
+  // Sample i is drawn by generator i / STREAM, skipping the draws of the
+  // samples before it, so that the ranges of the policy do not matter
+  policy.forEachRange(K, SAMPLE_GRAIN, [&](std::size_t begin, std::size_t end) {
+    for (std::size_t first = begin; first < end;) {
+      const std::size_t s = first / STREAM;
+      const std::size_t last = std::min(end, (s + 1) * STREAM);
+      std::seed_seq seq{std::uint32_t(seed), std::uint32_t(seed >> 32),
+                        std::uint32_t(s), std::uint32_t(s >> 32)};
+      std::mt19937_64 rng(seq);
+      rng.discard(6 * (first - s * STREAM));
+      sampleRange(L, T_ba, last - first, rng, out + first, stride);
+      first = last;
+    }
+  });
+}
+
+}  // namespace se3
+}  // namespace lgmath
@@ -0,0 +1,255 @@
+/**
+ * \file Spline.cpp
+ * \brief Implementation file for cumulative cubic B-spline trajectories on
+ * SE3.
+ *
+ * \author ASRL
+ */
+#include <lgmath/se3/Spline.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include <lgmath/Parallel.hpp>
+#include <lgmath/Trace.hpp>
+#include <lgmath/se3/Operations.hpp>
+
+#include "BatchKernels.hpp"
+
+namespace lgmath {
+namespace se3 {
+
+namespace {
+
+/** \brief Default grain size of the execution policies */
+const std::size_t SPLINE_GRAIN = 1 << 12;
+
+/** \brief Number of coefficients of a segment, 49 per factor */
+const std::size_t SEGMENT_COEFFS = 3 * 49;
+
+/**
+ * \brief The cumulative basis functions b_1, b_2 and b_3 at the fraction u of
+ * a segment, and their first and second derivatives with respect to u
+ */
+void basis(double u, double* b, double* db, double* ddb) {
+  const double u2 = u * u;
+  const double u3 = u2 * u;
+  b[0] = (5.0 + 3.0 * u - 3.0 * u2 + u3) / 6.0;
+  b[1] = (1.0 + 3.0 * u + 3.0 * u2 - 2.0 * u3) / 6.0;
+  b[2] = u3 / 6.0;
+  db[0] = (3.0 - 6.0 * u + 3.0 * u2) / 6.0;
+  db[1] = (3.0 + 6.0 * u - 6.0 * u2) / 6.0;
+  db[2] = 0.5 * u2;
+  ddb[0] = u - 1.0;
+  ddb[1] = 1.0 - 2.0 * u;
+  ddb[2] = u;
+}
+
+}  // namespace
+
+Spline::Spline(double t0, double dt) : t0_(t0), dt_(dt) {
+  if (!(dt > 0.0)) {
+    throw std::invalid_argument("Spline needs dt > 0");
+  }
+}
+
+Spline::Spline(double t0, double dt,
+               const std::vector<Transformation>& controlPoses)
+    : Spline(t0, dt) {
+  controlPoses_.reserve(controlPoses.size());
+  logs_.reserve(controlPoses.size());
+  for (const Transformation& T : controlPoses) {
+    addControlPose(T);
+  }
+}
+
+double Spline::endTime() const {
+  const std::size_t n = controlPoses_.size();
+  return n < 4 ? t0_ : t0_ + (n - 3) * dt_;
+}
+
+const Transformation& Spline::controlPose(std::size_t i) const {
+  return controlPoses_.at(i);
+}
+
+void Spline::setControlPose(std::size_t i, const Transformation& T) {
+  controlPoses_.at(i) = T;
+  if (i > 0) {
+    logs_[i] = (T * controlPoses_[i - 1].inverse()).vec();
+  }
+  if (i + 1 < controlPoses_.size()) {
+    logs_[i + 1] = (controlPoses_[i + 1] * T.inverse()).vec();
+  }
+}
+
+void Spline::addControlPose(const Transformation& T) {
+  if (controlPoses_.empty()) {
+    logs_.push_back(Eigen::Matrix<double, 6, 1>::Zero());
+  } else {
+    logs_.push_back((T * controlPoses_.back().inverse()).vec());
+  }
+  controlPoses_.push_back(T);
+}
+
+std::size_t Spline::segment(double t, double* u) const {
+  if (controlPoses_.size() < 4) {
+    throw std::logic_error("Spline needs at least 4 control poses");
+  }
+  if (!(t >= t0_ && t <= endTime())) {
+    throw std::out_of_range("Time is outside of the spline");
+  }
+  const double x = (t - t0_) / dt_;
+  const std::size_t k = std::min(static_cast<std::size_t>(std::floor(x)),
+                                 controlPoses_.size() - 4);
+  *u = x - k;
+  return k;
+}
+
+Transformation Spline::pose(double t) const {
+  double u, b[3], db[3], ddb[3];
+  const std::size_t k = segment(t, &u);
+  basis(u, b, db, ddb);
+  Eigen::Matrix4d T = controlPoses_[k].matrix();
+  for (std::size_t j = 1; j <= 3; ++j) {
+    T = vec2tran(Eigen::Matrix<double, 6, 1>(b[j - 1] * logs_[k + j])) * T;
+  }
+  return Transformation(T);
+}
+
+Transformation Spline::pose(double t, Eigen::Matrix<double, 6, 24>* jacobians,
+                            std::size_t* first) const {
+  if (jacobians == nullptr || first == nullptr) {
+    throw std::invalid_argument("Null pointer in Spline::pose");
+  }
+  double u, b[3], db[3], ddb[3];
+  const std::size_t k = segment(t, &u);
+  basis(u, b, db, ddb);
+
+  // A_j = exp(b_j * d_j); Q_j = Ad(A_3 * ... * A_j+1) carries a perturbation
+  // after factor j to the output
+  Eigen::Matrix4d A[3];
+  for (std::size_t j = 0; j < 3; ++j) {
+    A[j] = vec2tran(Eigen::Matrix<double, 6, 1>(b[j] * logs_[k + j + 1]));
+  }
+  Eigen::Matrix<double, 6, 6> Q[4];
+  Q[3].setIdentity();
+  for (std::size_t j = 3; j > 0; --j) {
+    Q[j - 1] = Q[j] * tranAd(A[j - 1]);
+  }
+
+  // Left perturbations of T_k+j and T_k+j-1 move d_j by
+  // J(d_j)^-1 * delta_j - J(-d_j)^-1 * delta_j-1, and T by
+  // M_j = Q_j * b_j * J(b_j * d_j) times that; T_k also moves T directly
+  // by Q_0 * delta_0
+  jacobians->setZero();
+  jacobians->leftCols<6>() = Q[0];
+  for (std::size_t j = 1; j <= 3; ++j) {
+    const Eigen::Matrix<double, 6, 1>& d = logs_[k + j];
+    const Eigen::Matrix<double, 6, 6> M =
+        Q[j] * b[j - 1] * vec2jac(Eigen::Matrix<double, 6, 1>(b[j - 1] * d));
+    jacobians->middleCols<6>(6 * j) += M * vec2jacinv(d);
+    jacobians->middleCols<6>(6 * (j - 1)) -=
+        M * vec2jacinv(Eigen::Matrix<double, 6, 1>(-d));
+  }
+  *first = k;
+  return Transformation(Eigen::Matrix4d(A[2] * A[1] * A[0] *
+                                        controlPoses_[k].matrix()));
+}
+
+Eigen::Matrix<double, 6, 1> Spline::velocity(double t) const {
+  double u, b[3], db[3], ddb[3];
+  const std::size_t k = segment(t, &u);
+  basis(u, b, db, ddb);
+
+  // Factor j adds db_j * d_j to the velocity of the factors before it,
+  // carried through Ad(A_j)
+  Eigen::Matrix<double, 6, 1> varpi = Eigen::Matrix<double, 6, 1>::Zero();
+  for (std::size_t j = 1; j <= 3; ++j) {
+    const Eigen::Matrix<double, 6, 1>& d = logs_[k + j];
+    const Eigen::Matrix4d A =
+        vec2tran(Eigen::Matrix<double, 6, 1>(b[j - 1] * d));
+    varpi = db[j - 1] * d + tranAd(A) * varpi;
+  }
+  return varpi / dt_;
+}
+
+Eigen::Matrix<double, 6, 1> Spline::acceleration(double t) const {
+  double u, b[3], db[3], ddb[3];
+  const std::size_t k = segment(t, &u);
+  basis(u, b, db, ddb);
+
+  // Differentiating the velocity recursion, d/du Ad(A_j) = db_j *
+  // curlyhat(d_j) * Ad(A_j), and curlyhat(d_j) * d_j = 0
+  Eigen::Matrix<double, 6, 1> varpi = Eigen::Matrix<double, 6, 1>::Zero();
+  Eigen::Matrix<double, 6, 1> dvarpi = Eigen::Matrix<double, 6, 1>::Zero();
+  for (std::size_t j = 1; j <= 3; ++j) {
+    const Eigen::Matrix<double, 6, 1>& d = logs_[k + j];
+    const Eigen::Matrix<double, 6, 6> Ad =
+        tranAd(vec2tran(Eigen::Matrix<double, 6, 1>(b[j - 1] * d)));
+    varpi = db[j - 1] * d + Ad * varpi;
+    dvarpi = ddb[j - 1] * d + Ad * dvarpi + db[j - 1] * curlyhat(d) * varpi;
+  }
+  return dvarpi / (dt_ * dt_);
+}
+
+void Spline::poses(const double* t, double* T, std::size_t n,
+                   std::size_t stride) const {
+  poses(common::ExecutionPolicy::sequential(), t, T, n, stride);
+}
+
+void Spline::poses(const common::ExecutionPolicy& policy, const double* t,
+                   double* T, std::size_t n, std::size_t stride) const {
+  if (n > 0 && (t == nullptr || T == nullptr)) {
+    throw std::invalid_argument("Null pointer in Spline::poses");
+  }
+  if (stride == 0) {
+    stride = n;
+  } else if (stride < n) {
+    throw std::invalid_argument("Stride is less than n in Spline::poses");
+  }
+  for (std::size_t i = 0; i < n; ++i) {
+    double u;
+    segment(t[i], &u);
+  }
+  LGMATH_TRACE_SCOPE("se3/Spline::poses", n);
+
+  // Factor 1 is exp(b_1 * d_1) * T_k = T_k * exp(b_1 * log(T_k^-1 * T_k+1)),
+  // and factors 2 and 3 are exp(b_j * d_j); a run of times in the same
+  // segment shares their coefficients
+  const detail::BatchKernels& kernels = detail::batchKernels();
+  policy.forEachRange(n, SPLINE_GRAIN, [&](std::size_t begin, std::size_t end) {
+    double u, coeffs[SEGMENT_COEFFS];
+    std::size_t current = controlPoses_.size();
+    for (std::size_t i = begin; i < end;) {
+      const std::size_t k = segment(t[i], &u);
+      std::size_t j = i + 1;
+      while (j < end && segment(t[j], &u) == k) {
+        ++j;
+      }
+      if (k != current) {
+        const Eigen::Matrix<double, 6, 1> xi =
+            (controlPoses_[k].inverse() * controlPoses_[k + 1]).vec();
+        detail::interpolationCoefficients(controlPoses_[k], xi.data(),
+                                          coeffs);
+        const Transformation identity;
+        detail::interpolationCoefficients(identity, logs_[k + 2].data(),
+                                          coeffs + 49);
+        detail::interpolationCoefficients(identity, logs_[k + 3].data(),
+                                          coeffs + 98);
+        current = k;
+      }
+      kernels.spline(coeffs, t0_ + k * dt_, 1.0 / dt_, t, T, stride, i, j);
+      i = j;
+    }
+  });
+}
+
+PoseArray Spline::poses(const Eigen::VectorXd& t) const {
+  PoseArray T(t.size());
+  poses(t.data(), T.data(), t.size(), T.stride());
+  return T;
+}
+
+}  // namespace se3
+}  // namespace lgmath
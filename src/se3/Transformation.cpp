@@ -11,32 +11,49 @@
 #include <iostream>
 #include <stdexcept>
 
+#include <lgmath/Counters.hpp>
 #include <lgmath/se3/Operations.hpp>
 #include <lgmath/so3/Operations.hpp>
 
 namespace lgmath {
 namespace se3 {
 
-Transformation::Transformation()
-    : C_ba_(Eigen::Matrix3d::Identity()), r_ab_inb_(Eigen::Vector3d::Zero()) {}
+Transformation::Transformation() : T_ba_(Matrix34d::Identity()) {}
 
 Transformation::Transformation(const Eigen::Matrix4d& T)
-    : C_ba_(T.block<3, 3>(0, 0)), r_ab_inb_(T.block<3, 1>(0, 3)) {
+    : T_ba_(T.topRows<3>()) {
+  // Trigger a conditional reprojection, depending on determinant
+  this->reproject(false);
+}
+
+Transformation::Transformation(const Eigen::Matrix4d& T, bool reproj)
+    : T_ba_(T.topRows<3>()) {
+  if (reproj) {
+    // Trigger a conditional reprojection, depending on determinant
+    this->reproject(false);
+  }
+}
+
+Transformation::Transformation(const Eigen::Isometry3d& T_ba)
+    : T_ba_(T_ba.affine()) {
   // Trigger a conditional reprojection, depending on determinant
   this->reproject(false);
 }
 
 Transformation::Transformation(const Eigen::Matrix3d& C_ba,
                                const Eigen::Vector3d& r_ba_ina) {
-  C_ba_ = C_ba;
+  T_ba_.leftCols<3>() = C_ba;
   // Trigger a conditional reprojection, depending on determinant
   this->reproject(false);
-  r_ab_inb_ = (-1.0) * C_ba_ * r_ba_ina;
+  T_ba_.col(3) = (-1.0) * T_ba_.leftCols<3>() * r_ba_ina;
 }
 
 Transformation::Transformation(const Eigen::Matrix<double, 6, 1>& xi_ab,
                                unsigned int numTerms) {
-  lgmath::se3::vec2tran(xi_ab, &C_ba_, &r_ab_inb_, numTerms);
+  Eigen::Matrix3d C_ba;
+  Eigen::Vector3d r_ab_inb;
+  lgmath::se3::vec2tran(xi_ab, &C_ba, &r_ab_inb, numTerms);
+  T_ba_ << C_ba, r_ab_inb;
 }
 
 Transformation::Transformation(const Eigen::VectorXd& xi_ab) {
@@ -48,51 +65,61 @@ Transformation::Transformation(const Eigen::VectorXd& xi_ab) {
   }
 
   // Construct using exponential map
-  lgmath::se3::vec2tran(xi_ab, &C_ba_, &r_ab_inb_, 0);
+  Eigen::Matrix3d C_ba;
+  Eigen::Vector3d r_ab_inb;
+  lgmath::se3::vec2tran(xi_ab, &C_ba, &r_ab_inb, 0);
+  T_ba_ << C_ba, r_ab_inb;
 }
 
 Eigen::Matrix4d Transformation::matrix() const {
-  Eigen::Matrix4d T_ba = Eigen::Matrix4d::Identity();
-  T_ba.topLeftCorner<3, 3>() = C_ba_;
-  T_ba.topRightCorner<3, 1>() = r_ab_inb_;
+  Eigen::Matrix4d T_ba;
+  T_ba << T_ba_, 0.0, 0.0, 0.0, 1.0;
   return T_ba;
 }
 
-const Eigen::Matrix3d& Transformation::C_ba() const { return C_ba_; }
+Eigen::Isometry3d Transformation::isometry() const {
+  Eigen::Isometry3d T_ba;
+  T_ba.affine() = T_ba_;
+  T_ba.makeAffine();
+  return T_ba;
+}
 
 Eigen::Vector3d Transformation::r_ba_ina() const {
-  return (-1.0) * C_ba_.transpose() * r_ab_inb_;
+  return (-1.0) * C_ba().transpose() * r_ab_inb();
 }
 
-const Eigen::Vector3d& Transformation::r_ab_inb() const { return r_ab_inb_; }
-
 Eigen::Matrix<double, 6, 1> Transformation::vec() const {
-  return lgmath::se3::tran2vec(this->C_ba_, this->r_ab_inb_);
+  return lgmath::se3::tran2vec(C_ba(), r_ab_inb());
 }
 
 Transformation Transformation::inverse() const {
+  LGMATH_COUNT(TRANSFORMATION_INVERSE);
   Transformation temp;
-  temp.C_ba_ = C_ba_.transpose();
+  temp.T_ba_.leftCols<3>() = C_ba().transpose();
   // Trigger a conditional reprojection, depending on determinant
   temp.reproject(false);
-  temp.r_ab_inb_ = (-1.0) * temp.C_ba_ * r_ab_inb_;
+  temp.T_ba_.col(3) = (-1.0) * temp.C_ba() * r_ab_inb();
   return temp;
 }
 
 Eigen::Matrix<double, 6, 6> Transformation::adjoint() const {
-  return lgmath::se3::tranAd(C_ba_, r_ab_inb_);
+  return lgmath::se3::tranAd(C_ba(), r_ab_inb());
 }
 
 void Transformation::reproject(bool force) {
+  LGMATH_COUNT(TRANSFORMATION_REPROJECT);
+
   // Note that the translation parameter always belongs to SE(3), but the
   // rotation can incur numerical error that accumulates.
-  C_ba_ = so3::vec2rot(so3::rot2vec(C_ba_));
+  T_ba_.leftCols<3>() = so3::vec2rot(so3::rot2vec(C_ba()));
 }
 
 Transformation& Transformation::operator*=(const Transformation& T_rhs) {
+  LGMATH_COUNT(TRANSFORMATION_COMPOSE);
+
   // Perform operation
-  this->r_ab_inb_ += this->C_ba_ * T_rhs.r_ab_inb_;
-  this->C_ba_ = this->C_ba_ * T_rhs.C_ba_;
+  T_ba_.col(3) += C_ba() * T_rhs.r_ab_inb();
+  T_ba_.leftCols<3>() = C_ba() * T_rhs.C_ba();
 
   // Trigger a conditional reprojection, depending on determinant
   this->reproject(false);
@@ -107,9 +134,11 @@ Transformation Transformation::operator*(const Transformation& T_rhs) const {
 }
 
 Transformation& Transformation::operator/=(const Transformation& T_rhs) {
+  LGMATH_COUNT(TRANSFORMATION_COMPOSE_INVERSE);
+
   // Perform operation
-  this->C_ba_ = this->C_ba_ * T_rhs.C_ba_.transpose();
-  this->r_ab_inb_ += (-1) * this->C_ba_ * T_rhs.r_ab_inb_;
+  T_ba_.leftCols<3>() = C_ba() * T_rhs.C_ba().transpose();
+  T_ba_.col(3) += (-1) * C_ba() * T_rhs.r_ab_inb();
 
   // Trigger a conditional reprojection, depending on determinant
   this->reproject(false);
@@ -126,11 +155,92 @@ Transformation Transformation::operator/(const Transformation& T_rhs) const {
 Eigen::Vector4d Transformation::operator*(
     const Eigen::Ref<const Eigen::Vector4d>& p_a) const {
   Eigen::Vector4d p_b;
-  p_b.head<3>() = C_ba_ * p_a.head<3>() + r_ab_inb_ * p_a[3];
+  p_b.head<3>() = T_ba_ * p_a;
   p_b[3] = p_a[3];
   return p_b;
 }
 
+namespace {
+
+/**
+ * \brief Writes the adjoint [C, r^ * C; 0, C] into J, building r^ * C from
+ * cross products rather than a 6x6 temporary
+ */
+void writeAdjoint(const Eigen::Ref<const Eigen::Matrix3d>& C,
+                  const Eigen::Ref<const Eigen::Vector3d>& r,
+                  Eigen::Matrix<double, 6, 6>* J) {
+  J->topLeftCorner<3, 3>() = C;
+  J->bottomRightCorner<3, 3>() = C;
+  J->bottomLeftCorner<3, 3>().setZero();
+  for (int col = 0; col < 3; ++col) {
+    J->block<3, 1>(0, 3 + col) = r.cross(C.col(col));
+  }
+}
+
+}  // namespace
+
+void composeWithJacobians(const Transformation& T_1, const Transformation& T_2,
+                          Transformation* T_12,
+                          Eigen::Matrix<double, 6, 6>* J_1,
+                          Eigen::Matrix<double, 6, 6>* J_2, bool reproj) {
+  // Every output is computed from these loads, so T_12 may alias T_1
+  const Eigen::Matrix3d C_1 = T_1.C_ba();
+  const Eigen::Vector3d r_1 = T_1.r_ab_inb();
+  if (J_1 != nullptr) {
+    J_1->setIdentity();
+  }
+  if (J_2 != nullptr) {
+    writeAdjoint(C_1, r_1, J_2);
+  }
+  if (T_12 != nullptr) {
+    LGMATH_COUNT(TRANSFORMATION_COMPOSE);
+    Eigen::Matrix4d T = Eigen::Matrix4d::Identity();
+    T.topRightCorner<3, 1>() = C_1 * T_2.r_ab_inb() + r_1;
+    T.topLeftCorner<3, 3>() = C_1 * T_2.C_ba();
+    *T_12 = Transformation(T, reproj);
+  }
+}
+
+void inverseWithJacobian(const Transformation& T, Transformation* T_inv,
+                         Eigen::Matrix<double, 6, 6>* J, bool reproj) {
+  // Every output is computed from these loads, so T_inv may alias T
+  const Eigen::Matrix3d C = T.C_ba();
+  const Eigen::Vector3d r = T.r_ab_inb();
+  if (J != nullptr) {
+    // -Ad(T^-1) = [-C^T, C^T * r^; 0, -C^T], since (C^T * r)^ = C^T * r^ * C
+    J->topLeftCorner<3, 3>() = -C.transpose();
+    J->bottomRightCorner<3, 3>() = -C.transpose();
+    J->bottomLeftCorner<3, 3>().setZero();
+    for (int row = 0; row < 3; ++row) {
+      // Row i of C^T * r^ is (C.col(i) x r)^T
+      J->block<1, 3>(row, 3) = C.col(row).cross(r).transpose();
+    }
+  }
+  if (T_inv != nullptr) {
+    LGMATH_COUNT(TRANSFORMATION_INVERSE);
+    Eigen::Matrix4d T_ab = Eigen::Matrix4d::Identity();
+    T_ab.topLeftCorner<3, 3>() = C.transpose();
+    T_ab.topRightCorner<3, 1>() = -C.transpose() * r;
+    *T_inv = Transformation(T_ab, reproj);
+  }
+}
+
+Eigen::Vector3d transformPointWithJacobian(const Transformation& T_ba,
+                                           const Eigen::Vector3d& p_a,
+                                           Eigen::Matrix3d* J_p,
+                                           Eigen::Matrix<double, 3, 6>* J_T) {
+  const Eigen::Vector3d p_b = T_ba.C_ba() * p_a + T_ba.r_ab_inb();
+  if (J_p != nullptr) {
+    *J_p = T_ba.C_ba();
+  }
+  if (J_T != nullptr) {
+    J_T->leftCols<3>().setIdentity();
+    J_T->rightCols<3>() << 0.0, p_b(2), -p_b(1), -p_b(2), 0.0, p_b(0), p_b(1),
+        -p_b(0), 0.0;
+  }
+  return p_b;
+}
+
 }  // namespace se3
 }  // namespace lgmath
 
@@ -0,0 +1,206 @@
+/**
+ * \file TransformationMap.cpp
+ * \brief Implementation file for transformation views over external buffers.
+ *
+ * \author ASRL
+ */
+#include <lgmath/se3/TransformationMap.hpp>
+
+#include <stdexcept>
+
+#include <lgmath/se3/Operations.hpp>
+
+namespace lgmath {
+namespace se3 {
+
+namespace {
+
+typedef Eigen::Map<const Eigen::Matrix<double, 3, 4, Eigen::RowMajor>>
+    RowMajorMap;
+typedef Eigen::Map<const Eigen::Matrix<double, 3, 4>> ColMajorMap;
+
+/**
+ * \brief Calls f with the rotation and translation of the buffer, mapped in
+ * place when the layout is a matrix
+ */
+template <class Function>
+auto visit(const double* data, PoseLayout layout, const Function& f) {
+  switch (layout) {
+    case PoseLayout::ROW_MAJOR_3X4: {
+      const RowMajorMap T(data);
+      return f(T.leftCols<3>(), T.col(3));
+    }
+    case PoseLayout::COL_MAJOR_3X4: {
+      const ColMajorMap T(data);
+      return f(T.leftCols<3>(), T.col(3));
+    }
+    case PoseLayout::TRANSLATION_QUATERNION:
+      return f(Eigen::Map<const Eigen::Quaterniond>(data + 3)
+                   .normalized()
+                   .toRotationMatrix(),
+               Eigen::Map<const Eigen::Vector3d>(data));
+    case PoseLayout::VECTOR6:
+      break;
+  }
+  Eigen::Matrix3d C;
+  Eigen::Vector3d r;
+  vec2tran(Eigen::Map<const Eigen::Matrix<double, 6, 1>>(data), &C, &r, 0);
+  return f(C, r);
+}
+
+}  // namespace
+
+int poseLayoutSize(PoseLayout layout) {
+  switch (layout) {
+    case PoseLayout::ROW_MAJOR_3X4:
+    case PoseLayout::COL_MAJOR_3X4:
+      return 12;
+    case PoseLayout::TRANSLATION_QUATERNION:
+      return 7;
+    case PoseLayout::VECTOR6:
+      break;
+  }
+  return 6;
+}
+
+ConstTransformationMap::ConstTransformationMap(const double* data,
+                                               PoseLayout layout)
+    : data_(data), layout_(layout) {
+  if (data == nullptr) {
+    throw std::invalid_argument(
+        "Tried to map a transformation over a null buffer");
+  }
+}
+
+Eigen::Matrix4d ConstTransformationMap::matrix() const {
+  return visit(data_, layout_, [](const auto& C, const auto& r) {
+    Eigen::Matrix4d T_ba = Eigen::Matrix4d::Identity();
+    T_ba.topLeftCorner<3, 3>() = C;
+    T_ba.topRightCorner<3, 1>() = r;
+    return T_ba;
+  });
+}
+
+Eigen::Matrix3d ConstTransformationMap::C_ba() const {
+  return visit(data_, layout_, [](const auto& C, const auto&) {
+    return Eigen::Matrix3d(C);
+  });
+}
+
+Eigen::Vector3d ConstTransformationMap::r_ab_inb() const {
+  return visit(data_, layout_, [](const auto&, const auto& r) {
+    return Eigen::Vector3d(r);
+  });
+}
+
+Eigen::Matrix<double, 6, 1> ConstTransformationMap::vec() const {
+  if (layout_ == PoseLayout::VECTOR6) {
+    return Eigen::Map<const Eigen::Matrix<double, 6, 1>>(data_);
+  }
+  return visit(data_, layout_, [](const auto& C, const auto& r) {
+    return tran2vec(C, r);
+  });
+}
+
+Transformation ConstTransformationMap::transformation() const {
+  return Transformation(matrix(), false);
+}
+
+Transformation ConstTransformationMap::inverse() const {
+  return transformation().inverse();
+}
+
+Eigen::Matrix<double, 6, 6> ConstTransformationMap::adjoint() const {
+  return visit(data_, layout_,
+               [](const auto& C, const auto& r) { return tranAd(C, r); });
+}
+
+Transformation ConstTransformationMap::operator*(
+    const ConstTransformationMap& T_rhs) const {
+  return transformation() * T_rhs.transformation();
+}
+
+Transformation ConstTransformationMap::operator*(
+    const Transformation& T_rhs) const {
+  return transformation() * T_rhs;
+}
+
+Eigen::Vector4d ConstTransformationMap::operator*(
+    const Eigen::Ref<const Eigen::Vector4d>& p_a) const {
+  return visit(data_, layout_, [&p_a](const auto& C, const auto& r) {
+    Eigen::Vector4d p_b;
+    p_b.head<3>() = C * p_a.head<3>() + r * p_a[3];
+    p_b[3] = p_a[3];
+    return p_b;
+  });
+}
+
+TransformationMap::TransformationMap(double* data, PoseLayout layout)
+    : ConstTransformationMap(data, layout) {}
+
+void TransformationMap::assign(const Eigen::Matrix3d& C_ba,
+                               const Eigen::Vector3d& r_ab_inb) {
+  double* out = data();
+  switch (layout_) {
+    case PoseLayout::ROW_MAJOR_3X4: {
+      Eigen::Map<Eigen::Matrix<double, 3, 4, Eigen::RowMajor>> T(out);
+      T << C_ba, r_ab_inb;
+      break;
+    }
+    case PoseLayout::COL_MAJOR_3X4: {
+      Eigen::Map<Eigen::Matrix<double, 3, 4>> T(out);
+      T << C_ba, r_ab_inb;
+      break;
+    }
+    case PoseLayout::TRANSLATION_QUATERNION: {
+      Eigen::Map<Eigen::Vector3d> r(out);
+      Eigen::Map<Eigen::Quaterniond> q(out + 3);
+      r = r_ab_inb;
+      q = Eigen::Quaterniond(C_ba);
+      break;
+    }
+    case PoseLayout::VECTOR6: {
+      Eigen::Map<Eigen::Matrix<double, 6, 1>> xi(out);
+      xi = tran2vec(C_ba, r_ab_inb);
+      break;
+    }
+  }
+}
+
+TransformationMap& TransformationMap::operator=(const Transformation& T) {
+  assign(T.C_ba(), T.r_ab_inb());
+  return *this;
+}
+
+TransformationMap& TransformationMap::operator=(
+    const ConstTransformationMap& T) {
+  visit(T.data(), T.layout(), [this](const auto& C, const auto& r) {
+    // Copy out first, since T may share the buffer
+    const Eigen::Matrix3d C_ba = C;
+    const Eigen::Vector3d r_ab_inb = r;
+    assign(C_ba, r_ab_inb);
+    return 0;
+  });
+  return *this;
+}
+
+TransformationMap& TransformationMap::operator=(const TransformationMap& T) {
+  return *this = static_cast<const ConstTransformationMap&>(T);
+}
+
+void compose(const ConstTransformationMap& T_lhs,
+             const ConstTransformationMap& T_rhs, TransformationMap* T_out) {
+  // Both are read before writing, so that out may alias them
+  const Eigen::Matrix3d C_rhs = T_rhs.C_ba();
+  const Eigen::Vector3d r_rhs = T_rhs.r_ab_inb();
+  visit(T_lhs.data(), T_lhs.layout(),
+        [&C_rhs, &r_rhs, T_out](const auto& C, const auto& r) {
+          const Eigen::Matrix3d C_ba = C * C_rhs;
+          const Eigen::Vector3d r_ab_inb = r + C * r_rhs;
+          T_out->assign(C_ba, r_ab_inb);
+          return 0;
+        });
+}
+
+}  // namespace se3
+}  // namespace lgmath
@@ -0,0 +1,109 @@
+/**
+ * \file TransformationPairWithCovariance.cpp
+ * \brief Implementation file for two transformations with a joint
+ * covariance.
+ *
+ * \author ASRL
+ */
+#include <lgmath/se3/TransformationPairWithCovariance.hpp>
+
+namespace lgmath {
+namespace se3 {
+
+namespace {
+
+typedef Eigen::Matrix<double, 6, 6> Matrix6d;
+
+/**
+ * \brief Ad(T) * M, from the blocks of Ad(T) = [C, r^ * C; 0, C]: the bottom
+ * rows C * M_b, and the top rows C * M_t + r x (C * M_b)
+ */
+Matrix6d adjointTimes(const Transformation& T, const Matrix6d& M) {
+  const Transformation::Matrix34d& T_ba = T.matrix34();
+  const auto C = T_ba.leftCols<3>();
+  const Eigen::Vector3d r = T_ba.col(3);
+  Matrix6d out;
+  out.bottomRows<3>().noalias() = C * M.bottomRows<3>();
+  out.topRows<3>().noalias() = C * M.topRows<3>();
+  for (int col = 0; col < 6; ++col) {
+    out.col(col).head<3>() +=
+        r.cross(Eigen::Vector3d(out.col(col).tail<3>()));
+  }
+  return out;
+}
+
+/** \brief Ad(T_1) * M * Ad(T_2)^T */
+Matrix6d adjointProduct(const Transformation& T_1, const Matrix6d& M,
+                        const Transformation& T_2) {
+  return adjointTimes(T_1, adjointTimes(T_2, M.transpose()).transpose());
+}
+
+}  // namespace
+
+TransformationPairWithCovariance::TransformationPairWithCovariance(
+    const Transformation& T_1, const Transformation& T_2,
+    const Matrix12d& covariance)
+    : T_1_(T_1), T_2_(T_2), covariance_(covariance) {}
+
+TransformationPairWithCovariance::TransformationPairWithCovariance(
+    const TransformationWithCovariance& T_1,
+    const TransformationWithCovariance& T_2,
+    const Eigen::Matrix<double, 6, 6>& crossCovariance)
+    : T_1_(T_1), T_2_(T_2) {
+  covariance_.topLeftCorner<6, 6>() = T_1.cov();
+  covariance_.topRightCorner<6, 6>() = crossCovariance;
+  covariance_.bottomLeftCorner<6, 6>() = crossCovariance.transpose();
+  covariance_.bottomRightCorner<6, 6>() = T_2.cov();
+}
+
+TransformationWithCovariance TransformationPairWithCovariance::first() const {
+  return TransformationWithCovariance(
+      T_1_, Matrix6d(covariance_.topLeftCorner<6, 6>()));
+}
+
+TransformationWithCovariance TransformationPairWithCovariance::second() const {
+  return TransformationWithCovariance(
+      T_2_, Matrix6d(covariance_.bottomRightCorner<6, 6>()));
+}
+
+TransformationWithCovariance TransformationPairWithCovariance::compose()
+    const {
+  // xi = xi_1 + Ad(T_1) * xi_2
+  const Matrix6d Z =
+      adjointTimes(T_1_, covariance_.bottomLeftCorner<6, 6>());
+  const Matrix6d cov =
+      covariance_.topLeftCorner<6, 6>() +
+      adjointProduct(T_1_, covariance_.bottomRightCorner<6, 6>(), T_1_) + Z +
+      Z.transpose();
+  return TransformationWithCovariance(T_1_ * T_2_, cov);
+}
+
+TransformationWithCovariance TransformationPairWithCovariance::relative()
+    const {
+  // xi = xi_1 - Ad(T_1 * T_2^-1) * xi_2
+  const Transformation T = T_1_ / T_2_;
+  const Matrix6d Z = adjointTimes(T, covariance_.bottomLeftCorner<6, 6>());
+  const Matrix6d cov =
+      covariance_.topLeftCorner<6, 6>() +
+      adjointProduct(T, covariance_.bottomRightCorner<6, 6>(), T) - Z -
+      Z.transpose();
+  return TransformationWithCovariance(T, cov);
+}
+
+TransformationPairWithCovariance TransformationPairWithCovariance::inverse()
+    const {
+  // xi_i' = -Ad(T_i^-1) * xi_i
+  const Transformation T_1 = T_1_.inverse(), T_2 = T_2_.inverse();
+  Matrix12d cov;
+  cov.topLeftCorner<6, 6>() =
+      adjointProduct(T_1, covariance_.topLeftCorner<6, 6>(), T_1);
+  cov.topRightCorner<6, 6>() =
+      adjointProduct(T_1, covariance_.topRightCorner<6, 6>(), T_2);
+  cov.bottomLeftCorner<6, 6>() = cov.topRightCorner<6, 6>().transpose();
+  cov.bottomRightCorner<6, 6>() =
+      adjointProduct(T_2, covariance_.bottomRightCorner<6, 6>(), T_2);
+  return TransformationPairWithCovariance(T_1, T_2, cov);
+}
+
+}  // namespace se3
+}  // namespace lgmath
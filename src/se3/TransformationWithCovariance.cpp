@@ -12,6 +12,7 @@
 
 #include <stdexcept>
 
+#include <lgmath/Counters.hpp>
 #include <lgmath/se3/Operations.hpp>
 #include <lgmath/so3/Operations.hpp>
 
@@ -114,7 +115,8 @@ TransformationWithCovariance& TransformationWithCovariance::operator=(
   return (*this);
 }
 
-const Eigen::Matrix<double, 6, 6>& TransformationWithCovariance::cov() const {
+const TransformationWithCovariance::Matrix6d&
+TransformationWithCovariance::cov() const {
   if (!covarianceSet_) {
     throw std::logic_error(
         "Covariance accessed before being set.  "
@@ -139,6 +141,7 @@ void TransformationWithCovariance::setZeroCovariance() {
 }
 
 TransformationWithCovariance TransformationWithCovariance::inverse() const {
+  LGMATH_COUNT(TRANSFORMATION_WITH_COVARIANCE_INVERSE);
   TransformationWithCovariance temp(Transformation::inverse(), false);
   Eigen::Matrix<double, 6, 6> adjointOfInverse = temp.adjoint();
   temp.setCovariance(adjointOfInverse * covariance_ *
@@ -148,12 +151,17 @@ TransformationWithCovariance TransformationWithCovariance::inverse() const {
 
 TransformationWithCovariance& TransformationWithCovariance::operator*=(
     const TransformationWithCovariance& T_rhs) {
+  LGMATH_COUNT(TRANSFORMATION_WITH_COVARIANCE_COMPOSE);
+
   // The covarianceSet_ flag is only set to true if BOTH transforms have a
   // properly set covariance
   Eigen::Matrix<double, 6, 6> Ad_lhs = Transformation::adjoint();
   this->covariance_ =
       this->covariance_ + Ad_lhs * T_rhs.covariance_ * Ad_lhs.transpose();
   this->covarianceSet_ = (this->covarianceSet_ && T_rhs.covarianceSet_);
+  if (!this->covarianceSet_) {
+    LGMATH_COUNT(TRANSFORMATION_WITH_COVARIANCE_COVARIANCE_UNSET);
+  }
 
   // Compound mean transform
   Transformation::operator*=(T_rhs);
@@ -168,6 +176,8 @@ TransformationWithCovariance& TransformationWithCovariance::operator*=(
 
 TransformationWithCovariance& TransformationWithCovariance::operator/=(
     const TransformationWithCovariance& T_rhs) {
+  LGMATH_COUNT(TRANSFORMATION_WITH_COVARIANCE_COMPOSE_INVERSE);
+
   // Note very carefully that we modify the internal transform before taking the
   // adjoint in order to avoid having to convert the rhs covariance explicitly
   Transformation::operator/=(T_rhs);
@@ -175,6 +185,9 @@ TransformationWithCovariance& TransformationWithCovariance::operator/=(
   this->covariance_ = this->covariance_ +
                       Ad_lhs_rhs * T_rhs.covariance_ * Ad_lhs_rhs.transpose();
   this->covarianceSet_ = (this->covarianceSet_ && T_rhs.covarianceSet_);
+  if (!this->covarianceSet_) {
+    LGMATH_COUNT(TRANSFORMATION_WITH_COVARIANCE_COVARIANCE_UNSET);
+  }
   return *this;
 }
 
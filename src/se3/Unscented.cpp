@@ -0,0 +1,163 @@
+/**
+ * \file Unscented.cpp
+ * \brief Implementation file for the unscented transform through SE3
+ * operations.
+ *
+ * \author ASRL
+ */
+#include <lgmath/se3/Unscented.hpp>
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include <lgmath/Trace.hpp>
+#include <lgmath/se3/PoseArray.hpp>
+
+#include "CovarianceFactor.hpp"
+
+namespace lgmath {
+namespace se3 {
+
+namespace {
+
+typedef Eigen::Matrix<double, 6, 1> Vector6d;
+typedef Eigen::Matrix<double, 6, 6> Matrix6d;
+typedef Eigen::Matrix<double, 12, 12> Matrix12d;
+typedef PoseArray::Matrix6Xd Matrix6Xd;
+
+/** \brief Norm of the last update of the output mean */
+const double TOLERANCE = 1e-12;
+
+/** \brief The weights of the sigma points */
+struct Weights {
+  /** \brief sqrt(n + lambda), the scale of the factor */
+  double scale;
+  /** \brief Weights of the mean in the output mean and covariance */
+  double mean0, cov0;
+  /** \brief Weight of the other points in both */
+  double other;
+};
+
+/** \brief The weights of the 2n + 1 sigma points */
+Weights sigmaWeights(int n, const UnscentedOptions& options) {
+  const double lambda =
+      options.alpha * options.alpha * (n + options.kappa) - n;
+  if (!(n + lambda > 0.0)) {
+    throw std::invalid_argument(
+        "The sigma points need n + lambda > 0 in the unscented transform");
+  }
+  Weights weights;
+  weights.scale = std::sqrt(n + lambda);
+  weights.mean0 = lambda / (n + lambda);
+  weights.cov0 =
+      weights.mean0 + 1.0 - options.alpha * options.alpha + options.beta;
+  weights.other = 0.5 / (n + lambda);
+  return weights;
+}
+
+/** \brief The 2n + 1 perturbations 0, +L.col(j), -L.col(j) */
+template <int N>
+Eigen::Matrix<double, N, Eigen::Dynamic> sigmaPerturbations(
+    const Eigen::Matrix<double, N, N>& L) {
+  Eigen::Matrix<double, N, Eigen::Dynamic> xi(N, 2 * N + 1);
+  xi.col(0).setZero();
+  xi.template middleCols<N>(1) = L;
+  xi.template rightCols<N>() = -L;
+  return xi;
+}
+
+/** \brief The sigma poses exp(xi_i^) * T */
+PoseArray sigmaPoses(const Matrix6Xd& xi, const Transformation& T) {
+  const std::vector<Transformation> means(xi.cols(), T);
+  return PoseArray(xi) * PoseArray(means);
+}
+
+/**
+ * \brief The weighted mean and covariance of the images Y of the sigma
+ * points, Y[0] the image of the mean
+ */
+TransformationWithCovariance recombine(const PoseArray& Y,
+                                       const Weights& weights,
+                                       const UnscentedOptions& options) {
+  const std::size_t m = Y.size(), stride = Y.stride();
+  PoseArray inverses(m), relative(m);
+  std::vector<double> rows(6 * stride);
+  Transformation Y_mean = Y[0];
+  Matrix6Xd xi;
+  Vector6d delta;
+  for (unsigned int k = 0;; ++k) {
+    const Transformation inverse = Y_mean.inverse();
+    for (std::size_t i = 0; i < m; ++i) {
+      inverses.set(i, inverse);
+    }
+    composeBatch(Y.data(), inverses.data(), relative.data(), m, stride);
+    tran2vecBatch(relative.data(), rows.data(), m, stride);
+    xi = Eigen::Map<Eigen::Matrix<double, 6, Eigen::Dynamic, Eigen::RowMajor>,
+                    0, Eigen::OuterStride<>>(rows.data(), 6, m,
+                                             Eigen::OuterStride<>(stride));
+    delta = weights.mean0 * xi.col(0) +
+            weights.other * xi.rightCols(m - 1).rowwise().sum();
+    Y_mean = Transformation(delta) * Y_mean;
+    if (delta.norm() < TOLERANCE || k + 1 >= options.maxIterations) {
+      break;
+    }
+  }
+
+  // The spread about the updated mean, to first order in delta
+  xi.colwise() -= delta;
+  const Matrix6d cov = weights.cov0 * xi.col(0) * xi.col(0).transpose() +
+                       weights.other * xi.rightCols(m - 1) *
+                           xi.rightCols(m - 1).transpose();
+  return TransformationWithCovariance(Y_mean, cov);
+}
+
+}  // namespace
+
+TransformationWithCovariance unscentedTransform(
+    const TransformationWithCovariance& T,
+    const std::function<Transformation(const Transformation&)>& f,
+    const UnscentedOptions& options) {
+  LGMATH_TRACE_SCOPE("se3/unscentedTransform", 13);
+  const Weights weights = sigmaWeights(6, options);
+  const Matrix6d L =
+      detail::covarianceFactor<6>(T.cov(), "unscentedTransform");
+  const PoseArray X =
+      sigmaPoses(sigmaPerturbations<6>(weights.scale * L), T);
+  PoseArray Y(X.size());
+  for (std::size_t i = 0; i < X.size(); ++i) {
+    Y.set(i, f(X[i]));
+  }
+  return recombine(Y, weights, options);
+}
+
+TransformationWithCovariance unscentedCompose(
+    const TransformationWithCovariance& T_lhs,
+    const TransformationWithCovariance& T_rhs,
+    const UnscentedOptions& options) {
+  LGMATH_TRACE_SCOPE("se3/unscentedCompose", 25);
+  const Weights weights = sigmaWeights(12, options);
+  Matrix12d L = Matrix12d::Zero();
+  L.topLeftCorner<6, 6>() =
+      detail::covarianceFactor<6>(T_lhs.cov(), "unscentedCompose");
+  L.bottomRightCorner<6, 6>() =
+      detail::covarianceFactor<6>(T_rhs.cov(), "unscentedCompose");
+  const Eigen::Matrix<double, 12, Eigen::Dynamic> xi =
+      sigmaPerturbations<12>(weights.scale * L);
+  const PoseArray Y = sigmaPoses(xi.topRows<6>(), T_lhs) *
+                      sigmaPoses(xi.bottomRows<6>(), T_rhs);
+  return recombine(Y, weights, options);
+}
+
+TransformationWithCovariance unscentedInverse(
+    const TransformationWithCovariance& T, const UnscentedOptions& options) {
+  LGMATH_TRACE_SCOPE("se3/unscentedInverse", 13);
+  const Weights weights = sigmaWeights(6, options);
+  const Matrix6d L = detail::covarianceFactor<6>(T.cov(), "unscentedInverse");
+  const PoseArray X =
+      sigmaPoses(sigmaPerturbations<6>(weights.scale * L), T);
+  return recombine(X.inverse(), weights, options);
+}
+
+}  // namespace se3
+}  // namespace lgmath
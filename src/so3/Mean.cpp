@@ -0,0 +1,117 @@
+/**
+ * \file Mean.cpp
+ * \brief Implementation file for the weighted means of rotations.
+ *
+ * \author ASRL
+ */
+#include <lgmath/so3/Mean.hpp>
+
+#include <stdexcept>
+
+#include <Eigen/SVD>
+
+#include <lgmath/Parallel.hpp>
+#include <lgmath/so3/Operations.hpp>
+
+#include "../Reduction.hpp"
+
+namespace lgmath {
+namespace so3 {
+
+namespace {
+
+/** \brief Most Gauss-Newton iterations of the Karcher mean */
+const unsigned int MAX_ITERATIONS = 100;
+
+/** \brief Norm of the last Karcher update */
+const double TOLERANCE = 1e-12;
+
+/** \brief Checks the weights, and returns their sum */
+double checkWeights(std::size_t n, const std::vector<double>& weights) {
+  if (n == 0) {
+    throw std::invalid_argument("No rotations to average.");
+  }
+  if (weights.empty()) {
+    return double(n);
+  }
+  if (weights.size() != n) {
+    throw std::invalid_argument("Need one weight per rotation.");
+  }
+  double total = 0.0;
+  for (double w : weights) {
+    if (!(w >= 0.0)) {
+      throw std::invalid_argument("Weights must be non-negative.");
+    }
+    total += w;
+  }
+  if (!(total > 0.0)) {
+    throw std::invalid_argument("Weights must have a positive sum.");
+  }
+  return total;
+}
+
+}  // namespace
+
+Rotation mean(const std::vector<Rotation>& rotations,
+              const std::vector<double>& weights, MeanMethod method,
+              Eigen::Matrix3d* spread) {
+  return mean(common::ExecutionPolicy::sequential(), rotations, weights,
+              method, spread);
+}
+
+Rotation mean(const common::ExecutionPolicy& policy,
+              const std::vector<Rotation>& rotations,
+              const std::vector<double>& weights, MeanMethod method,
+              Eigen::Matrix3d* spread) {
+  const std::size_t n = rotations.size();
+  const double total = checkWeights(n, weights);
+  auto weight = [&](std::size_t i) {
+    return weights.empty() ? 1.0 : weights[i];
+  };
+
+  // The chordal mean, projected onto SO3 with det(C) = 1
+  const Eigen::Matrix3d M = common::detail::reduce(
+      policy, n, Eigen::Matrix3d(Eigen::Matrix3d::Zero()),
+      [&](std::size_t i) -> Eigen::Matrix3d {
+        return weight(i) * rotations[i].matrix();
+      });
+  const Eigen::JacobiSVD<Eigen::Matrix3d> svd(
+      M, Eigen::ComputeFullU | Eigen::ComputeFullV);
+  Eigen::Vector3d diag = Eigen::Vector3d::Ones();
+  diag(2) = (svd.matrixU() * svd.matrixV().transpose()).determinant();
+  Eigen::Matrix3d C =
+      svd.matrixU() * diag.asDiagonal() * svd.matrixV().transpose();
+
+  // The Karcher mean, C <- exp(delta^) * C
+  if (method == MeanMethod::KARCHER) {
+    for (unsigned int k = 0; k < MAX_ITERATIONS; ++k) {
+      const Eigen::Vector3d delta =
+          common::detail::reduce(
+              policy, n, Eigen::Vector3d(Eigen::Vector3d::Zero()),
+              [&](std::size_t i) -> Eigen::Vector3d {
+                return weight(i) *
+                       rot2vec(rotations[i].matrix() * C.transpose());
+              }) /
+          total;
+      C = vec2rot(delta) * C;
+      if (delta.norm() < TOLERANCE) {
+        break;
+      }
+    }
+  }
+
+  if (spread) {
+    *spread = common::detail::reduce(
+                  policy, n, Eigen::Matrix3d(Eigen::Matrix3d::Zero()),
+                  [&](std::size_t i) -> Eigen::Matrix3d {
+                    const Eigen::Vector3d phi =
+                        rot2vec(rotations[i].matrix() * C.transpose());
+                    return weight(i) * phi * phi.transpose();
+                  }) /
+              total;
+  }
+  return Rotation(C);
+}
+
+}  // namespace so3
+}  // namespace lgmath
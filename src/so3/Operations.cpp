@@ -14,6 +14,8 @@
 
 #include <Eigen/Dense>
 
+#include <lgmath/Counters.hpp>
+
 namespace lgmath {
 namespace so3 {
 
@@ -26,11 +28,14 @@ Eigen::Matrix3d hat(const Eigen::Vector3d& vector) {
 
 Eigen::Matrix3d vec2rot(const Eigen::Vector3d& aaxis_ba,
                         unsigned int numTerms) {
+  LGMATH_COUNT(SO3_VEC2ROT);
+
   // Get angle
   const double phi_ba = aaxis_ba.norm();
 
   // If angle is very small, return Identity
   if (phi_ba < 1e-12) {
+    LGMATH_COUNT(SO3_VEC2ROT_SMALL_ANGLE);
     return Eigen::Matrix3d::Identity();
   }
 
@@ -45,6 +50,7 @@ Eigen::Matrix3d vec2rot(const Eigen::Vector3d& aaxis_ba,
 
   } else {
     // Numerical solution (good for testing the analytical solution)
+    LGMATH_COUNT(SO3_VEC2ROT_SERIES);
     Eigen::Matrix3d C_ab = Eigen::Matrix3d::Identity();
 
     // Incremental variables
@@ -78,6 +84,8 @@ void vec2rot(const Eigen::Vector3d& aaxis_ba, Eigen::Matrix3d* out_C_ab,
 }
 
 Eigen::Vector3d rot2vec(const Eigen::Matrix3d& C_ab) {
+  LGMATH_COUNT(SO3_ROT2VEC);
+
   // Get angle
   const double phi_ba = acos(std::clamp(0.5 * (C_ab.trace() - 1.0), -1.0, 1.0));
   const double sinphi_ba = sin(phi_ba);
@@ -94,6 +102,7 @@ Eigen::Vector3d rot2vec(const Eigen::Matrix3d& C_ab) {
     // ** Note with this method we do not know the sign of 'phi', however since
     // we know phi is
     //    close to pi or 2*pi, the sign is unimportant..
+    LGMATH_COUNT(SO3_ROT2VEC_NEAR_PI);
 
     // Find the eigenvalues and eigenvectors
     Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> eigenSolver(C_ab);
@@ -115,16 +124,20 @@ Eigen::Vector3d rot2vec(const Eigen::Matrix3d& C_ab) {
 
   } else {
     // Angle is near zero
+    LGMATH_COUNT(SO3_ROT2VEC_NEAR_ZERO);
     return Eigen::Vector3d::Zero();
   }
 }
 
 Eigen::Matrix3d vec2jac(const Eigen::Vector3d& aaxis_ba,
                         unsigned int numTerms) {
+  LGMATH_COUNT(SO3_VEC2JAC);
+
   // Get angle
   const double phi_ba = aaxis_ba.norm();
   if (phi_ba < 1e-12) {
     // If angle is very small, return Identity
+    LGMATH_COUNT(SO3_VEC2JAC_SMALL_ANGLE);
     return Eigen::Matrix3d::Identity();
   }
 
@@ -137,6 +150,7 @@ Eigen::Matrix3d vec2jac(const Eigen::Vector3d& aaxis_ba,
            (1.0 - sinTerm) * axis * axis.transpose() + cosTerm * so3::hat(axis);
   } else {
     // Numerical solution (good for testing the analytical solution)
+    LGMATH_COUNT(SO3_VEC2JAC_SERIES);
     Eigen::Matrix3d J_ab = Eigen::Matrix3d::Identity();
 
     // Incremental variables
@@ -154,10 +168,13 @@ Eigen::Matrix3d vec2jac(const Eigen::Vector3d& aaxis_ba,
 
 Eigen::Matrix3d vec2jacinv(const Eigen::Vector3d& aaxis_ba,
                            unsigned int numTerms) {
+  LGMATH_COUNT(SO3_VEC2JACINV);
+
   // Get angle
   const double phi_ba = aaxis_ba.norm();
   if (phi_ba < 1e-12) {
     // If angle is very small, return Identity
+    LGMATH_COUNT(SO3_VEC2JACINV_SMALL_ANGLE);
     return Eigen::Matrix3d::Identity();
   }
 
@@ -177,6 +194,7 @@ Eigen::Matrix3d vec2jacinv(const Eigen::Vector3d& aaxis_ba,
     }
 
     // Numerical solution (good for testing the analytical solution)
+    LGMATH_COUNT(SO3_VEC2JACINV_SERIES);
     Eigen::Matrix3d J_ab_inverse = Eigen::Matrix3d::Identity();
 
     // Incremental variables
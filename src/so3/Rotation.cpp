@@ -10,6 +10,7 @@
 
 #include <stdexcept>
 
+#include <lgmath/Counters.hpp>
 #include <lgmath/so3/Operations.hpp>
 
 namespace lgmath {
@@ -22,6 +23,13 @@ Rotation::Rotation(const Eigen::Matrix3d& C) : C_ba_(C) {
   this->reproject(false);
 }
 
+Rotation::Rotation(const Eigen::Matrix3d& C, bool reproj) : C_ba_(C) {
+  if (reproj) {
+    // Trigger a conditional reprojection, depending on determinant
+    this->reproject(false);
+  }
+}
+
 Rotation::Rotation(const Eigen::Vector3d& aaxis_ab, unsigned int numTerms) {
   C_ba_ = lgmath::so3::vec2rot(aaxis_ab, numTerms);
 }
@@ -45,6 +53,7 @@ Eigen::Vector3d Rotation::vec() const {
 }
 
 Rotation Rotation::inverse() const {
+  LGMATH_COUNT(ROTATION_INVERSE);
   Rotation temp;
   temp.C_ba_ = C_ba_.transpose();
   temp.reproject(
@@ -53,12 +62,16 @@ Rotation Rotation::inverse() const {
 }
 
 void Rotation::reproject(bool force) {
+  LGMATH_COUNT(ROTATION_REPROJECT);
   if (force || fabs(1.0 - this->C_ba_.determinant()) > 1e-6) {
+    LGMATH_COUNT(ROTATION_REPROJECT_APPLIED);
     C_ba_ = so3::vec2rot(so3::rot2vec(C_ba_));
   }
 }
 
 Rotation& Rotation::operator*=(const Rotation& C_rhs) {
+  LGMATH_COUNT(ROTATION_COMPOSE);
+
   // Perform operation
   this->C_ba_ = this->C_ba_ * C_rhs.C_ba_;
 
@@ -75,6 +88,8 @@ Rotation Rotation::operator*(const Rotation& C_rhs) const {
 }
 
 Rotation& Rotation::operator/=(const Rotation& C_rhs) {
+  LGMATH_COUNT(ROTATION_COMPOSE_INVERSE);
+
   // Perform operation
   this->C_ba_ = this->C_ba_ * C_rhs.C_ba_.transpose();
 
@@ -0,0 +1,159 @@
+/**
+ * \file RotationMap.cpp
+ * \brief Implementation file for rotation views over external buffers.
+ *
+ * \author ASRL
+ */
+#include <lgmath/so3/RotationMap.hpp>
+
+#include <stdexcept>
+
+#include <lgmath/so3/Operations.hpp>
+
+namespace lgmath {
+namespace so3 {
+
+namespace {
+
+typedef Eigen::Map<const Eigen::Matrix<double, 3, 3, Eigen::RowMajor>>
+    RowMajorMap;
+typedef Eigen::Map<const Eigen::Matrix3d> ColMajorMap;
+
+/**
+ * \brief Calls f with the rotation matrix of the buffer, mapped in place when
+ * the layout is a matrix
+ */
+template <class Function>
+auto visit(const double* data, RotationLayout layout, const Function& f) {
+  switch (layout) {
+    case RotationLayout::ROW_MAJOR_3X3:
+      return f(RowMajorMap(data));
+    case RotationLayout::COL_MAJOR_3X3:
+      return f(ColMajorMap(data));
+    case RotationLayout::QUATERNION:
+      return f(Eigen::Map<const Eigen::Quaterniond>(data)
+                   .normalized()
+                   .toRotationMatrix());
+    case RotationLayout::VECTOR3:
+      break;
+  }
+  return f(vec2rot(Eigen::Map<const Eigen::Vector3d>(data)));
+}
+
+}  // namespace
+
+int rotationLayoutSize(RotationLayout layout) {
+  switch (layout) {
+    case RotationLayout::ROW_MAJOR_3X3:
+    case RotationLayout::COL_MAJOR_3X3:
+      return 9;
+    case RotationLayout::QUATERNION:
+      return 4;
+    case RotationLayout::VECTOR3:
+      break;
+  }
+  return 3;
+}
+
+ConstRotationMap::ConstRotationMap(const double* data, RotationLayout layout)
+    : data_(data), layout_(layout) {
+  if (data == nullptr) {
+    throw std::invalid_argument("Tried to map a rotation over a null buffer");
+  }
+}
+
+Eigen::Matrix3d ConstRotationMap::matrix() const {
+  return visit(data_, layout_,
+               [](const auto& C) -> Eigen::Matrix3d { return C; });
+}
+
+Eigen::Vector3d ConstRotationMap::vec() const {
+  if (layout_ == RotationLayout::VECTOR3) {
+    return Eigen::Map<const Eigen::Vector3d>(data_);
+  }
+  return rot2vec(matrix());
+}
+
+Rotation ConstRotationMap::rotation() const {
+  return Rotation(matrix(), false);
+}
+
+Rotation ConstRotationMap::inverse() const {
+  return Rotation(Eigen::Matrix3d(matrix().transpose()), false);
+}
+
+Rotation ConstRotationMap::operator*(const ConstRotationMap& C_rhs) const {
+  return rotation() * C_rhs.rotation();
+}
+
+Rotation ConstRotationMap::operator*(const Rotation& C_rhs) const {
+  return rotation() * C_rhs;
+}
+
+Eigen::Vector3d ConstRotationMap::operator*(
+    const Eigen::Ref<const Eigen::Vector3d>& p_a) const {
+  if (layout_ == RotationLayout::QUATERNION) {
+    // Rotating with the quaternion is cheaper than building the matrix
+    return Eigen::Map<const Eigen::Quaterniond>(data_).normalized() * p_a;
+  }
+  return visit(data_, layout_, [&p_a](const auto& C) -> Eigen::Vector3d {
+    return C * p_a;
+  });
+}
+
+RotationMap::RotationMap(double* data, RotationLayout layout)
+    : ConstRotationMap(data, layout) {}
+
+void RotationMap::assign(const Eigen::Matrix3d& C_ba) {
+  double* out = data();
+  switch (layout_) {
+    case RotationLayout::ROW_MAJOR_3X3: {
+      Eigen::Map<Eigen::Matrix<double, 3, 3, Eigen::RowMajor>> C(out);
+      C = C_ba;
+      break;
+    }
+    case RotationLayout::COL_MAJOR_3X3: {
+      Eigen::Map<Eigen::Matrix3d> C(out);
+      C = C_ba;
+      break;
+    }
+    case RotationLayout::QUATERNION: {
+      Eigen::Map<Eigen::Quaterniond> q(out);
+      q = Eigen::Quaterniond(C_ba);
+      break;
+    }
+    case RotationLayout::VECTOR3: {
+      Eigen::Map<Eigen::Vector3d> aaxis(out);
+      aaxis = rot2vec(C_ba);
+      break;
+    }
+  }
+}
+
+RotationMap& RotationMap::operator=(const Rotation& C) {
+  assign(C.matrix());
+  return *this;
+}
+
+RotationMap& RotationMap::operator=(const ConstRotationMap& C) {
+  assign(C.matrix());
+  return *this;
+}
+
+RotationMap& RotationMap::operator=(const RotationMap& C) {
+  assign(C.matrix());
+  return *this;
+}
+
+void compose(const ConstRotationMap& C_lhs, const ConstRotationMap& C_rhs,
+             RotationMap* C_out) {
+  // Both are read before writing, so that out may alias them
+  const Eigen::Matrix3d rhs = C_rhs.matrix();
+  const Eigen::Matrix3d product = visit(
+      C_lhs.data(), C_lhs.layout(),
+      [&rhs](const auto& C) -> Eigen::Matrix3d { return C * rhs; });
+  C_out->assign(product);
+}
+
+}  // namespace so3
+}  // namespace lgmath
@@ -0,0 +1,475 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// \file BatchTests.cpp
+/// \brief Unit tests for the SE3 batch kernels and their instruction set
+/// dispatch.
+///
+/// \author ASRL
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include <lgmath.hpp>
+#include <lgmath/CommonMath.hpp>
+#include <lgmath/Dispatch.hpp>
+#include <lgmath/se3/Batch.hpp>
+
+#include "TestHelpers.hpp"
+
+using namespace lgmath;
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+///
+/// UNIT TESTS OF THE BATCH KERNELS
+///
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/** \brief Number of test elements, not a multiple of any vector width */
+const std::size_t N = 203;
+
+/** \brief Random algebra vectors, including small and near-pi angles */
+std::vector<Eigen::Matrix<double, 6, 1>> testVectors() {
+  std::vector<Eigen::Matrix<double, 6, 1>> xis;
+  for (std::size_t i = 0; i < N; ++i) {
+    Eigen::Matrix<double, 6, 1> xi = Eigen::Matrix<double, 6, 1>::Random();
+    xi.head<3>() *= 10.0;
+    if (i % 17 == 0) {
+      xi.tail<3>().setZero();
+    } else if (i % 17 == 1) {
+      xi.tail<3>() *= 1e-13;
+    } else if (i % 17 == 2) {
+      xi.tail<3>() *= 1e-7;
+    } else if (i % 17 == 3) {
+      xi.tail<3>() = xi.tail<3>().normalized() * (constants::PI - 1e-3);
+    } else {
+      xi.tail<3>() *= 3.0;
+    }
+    xis.push_back(xi);
+  }
+  return xis;
+}
+
+/** \brief Runs a test for every supported instruction set */
+template <class Test>
+void forEachIsa(const Test& test) {
+  const common::Isa active = common::activeIsa();
+  for (common::Isa isa : common::supportedIsas()) {
+    SCOPED_TRACE(common::isaName(isa));
+    common::setIsa(isa);
+    test();
+  }
+  common::setIsa(active);
+}
+
+}  // namespace
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the instruction set selection
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, BatchDispatch) {
+  const std::vector<common::Isa> isas = common::supportedIsas();
+  ASSERT_FALSE(isas.empty());
+  EXPECT_EQ(isas.front(), common::Isa::GENERIC);
+  EXPECT_TRUE(common::isaSupported(common::detectIsa()));
+  EXPECT_TRUE(common::isaSupported(common::activeIsa()));
+  for (common::Isa isa : {common::Isa::GENERIC, common::Isa::SSE4_2,
+                          common::Isa::AVX2, common::Isa::AVX512}) {
+    EXPECT_EQ(common::parseIsa(common::isaName(isa)), isa);
+    if (!common::isaSupported(isa)) {
+      EXPECT_THROW(common::setIsa(isa), std::invalid_argument);
+    }
+  }
+  EXPECT_THROW(common::parseIsa("mmx"), std::invalid_argument);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the batch exponential and logarithmic maps
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, BatchExpLog) {
+  const std::vector<Eigen::Matrix<double, 6, 1>> xis = testVectors();
+  // Use a stride larger than the number of elements
+  const std::size_t stride = N + 5;
+  std::vector<double> xi(6 * stride), T(12 * stride), xi_out(6 * stride);
+  for (std::size_t i = 0; i < N; ++i) {
+    for (std::size_t k = 0; k < 6; ++k) {
+      xi[k * stride + i] = xis[i](k);
+    }
+  }
+
+  forEachIsa([&]() {
+    se3::vec2tranBatch(xi.data(), T.data(), N, stride);
+    se3::tran2vecBatch(T.data(), xi_out.data(), N, stride);
+    for (std::size_t i = 0; i < N; ++i) {
+      const se3::Transformation T_ref(xis[i]);
+      EXPECT_TRUE(common::nearEqual(test::batchPose(T.data(), i, stride),
+                                    T_ref.matrix(), 1e-12))
+          << i;
+      Eigen::Matrix<double, 6, 1> xi_i;
+      for (std::size_t k = 0; k < 6; ++k) {
+        xi_i(k) = xi_out[k * stride + i];
+      }
+      // The logarithm loses precision as the angle approaches pi
+      const double tol = i % 17 == 3 ? 1e-7 : 1e-9;
+      EXPECT_LT((xi_i - T_ref.vec()).norm(), tol) << i;
+    }
+  });
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the batch logarithmic map of rotations by exactly pi
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, BatchLogPi) {
+  // Rotations by pi about x, y and z
+  const double diagonals[3][3] = {{1, -1, -1}, {-1, 1, -1}, {-1, -1, 1}};
+  const std::size_t n = 3;
+  std::vector<double> T(12 * n, 0.0), xi(6 * n);
+  for (std::size_t i = 0; i < n; ++i) {
+    for (std::size_t row = 0; row < 3; ++row) {
+      T[(5 * row) * n + i] = diagonals[i][row];
+      T[(4 * row + 3) * n + i] = 1.0;
+    }
+  }
+
+  forEachIsa([&]() {
+    se3::tran2vecBatch(T.data(), xi.data(), n);
+    for (std::size_t i = 0; i < n; ++i) {
+      Eigen::Matrix<double, 6, 1> xi_i;
+      for (std::size_t k = 0; k < 6; ++k) {
+        xi_i(k) = xi[k * n + i];
+      }
+      const Eigen::Matrix4d T_i = test::batchPose(T.data(), i, n);
+      EXPECT_LT((xi_i - se3::tran2vec(T_i)).norm(), 1e-12) << i;
+      EXPECT_NEAR(xi_i.tail<3>().norm(), constants::PI, 1e-12) << i;
+    }
+  });
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the batch point transform, also in place
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, BatchTransformPoints) {
+  Eigen::Matrix<double, 6, 1> xi = Eigen::Matrix<double, 6, 1>::Random();
+  const se3::Transformation T_ba(xi);
+  const Eigen::Matrix<double, 3, Eigen::Dynamic> points =
+      Eigen::Matrix<double, 3, Eigen::Dynamic>::Random(3, N) * 100.0;
+
+  forEachIsa([&]() {
+    // The layout of a row-major 3xN matrix
+    Eigen::Matrix<double, 3, Eigen::Dynamic, Eigen::RowMajor> p_a = points;
+    Eigen::Matrix<double, 3, Eigen::Dynamic, Eigen::RowMajor> p_b(3, N);
+    se3::transformPointsBatch(T_ba, p_a.data(), p_b.data(), N);
+    se3::transformPointsBatch(T_ba, p_a.data(), p_a.data(), N);
+    for (std::size_t i = 0; i < N; ++i) {
+      const Eigen::Vector3d ref =
+          T_ba.C_ba() * points.col(i) + T_ba.r_ab_inb();
+      EXPECT_LT((p_b.col(i) - ref).norm(), 1e-10);
+      EXPECT_LT((p_a.col(i) - ref).norm(), 1e-10);
+    }
+  });
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the batch covariance propagation, also in place
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, BatchPropagateCovariance) {
+  const std::vector<Eigen::Matrix<double, 6, 1>> xis = testVectors();
+  std::vector<double> T(12 * N), cov(21 * N), out(21 * N);
+  std::vector<Eigen::Matrix<double, 6, 6>> covs;
+  for (std::size_t i = 0; i < N; ++i) {
+    test::setBatchPose(se3::Transformation(xis[i]).matrix(), i, N, T.data());
+    covs.push_back(test::randomCovariance());
+    const Eigen::Matrix<double, 21, 1> packed = io::packCovariance(covs[i]);
+    for (std::size_t k = 0; k < 21; ++k) {
+      cov[k * N + i] = packed(k);
+    }
+  }
+
+  forEachIsa([&]() {
+    std::vector<double> inPlace = cov;
+    se3::propagateCovarianceBatch(T.data(), cov.data(), out.data(), N);
+    se3::propagateCovarianceBatch(T.data(), inPlace.data(), inPlace.data(), N);
+    for (std::size_t i = 0; i < N; ++i) {
+      const Eigen::Matrix<double, 6, 6> Ad =
+          se3::Transformation(xis[i]).adjoint();
+      const Eigen::Matrix<double, 21, 1> ref =
+          io::packCovariance(Ad * covs[i] * Ad.transpose());
+      for (std::size_t k = 0; k < 21; ++k) {
+        const double tol = 1e-12 * std::max(1.0, std::abs(ref(k)));
+        EXPECT_NEAR(out[k * N + i], ref(k), tol) << i;
+        EXPECT_NEAR(inPlace[k * N + i], ref(k), tol) << i;
+      }
+    }
+  });
+}
+
+namespace {
+
+typedef Eigen::Matrix<double, 6, 6> Matrix6d;
+
+/** \brief Poses and random covariances in the batch layout, with stride N */
+void testPoses(std::vector<Eigen::Matrix4d>* poses,
+               std::vector<Matrix6d>* covs, std::vector<double>* T,
+               std::vector<double>* cov) {
+  const std::vector<Eigen::Matrix<double, 6, 1>> xis = testVectors();
+  T->resize(12 * N);
+  cov->resize(21 * N);
+  for (std::size_t i = 0; i < N; ++i) {
+    poses->push_back(se3::vec2tran(xis[i]));
+    covs->push_back(test::randomCovariance());
+    test::setBatchPose(poses->back(), i, N, T->data());
+    const Eigen::Matrix<double, 21, 1> packed =
+        io::packCovariance(covs->back());
+    for (std::size_t k = 0; k < 21; ++k) {
+      (*cov)[k * N + i] = packed(k);
+    }
+  }
+}
+
+/** \brief Checks element i of batch poses and covariances */
+void expectBatchElement(const std::vector<double>& T,
+                        const std::vector<double>& cov, std::size_t stride,
+                        std::size_t i, const Eigen::Matrix4d& T_ref,
+                        const Matrix6d& cov_ref) {
+  EXPECT_TRUE(
+      common::nearEqual(test::batchPose(T.data(), i, stride), T_ref, 1e-12))
+      << i;
+  const Eigen::Matrix<double, 21, 1> packed = io::packCovariance(cov_ref);
+  for (std::size_t k = 0; k < 21; ++k) {
+    const double tol = 1e-12 * std::max(1.0, std::abs(packed(k)));
+    EXPECT_NEAR(cov[k * stride + i], packed(k), tol) << i;
+  }
+}
+
+}  // namespace
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the batch inverse, with and without covariances, also in place
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, BatchInverse) {
+  std::vector<Eigen::Matrix4d> poses;
+  std::vector<Matrix6d> covs;
+  std::vector<double> T, cov;
+  testPoses(&poses, &covs, &T, &cov);
+
+  forEachIsa([&]() {
+    std::vector<double> out(12 * N), outCov(21 * N), inPlace = T;
+    se3::inverseBatch(T.data(), cov.data(), out.data(), outCov.data(), N);
+    se3::inverseBatch(inPlace.data(), inPlace.data(), N);
+    for (std::size_t i = 0; i < N; ++i) {
+      // TransformationWithCovariance::inverse, without reprojection
+      const Eigen::Matrix4d T_inv = poses[i].inverse();
+      const Matrix6d Ad = se3::tranAd(T_inv);
+      expectBatchElement(out, outCov, N, i, T_inv,
+                         Ad * covs[i] * Ad.transpose());
+      for (std::size_t k = 0; k < 12; ++k) {
+        EXPECT_EQ(inPlace[k * N + i], out[k * N + i]) << i;
+      }
+    }
+  });
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the batch relative poses, with and without covariances
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, BatchRelativePoses) {
+  std::vector<Eigen::Matrix4d> poses;
+  std::vector<Matrix6d> covs;
+  std::vector<double> T, cov;
+  testPoses(&poses, &covs, &T, &cov);
+
+  // Consecutive pairs, loop closures and a pose with itself, with a stride
+  // larger than the number of pairs
+  const std::size_t m = 2 * N + 1, stride = m + 3;
+  std::vector<std::size_t> pairs(2 * stride);
+  for (std::size_t k = 0; k < m; ++k) {
+    pairs[k] = k < N ? k : (7 * k) % N;
+    pairs[stride + k] = k < N ? (k + 1) % N : (13 * k) % N;
+  }
+  pairs[m - 1] = pairs[stride + m - 1] = 5;
+
+  forEachIsa([&]() {
+    std::vector<double> out(12 * stride), outPoses(12 * stride),
+        outCov(21 * stride);
+    se3::relativePosesBatch(T.data(), cov.data(), N, pairs.data(), out.data(),
+                            outCov.data(), m, stride);
+    se3::relativePosesBatch(T.data(), N, pairs.data(), outPoses.data(), m,
+                            stride);
+    for (std::size_t k = 0; k < m; ++k) {
+      // TransformationWithCovariance::operator/, without reprojection
+      const std::size_t i = pairs[k], j = pairs[stride + k];
+      const Eigen::Matrix4d T_ij = poses[i] * poses[j].inverse();
+      const Matrix6d Ad = se3::tranAd(T_ij);
+      expectBatchElement(out, outCov, stride, k, T_ij,
+                         covs[i] + Ad * covs[j] * Ad.transpose());
+      for (std::size_t row = 0; row < 12; ++row) {
+        EXPECT_EQ(outPoses[row * stride + k], out[row * stride + k]) << k;
+      }
+    }
+  });
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the batch composition, per-pose point transform and adjoint
+/// product, also in place
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, BatchComposeAdjoint) {
+  std::vector<Eigen::Matrix4d> poses;
+  std::vector<Matrix6d> covs;
+  std::vector<double> T, cov;
+  testPoses(&poses, &covs, &T, &cov);
+  std::vector<double> v(6 * N), p(3 * N);
+  for (double& x : v) {
+    x = Eigen::Matrix<double, 1, 1>::Random()(0);
+  }
+  for (double& x : p) {
+    x = 10.0 * Eigen::Matrix<double, 1, 1>::Random()(0);
+  }
+
+  forEachIsa([&]() {
+    // Compose every pose with the next one
+    std::vector<double> rhs(12 * N), composed(12 * N);
+    for (std::size_t k = 0; k < 12; ++k) {
+      for (std::size_t i = 0; i < N; ++i) {
+        rhs[k * N + i] = T[k * N + (i + 1) % N];
+      }
+    }
+    se3::composeBatch(T.data(), rhs.data(), composed.data(), N);
+    se3::composeBatch(T.data(), rhs.data(), rhs.data(), N);
+    std::vector<double> Ad_v = v, p_b = p;
+    se3::applyAdjointBatch(T.data(), Ad_v.data(), Ad_v.data(), N);
+    se3::transformPointsBatch(T.data(), p_b.data(), p_b.data(), N);
+
+    for (std::size_t i = 0; i < N; ++i) {
+      const Eigen::Matrix4d T_ref = poses[i] * poses[(i + 1) % N];
+      const Eigen::Matrix4d T_i = test::batchPose(composed.data(), i, N);
+      EXPECT_TRUE(common::nearEqual(T_i, T_ref, 1e-12)) << i;
+      EXPECT_EQ(test::batchPose(rhs.data(), i, N), T_i) << i;
+      Eigen::Matrix<double, 6, 1> v_i;
+      for (std::size_t k = 0; k < 6; ++k) {
+        v_i(k) = v[k * N + i];
+      }
+      const Eigen::Matrix<double, 6, 1> Ad_ref = se3::tranAd(poses[i]) * v_i;
+      for (std::size_t k = 0; k < 6; ++k) {
+        EXPECT_NEAR(Ad_v[k * N + i], Ad_ref(k), 1e-10) << i;
+      }
+      const Eigen::Vector4d p_ref =
+          poses[i] * Eigen::Vector4d(p[i], p[N + i], p[2 * N + i], 1.0);
+      for (std::size_t k = 0; k < 3; ++k) {
+        EXPECT_NEAR(p_b[k * N + i], p_ref(k), 1e-10) << i;
+      }
+    }
+  });
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the batch Jacobian and curlyhat products, also in place
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, BatchJacobianProducts) {
+  typedef Eigen::Matrix<double, 6, 1> Vector6d;
+  typedef void (*BatchProduct)(const double*, const double*, double*,
+                               std::size_t, std::size_t);
+  typedef Vector6d (*Product)(const Vector6d&, const Vector6d&);
+  const std::vector<std::pair<BatchProduct, Product>> products = {
+      {se3::applyJacBatch, se3::applyJac},
+      {se3::applyJacTransposeBatch, se3::applyJacTranspose},
+      {se3::applyJacInvBatch, se3::applyJacInv},
+      {se3::applyCurlyhatBatch, se3::applyCurlyhat}};
+
+  const std::vector<Vector6d> xis = testVectors();
+  std::vector<Vector6d> vs;
+  std::vector<double> xi(6 * N), v(6 * N), out(6 * N);
+  for (std::size_t i = 0; i < N; ++i) {
+    vs.push_back(Vector6d::Random());
+    for (std::size_t k = 0; k < 6; ++k) {
+      xi[k * N + i] = xis[i](k);
+      v[k * N + i] = vs[i](k);
+    }
+  }
+
+  forEachIsa([&]() {
+    for (const auto& product : products) {
+      std::vector<double> inPlace = v;
+      product.first(xi.data(), v.data(), out.data(), N, 0);
+      product.first(xi.data(), inPlace.data(), inPlace.data(), N, 0);
+      for (std::size_t i = 0; i < N; ++i) {
+        const Vector6d ref = product.second(xis[i], vs[i]);
+        for (std::size_t k = 0; k < 6; ++k) {
+          const double tol = 1e-10 * std::max(1.0, std::abs(ref(k)));
+          EXPECT_NEAR(out[k * N + i], ref(k), tol) << i;
+          EXPECT_NEAR(inPlace[k * N + i], ref(k), tol) << i;
+        }
+      }
+    }
+  });
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the batch interpolation of pose pairs
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, BatchInterpolate) {
+  const std::vector<Eigen::Matrix<double, 6, 1>> xis = testVectors();
+  std::vector<double> alpha(N), T(12 * N);
+  for (std::size_t i = 0; i < N; ++i) {
+    // Interpolate and extrapolate
+    alpha[i] = -0.5 + 2.0 * double(i) / N;
+  }
+
+  forEachIsa([&]() {
+    // Pairs with small, medium and near-pi relative rotations
+    for (std::size_t pair = 0; pair < 17; ++pair) {
+      const se3::Transformation T_0(xis[N - 1 - pair]);
+      const se3::Transformation T_1 =
+          T_0 * se3::Transformation(xis[pair]);
+      se3::interpolateBatch(T_0, T_1, alpha.data(), T.data(), N);
+      const Eigen::Matrix<double, 6, 1> xi = (T_0.inverse() * T_1).vec();
+      for (std::size_t i = 0; i < N; ++i) {
+        // The closed form of vec2tran cancels at small angles, where the
+        // series is exact to rounding
+        const Eigen::Matrix4d T_ref =
+            T_0.matrix() *
+            se3::vec2tran(Eigen::Matrix<double, 6, 1>(alpha[i] * xi),
+                          pair % 17 == 2 ? 20 : 0);
+        EXPECT_TRUE(
+            common::nearEqual(test::batchPose(T.data(), i, N), T_ref, 1e-12))
+            << pair << " " << i;
+      }
+    }
+  });
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the argument checks
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, BatchArguments) {
+  std::vector<double> xi(6 * 4, 0.0), T(12 * 4);
+  EXPECT_THROW(se3::vec2tranBatch(nullptr, T.data(), 4), std::invalid_argument);
+  EXPECT_THROW(se3::vec2tranBatch(xi.data(), T.data(), 4, 3),
+               std::invalid_argument);
+  // Nothing to do
+  EXPECT_NO_THROW(se3::vec2tranBatch(nullptr, nullptr, 0));
+  se3::vec2tranBatch(xi.data(), T.data(), 4);
+  EXPECT_EQ(T[0], 1.0);
+  EXPECT_EQ(T[3 * 4], 0.0);
+
+  // Pose indices out of range
+  std::vector<std::size_t> pairs = {0, 3, 1, 4};
+  std::vector<double> out(12 * 2);
+  EXPECT_THROW(se3::relativePosesBatch(T.data(), 4, pairs.data(), out.data(),
+                                       2),
+               std::invalid_argument);
+  pairs[3] = 2;
+  se3::relativePosesBatch(T.data(), 4, pairs.data(), out.data(), 2);
+  EXPECT_EQ(out[0], 1.0);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
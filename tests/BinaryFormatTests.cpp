@@ -0,0 +1,193 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// \file BinaryFormatTests.cpp
+/// \brief Unit tests for the binary encoding of rotations and transformations.
+/// \details Round trips random rotations and transformations through the
+/// encoder, decoder and the in-place views.
+///
+/// \author ASRL
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <lgmath/CommonMath.hpp>
+
+#include <lgmath/io/BinaryFormat.hpp>
+#include <lgmath/se3/Transformation.hpp>
+#include <lgmath/se3/TransformationWithCovariance.hpp>
+#include <lgmath/so3/Rotation.hpp>
+
+using namespace lgmath;
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+///
+/// UNIT TESTS OF BINARY ENCODING
+///
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the record sizes and header layout
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, BinaryFormatLayout) {
+  EXPECT_EQ(io::ROTATION_RECORD_SIZE, 80u);
+  EXPECT_EQ(io::TRANSFORMATION_RECORD_SIZE, 104u);
+  EXPECT_EQ(io::TRANSFORMATION_WITH_COVARIANCE_RECORD_SIZE, 272u);
+
+  Eigen::Matrix<double, 6, 1> xi = Eigen::Matrix<double, 6, 1>::Random();
+  se3::Transformation T(xi);
+  unsigned char buffer[io::TRANSFORMATION_RECORD_SIZE];
+  EXPECT_EQ(io::encode(T, buffer, sizeof(buffer)),
+            io::TRANSFORMATION_RECORD_SIZE);
+  EXPECT_EQ(buffer[0], io::BINARY_FORMAT_VERSION);
+  EXPECT_EQ(buffer[1], (unsigned char)io::RecordType::TRANSFORMATION);
+  EXPECT_EQ(buffer[2], 0);
+
+  // The payload is the 3x4 row-major [C_ba | r_ab_inb], little-endian
+  double first, fourth;
+  std::memcpy(&first, buffer + io::RECORD_HEADER_SIZE, sizeof(double));
+  std::memcpy(&fourth, buffer + io::RECORD_HEADER_SIZE + 3 * sizeof(double),
+              sizeof(double));
+  EXPECT_EQ(first, T.C_ba()(0, 0));
+  EXPECT_EQ(fourth, T.r_ab_inb()(0));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test packing of the covariance upper triangle
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, BinaryFormatPackedCovariance) {
+  Eigen::Matrix<double, 6, 6> A = Eigen::Matrix<double, 6, 6>::Random();
+  Eigen::Matrix<double, 6, 6> U = A * A.transpose();
+  Eigen::Matrix<double, 21, 1> packed = io::packCovariance(U);
+  EXPECT_EQ(packed(0), U(0, 0));
+  EXPECT_EQ(packed(5), U(0, 5));
+  EXPECT_EQ(packed(6), U(1, 1));
+  EXPECT_EQ(packed(20), U(5, 5));
+  EXPECT_TRUE(U == io::unpackCovariance(packed));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test exact round trips through encode/decode
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, BinaryFormatRoundTrip) {
+  const unsigned numTests = 20;
+  for (unsigned i = 0; i < numTests; i++) {
+    Eigen::Matrix<double, 6, 1> xi = Eigen::Matrix<double, 6, 1>::Random();
+    Eigen::Matrix<double, 6, 6> A = Eigen::Matrix<double, 6, 6>::Random();
+
+    // Rotation
+    {
+      so3::Rotation C(Eigen::Vector3d(Eigen::Vector3d::Random()));
+      unsigned char buffer[io::ROTATION_RECORD_SIZE];
+      io::encode(C, buffer, sizeof(buffer));
+      EXPECT_TRUE(C.matrix() ==
+                  io::decodeRotation(buffer, sizeof(buffer)).matrix());
+      EXPECT_TRUE(C.matrix() == io::RotationView(buffer, sizeof(buffer))
+                                    .matrix()
+                                    .eval());
+    }
+
+    // Transformation
+    {
+      se3::Transformation T(xi);
+      unsigned char buffer[io::TRANSFORMATION_RECORD_SIZE];
+      io::encode(T, buffer, sizeof(buffer));
+      EXPECT_TRUE(T.matrix() ==
+                  io::decodeTransformation(buffer, sizeof(buffer)).matrix());
+
+      io::TransformationView view(buffer, sizeof(buffer));
+      EXPECT_TRUE(T.matrix() == view.matrix());
+      EXPECT_TRUE(T.C_ba() == view.C_ba().eval());
+      EXPECT_TRUE(T.r_ab_inb() == view.r_ab_inb().eval());
+      EXPECT_TRUE(T.matrix() == view.transformation().matrix());
+    }
+
+    // Transformation with covariance
+    {
+      se3::TransformationWithCovariance T(xi, A * A.transpose());
+      unsigned char buffer[io::TRANSFORMATION_WITH_COVARIANCE_RECORD_SIZE];
+      io::encode(T, buffer, sizeof(buffer));
+      EXPECT_EQ(buffer[2] & io::FLAG_COVARIANCE_SET, io::FLAG_COVARIANCE_SET);
+
+      se3::TransformationWithCovariance test =
+          io::decodeTransformationWithCovariance(buffer, sizeof(buffer));
+      EXPECT_TRUE(T.matrix() == test.matrix());
+      EXPECT_TRUE(test.covarianceSet());
+      EXPECT_TRUE(T.cov() == test.cov());
+
+      io::TransformationWithCovarianceView view(buffer, sizeof(buffer));
+      EXPECT_TRUE(view.covarianceSet());
+      EXPECT_TRUE(T.cov() == view.cov());
+      EXPECT_TRUE(T.cov() == view.transformationWithCovariance().cov());
+
+      // The base view and decoder ignore the covariance block
+      EXPECT_TRUE(T.matrix() ==
+                  io::decodeTransformation(buffer, sizeof(buffer)).matrix());
+      EXPECT_TRUE(T.matrix() ==
+                  io::TransformationView(buffer, sizeof(buffer)).matrix());
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test that the covariance flag survives the round trip
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, BinaryFormatUnsetCovariance) {
+  Eigen::Matrix<double, 6, 1> xi = Eigen::Matrix<double, 6, 1>::Random();
+  se3::TransformationWithCovariance T(xi);
+  ASSERT_FALSE(T.covarianceSet());
+  unsigned char buffer[io::TRANSFORMATION_WITH_COVARIANCE_RECORD_SIZE];
+  io::encode(T, buffer, sizeof(buffer));
+  EXPECT_EQ(buffer[2], 0);
+
+  se3::TransformationWithCovariance test =
+      io::decodeTransformationWithCovariance(buffer, sizeof(buffer));
+  EXPECT_FALSE(test.covarianceSet());
+  EXPECT_THROW(test.cov(), std::logic_error);
+
+  io::TransformationWithCovarianceView view(buffer, sizeof(buffer));
+  EXPECT_FALSE(view.covarianceSet());
+  EXPECT_THROW(view.cov(), std::logic_error);
+  EXPECT_FALSE(view.transformationWithCovariance().covarianceSet());
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test that malformed records are rejected
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, BinaryFormatErrors) {
+  Eigen::Matrix<double, 6, 1> xi = Eigen::Matrix<double, 6, 1>::Random();
+  se3::Transformation T(xi);
+  std::vector<unsigned char> buffer(io::TRANSFORMATION_RECORD_SIZE);
+
+  // Output buffer too small
+  EXPECT_THROW(io::encode(T, buffer.data(), buffer.size() - 1),
+               std::invalid_argument);
+  EXPECT_THROW(io::encode(T, NULL, buffer.size()), std::invalid_argument);
+
+  io::encode(T, buffer.data(), buffer.size());
+
+  // Truncated input
+  EXPECT_THROW(io::decodeTransformation(buffer.data(), buffer.size() - 1),
+               std::invalid_argument);
+
+  // Wrong record type
+  EXPECT_THROW(io::decodeRotation(buffer.data(), buffer.size()),
+               std::invalid_argument);
+  EXPECT_THROW(
+      io::TransformationWithCovarianceView(buffer.data(), buffer.size()),
+      std::invalid_argument);
+
+  // Unknown version
+  buffer[0] = io::BINARY_FORMAT_VERSION + 1;
+  EXPECT_THROW(io::TransformationView(buffer.data(), buffer.size()),
+               std::invalid_argument);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,152 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// \file CachedTransformationTests.cpp
+/// \brief Unit tests for the transformation class with a cached log map and
+/// adjoint.
+///
+/// \author ASRL
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include <lgmath/CommonMath.hpp>
+#include <lgmath/se3/CachedTransformation.hpp>
+#include <lgmath/se3/Transformation.hpp>
+
+using namespace lgmath;
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+///
+/// UNIT TESTS OF CACHED TRANSFORMATION
+///
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test that the cached values match Transformation and are cleared by
+/// every modification
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, CachedTransformationInvalidation) {
+  Eigen::Matrix<double, 6, 1> xi_1, xi_2;
+  xi_1 << 1.0, -2.0, 0.5, 0.3, -1.2, 0.7;
+  xi_2 << -0.4, 0.8, 3.0, -2.1, 0.4, 0.9;
+  const se3::Transformation T_2(xi_2);
+  se3::Transformation T(xi_1);
+  se3::CachedTransformation T_cached(xi_1);
+
+  // Checks that the values match and that both entries are then filled
+  const auto check = [&T, &T_cached]() {
+    EXPECT_FALSE(T_cached.vecCached());
+    EXPECT_FALSE(T_cached.adjointCached());
+    for (int i = 0; i < 2; ++i) {
+      EXPECT_TRUE(common::nearEqual(T_cached.matrix(), T.matrix(), 1e-12));
+      EXPECT_TRUE(common::nearEqual(T_cached.vec(), T.vec(), 1e-12));
+      EXPECT_TRUE(common::nearEqual(T_cached.adjoint(), T.adjoint(), 1e-12));
+    }
+    EXPECT_TRUE(T_cached.vecCached());
+    EXPECT_TRUE(T_cached.adjointCached());
+  };
+
+  check();
+  T *= T_2;
+  T_cached *= T_2;
+  check();
+  T /= T_2;
+  T_cached /= T_2;
+  check();
+  T.reproject();
+  T_cached.reproject();
+  check();
+  T = T_2;
+  T_cached = T_2;
+  check();
+  T = se3::Transformation(xi_1);
+  T_cached = se3::Transformation(xi_1);
+  check();
+
+  // Through a base reference, the virtual operators also clear the cache
+  se3::Transformation& T_base = T_cached;
+  T *= T_2;
+  T_base *= T_2;
+  check();
+  T = T_2;
+  T_base = T_2;
+  check();
+  T.reproject();
+  T_base.reproject();
+  check();
+
+  // The inverse starts with an empty cache
+  T_cached.vec();
+  EXPECT_FALSE(T_cached.inverse().vecCached());
+  EXPECT_TRUE(common::nearEqual(T_cached.inverse().vec(), T.inverse().vec(),
+                                1e-12));
+
+  // Copies take the filled entries along
+  T_cached.adjoint();
+  se3::CachedTransformation T_copy(T_cached);
+  EXPECT_TRUE(T_copy.vecCached());
+  EXPECT_TRUE(T_copy.adjointCached());
+  EXPECT_TRUE(common::nearEqual(T_copy.vec(), T.vec(), 1e-12));
+  se3::CachedTransformation T_moved;
+  T_moved = std::move(T_copy);
+  EXPECT_TRUE(T_moved.adjointCached());
+  EXPECT_TRUE(common::nearEqual(T_moved.adjoint(), T.adjoint(), 1e-12));
+  T_copy = se3::CachedTransformation(T_2);
+  EXPECT_FALSE(T_copy.vecCached());
+
+  // Vectors reallocate by moving, which keeps the caches
+  EXPECT_TRUE(
+      std::is_nothrow_move_constructible<se3::CachedTransformation>::value);
+  std::vector<se3::CachedTransformation> transforms(1, T_moved);
+  transforms.resize(transforms.capacity() + 1);
+  EXPECT_TRUE(transforms[0].adjointCached());
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test concurrent const readers of one transformation
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, CachedTransformationThreads) {
+  const unsigned numThreads = 4;
+  std::vector<se3::CachedTransformation> transforms;
+  std::vector<se3::Transformation> expected;
+  for (int i = 0; i < 64; ++i) {
+    const Eigen::Matrix<double, 6, 1> xi =
+        Eigen::Matrix<double, 6, 1>::Random();
+    transforms.emplace_back(xi);
+    expected.emplace_back(xi);
+  }
+
+  // Every thread reads every transformation, racing to fill the caches
+  std::vector<int> mismatches(numThreads, 0);
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < numThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (std::size_t i = 0; i < transforms.size(); ++i) {
+        const std::size_t j = (i + 16 * t) % transforms.size();
+        if (!common::nearEqual(transforms[j].vec(), expected[j].vec(),
+                               1e-12) ||
+            !common::nearEqual(transforms[j].adjoint(), expected[j].adjoint(),
+                               1e-12)) {
+          ++mismatches[t];
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (unsigned t = 0; t < numThreads; ++t) {
+    EXPECT_EQ(mismatches[t], 0);
+  }
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
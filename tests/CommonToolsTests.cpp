@@ -0,0 +1,142 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// \file CommonToolsTests.cpp
+/// \brief Unit tests for the timers and latency histograms.
+///
+/// \author ASRL
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <lgmath/CommonTools.hpp>
+
+using namespace lgmath;
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+///
+/// UNIT TESTS OF THE COMMON TOOLS
+///
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the timers against a sleep
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, CommonToolsTimers) {
+  // Calibrate the counter before timing
+  EXPECT_GT(common::TscClock::nanosecondsPerTick(), 0.0);
+
+  common::Timer timer;
+  const std::uint64_t start = common::TscClock::now();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  const double ms = timer.milliseconds();
+  const double tscMs =
+      1e-6 * common::TscClock::toNanoseconds(common::TscClock::now() - start);
+  EXPECT_GE(ms, 20.0);
+  EXPECT_LT(ms, 1000.0);
+  EXPECT_GE(timer.seconds(), 1e-3 * ms);
+  EXPECT_GT(tscMs, 15.0);
+  EXPECT_LT(tscMs, 1000.0);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the log-linear bucket layout
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, CommonToolsHistogramBuckets) {
+  typedef common::LatencyHistogram Histogram;
+  for (std::uint64_t v = 0; v < 16; ++v) {
+    EXPECT_EQ(Histogram::bucket(v), v);
+  }
+  EXPECT_EQ(Histogram::bucket(16), 16u);
+  EXPECT_EQ(Histogram::bucket(UINT64_MAX), Histogram::NUM_BUCKETS - 1);
+  EXPECT_EQ(Histogram::upperBound(Histogram::NUM_BUCKETS - 1), UINT64_MAX);
+
+  // Buckets are contiguous, and each value lies in its bucket
+  for (std::size_t b = 1; b < Histogram::NUM_BUCKETS; ++b) {
+    EXPECT_EQ(Histogram::lowerBound(b), Histogram::upperBound(b - 1) + 1);
+  }
+  for (std::uint64_t v : {17ull, 1000ull, 123456789ull, 1ull << 40}) {
+    const std::size_t b = Histogram::bucket(v);
+    EXPECT_LE(Histogram::lowerBound(b), v);
+    EXPECT_GE(Histogram::upperBound(b), v);
+    // Relative precision of 1/16
+    EXPECT_LE(Histogram::upperBound(b) - Histogram::lowerBound(b), v / 16);
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the histogram statistics
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, CommonToolsHistogramPercentiles) {
+  common::LatencyHistogram histogram;
+  EXPECT_EQ(histogram.count(), 0u);
+  EXPECT_EQ(histogram.percentile(50), 0u);
+  for (std::uint64_t v = 1; v <= 1000; ++v) {
+    histogram.record(v);
+  }
+  EXPECT_EQ(histogram.count(), 1000u);
+  EXPECT_EQ(histogram.min(), 1u);
+  EXPECT_EQ(histogram.max(), 1000u);
+  EXPECT_DOUBLE_EQ(histogram.mean(), 500.5);
+  EXPECT_NEAR(double(histogram.percentile(50)), 500.0, 500.0 / 16);
+  EXPECT_NEAR(double(histogram.percentile(99)), 990.0, 990.0 / 16);
+  EXPECT_EQ(histogram.percentile(100), 1000u);
+
+  // Merging adds the counts
+  common::LatencyHistogram other;
+  other.record(5000);
+  histogram.merge(other);
+  EXPECT_EQ(histogram.count(), 1001u);
+  EXPECT_EQ(histogram.max(), 5000u);
+
+  common::LatencyHistogram copy(histogram);
+  EXPECT_EQ(copy.count(), 1001u);
+  histogram.clear();
+  EXPECT_EQ(histogram.count(), 0u);
+  EXPECT_EQ(copy.percentile(100), 5000u);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test probes recording from several threads, merged by name
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, CommonToolsScopedProbe) {
+  const unsigned numThreads = 4;
+  const unsigned N = 1000;
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < numThreads; ++t) {
+    threads.emplace_back([]() {
+      for (unsigned i = 0; i < N; ++i) {
+        LGMATH_SCOPED_PROBE("test/probe");
+        volatile double x = 0.0;
+        for (int j = 0; j < 100; ++j) {
+          x = x + j;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  common::HistogramRegistry& registry = common::HistogramRegistry::instance();
+  common::LatencyHistogram merged = registry.merged("test/probe");
+  EXPECT_EQ(merged.count(), numThreads * N);
+  EXPECT_GT(merged.max(), 0u);
+  EXPECT_LE(merged.percentile(50), merged.max());
+
+  std::stringstream dump;
+  registry.dump(dump);
+  EXPECT_NE(dump.str().find("test/probe: count 4000"), std::string::npos);
+
+  registry.clear();
+  EXPECT_EQ(registry.merged("test/probe").count(), 0u);
+  EXPECT_EQ(registry.merged("unknown").count(), 0u);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
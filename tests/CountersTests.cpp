@@ -0,0 +1,186 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// \file CountersTests.cpp
+/// \brief Unit tests for the opt-in branch and operation counters.
+/// \details The expected counts depend on whether lgmath was built with
+/// LGMATH_ENABLE_COUNTERS; without it, every snapshot must be zero.
+///
+/// \author ASRL
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <lgmath.hpp>
+#include <lgmath/Counters.hpp>
+
+using namespace lgmath;
+using common::Counter;
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+///
+/// UNIT TESTS OF THE COUNTERS
+///
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/** \brief Gets the expected count, which is zero if counters are disabled */
+std::uint64_t expected(std::uint64_t count) {
+  return common::countersEnabled() ? count : 0;
+}
+
+/** \brief Gets one counter of a snapshot */
+std::uint64_t get(const common::CounterValues& values, Counter counter) {
+  return values[std::size_t(counter)];
+}
+
+}  // namespace
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the counters of the so3 branches
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, CountersSO3Branches) {
+  common::resetCounters();
+
+  so3::vec2rot(Eigen::Vector3d::Zero());
+  so3::vec2rot(Eigen::Vector3d(0.1, 0.2, 0.3));
+  so3::vec2rot(Eigen::Vector3d(0.1, 0.2, 0.3), 10);
+  so3::rot2vec(Eigen::Matrix3d::Identity());
+  // A rotation of pi about x
+  const Eigen::Matrix3d C_pi = Eigen::Vector3d(1.0, -1.0, -1.0).asDiagonal();
+  so3::rot2vec(C_pi);
+
+  const common::CounterValues values = common::counterSnapshot();
+  EXPECT_EQ(get(values, Counter::SO3_VEC2ROT), expected(3));
+  EXPECT_EQ(get(values, Counter::SO3_VEC2ROT_SMALL_ANGLE), expected(1));
+  EXPECT_EQ(get(values, Counter::SO3_VEC2ROT_SERIES), expected(1));
+  EXPECT_EQ(get(values, Counter::SO3_ROT2VEC), expected(2));
+  EXPECT_EQ(get(values, Counter::SO3_ROT2VEC_NEAR_ZERO), expected(1));
+  EXPECT_EQ(get(values, Counter::SO3_ROT2VEC_NEAR_PI), expected(1));
+
+  common::resetCounters();
+  const common::CounterValues reset = common::counterSnapshot();
+  for (std::size_t i = 0; i < common::NUM_COUNTERS; ++i) {
+    EXPECT_EQ(reset[i], 0u);
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the counters of the class operations
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, CountersTransformation) {
+  Eigen::Matrix<double, 6, 1> xi;
+  xi << 1.0, 2.0, 3.0, 0.1, 0.2, 0.3;
+  se3::Transformation T(xi);
+  se3::TransformationWithCovariance T_cov(xi);
+
+  const common::CounterValues before = common::counterSnapshot();
+  se3::Transformation T_2 = T * T;
+  T_2 = T_2 / T;
+  T_2 = T_2.inverse();
+  se3::TransformationWithCovariance T_cov_2 = T_cov * T_cov;
+  // Unless the reprojection is skipped explicitly
+  Eigen::Matrix<double, 6, 6> J;
+  se3::composeWithJacobians(T, T, &T_2, nullptr, &J, false);
+  se3::inverseWithJacobian(T, &T_2, &J, false);
+  const common::CounterValues values =
+      common::counterDifference(common::counterSnapshot(), before);
+
+  EXPECT_EQ(get(values, Counter::TRANSFORMATION_COMPOSE), expected(3));
+  EXPECT_EQ(get(values, Counter::TRANSFORMATION_COMPOSE_INVERSE), expected(1));
+  EXPECT_EQ(get(values, Counter::TRANSFORMATION_INVERSE), expected(2));
+  // Every operation reprojects, unconditionally
+  EXPECT_EQ(get(values, Counter::TRANSFORMATION_REPROJECT), expected(4));
+  EXPECT_EQ(get(values, Counter::TRANSFORMATION_WITH_COVARIANCE_COMPOSE),
+            expected(1));
+  EXPECT_EQ(
+      get(values, Counter::TRANSFORMATION_WITH_COVARIANCE_COVARIANCE_UNSET),
+      expected(1));
+
+  std::stringstream out;
+  common::printCounters(out, values);
+  EXPECT_EQ(out.str().find("Transformation/reproject: 4") != std::string::npos,
+            common::countersEnabled());
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the hits and misses of the cached transformation
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, CountersCachedTransformation) {
+  Eigen::Matrix<double, 6, 1> xi;
+  xi << 1.0, 2.0, 3.0, 0.1, 0.2, 0.3;
+  se3::CachedTransformation T(xi);
+
+  const common::CounterValues before = common::counterSnapshot();
+  for (int i = 0; i < 4; ++i) {
+    T.vec();
+  }
+  T.adjoint();
+  T *= se3::Transformation(xi);
+  T.adjoint();
+  T.adjoint();
+  const common::CounterValues values =
+      common::counterDifference(common::counterSnapshot(), before);
+
+  EXPECT_EQ(get(values, Counter::CACHED_TRANSFORMATION_VEC_HIT), expected(3));
+  EXPECT_EQ(get(values, Counter::CACHED_TRANSFORMATION_VEC_MISS), expected(1));
+  EXPECT_EQ(get(values, Counter::CACHED_TRANSFORMATION_ADJOINT_HIT),
+            expected(1));
+  EXPECT_EQ(get(values, Counter::CACHED_TRANSFORMATION_ADJOINT_MISS),
+            expected(2));
+  // Only the misses compute the log map
+  EXPECT_EQ(get(values, Counter::SE3_TRAN2VEC), expected(1));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test that the counters of all threads are summed
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, CountersThreads) {
+  const unsigned numThreads = 4;
+  const unsigned N = 100;
+  const common::CounterValues before = common::counterSnapshotAll();
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < numThreads; ++t) {
+    threads.emplace_back([]() {
+      for (unsigned i = 0; i < N; ++i) {
+        so3::vec2jac(Eigen::Vector3d(0.1, 0.2, 0.3));
+      }
+      // Each thread has its own counters
+      EXPECT_EQ(get(common::counterSnapshot(), Counter::SO3_VEC2JAC),
+                expected(N));
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // Exited threads are still counted
+  const common::CounterValues values =
+      common::counterDifference(common::counterSnapshotAll(), before);
+  EXPECT_EQ(get(values, Counter::SO3_VEC2JAC), expected(numThreads * N));
+
+  common::resetAllCounters();
+  EXPECT_EQ(get(common::counterSnapshotAll(), Counter::SO3_VEC2JAC), 0u);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test that every counter has a distinct name
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, CountersNames) {
+  std::vector<std::string> names;
+  for (std::size_t i = 0; i < common::NUM_COUNTERS; ++i) {
+    names.push_back(common::counterName(Counter(i)));
+    EXPECT_FALSE(names.back().empty());
+  }
+  std::sort(names.begin(), names.end());
+  EXPECT_TRUE(std::adjacent_find(names.begin(), names.end()) == names.end());
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,160 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// \file DeskewTests.cpp
+/// \brief Unit tests for the motion compensation (de-skew) of scans.
+///
+/// \author ASRL
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include <lgmath.hpp>
+#include <lgmath/CommonMath.hpp>
+#include <lgmath/Dispatch.hpp>
+#include <lgmath/Parallel.hpp>
+#include <lgmath/se3/Deskew.hpp>
+
+using namespace lgmath;
+
+namespace {
+
+typedef Eigen::Matrix<double, 6, 1> Vector6d;
+
+/** \brief Number of test points, not a multiple of any vector width */
+const std::size_t N = 2003;
+
+/** \brief A scan of 0.1 s, turning by 0.5 rad and moving by 2 m */
+const double T_START = 10.0, T_END = 10.1;
+const Vector6d XI = (Vector6d() << 2.0, 0.1, 0.0, 0.02, -0.05, 0.5).finished();
+
+/** \brief Points up to 50 m away, in time order */
+void testScan(Eigen::VectorXd* t, Eigen::Matrix3Xd* p) {
+  *t = Eigen::VectorXd::LinSpaced(N, T_START, T_END);
+  *p = 50.0 * Eigen::Matrix3Xd::Random(3, N);
+}
+
+/** \brief Largest distance between the de-skewed and the exact points */
+double maxError(const se3::Deskew& deskew, const Eigen::VectorXd& t,
+                const Eigen::Matrix3Xd& p, const Eigen::Matrix3Xd& out) {
+  double error = 0.0;
+  for (std::size_t i = 0; i < N; ++i) {
+    const se3::Transformation T = deskew.pose(t(i));
+    const Eigen::Vector3d exact = T.C_ba() * p.col(i) + T.r_ab_inb();
+    error = std::max(error, (out.col(i) - exact).norm());
+  }
+  return error;
+}
+
+}  // namespace
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+///
+/// UNIT TESTS OF DESKEW
+///
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the poses and the accuracy as a function of the buckets
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, DeskewAccuracy) {
+  const se3::Transformation T_start(Vector6d(Vector6d::Random()));
+  const se3::Transformation T_end = T_start * se3::Transformation(XI);
+  Eigen::VectorXd t;
+  Eigen::Matrix3Xd p;
+  testScan(&t, &p);
+
+  const se3::Deskew poses(T_start, T_end, T_START, T_END);
+  EXPECT_TRUE(common::nearEqual(poses.pose(T_START).matrix(),
+                                T_start.matrix(), 1e-12));
+  EXPECT_TRUE(common::nearEqual(poses.pose(T_END).matrix(), T_end.matrix(),
+                                1e-9));
+  EXPECT_TRUE(common::nearEqual(
+      poses.pose(10.03).matrix(),
+      se3::interpolate(T_start, T_end, 0.3).matrix(), 1e-9));
+
+  // The error falls as 1 / K^2, from 87 m * 0.5^2 / 8 with one bucket
+  const std::vector<std::size_t> numKnots = {1, 4, 16, 64};
+  std::vector<double> errors;
+  for (std::size_t K : numKnots) {
+    const se3::Deskew deskew(T_start, T_end, T_START, T_END, K);
+    EXPECT_EQ(deskew.numKnots(), K);
+    errors.push_back(maxError(deskew, t, p, deskew.apply(t, p)));
+  }
+  EXPECT_LT(errors[0], 3.0);
+  EXPECT_LT(errors[3], 1e-3);
+  for (std::size_t k = 1; k < errors.size(); ++k) {
+    EXPECT_GT(errors[k - 1] / errors[k], 12.0) << numKnots[k];
+  }
+
+  // Points at the knots are exact
+  const se3::Deskew deskew(T_start, T_end, T_START, T_END, 4);
+  for (int k = 0; k <= 4; ++k) {
+    const double t_k = T_START + 0.025 * k;
+    const Eigen::Vector3d p_k(10.0, -20.0, 3.0);
+    const Eigen::Matrix3Xd out =
+        deskew.apply(Eigen::VectorXd::Constant(1, t_k), p_k);
+    const se3::Transformation T = deskew.pose(t_k);
+    EXPECT_TRUE(common::nearEqual(out.col(0), T.C_ba() * p_k + T.r_ab_inb(),
+                                  1e-9));
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the constant-velocity form, unordered times and the kernels
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, DeskewVelocity) {
+  const se3::Transformation T_start(Vector6d(Vector6d::Random()));
+  const se3::Transformation T_end = T_start * se3::Transformation(XI);
+  Eigen::VectorXd t;
+  Eigen::Matrix3Xd p;
+  testScan(&t, &p);
+
+  const se3::Deskew poses(T_start, T_end, T_START, T_END, 8);
+  const se3::Deskew velocity(T_start, Vector6d(XI / (T_END - T_START)),
+                             T_START, T_END, 8);
+  const Eigen::Matrix3Xd reference = poses.apply(t, p);
+  EXPECT_TRUE(common::nearEqual(velocity.apply(t, p), reference, 1e-9));
+
+  // Any order of the points, on any instruction set and executor
+  Eigen::VectorXd t_reversed = t.reverse();
+  Eigen::Matrix3Xd p_reversed = p.rowwise().reverse();
+  const common::Isa active = common::activeIsa();
+  common::ThreadPool pool(4);
+  for (common::Isa isa : common::supportedIsas()) {
+    SCOPED_TRACE(common::isaName(isa));
+    common::setIsa(isa);
+    EXPECT_TRUE(common::nearEqual(poses.apply(t_reversed, p_reversed),
+                                  reference.rowwise().reverse(), 1e-9));
+
+    std::vector<double> rows(3 * N);
+    Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, 3>>(rows.data(), N, 3) =
+        p.transpose();
+    poses.apply(common::ExecutionPolicy(pool, common::Chunking::DYNAMIC, 64),
+                t.data(), rows.data(), rows.data(), N);
+    EXPECT_TRUE(common::nearEqual(
+        Eigen::Matrix3Xd(
+            Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, 3>>(rows.data(),
+                                                                 N, 3)
+                .transpose()),
+        reference, 1e-9));
+  }
+  common::setIsa(active);
+
+  EXPECT_THROW(se3::Deskew(T_start, T_end, T_END, T_START),
+               std::invalid_argument);
+  EXPECT_THROW(se3::Deskew(T_start, T_end, T_START, T_END, 0),
+               std::invalid_argument);
+  EXPECT_THROW(poses.apply(t.head(3), p), std::invalid_argument);
+  EXPECT_THROW(poses.apply(t.data(), nullptr, nullptr, N),
+               std::invalid_argument);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,281 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// \file GaussianProcessTests.cpp
+/// \brief Unit tests for the Gaussian process priors on SE3 trajectories.
+///
+/// \author ASRL
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include <lgmath.hpp>
+#include <lgmath/CommonMath.hpp>
+#include <lgmath/Dispatch.hpp>
+#include <lgmath/Parallel.hpp>
+#include <lgmath/se3/GaussianProcess.hpp>
+
+#include "TestHelpers.hpp"
+
+using namespace lgmath;
+
+namespace {
+
+typedef Eigen::Matrix<double, 6, 1> Vector6d;
+typedef Eigen::Matrix<double, 6, 6> Matrix6d;
+
+/** \brief Knot times */
+const double T1 = 2.0, T2 = 2.5;
+
+/** \brief A power spectral density */
+Matrix6d testQc() { return test::randomCovariance(1.0, 1.0); }
+
+/** \brief Two knots of a moderately curved motion */
+void testKnots(se3::gp::Knot* knot1, se3::gp::Knot* knot2) {
+  const Vector6d varpi =
+      (Vector6d() << 2.0, 0.3, -0.1, 0.1, -0.2, 0.6).finished();
+  knot1->time = T1;
+  knot1->T = se3::Transformation(Vector6d(Vector6d::Random()));
+  knot1->varpi = varpi + 0.1 * Vector6d::Random();
+  knot2->time = T2;
+  knot2->T = se3::Transformation(Vector6d((T2 - T1) * varpi +
+                                          0.05 * Vector6d::Random())) *
+             knot1->T;
+  knot2->varpi = varpi + 0.1 * Vector6d::Random();
+}
+
+/**
+ * \brief The central difference (T_plus - T_minus) * T^-1 of the poses around
+ * T, taken out of the algebra
+ */
+Vector6d difference(const se3::Transformation& T_plus,
+                    const se3::Transformation& T_minus,
+                    const se3::Transformation& T) {
+  const Eigen::Matrix4d D =
+      (T_plus.matrix() - T_minus.matrix()) * T.inverse().matrix();
+  Vector6d xi;
+  xi << D.block<3, 1>(0, 3), 0.5 * (D(2, 1) - D(1, 2)),
+      0.5 * (D(0, 2) - D(2, 0)), 0.5 * (D(1, 0) - D(0, 1));
+  return xi;
+}
+
+/** \brief Perturbs component e of [T_1, varpi_1, T_2, varpi_2] by h */
+se3::gp::Interval perturbed(const se3::gp::Knot& knot1,
+                            const se3::gp::Knot& knot2, int e, double h) {
+  se3::gp::Knot knots[2] = {knot1, knot2};
+  se3::gp::Knot& knot = knots[e / 12];
+  const Vector6d delta = h * Vector6d::Unit(e % 6);
+  if (e % 12 < 6) {
+    knot.T = se3::Transformation(delta) * knot.T;
+  } else {
+    knot.varpi += delta;
+  }
+  return se3::gp::Interval(knots[0], knots[1]);
+}
+
+}  // namespace
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+///
+/// UNIT TESTS OF GAUSSIAN PROCESS PRIORS
+///
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the transition matrices and process noises
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, GaussianProcessTransitions) {
+  const Matrix6d Qc = testQc();
+  const double a = 0.3, b = 0.45;
+  EXPECT_TRUE(common::nearEqual(
+      se3::gp::wnoaTransition(a + b),
+      Eigen::Matrix<double, 12, 12>(se3::gp::wnoaTransition(a) *
+                                    se3::gp::wnoaTransition(b)),
+      1e-12));
+  EXPECT_TRUE(common::nearEqual(
+      se3::gp::wnojTransition(a + b),
+      Eigen::Matrix<double, 18, 18>(se3::gp::wnojTransition(a) *
+                                    se3::gp::wnojTransition(b)),
+      1e-12));
+  EXPECT_TRUE(common::nearEqual(
+      Eigen::Matrix<double, 12, 12>(se3::gp::wnoaQ(a, Qc) *
+                                    se3::gp::wnoaQinv(a, Qc)),
+      Eigen::Matrix<double, 12, 12>::Identity().eval(), 1e-9));
+  EXPECT_TRUE(common::nearEqual(
+      Eigen::Matrix<double, 18, 18>(se3::gp::wnojQ(a, Qc) *
+                                    se3::gp::wnojQinv(a, Qc)),
+      Eigen::Matrix<double, 18, 18>::Identity().eval(), 1e-9));
+
+  // Q(a + b) = Phi(b) * Q(a) * Phi(b)^T + Q(b)
+  const Eigen::Matrix<double, 12, 12> Phi = se3::gp::wnoaTransition(b);
+  EXPECT_TRUE(common::nearEqual(
+      se3::gp::wnoaQ(a + b, Qc),
+      Eigen::Matrix<double, 12, 12>(Phi * se3::gp::wnoaQ(a, Qc) *
+                                        Phi.transpose() +
+                                    se3::gp::wnoaQ(b, Qc)),
+      1e-12));
+  const Eigen::Matrix<double, 18, 18> PhiJ = se3::gp::wnojTransition(b);
+  EXPECT_TRUE(common::nearEqual(
+      se3::gp::wnojQ(a + b, Qc),
+      Eigen::Matrix<double, 18, 18>(PhiJ * se3::gp::wnojQ(a, Qc) *
+                                        PhiJ.transpose() +
+                                    se3::gp::wnojQ(b, Qc)),
+      1e-12));
+  EXPECT_THROW(se3::gp::wnoaQinv(0.0, Qc), std::invalid_argument);
+  EXPECT_THROW(se3::gp::wnojQinv(-1.0, Qc), std::invalid_argument);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the interpolated poses and velocities
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, GaussianProcessInterpolation) {
+  // On a constant velocity motion, the prior gives back the motion
+  const Vector6d varpi =
+      (Vector6d() << 1.0, -2.0, 0.5, 0.4, 0.3, -0.9).finished();
+  const se3::Transformation T_1(Vector6d(Vector6d::Random()));
+  const se3::gp::Knot knot1 = {T1, T_1, varpi};
+  const se3::gp::Knot knot2 = {
+      T2, se3::Transformation(Vector6d((T2 - T1) * varpi)) * T_1, varpi};
+  const se3::gp::Interval line(knot1, knot2);
+  EXPECT_DOUBLE_EQ(line.startTime(), T1);
+  EXPECT_DOUBLE_EQ(line.endTime(), T2);
+  for (double t = T1; t <= T2; t += 0.05) {
+    const se3::Transformation T =
+        se3::Transformation(Vector6d((t - T1) * varpi)) * T_1;
+    EXPECT_TRUE(common::nearEqual(line.pose(t).matrix(), T.matrix(), 1e-9));
+    EXPECT_TRUE(common::nearEqual(line.velocity(t), varpi, 1e-9));
+  }
+
+  // In general, the knots are interpolated and the velocity is that of the
+  // poses
+  se3::gp::Knot knot3, knot4;
+  testKnots(&knot3, &knot4);
+  const se3::gp::Interval interval(knot3, knot4);
+  EXPECT_TRUE(common::nearEqual(interval.pose(T1).matrix(),
+                                knot3.T.matrix(), 1e-12));
+  EXPECT_TRUE(common::nearEqual(interval.pose(T2).matrix(),
+                                knot4.T.matrix(), 1e-9));
+  EXPECT_TRUE(common::nearEqual(interval.velocity(T1), knot3.varpi, 1e-12));
+  EXPECT_TRUE(common::nearEqual(interval.velocity(T2), knot4.varpi, 1e-9));
+  const double h = 1e-5;
+  for (double t = T1 + 0.01; t < T2; t += 0.07) {
+    EXPECT_TRUE(common::nearEqual(
+        interval.velocity(t),
+        Vector6d(difference(interval.pose(t + h), interval.pose(t - h),
+                            interval.pose(t)) /
+                 (2.0 * h)),
+        1e-6));
+  }
+  EXPECT_THROW(se3::gp::Interval(knot4, knot3), std::invalid_argument);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the Jacobians numerically and the covariance at the knots
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, GaussianProcessJacobians) {
+  se3::gp::Knot knot1, knot2;
+  testKnots(&knot1, &knot2);
+  const se3::gp::Interval interval(knot1, knot2);
+  const double h = 1e-6;
+  for (double t = T1; t <= T2; t += 0.1) {
+    SCOPED_TRACE(t);
+    Eigen::Matrix<double, 6, 24> poseJacobian, velocityJacobian;
+    const se3::Transformation T = interval.pose(t, &poseJacobian);
+    EXPECT_TRUE(
+        common::nearEqual(T.matrix(), interval.pose(t).matrix(), 1e-12));
+    EXPECT_TRUE(common::nearEqual(interval.velocity(t, &velocityJacobian),
+                                  interval.velocity(t), 1e-12));
+    Eigen::Matrix<double, 6, 24> poseNumerical, velocityNumerical;
+    for (int e = 0; e < 24; ++e) {
+      const se3::gp::Interval plus = perturbed(knot1, knot2, e, h);
+      const se3::gp::Interval minus = perturbed(knot1, knot2, e, -h);
+      poseNumerical.col(e) = difference(plus.pose(t), minus.pose(t), T) /
+                             (2.0 * h);
+      velocityNumerical.col(e) =
+          (plus.velocity(t) - minus.velocity(t)) / (2.0 * h);
+    }
+    // The approximations of the derivatives of the se3 Jacobians are off by
+    // the square of the motion over the interval, here 0.3 rad and 1 m
+    const double poseScale = poseNumerical.cwiseAbs().maxCoeff();
+    EXPECT_LT((poseJacobian - poseNumerical).cwiseAbs().maxCoeff(),
+              0.01 * poseScale);
+    const double velocityScale = velocityNumerical.cwiseAbs().maxCoeff();
+    EXPECT_LT((velocityJacobian - velocityNumerical).cwiseAbs().maxCoeff(),
+              0.1 * velocityScale);
+  }
+
+  // At the knots, the covariance is that of the knot
+  const Matrix6d Qc = testQc();
+  const Eigen::Matrix<double, 24, 24> knotCov =
+      test::randomCovariance<24>(0.1, 1e-3);
+  EXPECT_TRUE(common::nearEqual(interval.covariance(T1, knotCov, Qc),
+                                knotCov.topLeftCorner<12, 12>().eval(),
+                                1e-12));
+  const Eigen::Matrix<double, 12, 12> cov_2 =
+      interval.covariance(T2, knotCov, Qc);
+  EXPECT_TRUE(common::nearEqual(cov_2.topLeftCorner<6, 6>().eval(),
+                                knotCov.block<6, 6>(12, 12).eval(), 1e-9));
+
+  // Between the knots, the prior adds uncertainty, and the covariance stays
+  // symmetric positive definite
+  const Eigen::Matrix<double, 12, 12> cov =
+      interval.covariance(0.5 * (T1 + T2), knotCov, Qc);
+  EXPECT_TRUE(common::nearEqual(cov, cov.transpose().eval(), 1e-12));
+  typedef Eigen::Matrix<double, 12, 12> Matrix12d;
+  EXPECT_GT(
+      Eigen::SelfAdjointEigenSolver<Matrix12d>(cov).eigenvalues().minCoeff(),
+      0.0);
+  const Eigen::Matrix<double, 12, 12> noPrior = interval.covariance(
+      0.5 * (T1 + T2), knotCov, Matrix6d::Zero().eval());
+  EXPECT_GT((cov - noPrior).trace(), 0.0);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the batch states against the single states
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, GaussianProcessBatch) {
+  se3::gp::Knot knot1, knot2;
+  testKnots(&knot1, &knot2);
+  const se3::gp::Interval interval(knot1, knot2);
+  const std::size_t n = 1003, stride = n + 3;
+  const Eigen::VectorXd t = Eigen::VectorXd::LinSpaced(n, T1, T2);
+
+  const common::Isa active = common::activeIsa();
+  common::ThreadPool pool(4);
+  for (common::Isa isa : common::supportedIsas()) {
+    SCOPED_TRACE(common::isaName(isa));
+    common::setIsa(isa);
+    std::vector<double> T(se3::BATCH_POSE_ROWS * stride);
+    std::vector<double> varpi(6 * stride);
+    std::vector<double> T_pool(se3::BATCH_POSE_ROWS * n);
+    interval.states(t.data(), T.data(), varpi.data(), n, stride);
+    const common::ExecutionPolicy policy(pool, common::Chunking::DYNAMIC, 64);
+    interval.states(policy, t.data(), T_pool.data(), nullptr, n);
+    for (std::size_t i = 0; i < n; ++i) {
+      const Eigen::Matrix4d pose = interval.pose(t(i)).matrix();
+      const Vector6d velocity = interval.velocity(t(i));
+      EXPECT_TRUE(common::nearEqual(test::batchPose(T.data(), i, stride),
+                                    pose, 1e-12));
+      EXPECT_TRUE(common::nearEqual(test::batchPose(T_pool.data(), i, n),
+                                    pose, 1e-12));
+      for (std::size_t k = 0; k < 6; ++k) {
+        EXPECT_NEAR(varpi[k * stride + i], velocity(k), 1e-12);
+      }
+    }
+  }
+  common::setIsa(active);
+
+  std::vector<double> T(se3::BATCH_POSE_ROWS * n);
+  EXPECT_THROW(interval.states(t.data(), nullptr, nullptr, n),
+               std::invalid_argument);
+  EXPECT_THROW(interval.states(t.data(), T.data(), nullptr, n, n - 1),
+               std::invalid_argument);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
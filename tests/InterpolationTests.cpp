@@ -0,0 +1,117 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// \file InterpolationTests.cpp
+/// \brief Unit tests for the geodesic interpolation of transformations.
+///
+/// \author ASRL
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+
+#include <Eigen/Dense>
+
+#include <lgmath.hpp>
+#include <lgmath/CommonMath.hpp>
+#include <lgmath/se3/Interpolation.hpp>
+
+#include "TestHelpers.hpp"
+
+using namespace lgmath;
+
+namespace {
+
+typedef Eigen::Matrix<double, 6, 1> Vector6d;
+typedef Eigen::Matrix<double, 6, 6> Matrix6d;
+
+/** \brief A random covariance */
+Matrix6d randomCovariance() { return test::randomCovariance(0.1, 1e-3); }
+
+}  // namespace
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+///
+/// UNIT TESTS OF INTERPOLATION
+///
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the interpolated and extrapolated poses
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, InterpolateTransformation) {
+  for (int test = 0; test < 20; ++test) {
+    const se3::Transformation T_0(Vector6d(2.0 * Vector6d::Random()));
+    const se3::Transformation T_1(Vector6d(2.0 * Vector6d::Random()));
+
+    EXPECT_TRUE(common::nearEqual(se3::interpolate(T_0, T_1, 0.0).matrix(),
+                                  T_0.matrix(), 1e-9));
+    EXPECT_TRUE(common::nearEqual(se3::interpolate(T_0, T_1, 1.0).matrix(),
+                                  T_1.matrix(), 1e-9));
+
+    // Two half steps make a whole step
+    const se3::Transformation T_half = se3::interpolate(T_0, T_1, 0.5);
+    EXPECT_TRUE(common::nearEqual(
+        (T_half * T_0.inverse() * T_half).matrix(), T_1.matrix(), 1e-9));
+
+    // Extrapolation continues with the same velocity
+    const Vector6d xi = (T_0.inverse() * T_1).vec();
+    for (double alpha : {-0.7, 0.3, 1.6}) {
+      const Eigen::Matrix4d T_ref =
+          T_0.matrix() * se3::vec2tran(Vector6d(alpha * xi));
+      EXPECT_TRUE(common::nearEqual(
+          se3::interpolate(T_0, T_1, alpha).matrix(), T_ref, 1e-9));
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the interpolated covariances against numerical Jacobians
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, InterpolateCovariance) {
+  for (int test = 0; test < 10; ++test) {
+    const se3::TransformationWithCovariance T_0(
+        se3::Transformation(Vector6d(Vector6d::Random())), randomCovariance());
+    const se3::TransformationWithCovariance T_1(
+        se3::Transformation(Vector6d(Vector6d::Random())), randomCovariance());
+
+    EXPECT_TRUE(common::nearEqual(se3::interpolate(T_0, T_1, 0.0).cov(),
+                                  T_0.cov(), 1e-9));
+    EXPECT_TRUE(common::nearEqual(se3::interpolate(T_0, T_1, 1.0).cov(),
+                                  T_1.cov(), 1e-9));
+
+    const se3::Transformation T_0_mean = T_0, T_1_mean = T_1;
+    for (double alpha : {0.3, 1.4}) {
+      const se3::TransformationWithCovariance T =
+          se3::interpolate(T_0, T_1, alpha);
+
+      // Jacobians of T with respect to left perturbations of T_0 and T_1
+      const double h = 1e-6;
+      Matrix6d B, A;
+      for (int k = 0; k < 6; ++k) {
+        const se3::Transformation d(Vector6d(h * Vector6d::Unit(k)));
+        const se3::Transformation T_0_d =
+            se3::interpolate(d * T_0_mean, T_1_mean, alpha);
+        const se3::Transformation T_1_d =
+            se3::interpolate(T_0_mean, d * T_1_mean, alpha);
+        B.col(k) = (T_0_d * T.inverse()).vec() / h;
+        A.col(k) = (T_1_d * T.inverse()).vec() / h;
+      }
+      const Matrix6d cov_ref = A * T_1.cov() * A.transpose() +
+                               B * T_0.cov() * B.transpose();
+      EXPECT_TRUE(common::nearEqual(T.cov(), cov_ref, 1e-6));
+      EXPECT_TRUE(common::nearEqual(
+          T.matrix(), se3::interpolate(T_0_mean, T_1_mean, alpha).matrix(),
+          1e-12));
+    }
+  }
+
+  // The covariance is only set if both are
+  const se3::TransformationWithCovariance unset(
+      se3::Transformation(Vector6d(Vector6d::Random())));
+  EXPECT_FALSE(
+      se3::interpolate(unset, se3::TransformationWithCovariance(true), 0.5)
+          .covarianceSet());
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,96 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// \file Layout.hpp
+/// \brief The sizes and alignments of the lgmath classes with fixed-size Eigen
+/// members, as seen by the translation unit that includes this header.
+/// \details Included both by LayoutTests.cpp and by LayoutAvx2.cpp, which is
+/// compiled with AVX2 flags, so that the test can compare the layouts a
+/// caller sees with different instruction set flags than the library. Only
+/// constants are measured, so that no inline function of lgmath is compiled
+/// with other flags.
+///
+/// \author ASRL
+//////////////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <cstddef>
+
+#include <lgmath/io/TrajectoryCodec.hpp>
+#include <lgmath/se3/CachedTransformation.hpp>
+#include <lgmath/se3/Deskew.hpp>
+#include <lgmath/se3/GaussianProcess.hpp>
+#include <lgmath/se3/Transformation.hpp>
+#include <lgmath/se3/TransformationPairWithCovariance.hpp>
+#include <lgmath/se3/TransformationWithCovariance.hpp>
+#include <lgmath/so3/Rotation.hpp>
+
+/**
+ * \brief Calls X(type) for every public class with fixed-size Eigen members,
+ * and for the public typedefs of such members; a new class goes here
+ */
+#define LGMATH_LAYOUT_TYPES(X)                        \
+  X(so3::Rotation)                                    \
+  X(se3::Transformation)                              \
+  X(se3::Transformation::Matrix34d)                   \
+  X(se3::CachedTransformation)                        \
+  X(se3::CachedTransformation::Vector6d)              \
+  X(se3::CachedTransformation::Matrix6d)              \
+  X(se3::TransformationWithCovariance)                \
+  X(se3::TransformationWithCovariance::Matrix6d)      \
+  X(se3::TransformationPairWithCovariance)            \
+  X(se3::TransformationPairWithCovariance::Matrix12d) \
+  X(se3::gp::Knot)                                    \
+  X(se3::gp::Interval)                                \
+  X(se3::Deskew)                                      \
+  X(io::TrajectoryEncoder)                            \
+  X(io::TrajectoryDecoder)                            \
+  X(io::CompressedTrajectory)
+
+namespace lgmath {
+namespace test {
+
+#define LGMATH_LAYOUT_ONE(type) +1
+
+/** \brief Number of classes in a Layout */
+const std::size_t NUM_LAYOUT_TYPES = 0 LGMATH_LAYOUT_TYPES(LGMATH_LAYOUT_ONE);
+
+#undef LGMATH_LAYOUT_ONE
+
+/** \brief The sizes and alignments of the classes */
+struct Layout {
+  std::size_t sizes[NUM_LAYOUT_TYPES];
+  std::size_t alignments[NUM_LAYOUT_TYPES];
+};
+
+#define LGMATH_LAYOUT_NAME(type) #type,
+
+/** \brief The names of the classes of a Layout */
+const char* const LAYOUT_NAMES[NUM_LAYOUT_TYPES] = {
+    LGMATH_LAYOUT_TYPES(LGMATH_LAYOUT_NAME)};
+
+#undef LGMATH_LAYOUT_NAME
+
+namespace {
+
+#define LGMATH_LAYOUT_SIZE(type) sizeof(type),
+#define LGMATH_LAYOUT_ALIGNMENT(type) alignof(type),
+
+/**
+ * \brief The Layout of the including translation unit, for its own flags;
+ * internal, so that each translation unit keeps its own
+ */
+Layout measureLayout() {
+  const Layout layout = {{LGMATH_LAYOUT_TYPES(LGMATH_LAYOUT_SIZE)},
+                         {LGMATH_LAYOUT_TYPES(LGMATH_LAYOUT_ALIGNMENT)}};
+  return layout;
+}
+
+#undef LGMATH_LAYOUT_SIZE
+#undef LGMATH_LAYOUT_ALIGNMENT
+
+}  // namespace
+
+/** \brief The Layout of LayoutAvx2.cpp, compiled with -mavx2 -mfma */
+Layout avx2Layout();
+
+}  // namespace test
+}  // namespace lgmath
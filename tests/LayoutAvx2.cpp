@@ -0,0 +1,16 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// \file LayoutAvx2.cpp
+/// \brief The class layouts seen by a caller built with -mavx2 -mfma.
+///
+/// \author ASRL
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "Layout.hpp"
+
+namespace lgmath {
+namespace test {
+
+Layout avx2Layout() { return measureLayout(); }
+
+}  // namespace test
+}  // namespace lgmath
@@ -0,0 +1,43 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// \file LayoutTests.cpp
+/// \brief Unit tests for the layouts of the classes across instruction set
+/// flags.
+///
+/// \author ASRL
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+
+#include <lgmath/Dispatch.hpp>
+
+#include "Layout.hpp"
+
+using namespace lgmath;
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+///
+/// UNIT TESTS OF THE CLASS LAYOUTS
+///
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST(LGMath, LayoutAcrossIsaFlags) {
+  // The inline accessors of a caller built with AVX2 flags must see the
+  // members where the library, built without, put them
+  if (!common::isaSupported(common::Isa::AVX2)) {
+    GTEST_SKIP() << "The CPU does not support AVX2";
+  }
+  const test::Layout layout = test::measureLayout();
+  const test::Layout avx2 = test::avx2Layout();
+  for (std::size_t k = 0; k < test::NUM_LAYOUT_TYPES; ++k) {
+    EXPECT_EQ(layout.sizes[k], avx2.sizes[k])
+        << "sizeof(" << test::LAYOUT_NAMES[k] << ")";
+    EXPECT_EQ(layout.alignments[k], avx2.alignments[k])
+        << "alignof(" << test::LAYOUT_NAMES[k] << ")";
+  }
+  EXPECT_EQ(alignof(se3::Transformation::Matrix34d), alignof(double));
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,201 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// \file MapTests.cpp
+/// \brief Unit tests for the rotation and transformation views over external
+/// buffers.
+///
+/// \author ASRL
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include <lgmath.hpp>
+#include <lgmath/CommonMath.hpp>
+#include <lgmath/se3/TransformationMap.hpp>
+#include <lgmath/so3/RotationMap.hpp>
+
+using namespace lgmath;
+
+namespace {
+
+const std::vector<so3::RotationLayout> ROTATION_LAYOUTS = {
+    so3::RotationLayout::ROW_MAJOR_3X3, so3::RotationLayout::COL_MAJOR_3X3,
+    so3::RotationLayout::QUATERNION, so3::RotationLayout::VECTOR3};
+
+const std::vector<se3::PoseLayout> POSE_LAYOUTS = {
+    se3::PoseLayout::ROW_MAJOR_3X4, se3::PoseLayout::COL_MAJOR_3X4,
+    se3::PoseLayout::TRANSLATION_QUATERNION, se3::PoseLayout::VECTOR6};
+
+}  // namespace
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+///
+/// UNIT TESTS OF ROTATION MAPS
+///
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the mapped rotations against Rotation in every layout
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, RotationMapLayouts) {
+  const so3::Rotation C_1(Eigen::Vector3d(0.3, -1.2, 0.7));
+  const so3::Rotation C_2(Eigen::Vector3d(-2.1, 0.4, 0.9));
+  const Eigen::Vector3d p(1.0, -2.0, 3.0);
+
+  // Known layouts of C_1
+  const Eigen::Matrix3d C = C_1.matrix();
+  const std::vector<double> row_major = {C(0, 0), C(0, 1), C(0, 2),
+                                         C(1, 0), C(1, 1), C(1, 2),
+                                         C(2, 0), C(2, 1), C(2, 2)};
+  const Eigen::Quaterniond q(C);
+  const std::vector<double> quaternion = {q.x(), q.y(), q.z(), q.w()};
+
+  for (const auto layout : ROTATION_LAYOUTS) {
+    std::vector<double> buffer(so3::rotationLayoutSize(layout));
+    so3::RotationMap C_1_map(buffer.data(), layout);
+    C_1_map = C_1;
+    if (layout == so3::RotationLayout::ROW_MAJOR_3X3) {
+      EXPECT_EQ(buffer, row_major);
+    } else if (layout == so3::RotationLayout::QUATERNION) {
+      EXPECT_EQ(buffer, quaternion);
+    }
+
+    const so3::ConstRotationMap C_1_const(buffer.data(), layout);
+    EXPECT_TRUE(common::nearEqual(C_1_const.matrix(), C, 1e-12));
+    EXPECT_TRUE(common::nearEqual(C_1_const.vec(), C_1.vec(), 1e-12));
+    EXPECT_TRUE(common::nearEqual(C_1_const.inverse().matrix(),
+                                  C_1.inverse().matrix(), 1e-12));
+    EXPECT_TRUE(common::nearEqual(C_1_const * p, C_1 * p, 1e-12));
+    EXPECT_TRUE(common::nearEqual((C_1_const * C_2).matrix(),
+                                  (C_1 * C_2).matrix(), 1e-12));
+
+    // Compose into a buffer of another layout, and in place
+    for (const auto out_layout : ROTATION_LAYOUTS) {
+      std::vector<double> out(so3::rotationLayoutSize(out_layout));
+      so3::RotationMap C_out(out.data(), out_layout);
+      C_out = C_2;
+      so3::compose(C_1_const, C_out, &C_out);
+      EXPECT_TRUE(common::nearEqual(C_out.matrix(), (C_1 * C_2).matrix(),
+                                    1e-12));
+      C_out = C_1_const;
+      EXPECT_TRUE(common::nearEqual(C_out.matrix(), C, 1e-12));
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test that mapping a null buffer throws
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, MapNullBuffer) {
+  EXPECT_THROW(
+      so3::ConstRotationMap(nullptr, so3::RotationLayout::QUATERNION),
+      std::invalid_argument);
+  EXPECT_THROW(se3::TransformationMap(nullptr, se3::PoseLayout::VECTOR6),
+               std::invalid_argument);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+///
+/// UNIT TESTS OF TRANSFORMATION MAPS
+///
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the mapped transformations against Transformation in every
+/// layout
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, TransformationMapLayouts) {
+  Eigen::Matrix<double, 6, 1> xi_1, xi_2;
+  xi_1 << 1.0, -2.0, 0.5, 0.3, -1.2, 0.7;
+  xi_2 << -0.4, 0.8, 3.0, -2.1, 0.4, 0.9;
+  const se3::Transformation T_1(xi_1), T_2(xi_2);
+  const Eigen::Vector4d p(1.0, -2.0, 3.0, 1.0);
+
+  // Known layouts of T_1
+  const Eigen::Matrix4d T = T_1.matrix();
+  std::vector<double> row_major;
+  for (int i = 0; i < 3; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      row_major.push_back(T(i, j));
+    }
+  }
+  const Eigen::Quaterniond q(T_1.C_ba());
+  const std::vector<double> pose = {T(0, 3), T(1, 3), T(2, 3), q.x(),
+                                    q.y(),   q.z(),   q.w()};
+
+  for (const auto layout : POSE_LAYOUTS) {
+    std::vector<double> buffer(se3::poseLayoutSize(layout));
+    se3::TransformationMap T_1_map(buffer.data(), layout);
+    T_1_map = T_1;
+    if (layout == se3::PoseLayout::ROW_MAJOR_3X4) {
+      EXPECT_EQ(buffer, row_major);
+    } else if (layout == se3::PoseLayout::TRANSLATION_QUATERNION) {
+      EXPECT_EQ(buffer, pose);
+    }
+
+    const se3::ConstTransformationMap T_1_const(buffer.data(), layout);
+    EXPECT_TRUE(common::nearEqual(T_1_const.matrix(), T, 1e-12));
+    EXPECT_TRUE(common::nearEqual(T_1_const.C_ba(), T_1.C_ba(), 1e-12));
+    EXPECT_TRUE(
+        common::nearEqual(T_1_const.r_ab_inb(), T_1.r_ab_inb(), 1e-12));
+    EXPECT_TRUE(common::nearEqual(T_1_const.vec(), xi_1, 1e-12));
+    EXPECT_TRUE(common::nearEqual(T_1_const.transformation().matrix(), T,
+                                  1e-12));
+    EXPECT_TRUE(common::nearEqual(T_1_const.inverse().matrix(),
+                                  T_1.inverse().matrix(), 1e-12));
+    EXPECT_TRUE(
+        common::nearEqual(T_1_const.adjoint(), T_1.adjoint(), 1e-12));
+    EXPECT_TRUE(common::nearEqual(T_1_const * p, T_1 * p, 1e-12));
+    EXPECT_TRUE(common::nearEqual((T_1_const * T_2).matrix(),
+                                  (T_1 * T_2).matrix(), 1e-12));
+
+    // Compose into a buffer of another layout, and in place
+    for (const auto out_layout : POSE_LAYOUTS) {
+      std::vector<double> out(se3::poseLayoutSize(out_layout));
+      se3::TransformationMap T_out(out.data(), out_layout);
+      T_out = T_2;
+      se3::compose(T_1_const, T_out, &T_out);
+      EXPECT_TRUE(common::nearEqual(T_out.matrix(), (T_1 * T_2).matrix(),
+                                    1e-12));
+      EXPECT_TRUE(common::nearEqual((T_out * T_1_const).matrix(),
+                                    (T_1 * T_2 * T_1).matrix(), 1e-12));
+      T_out = T_1_const;
+      EXPECT_TRUE(common::nearEqual(T_out.matrix(), T, 1e-12));
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test that the maps read and write the caller's buffer in place
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, TransformationMapInPlace) {
+  // An unnormalized quaternion is normalized when read
+  std::vector<double> pose = {1.0, 2.0, 3.0, 0.0, 0.0, 2.0, 0.0};
+  const se3::ConstTransformationMap T_view(
+      pose.data(), se3::PoseLayout::TRANSLATION_QUATERNION);
+  Eigen::Matrix3d C_expected;
+  C_expected << -1.0, 0.0, 0.0, 0.0, -1.0, 0.0, 0.0, 0.0, 1.0;
+  EXPECT_TRUE(common::nearEqual(T_view.C_ba(), C_expected, 1e-12));
+
+  // Changes to the buffer are seen through the view
+  pose[0] = -5.0;
+  EXPECT_EQ(T_view.r_ab_inb()(0), -5.0);
+
+  // Assigning one map to another copies values, not the pointer
+  std::vector<double> other(12, 0.0);
+  se3::TransformationMap T_other(other.data(),
+                                 se3::PoseLayout::COL_MAJOR_3X4);
+  T_other = T_view;
+  EXPECT_EQ(T_other.data(), other.data());
+  EXPECT_EQ(other[9], -5.0);
+  EXPECT_EQ(other[0], -1.0);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
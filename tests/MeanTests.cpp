@@ -0,0 +1,200 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// \file MeanTests.cpp
+/// \brief Unit tests for the weighted means of rotations and transformations.
+///
+/// \author ASRL
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include <lgmath.hpp>
+#include <lgmath/CommonMath.hpp>
+#include <lgmath/Parallel.hpp>
+#include <lgmath/se3/Mean.hpp>
+#include <lgmath/so3/Mean.hpp>
+
+using namespace lgmath;
+
+namespace {
+
+typedef Eigen::Matrix<double, 6, 1> Vector6d;
+typedef Eigen::Matrix<double, 6, 6> Matrix6d;
+
+/** \brief Rotations exp(+-phi_k^) * C about C, and the sum of phi_k phi_k^T */
+std::vector<so3::Rotation> symmetricRotations(const so3::Rotation& C,
+                                              std::size_t pairs,
+                                              Eigen::Matrix3d* outer) {
+  std::vector<so3::Rotation> rotations;
+  outer->setZero();
+  for (std::size_t k = 0; k < pairs; ++k) {
+    const Eigen::Vector3d phi = 0.5 * Eigen::Vector3d::Random();
+    rotations.push_back(so3::Rotation(Eigen::Vector3d(phi)) * C);
+    rotations.push_back(so3::Rotation(Eigen::Vector3d(-phi)) * C);
+    *outer += 2.0 * phi * phi.transpose();
+  }
+  return rotations;
+}
+
+/** \brief Transformations exp(+-xi_k^) * T about T */
+std::vector<se3::Transformation> symmetricTransformations(
+    const se3::Transformation& T, std::size_t pairs, Matrix6d* outer) {
+  std::vector<se3::Transformation> transformations;
+  outer->setZero();
+  for (std::size_t k = 0; k < pairs; ++k) {
+    const Vector6d xi = 0.5 * Vector6d::Random();
+    transformations.push_back(se3::Transformation(Vector6d(xi)) * T);
+    transformations.push_back(se3::Transformation(Vector6d(-xi)) * T);
+    *outer += 2.0 * xi * xi.transpose();
+  }
+  return transformations;
+}
+
+/** \brief Transformations scattered about a random one */
+std::vector<se3::Transformation> scatteredTransformations(std::size_t n,
+                                                          double scale) {
+  const se3::Transformation T(Vector6d(Vector6d::Random()));
+  std::vector<se3::Transformation> transformations;
+  for (std::size_t i = 0; i < n; ++i) {
+    transformations.push_back(
+        se3::Transformation(Vector6d(scale * Vector6d::Random())) * T);
+  }
+  return transformations;
+}
+
+}  // namespace
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+///
+/// UNIT TESTS OF THE ROTATION MEANS
+///
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST(LGMath, RotationMean) {
+  const so3::Rotation C(Eigen::Vector3d(Eigen::Vector3d::Random()));
+  Eigen::Matrix3d outer;
+  const std::vector<so3::Rotation> rotations =
+      symmetricRotations(C, 50, &outer);
+
+  // Both means of symmetric perturbations are the center
+  Eigen::Matrix3d spread;
+  const so3::Rotation karcher =
+      so3::mean(rotations, {}, so3::MeanMethod::KARCHER, &spread);
+  EXPECT_TRUE(common::nearEqual(karcher.matrix(), C.matrix(), 1e-9));
+  EXPECT_TRUE(
+      common::nearEqual(spread, outer / double(rotations.size()), 1e-9));
+  const so3::Rotation chordal =
+      so3::mean(rotations, {}, so3::MeanMethod::CHORDAL);
+  EXPECT_TRUE(common::nearEqual(chordal.matrix(), C.matrix(), 1e-9));
+
+  // Weights move the Karcher mean along the geodesic
+  const Eigen::Vector3d phi(0.4, -0.8, 0.2);
+  const std::vector<so3::Rotation> pair = {C, so3::Rotation(phi) * C};
+  const so3::Rotation weighted = so3::mean(pair, {1.0, 3.0});
+  const so3::Rotation expected =
+      so3::Rotation(Eigen::Vector3d(0.75 * phi)) * C;
+  EXPECT_TRUE(
+      common::nearEqual(weighted.matrix(), expected.matrix(), 1e-9));
+  EXPECT_TRUE(
+      common::nearEqual(so3::mean(pair, {0.0, 2.0}).matrix(),
+                        pair[1].matrix(), 1e-9));
+
+  EXPECT_THROW(so3::mean(std::vector<so3::Rotation>()),
+               std::invalid_argument);
+  EXPECT_THROW(so3::mean(pair, {1.0}), std::invalid_argument);
+  EXPECT_THROW(so3::mean(pair, {1.0, -1.0}), std::invalid_argument);
+  EXPECT_THROW(so3::mean(pair, {0.0, 0.0}), std::invalid_argument);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+///
+/// UNIT TESTS OF THE TRANSFORMATION MEANS
+///
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST(LGMath, TransformationMean) {
+  const se3::Transformation T(Vector6d(Vector6d::Random()));
+  Matrix6d outer;
+  const std::vector<se3::Transformation> transformations =
+      symmetricTransformations(T, 50, &outer);
+
+  Matrix6d spread;
+  const se3::Transformation karcher =
+      se3::mean(transformations, {}, se3::MeanMethod::KARCHER, &spread);
+  EXPECT_TRUE(common::nearEqual(karcher.matrix(), T.matrix(), 1e-9));
+  EXPECT_TRUE(common::nearEqual(
+      spread, outer / double(transformations.size()), 1e-9));
+
+  // Weights move the Karcher mean along the geodesic
+  const Vector6d xi = (Vector6d() << 0.5, -0.2, 0.3, 0.4, -0.8, 0.2).finished();
+  const std::vector<se3::Transformation> pair = {
+      T, se3::Transformation(xi) * T};
+  EXPECT_TRUE(common::nearEqual(
+      se3::mean(pair, {1.0, 3.0}).matrix(),
+      (se3::Transformation(Vector6d(0.75 * xi)) * T).matrix(), 1e-9));
+
+  // The chordal mean is close to the Karcher mean of a tight cluster
+  const std::vector<se3::Transformation> cluster =
+      scatteredTransformations(200, 0.01);
+  const se3::Transformation chordal =
+      se3::mean(cluster, {}, se3::MeanMethod::CHORDAL);
+  EXPECT_LT((chordal / se3::mean(cluster)).vec().norm(), 1e-4);
+
+  EXPECT_THROW(se3::mean(std::vector<se3::Transformation>()),
+               std::invalid_argument);
+  EXPECT_THROW(se3::mean(pair, {1.0, 2.0, 3.0}), std::invalid_argument);
+  EXPECT_THROW(se3::mean(pair, {-1.0, 2.0}), std::invalid_argument);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+///
+/// UNIT TESTS OF THE PARALLEL MEANS
+///
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST(LGMath, MeanDeterminism) {
+  const std::vector<se3::Transformation> transformations =
+      scatteredTransformations(5000, 0.5);
+  std::vector<double> weights(transformations.size());
+  for (std::size_t i = 0; i < weights.size(); ++i) {
+    weights[i] = 1.0 + double(i % 7);
+  }
+  std::vector<so3::Rotation> rotations;
+  for (const se3::Transformation& T : transformations) {
+    rotations.push_back(so3::Rotation(Eigen::Matrix3d(T.C_ba())));
+  }
+
+  Matrix6d spread;
+  const se3::Transformation T =
+      se3::mean(transformations, weights, se3::MeanMethod::KARCHER, &spread);
+  Eigen::Matrix3d rotationSpread;
+  const so3::Rotation C =
+      so3::mean(rotations, weights, so3::MeanMethod::KARCHER, &rotationSpread);
+
+  // Bitwise the same on any number of threads
+  for (std::size_t numThreads : {1, 2, 4, 8}) {
+    common::ThreadPool pool(numThreads);
+    const common::ExecutionPolicy policy(pool, common::Chunking::DYNAMIC, 1);
+    Matrix6d poolSpread;
+    EXPECT_EQ(se3::mean(policy, transformations, weights,
+                        se3::MeanMethod::KARCHER, &poolSpread)
+                  .matrix(),
+              T.matrix());
+    EXPECT_EQ(poolSpread, spread);
+    Eigen::Matrix3d poolRotationSpread;
+    EXPECT_EQ(so3::mean(policy, rotations, weights, so3::MeanMethod::KARCHER,
+                        &poolRotationSpread)
+                  .matrix(),
+              C.matrix());
+    EXPECT_EQ(poolRotationSpread, rotationSpread);
+  }
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,252 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// \file ParallelTests.cpp
+/// \brief Unit tests for the executors and the execution policies of the
+/// batch functions.
+///
+/// \author ASRL
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include <lgmath.hpp>
+#include <lgmath/Parallel.hpp>
+#include <lgmath/se3/Batch.hpp>
+
+using namespace lgmath;
+
+namespace {
+
+/** \brief Runs the tasks in order, recording them, with any concurrency */
+class RecordingExecutor : public common::Executor {
+ public:
+  explicit RecordingExecutor(std::size_t concurrency)
+      : concurrency_(concurrency) {}
+
+  void run(std::size_t numTasks,
+           const std::function<void(std::size_t)>& task) override {
+    numTasks_.push_back(numTasks);
+    common::serialExecutor().run(numTasks, task);
+  }
+
+  std::size_t concurrency() const override { return concurrency_; }
+
+  /** \brief Number of tasks of each call to run() */
+  const std::vector<std::size_t>& numTasks() const { return numTasks_; }
+
+ private:
+  std::size_t concurrency_;
+  std::vector<std::size_t> numTasks_;
+};
+
+/** \brief The ranges of forEachRange */
+std::vector<std::pair<std::size_t, std::size_t>> ranges(
+    const common::ExecutionPolicy& policy, std::size_t n) {
+  std::vector<std::pair<std::size_t, std::size_t>> result;
+  policy.forEachRange(n, 100, [&](std::size_t begin, std::size_t end) {
+    result.emplace_back(begin, end);
+  });
+  return result;
+}
+
+}  // namespace
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+///
+/// UNIT TESTS OF THE EXECUTORS
+///
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test that a thread pool runs every task once
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, ThreadPoolRunsAllTasks) {
+  for (std::size_t numThreads : {1, 2, 4, 8}) {
+    common::ThreadPool pool(numThreads);
+    EXPECT_EQ(pool.concurrency(), numThreads);
+    std::vector<std::atomic<int>> counts(1000);
+    for (auto& count : counts) {
+      count = 0;
+    }
+    for (int repeat = 0; repeat < 3; ++repeat) {
+      pool.run(counts.size(), [&](std::size_t i) { ++counts[i]; });
+    }
+    for (const auto& count : counts) {
+      EXPECT_EQ(count.load(), 3);
+    }
+    pool.run(0, [](std::size_t) { FAIL(); });
+  }
+  EXPECT_GE(common::ThreadPool().concurrency(), 1u);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test that exceptions of the tasks reach the caller
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, ThreadPoolExceptions) {
+  common::ThreadPool pool(4);
+  EXPECT_THROW(pool.run(100,
+                        [](std::size_t i) {
+                          if (i == 37) {
+                            throw std::runtime_error("task failed");
+                          }
+                        }),
+               std::runtime_error);
+
+  // The pool is still usable
+  std::atomic<int> count(0);
+  pool.run(100, [&](std::size_t) { ++count; });
+  EXPECT_EQ(count.load(), 100);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test runs from within tasks and from several threads at once
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, ThreadPoolNestedRuns) {
+  common::ThreadPool pool(3);
+  std::atomic<int> count(0);
+  pool.run(8, [&](std::size_t) {
+    pool.run(50, [&](std::size_t) { ++count; });
+  });
+  EXPECT_EQ(count.load(), 400);
+
+  count = 0;
+  std::vector<std::thread> callers;
+  for (int t = 0; t < 4; ++t) {
+    callers.emplace_back(
+        [&] { pool.run(100, [&](std::size_t) { ++count; }); });
+  }
+  for (auto& caller : callers) {
+    caller.join();
+  }
+  EXPECT_EQ(count.load(), 400);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+///
+/// UNIT TESTS OF THE EXECUTION POLICIES
+///
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the ranges of the chunking modes
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, ExecutionPolicyChunking) {
+  const std::size_t n = 10000;
+  RecordingExecutor serial(1), wide(16);
+
+  // Deterministic ranges are whole chunks of at least the grain size, the
+  // same on any executor
+  const auto fixed =
+      ranges(common::ExecutionPolicy(serial, common::Chunking::DETERMINISTIC),
+             n);
+  EXPECT_EQ(fixed,
+            ranges(common::ExecutionPolicy(
+                       wide, common::Chunking::DETERMINISTIC),
+                   n));
+  ASSERT_EQ(fixed.size(), (n + 127) / 128);
+  for (std::size_t k = 0; k < fixed.size(); ++k) {
+    EXPECT_EQ(fixed[k].first, 128 * k);
+    EXPECT_EQ(fixed[k].second, std::min(n, 128 * (k + 1)));
+  }
+  EXPECT_EQ(ranges(common::ExecutionPolicy(
+                       serial, common::Chunking::DETERMINISTIC, 1000),
+                   n)
+                .size(),
+            (n + 1023) / 1024);
+
+  // Dynamic ranges follow the concurrency of the executor
+  const auto single = ranges(common::ExecutionPolicy(serial), n);
+  ASSERT_EQ(single.size(), 1u);
+  EXPECT_EQ(single[0], std::make_pair(std::size_t(0), n));
+  const auto split = ranges(common::ExecutionPolicy(wide), n);
+  EXPECT_EQ(split.size(), wide.numTasks().back());
+  EXPECT_GT(split.size(), 16u);
+  EXPECT_EQ(split.front().first, 0u);
+  EXPECT_EQ(split.back().second, n);
+  for (std::size_t k = 1; k < split.size(); ++k) {
+    EXPECT_EQ(split[k].first, split[k - 1].second);
+    EXPECT_EQ(split[k].first % 64, 0u);
+  }
+
+  EXPECT_TRUE(ranges(common::ExecutionPolicy(wide), 0).empty());
+  EXPECT_EQ(ranges(common::ExecutionPolicy::sequential(), n).size(), 1u);
+  EXPECT_EQ(&common::ExecutionPolicy::parallel().executor(),
+            &common::defaultExecutor());
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test that the batch functions give the same results on any executor
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, BatchPolicies) {
+  const std::size_t n = 1000, numPoses = 300;
+  const Eigen::MatrixXd xi = Eigen::MatrixXd::Random(6, n);
+  const Eigen::MatrixXd v = Eigen::MatrixXd::Random(6, n);
+  const Eigen::MatrixXd p = Eigen::MatrixXd::Random(3, n);
+  const Eigen::MatrixXd cov = Eigen::MatrixXd::Random(numPoses, 21);
+  Eigen::Matrix<std::size_t, Eigen::Dynamic, Eigen::Dynamic> pairs(n, 2);
+  for (std::size_t k = 0; k < n; ++k) {
+    pairs(k, 0) = (7 * k) % numPoses;
+    pairs(k, 1) = (13 * k + 5) % numPoses;
+  }
+  Eigen::MatrixXd poses(numPoses, 12);
+  se3::vec2tranBatch(Eigen::MatrixXd(xi.leftCols(numPoses).transpose()).data(),
+                     poses.data(), numPoses);
+
+  // The outputs of several batch functions, computed with a policy
+  const auto outputs = [&](const common::ExecutionPolicy& policy) {
+    const Eigen::MatrixXd xi_rows = xi.transpose(), v_rows = v.transpose();
+    const Eigen::MatrixXd p_rows = p.transpose();
+    Eigen::MatrixXd T(n, 12), rel(n, 12), relCov(n, 21);
+    Eigen::MatrixXd xi_out(n, 6), p_out(n, 3), Jv(n, 6);
+    se3::vec2tranBatch(policy, xi_rows.data(), T.data(), n);
+    se3::tran2vecBatch(policy, T.data(), xi_out.data(), n);
+    se3::transformPointsBatch(policy, T.data(), p_rows.data(), p_out.data(),
+                              n);
+    se3::applyJacBatch(policy, xi_rows.data(), v_rows.data(), Jv.data(), n);
+    se3::relativePosesBatch(policy, poses.data(), cov.data(), numPoses,
+                            pairs.data(), rel.data(), relCov.data(), n);
+    return std::vector<Eigen::MatrixXd>{T, xi_out, p_out, Jv, rel, relCov};
+  };
+
+  const std::vector<Eigen::MatrixXd> reference =
+      outputs(common::ExecutionPolicy::sequential());
+  for (std::size_t numThreads : {1, 2, 4, 8}) {
+    common::ThreadPool pool(numThreads);
+    for (auto chunking :
+         {common::Chunking::DYNAMIC, common::Chunking::DETERMINISTIC}) {
+      const std::vector<Eigen::MatrixXd> results =
+          outputs(common::ExecutionPolicy(pool, chunking, 64));
+      for (std::size_t k = 0; k < reference.size(); ++k) {
+        // Bitwise identical, not just near
+        EXPECT_TRUE((results[k].array() == reference[k].array()).all())
+            << "output " << k << " with " << numThreads << " threads";
+      }
+    }
+  }
+
+  // The batch functions use the executor of the policy, and check their
+  // arguments before running any task
+  RecordingExecutor recording(4);
+  Eigen::MatrixXd T(n, 12);
+  se3::vec2tranBatch(common::ExecutionPolicy(recording),
+                     Eigen::MatrixXd(xi.transpose()).data(), T.data(), n);
+  EXPECT_EQ(recording.numTasks().size(), 1u);
+  EXPECT_THROW(se3::composeBatch(common::ExecutionPolicy(recording), T.data(),
+                                 nullptr, T.data(), n),
+               std::invalid_argument);
+  EXPECT_EQ(recording.numTasks().size(), 1u);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,219 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// \file PoseArrayTests.cpp
+/// \brief Unit tests for the structure of arrays containers of
+/// transformations.
+///
+/// \author ASRL
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include <lgmath.hpp>
+#include <lgmath/CommonMath.hpp>
+#include <lgmath/se3/PoseArray.hpp>
+#include <lgmath/se3/PoseCovArray.hpp>
+
+#include "TestHelpers.hpp"
+
+using namespace lgmath;
+
+namespace {
+
+typedef Eigen::Matrix<double, 6, 6> Matrix6d;
+
+/** \brief Number of test elements, not a multiple of a cache line */
+const std::size_t N = 37;
+
+/** \brief Random transformations */
+std::vector<se3::Transformation> testTransformations() {
+  std::vector<se3::Transformation> poses;
+  for (std::size_t i = 0; i < N; ++i) {
+    poses.emplace_back(Eigen::Matrix<double, 6, 1>(
+        3.0 * Eigen::Matrix<double, 6, 1>::Random()));
+  }
+  return poses;
+}
+
+/** \brief Random transformations with random covariances */
+std::vector<se3::TransformationWithCovariance> testTransformationsWithCov() {
+  std::vector<se3::TransformationWithCovariance> poses;
+  for (const auto& T : testTransformations()) {
+    poses.emplace_back(T, test::randomCovariance());
+  }
+  return poses;
+}
+
+}  // namespace
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+///
+/// UNIT TESTS OF POSE ARRAYS
+///
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the conversions, element access and layout
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, PoseArrayConversions) {
+  const std::vector<se3::Transformation> poses = testTransformations();
+  se3::PoseArray array(poses);
+  ASSERT_EQ(array.size(), N);
+  EXPECT_EQ(array.stride() % 8, 0u);
+  EXPECT_GE(array.stride(), N);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(array.data()) % 64, 0u);
+
+  // Row k of element i, as in the batch layout
+  const std::vector<se3::Transformation> copies = array.transformations();
+  for (std::size_t i = 0; i < N; ++i) {
+    EXPECT_EQ(array[i].matrix(), poses[i].matrix());
+    EXPECT_EQ(copies[i].matrix(), poses[i].matrix());
+    EXPECT_EQ(array.data()[7 * array.stride() + i], poses[i].r_ab_inb()(1));
+  }
+  EXPECT_THROW(array.at(N), std::out_of_range);
+
+  // Resizing keeps the first elements and adds identities
+  array.set(2, se3::Transformation());
+  array.resize(N + 20);
+  EXPECT_EQ(array.size(), N + 20);
+  EXPECT_EQ(array[0].matrix(), poses[0].matrix());
+  EXPECT_EQ(array[2].matrix(), Eigen::Matrix4d::Identity());
+  EXPECT_EQ(array[N + 19].matrix(), Eigen::Matrix4d::Identity());
+  array.resize(3);
+  EXPECT_EQ(array[1].matrix(), poses[1].matrix());
+  array.resize(5);
+  EXPECT_EQ(array[4].matrix(), Eigen::Matrix4d::Identity());
+  EXPECT_TRUE(se3::PoseArray().empty());
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the batch operations against Transformation
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, PoseArrayOperations) {
+  const std::vector<se3::Transformation> lhs = testTransformations();
+  const std::vector<se3::Transformation> rhs = testTransformations();
+  const se3::PoseArray lhs_array(lhs), rhs_array(rhs);
+  const se3::PoseArray::Matrix6Xd v = se3::PoseArray::Matrix6Xd::Random(6, N);
+  const Eigen::Matrix3Xd p = Eigen::Matrix3Xd::Random(3, N);
+
+  const se3::PoseArray composed = lhs_array * rhs_array;
+  se3::PoseArray inPlace = lhs_array;
+  inPlace *= rhs_array;
+  const se3::PoseArray inverse = lhs_array.inverse();
+  const se3::PoseArray::Matrix6Xd xi = lhs_array.vec();
+  const se3::PoseArray exp(xi);
+  const se3::PoseArray::Matrix6Xd Ad_v = lhs_array.applyAdjoint(v);
+  const Eigen::Matrix3Xd p_b = lhs_array.transformPoints(p);
+
+  for (std::size_t i = 0; i < N; ++i) {
+    // The batch operations do not reproject
+    const Eigen::Matrix4d T_ref = lhs[i].matrix() * rhs[i].matrix();
+    EXPECT_TRUE(common::nearEqual(composed[i].matrix(), T_ref, 1e-12));
+    EXPECT_TRUE(common::nearEqual(inPlace[i].matrix(), T_ref, 1e-12));
+    EXPECT_TRUE(common::nearEqual(inverse[i].matrix(),
+                                  lhs[i].matrix().inverse(), 1e-12));
+    EXPECT_TRUE(common::nearEqual(xi.col(i), lhs[i].vec(), 1e-9));
+    EXPECT_TRUE(common::nearEqual(exp[i].matrix(), lhs[i].matrix(), 1e-9));
+    EXPECT_TRUE(common::nearEqual(Ad_v.col(i), lhs[i].adjoint() * v.col(i),
+                                  1e-12));
+    EXPECT_TRUE(common::nearEqual(
+        p_b.col(i), lhs[i].C_ba() * p.col(i) + lhs[i].r_ab_inb(), 1e-12));
+  }
+
+  EXPECT_THROW(lhs_array * se3::PoseArray(N - 1), std::invalid_argument);
+  EXPECT_THROW(lhs_array.transformPoints(Eigen::Matrix3Xd(3, N + 1)),
+               std::invalid_argument);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+///
+/// UNIT TESTS OF POSE ARRAYS WITH COVARIANCE
+///
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the conversions and element access
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, PoseCovArrayConversions) {
+  const std::vector<se3::TransformationWithCovariance> poses =
+      testTransformationsWithCov();
+  se3::PoseCovArray array(poses);
+  ASSERT_EQ(array.size(), N);
+  EXPECT_EQ(array.covarianceData(), array.data() + 12 * array.stride());
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(array.covarianceData()) % 64, 0u);
+
+  const std::vector<se3::TransformationWithCovariance> copies =
+      array.transformations();
+  for (std::size_t i = 0; i < N; ++i) {
+    EXPECT_EQ(array[i].matrix(), poses[i].matrix());
+    EXPECT_TRUE(common::nearEqual(array[i].cov(), poses[i].cov(), 1e-15));
+    EXPECT_TRUE(common::nearEqual(copies[i].cov(), poses[i].cov(), 1e-15));
+  }
+  EXPECT_THROW(array.at(N), std::out_of_range);
+
+  // New elements have zero covariances, and unset covariances are rejected
+  array.resize(N + 1);
+  EXPECT_EQ(array.cov(N), Matrix6d::Zero());
+  EXPECT_EQ(array.cov(0), poses[0].cov());
+  EXPECT_THROW(array.set(0, se3::TransformationWithCovariance()),
+               std::logic_error);
+
+  // One covariance for all poses
+  const std::vector<se3::Transformation> shared_poses = testTransformations();
+  const se3::PoseCovArray shared(se3::PoseArray(shared_poses),
+                                 Matrix6d::Identity());
+  EXPECT_EQ(shared.cov(N - 1), Matrix6d::Identity());
+  EXPECT_EQ(shared[N - 1].matrix(), shared_poses[N - 1].matrix());
+
+  // The poses alone are copied out, as the operations of a PoseArray would
+  // leave the covariances stale
+  static_assert(
+      !std::is_convertible<se3::PoseCovArray*, se3::PoseArray*>::value,
+      "PoseCovArray must not be usable as a PoseArray");
+  const se3::PoseArray copied = shared.poses();
+  ASSERT_EQ(copied.size(), N);
+  EXPECT_EQ(copied[N - 1].matrix(), shared_poses[N - 1].matrix());
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the covariance propagation against TransformationWithCovariance
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, PoseCovArrayOperations) {
+  const std::vector<se3::TransformationWithCovariance> lhs =
+      testTransformationsWithCov();
+  const std::vector<se3::TransformationWithCovariance> rhs =
+      testTransformationsWithCov();
+  const se3::PoseCovArray lhs_array(lhs), rhs_array(rhs);
+
+  const se3::PoseCovArray composed = lhs_array * rhs_array;
+  se3::PoseCovArray inPlace = lhs_array;
+  inPlace *= rhs_array;
+  const se3::PoseCovArray inverse = lhs_array.inverse();
+
+  for (std::size_t i = 0; i < N; ++i) {
+    // The covariances of TransformationWithCovariance, without reprojection
+    const Matrix6d Ad = lhs[i].adjoint();
+    const Matrix6d cov_ref = lhs[i].cov() + Ad * rhs[i].cov() * Ad.transpose();
+    const Eigen::Matrix4d T_ref = lhs[i].matrix() * rhs[i].matrix();
+    EXPECT_TRUE(common::nearEqual(composed[i].matrix(), T_ref, 1e-12));
+    EXPECT_TRUE(common::nearEqual(composed.cov(i), cov_ref, 1e-10));
+    EXPECT_TRUE(common::nearEqual(inPlace.cov(i), cov_ref, 1e-10));
+
+    const Eigen::Matrix4d T_inv = lhs[i].matrix().inverse();
+    const Matrix6d Ad_inv = se3::tranAd(T_inv);
+    EXPECT_TRUE(common::nearEqual(inverse[i].matrix(), T_inv, 1e-12));
+    EXPECT_TRUE(common::nearEqual(
+        inverse.cov(i), Ad_inv * lhs[i].cov() * Ad_inv.transpose(), 1e-10));
+  }
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -368,6 +368,42 @@ TEST(LGMath, TestIdentityAdTvEqualIPlusCurlyHatvTimesJv) {
   }
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the matrix-free Jacobian and curlyhat products against the
+/// dense matrices
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, TestMatrixFreeJacobianProducts) {
+  typedef Eigen::Matrix<double, 6, 1> Vector6d;
+  std::vector<Vector6d> trueVecs;
+  Vector6d temp;
+  temp << 1.0, 2.0, 3.0, 0.0, 0.0, 0.0;
+  trueVecs.push_back(temp);
+  temp << 1.0, 2.0, 3.0, 1e-13, 0.0, 0.0;
+  trueVecs.push_back(temp);
+  temp << 1.0, 2.0, 3.0, 0.0, 0.0, lgmath::constants::PI;
+  trueVecs.push_back(temp);
+  temp << -1.0, 0.5, 2.0, 0.0, 0.5 * lgmath::constants::PI, 0.0;
+  trueVecs.push_back(temp);
+  for (unsigned i = 0; i < 20; i++) {
+    trueVecs.push_back(Vector6d::Random());
+  }
+
+  for (const Vector6d& xi : trueVecs) {
+    const Vector6d v = Vector6d::Random();
+    EXPECT_TRUE(lgmath::common::nearEqual(lgmath::se3::curlyhat(xi) * v,
+                                          lgmath::se3::applyCurlyhat(xi, v),
+                                          1e-12));
+    EXPECT_TRUE(lgmath::common::nearEqual(lgmath::se3::vec2jac(xi) * v,
+                                          lgmath::se3::applyJac(xi, v), 1e-12));
+    EXPECT_TRUE(lgmath::common::nearEqual(
+        lgmath::se3::vec2jac(xi).transpose() * v,
+        lgmath::se3::applyJacTranspose(xi, v), 1e-12));
+    EXPECT_TRUE(lgmath::common::nearEqual(lgmath::se3::vec2jacinv(xi) * v,
+                                          lgmath::se3::applyJacInv(xi, v),
+                                          1e-12));
+  }
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,129 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// \file SamplingTests.cpp
+/// \brief Unit tests for drawing poses from a TransformationWithCovariance.
+///
+/// \author ASRL
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include <lgmath.hpp>
+#include <lgmath/CommonMath.hpp>
+#include <lgmath/Parallel.hpp>
+#include <lgmath/se3/Sampling.hpp>
+
+#include "TestHelpers.hpp"
+
+using namespace lgmath;
+
+namespace {
+
+typedef Eigen::Matrix<double, 6, 1> Vector6d;
+typedef Eigen::Matrix<double, 6, 6> Matrix6d;
+
+/** \brief A mean pose with a correlated covariance */
+se3::TransformationWithCovariance testPose() {
+  const Matrix6d cov = test::randomCovariance(0.1, 1e-4);
+  return se3::TransformationWithCovariance(
+      se3::Transformation(Vector6d(Vector6d::Random())), cov);
+}
+
+}  // namespace
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+///
+/// UNIT TESTS OF THE SAMPLE STATISTICS
+///
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST(LGMath, SampleStatistics) {
+  const se3::TransformationWithCovariance T = testPose();
+  const std::size_t K = 100000;
+  se3::PoseArray samples(K);
+  std::mt19937_64 rng(42);
+  se3::sample(T, K, rng, samples.data(), samples.stride());
+
+  // The left perturbations log(T_k * T^-1) have zero mean and covariance cov()
+  Vector6d mean = Vector6d::Zero();
+  Matrix6d cov = Matrix6d::Zero();
+  for (std::size_t i = 0; i < K; ++i) {
+    const Vector6d xi = (samples[i] / T).vec();
+    mean += xi;
+    cov += xi * xi.transpose();
+  }
+  mean /= double(K);
+  cov /= double(K);
+  const Vector6d sigma = T.cov().diagonal().cwiseSqrt();
+  for (int k = 0; k < 6; ++k) {
+    EXPECT_LT(std::abs(mean(k)), 5.0 * sigma(k) / std::sqrt(double(K)));
+  }
+  EXPECT_LT((cov - T.cov()).norm(), 0.03 * T.cov().norm());
+
+  // A semi-definite covariance leaves some directions unperturbed
+  Matrix6d singular = Matrix6d::Zero();
+  singular(0, 0) = singular(5, 5) = 0.01;
+  singular(0, 5) = singular(5, 0) = 0.01;
+  se3::sample(se3::TransformationWithCovariance(T, singular), 1000, rng,
+              samples.data(), samples.stride());
+  for (std::size_t i = 0; i < 1000; ++i) {
+    const Vector6d xi = (samples[i] / T).vec();
+    EXPECT_NEAR(xi(0), xi(5), 1e-9);
+    EXPECT_NEAR(xi.segment<4>(1).norm(), 0.0, 1e-9);
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+///
+/// UNIT TESTS OF THE PARALLEL SAMPLING
+///
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST(LGMath, SampleDeterminism) {
+  const se3::TransformationWithCovariance T = testPose();
+  const std::size_t K = 10007, stride = K + 5;
+  std::vector<double> expected(se3::BATCH_POSE_ROWS * stride);
+  se3::sample(common::ExecutionPolicy::sequential(), T, K, 7, expected.data(),
+              stride);
+
+  // The same samples on any number of threads
+  for (std::size_t numThreads : {1, 2, 4, 8}) {
+    common::ThreadPool pool(numThreads);
+    const common::ExecutionPolicy policy(pool, common::Chunking::DYNAMIC, 1);
+    std::vector<double> samples(expected.size());
+    se3::sample(policy, T, K, 7, samples.data(), stride);
+    for (std::size_t k = 0; k < se3::BATCH_POSE_ROWS; ++k) {
+      for (std::size_t i = 0; i < K; ++i) {
+        ASSERT_EQ(samples[k * stride + i], expected[k * stride + i]);
+      }
+    }
+  }
+
+  // Other seeds give other samples
+  std::vector<double> other(expected.size());
+  se3::sample(common::ExecutionPolicy::sequential(), T, K, 8, other.data(),
+              stride);
+  EXPECT_NE(other[0], expected[0]);
+
+  std::mt19937_64 rng;
+  se3::TransformationWithCovariance noCovariance(T.matrix());
+  EXPECT_THROW(se3::sample(noCovariance, K, rng, other.data()),
+               std::logic_error);
+  EXPECT_THROW(se3::sample(se3::TransformationWithCovariance(
+                               T, Matrix6d(-Matrix6d::Identity())),
+                           K, rng, other.data()),
+               std::invalid_argument);
+  EXPECT_THROW(se3::sample(T, K, rng, nullptr), std::invalid_argument);
+  EXPECT_THROW(se3::sample(T, K, rng, other.data(), K - 1),
+               std::invalid_argument);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,199 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// \file SplineTests.cpp
+/// \brief Unit tests for the cumulative cubic B-spline trajectories on SE3.
+///
+/// \author ASRL
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include <lgmath.hpp>
+#include <lgmath/CommonMath.hpp>
+#include <lgmath/Dispatch.hpp>
+#include <lgmath/Parallel.hpp>
+#include <lgmath/se3/Spline.hpp>
+
+#include "TestHelpers.hpp"
+
+using namespace lgmath;
+
+namespace {
+
+typedef Eigen::Matrix<double, 6, 1> Vector6d;
+
+/** \brief Start time and time between control poses */
+const double T0 = 5.0, DT = 0.2;
+
+/** \brief A random walk of control poses */
+se3::Spline randomSpline(std::size_t numControlPoses) {
+  std::vector<se3::Transformation> controlPoses;
+  se3::Transformation T(Vector6d(Vector6d::Random()));
+  for (std::size_t k = 0; k < numControlPoses; ++k) {
+    controlPoses.push_back(T);
+    T = se3::Transformation(Vector6d(0.4 * Vector6d::Random())) * T;
+  }
+  return se3::Spline(T0, DT, controlPoses);
+}
+
+/**
+ * \brief The central difference (T_plus - T_minus) * T^-1 of the poses around
+ * T, taken out of the algebra; unlike logarithms of nearby poses, it does not
+ * round rotations below 1e-9 rad to zero
+ */
+Vector6d difference(const se3::Transformation& T_plus,
+                    const se3::Transformation& T_minus,
+                    const se3::Transformation& T) {
+  const Eigen::Matrix4d D =
+      (T_plus.matrix() - T_minus.matrix()) * T.inverse().matrix();
+  Vector6d xi;
+  xi << D.block<3, 1>(0, 3), 0.5 * (D(2, 1) - D(1, 2)),
+      0.5 * (D(0, 2) - D(2, 0)), 0.5 * (D(1, 0) - D(0, 1));
+  return xi;
+}
+
+}  // namespace
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+///
+/// UNIT TESTS OF SPLINE
+///
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test that control poses on a constant velocity give it back
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, SplineConstantVelocity) {
+  const Vector6d varpi =
+      (Vector6d() << 3.0, -0.5, 0.2, 0.3, -0.1, 1.2).finished();
+  const se3::Transformation T_0(Vector6d(Vector6d::Random()));
+  se3::Spline spline(T0, DT);
+  for (int k = 0; k < 8; ++k) {
+    if (k < 4) {
+      EXPECT_THROW(spline.pose(T0), std::logic_error);
+    }
+    spline.addControlPose(se3::Transformation(Vector6d(k * DT * varpi)) * T_0);
+  }
+  EXPECT_EQ(spline.numControlPoses(), 8u);
+  EXPECT_DOUBLE_EQ(spline.startTime(), T0);
+  EXPECT_DOUBLE_EQ(spline.endTime(), T0 + 5 * DT);
+  EXPECT_DOUBLE_EQ(spline.knotSpacing(), DT);
+
+  // The cumulative basis functions sum to 1 + u, so that the pose at t is
+  // exp((t - t0 + dt) * varpi) * T_0
+  for (double t = T0; t <= spline.endTime(); t += 0.037) {
+    const se3::Transformation T =
+        se3::Transformation(Vector6d((t - T0 + DT) * varpi)) * T_0;
+    EXPECT_TRUE(common::nearEqual(spline.pose(t).matrix(), T.matrix(), 1e-9));
+    EXPECT_TRUE(common::nearEqual(spline.velocity(t), varpi, 1e-9));
+    EXPECT_TRUE(
+        common::nearEqual(spline.acceleration(t), Vector6d::Zero(), 1e-9));
+  }
+  EXPECT_NO_THROW(spline.pose(spline.endTime()));
+  EXPECT_THROW(spline.pose(T0 - 1e-9), std::out_of_range);
+  EXPECT_THROW(spline.velocity(spline.endTime() + 1e-9), std::out_of_range);
+  EXPECT_THROW(spline.controlPose(8), std::out_of_range);
+  EXPECT_THROW(se3::Spline(T0, 0.0), std::invalid_argument);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the velocity, acceleration and Jacobians numerically
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, SplineDerivatives) {
+  const se3::Spline spline = randomSpline(9);
+  const double h = 1e-5;
+  for (double t = T0 + 0.01; t < spline.endTime() - 0.01; t += 0.061) {
+    SCOPED_TRACE(t);
+    // dT/dt = varpi^ * T
+    const Vector6d varpi =
+        difference(spline.pose(t + h), spline.pose(t - h), spline.pose(t)) /
+        (2.0 * h);
+    EXPECT_TRUE(common::nearEqual(spline.velocity(t), varpi, 1e-6));
+    const Vector6d acceleration =
+        (spline.velocity(t + h) - spline.velocity(t - h)) / (2.0 * h);
+    EXPECT_TRUE(common::nearEqual(spline.acceleration(t), acceleration, 1e-5));
+
+    // Left perturbations of each of the 4 control poses of the segment
+    Eigen::Matrix<double, 6, 24> jacobians;
+    std::size_t first;
+    const se3::Transformation T = spline.pose(t, &jacobians, &first);
+    EXPECT_TRUE(common::nearEqual(T.matrix(), spline.pose(t).matrix(), 1e-12));
+    EXPECT_EQ(first, static_cast<std::size_t>((t - T0) / DT));
+    Eigen::Matrix<double, 6, 24> numerical;
+    for (std::size_t k = 0; k < 4; ++k) {
+      for (int e = 0; e < 6; ++e) {
+        const se3::Transformation T_k = spline.controlPose(first + k);
+        const Vector6d delta = h * Vector6d::Unit(e);
+        se3::Spline plus = spline, minus = spline;
+        plus.setControlPose(first + k, se3::Transformation(delta) * T_k);
+        minus.setControlPose(first + k,
+                             se3::Transformation(Vector6d(-delta)) * T_k);
+        numerical.col(6 * k + e) =
+            difference(plus.pose(t), minus.pose(t), T) / (2.0 * h);
+      }
+    }
+    EXPECT_TRUE(common::nearEqual(jacobians, numerical, 1e-6));
+
+    // Moving every control pose by the same perturbation moves the pose by it
+    const Eigen::Matrix<double, 6, 6> sum =
+        jacobians.middleCols<6>(0) + jacobians.middleCols<6>(6) +
+        jacobians.middleCols<6>(12) + jacobians.middleCols<6>(18);
+    EXPECT_TRUE(common::nearEqual(
+        sum, Eigen::Matrix<double, 6, 6>::Identity().eval(), 1e-9));
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the batch poses against the single poses
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, SplineBatch) {
+  const se3::Spline spline = randomSpline(20);
+  const std::size_t n = 2003;
+  const Eigen::VectorXd t =
+      Eigen::VectorXd::LinSpaced(n, spline.startTime(), spline.endTime());
+  std::vector<se3::Transformation> reference;
+  for (std::size_t i = 0; i < n; ++i) {
+    reference.push_back(spline.pose(t(i)));
+  }
+
+  // In time order, in reverse order, with a stride and on a thread pool, on
+  // every instruction set
+  const Eigen::VectorXd t_reversed = t.reverse();
+  const std::size_t stride = n + 5;
+  const common::Isa active = common::activeIsa();
+  common::ThreadPool pool(4);
+  for (common::Isa isa : common::supportedIsas()) {
+    SCOPED_TRACE(common::isaName(isa));
+    common::setIsa(isa);
+    const se3::PoseArray sorted = spline.poses(t);
+    const se3::PoseArray reversed = spline.poses(t_reversed);
+    std::vector<double> rows(se3::BATCH_POSE_ROWS * stride);
+    spline.poses(common::ExecutionPolicy(pool, common::Chunking::DYNAMIC, 64),
+                 t.data(), rows.data(), n, stride);
+    ASSERT_EQ(sorted.size(), n);
+    for (std::size_t i = 0; i < n; ++i) {
+      const Eigen::Matrix4d& T = reference[i].matrix();
+      EXPECT_TRUE(common::nearEqual(sorted[i].matrix(), T, 1e-12)) << i;
+      EXPECT_TRUE(common::nearEqual(reversed[n - 1 - i].matrix(), T, 1e-12));
+      EXPECT_TRUE(common::nearEqual(test::batchPose(rows.data(), i, stride),
+                                    T, 1e-12));
+    }
+  }
+  common::setIsa(active);
+
+  EXPECT_THROW(spline.poses(Eigen::VectorXd::Constant(3, T0 - 1.0)),
+               std::out_of_range);
+  EXPECT_THROW(spline.poses(t.data(), nullptr, n), std::invalid_argument);
+  std::vector<double> rows(se3::BATCH_POSE_ROWS * n);
+  EXPECT_THROW(spline.poses(t.data(), rows.data(), n, n - 1),
+               std::invalid_argument);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,50 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// \file TestHelpers.hpp
+/// \brief Helpers shared by the unit tests: random covariances, and the poses
+/// of rows in the batch layout of se3/Batch.hpp.
+///
+/// \author ASRL
+//////////////////////////////////////////////////////////////////////////////////////////////
+#pragma once
+
+#include <cstddef>
+
+#include <Eigen/Core>
+
+#include <lgmath/se3/Batch.hpp>
+
+namespace lgmath {
+namespace test {
+
+/**
+ * \brief A random covariance A * A^T + floor * 1, with the entries of A
+ * uniform in [-scale, scale]
+ */
+template <int N = 6>
+Eigen::Matrix<double, N, N> randomCovariance(double scale = 1.0,
+                                             double floor = 0.0) {
+  const Eigen::Matrix<double, N, N> A =
+      scale * Eigen::Matrix<double, N, N>::Random();
+  return A * A.transpose() + floor * Eigen::Matrix<double, N, N>::Identity();
+}
+
+/** \brief Gets pose i of rows in the batch layout, with a stride */
+inline Eigen::Matrix4d batchPose(const double* T, std::size_t i,
+                                 std::size_t stride) {
+  Eigen::Matrix4d T_ba = Eigen::Matrix4d::Identity();
+  for (std::size_t k = 0; k < se3::BATCH_POSE_ROWS; ++k) {
+    T_ba(k / 4, k % 4) = T[k * stride + i];
+  }
+  return T_ba;
+}
+
+/** \brief Sets pose i of rows in the batch layout, with a stride */
+inline void setBatchPose(const Eigen::Matrix4d& T_ba, std::size_t i,
+                         std::size_t stride, double* T) {
+  for (std::size_t k = 0; k < se3::BATCH_POSE_ROWS; ++k) {
+    T[k * stride + i] = T_ba(k / 4, k % 4);
+  }
+}
+
+}  // namespace test
+}  // namespace lgmath
@@ -0,0 +1,182 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// \file TraceTests.cpp
+/// \brief Unit tests for the tracing of lgmath batch operations.
+///
+/// \author ASRL
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <lgmath.hpp>
+#include <lgmath/Trace.hpp>
+
+using namespace lgmath;
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+///
+/// UNIT TESTS OF THE TRACING
+///
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/** \brief Counts the occurrences of a substring */
+std::size_t occurrences(const std::string& text, const std::string& pattern) {
+  std::size_t count = 0;
+  for (std::size_t pos = text.find(pattern); pos != std::string::npos;
+       pos = text.find(pattern, pos + pattern.size())) {
+    ++count;
+  }
+  return count;
+}
+
+}  // namespace
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test that nothing is recorded while tracing is disabled
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, TraceDisabled) {
+  common::setTracingEnabled(false);
+  common::clearTrace();
+  EXPECT_FALSE(common::tracingEnabled());
+  for (int i = 0; i < 10; ++i) {
+    LGMATH_TRACE_SCOPE("test/disabled");
+  }
+  EXPECT_EQ(common::traceEventCount(), 0u);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the exported events of several threads
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, TraceChromeExport) {
+  common::clearTrace();
+  common::setTracingEnabled(true);
+  const unsigned numThreads = 3;
+  const unsigned N = 10;
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < numThreads; ++t) {
+    threads.emplace_back([t]() {
+      common::setTraceThreadName("worker \"" + std::to_string(t) + "\"");
+      for (unsigned i = 0; i < N; ++i) {
+        LGMATH_TRACE_SCOPE("test/outer", 42);
+        LGMATH_TRACE_SCOPE("test/inner");
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  common::setTracingEnabled(false);
+  EXPECT_EQ(common::traceEventCount(), 2 * numThreads * N);
+
+  std::stringstream out;
+  common::writeChromeTrace(out);
+  const std::string json = out.str();
+  EXPECT_EQ(json.find("{\"traceEvents\":["), 0u);
+  EXPECT_NE(json.find("],\"displayTimeUnit\":\"ns\"}"), std::string::npos);
+  EXPECT_EQ(occurrences(json, "\"name\":\"test/outer\""), numThreads * N);
+  EXPECT_EQ(occurrences(json, "\"name\":\"test/inner\""), numThreads * N);
+  EXPECT_EQ(occurrences(json, "\"args\":{\"count\":42}"), numThreads * N);
+  EXPECT_EQ(occurrences(json, "\"ph\":\"M\""), numThreads);
+  EXPECT_NE(json.find("\"name\":\"worker \\\"0\\\"\""), std::string::npos);
+  EXPECT_EQ(json.find("\"ts\":-"), std::string::npos);
+
+  common::clearTrace();
+  EXPECT_EQ(common::traceEventCount(), 0u);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test that only traced threads allocate a ring buffer, and that
+/// clearTrace() frees those of the exited threads after their export
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, TraceThreadBuffers) {
+  common::setTracingEnabled(false);
+  common::clearTrace();
+  const std::size_t bytes = common::traceBufferBytes();
+  const unsigned numThreads = 4;
+  const unsigned N = 10;
+  const auto run = [](const char* name) {
+    common::setTraceThreadName(name);
+    for (unsigned i = 0; i < N; ++i) {
+      LGMATH_TRACE_SCOPE("test/sequential");
+    }
+  };
+  for (unsigned t = 0; t < numThreads; ++t) {
+    std::thread(run, "untraced").join();
+  }
+  EXPECT_EQ(common::traceBufferBytes(), bytes);
+
+  common::setTracingEnabled(true);
+  for (unsigned t = 0; t < numThreads; ++t) {
+    std::thread(run, "traced").join();
+  }
+  common::setTracingEnabled(false);
+  EXPECT_EQ(common::traceEventCount(), numThreads * N);
+  EXPECT_EQ(common::traceBufferBytes(),
+            bytes + numThreads * common::TRACE_BUFFER_CAPACITY *
+                        sizeof(common::TraceEvent));
+
+  std::stringstream out;
+  common::writeChromeTrace(out);
+  EXPECT_EQ(occurrences(out.str(), "\"name\":\"test/sequential\""),
+            numThreads * N);
+  EXPECT_EQ(occurrences(out.str(), "\"name\":\"traced\""), numThreads);
+
+  common::clearTrace();
+  EXPECT_EQ(common::traceBufferBytes(), bytes);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test that the ring buffer keeps the most recent events
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, TraceRingBuffer) {
+  common::clearTrace();
+  common::setTracingEnabled(true);
+  const std::size_t extra = 10;
+  for (std::size_t i = 0; i < common::TRACE_BUFFER_CAPACITY + extra; ++i) {
+    LGMATH_TRACE_SCOPE("test/ring", i + 1);
+  }
+  common::setTracingEnabled(false);
+  EXPECT_EQ(common::traceEventCount(), common::TRACE_BUFFER_CAPACITY);
+  EXPECT_EQ(common::traceEventsDropped(), extra);
+
+  std::stringstream out;
+  common::writeChromeTrace(out);
+  EXPECT_EQ(out.str().find("\"count\":10}"), std::string::npos);
+  EXPECT_NE(out.str().find("\"count\":11}"), std::string::npos);
+  common::clearTrace();
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test that library operations are traced
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, TraceLibraryScopes) {
+  common::clearTrace();
+  common::setTracingEnabled(true);
+  std::stringstream stream;
+  {
+    io::TrajectoryEncoder encoder(stream);
+    for (int i = 0; i < 10; ++i) {
+      Eigen::Matrix<double, 6, 1> xi = Eigen::Matrix<double, 6, 1>::Zero();
+      xi(0) = 0.1 * i;
+      encoder.push(se3::Transformation(xi));
+    }
+  }
+  common::setTracingEnabled(false);
+
+  std::stringstream out;
+  common::writeChromeTrace(out);
+  EXPECT_NE(out.str().find("\"name\":\"io/TrajectoryEncoder/flushBlock\""),
+            std::string::npos);
+  common::clearTrace();
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,219 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// \file TrajectoryCodecTests.cpp
+/// \brief Unit tests for the Lie-algebra delta trajectory codec.
+///
+/// \author ASRL
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include <lgmath/io/TrajectoryCodec.hpp>
+#include <lgmath/se3/Transformation.hpp>
+
+using namespace lgmath;
+
+namespace {
+
+/** \brief Smooth trajectory, integrated from a slowly varying velocity */
+std::vector<se3::Transformation> smoothTrajectory(unsigned N) {
+  std::vector<se3::Transformation> poses;
+  Eigen::Matrix<double, 6, 1> xi = Eigen::Matrix<double, 6, 1>::Random();
+  se3::Transformation T(xi);
+  for (unsigned i = 0; i < N; i++) {
+    // 10 m/s forward, turning slowly, at 100 Hz
+    Eigen::Matrix<double, 6, 1> increment;
+    increment << 0.1, 0.0, 0.0, 0.0, 0.0, 0.01 * std::sin(0.01 * i);
+    Eigen::Matrix<double, 6, 1> noise = Eigen::Matrix<double, 6, 1>::Random();
+    T = se3::Transformation(Eigen::Matrix<double, 6, 1>(
+            increment + 1e-3 * noise)) *
+        T;
+    poses.push_back(T);
+  }
+  return poses;
+}
+
+/** \brief Translational and rotational error of T_test with respect to T */
+Eigen::Vector2d error(const se3::Transformation& T_test,
+                      const se3::Transformation& T) {
+  Eigen::Matrix<double, 6, 1> xi = (T_test / T).vec();
+  return Eigen::Vector2d(xi.head<3>().norm(), xi.tail<3>().norm());
+}
+
+}  // namespace
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+///
+/// UNIT TESTS OF THE TRAJECTORY CODEC
+///
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test that the reconstruction error is bounded by the tolerances
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, TrajectoryCodecRoundTrip) {
+  const unsigned N = 5000;
+  std::vector<se3::Transformation> poses = smoothTrajectory(N);
+
+  io::TrajectoryCodecOptions options;
+  options.translationTolerance = 1e-4;
+  options.rotationTolerance = 1e-5;
+  options.keyframeInterval = 128;
+
+  std::stringstream stream;
+  io::TrajectoryCodecStats stats;
+  {
+    io::TrajectoryEncoder encoder(stream, options);
+    for (const auto& T : poses) {
+      encoder.push(T);
+    }
+    encoder.finish();
+    stats = encoder.stats();
+  }
+  EXPECT_EQ(stats.poses, N);
+  EXPECT_EQ(stats.rawBytes, N * 12 * sizeof(double));
+  EXPECT_EQ(stats.compressedBytes, stream.str().size());
+  std::cout << "compression ratio: " << stats.compressionRatio()
+            << ", max error: " << stats.maxTranslationError << " m, "
+            << stats.maxRotationError << " rad" << std::endl;
+  EXPECT_GT(stats.compressionRatio(), 4.0);
+
+  // Each component of the increment is within its tolerance, so the norms are
+  // within sqrt(3) of it, up to the Jacobian of the (small) increments
+  const double translationBound = 1.1 * std::sqrt(3.0) * 1e-4;
+  const double rotationBound = 1.1 * std::sqrt(3.0) * 1e-5;
+  EXPECT_LT(stats.maxTranslationError, translationBound);
+  EXPECT_LT(stats.maxRotationError, rotationBound);
+  EXPECT_LE(stats.rmsTranslationError(), stats.maxTranslationError);
+
+  io::TrajectoryDecoder decoder(stream);
+  EXPECT_EQ(decoder.options().keyframeInterval, 128u);
+  se3::Transformation T;
+  for (unsigned i = 0; i < N; i++) {
+    ASSERT_TRUE(decoder.next(&T));
+    Eigen::Vector2d e = error(T, poses[i]);
+    EXPECT_LT(e(0), translationBound);
+    EXPECT_LT(e(1), rotationBound);
+
+    // Keyframes are exact
+    if (i % options.keyframeInterval == 0) {
+      EXPECT_TRUE(T.matrix() == poses[i].matrix());
+    }
+  }
+  EXPECT_FALSE(decoder.next(&T));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test random access against the streaming decoder
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, TrajectoryCodecRandomAccess) {
+  const unsigned N = 1000;
+  std::vector<se3::Transformation> poses = smoothTrajectory(N);
+  io::TrajectoryCodecOptions options;
+  options.keyframeInterval = 64;
+
+  std::stringstream stream;
+  {
+    io::TrajectoryEncoder encoder(stream, options);
+    for (const auto& T : poses) {
+      encoder.push(T);
+    }
+    // finish() is called on destruction
+  }
+  const std::string bytes = stream.str();
+  io::CompressedTrajectory trajectory(
+      reinterpret_cast<const unsigned char*>(bytes.data()), bytes.size());
+  ASSERT_EQ(trajectory.size(), N);
+
+  io::TrajectoryDecoder decoder(stream);
+  se3::Transformation T;
+  for (unsigned i = 0; i < N; i++) {
+    ASSERT_TRUE(decoder.next(&T));
+    EXPECT_TRUE(trajectory.at(i).matrix() == T.matrix());
+  }
+  EXPECT_THROW(trajectory.at(N), std::out_of_range);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test that the error follows the tolerance, and large jumps survive
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, TrajectoryCodecTolerance) {
+  const unsigned N = 2000;
+  std::vector<se3::Transformation> poses = smoothTrajectory(N);
+
+  // Teleport in the middle of the trajectory
+  Eigen::Matrix<double, 6, 1> jump;
+  jump << 1000.0, -500.0, 20.0, 1.0, -2.0, 0.5;
+  for (unsigned i = N / 2; i < N; i++) {
+    poses[i] = se3::Transformation(jump) * poses[i];
+  }
+
+  double previousRatio = 0.0;
+  for (double tolerance : {1e-6, 1e-4, 1e-2}) {
+    io::TrajectoryCodecOptions options;
+    options.translationTolerance = tolerance;
+    options.rotationTolerance = 0.1 * tolerance;
+    std::stringstream stream;
+    io::TrajectoryEncoder encoder(stream, options);
+    for (const auto& T : poses) {
+      encoder.push(T);
+    }
+    encoder.finish();
+    // The jump is large, so its Jacobian loosens the bound
+    EXPECT_LT(encoder.stats().maxTranslationError,
+              2.0 * std::sqrt(3.0) * tolerance);
+    EXPECT_GT(encoder.stats().compressionRatio(), previousRatio);
+    previousRatio = encoder.stats().compressionRatio();
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test that bad options and streams are rejected
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, TrajectoryCodecErrors) {
+  std::stringstream stream;
+  io::TrajectoryCodecOptions options;
+  options.keyframeInterval = 0;
+  EXPECT_THROW(io::TrajectoryEncoder(stream, options), std::invalid_argument);
+  options.keyframeInterval = 10;
+  options.translationTolerance = 0.0;
+  EXPECT_THROW(io::TrajectoryEncoder(stream, options), std::invalid_argument);
+
+  // Not a compressed trajectory
+  std::stringstream empty;
+  EXPECT_THROW(io::TrajectoryDecoder decoder(empty), std::invalid_argument);
+
+  // Truncated stream
+  std::stringstream valid;
+  {
+    io::TrajectoryEncoder encoder(valid);
+    for (const auto& T : smoothTrajectory(50)) {
+      encoder.push(T);
+    }
+    encoder.finish();
+    EXPECT_THROW(encoder.push(se3::Transformation()), std::logic_error);
+  }
+  std::string bytes = valid.str();
+  bytes.resize(bytes.size() - 10);
+  EXPECT_THROW(
+      io::CompressedTrajectory(
+          reinterpret_cast<const unsigned char*>(bytes.data()), bytes.size()),
+      std::invalid_argument);
+  std::stringstream truncated(bytes);
+  io::TrajectoryDecoder decoder(truncated);
+  se3::Transformation T;
+  EXPECT_THROW(decoder.next(&T), std::invalid_argument);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
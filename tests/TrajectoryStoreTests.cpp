@@ -0,0 +1,199 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// \file TrajectoryStoreTests.cpp
+/// \brief Unit tests for the memory-mapped trajectory file.
+///
+/// \author ASRL
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include <lgmath/io/TrajectoryStore.hpp>
+#include <lgmath/se3/TransformationWithCovariance.hpp>
+
+#include "TestHelpers.hpp"
+
+using namespace lgmath;
+
+namespace {
+
+/** \brief Creates a unique, empty temporary file and removes it on exit */
+class TemporaryFile {
+ public:
+  TemporaryFile() {
+    char name[] = "/tmp/lgmath_trajectory_XXXXXX";
+    const int fd = mkstemp(name);
+    EXPECT_GE(fd, 0);
+    close(fd);
+    path_ = name;
+  }
+  ~TemporaryFile() { unlink(path_.c_str()); }
+  const std::string& path() const { return path_; }
+
+ private:
+  std::string path_;
+};
+
+/** \brief Random pose with a random covariance */
+se3::TransformationWithCovariance randomPose() {
+  Eigen::Matrix<double, 6, 1> xi = Eigen::Matrix<double, 6, 1>::Random();
+  return se3::TransformationWithCovariance(xi, test::randomCovariance());
+}
+
+}  // namespace
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+///
+/// UNIT TESTS OF THE TRAJECTORY STORE
+///
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test writing and reading back a trajectory
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, TrajectoryStoreRoundTrip) {
+  TemporaryFile file;
+  const unsigned N = 10000;
+  std::vector<se3::TransformationWithCovariance> poses;
+  {
+    io::TrajectoryWriter writer(file.path());
+    for (unsigned i = 0; i < N; i++) {
+      poses.push_back(randomPose());
+      writer.append(std::int64_t(10 * i), poses.back());
+    }
+    EXPECT_EQ(writer.size(), N);
+  }
+
+  io::TrajectoryReader reader(file.path());
+  ASSERT_EQ(reader.size(), N);
+  for (unsigned i = 0; i < N; i++) {
+    io::TrajectoryReader::Record record = reader[i];
+    EXPECT_EQ(record.timestamp, std::int64_t(10 * i));
+    EXPECT_TRUE(record.pose.matrix() == poses[i].matrix());
+    EXPECT_TRUE(record.pose.cov() == poses[i].cov());
+  }
+  EXPECT_THROW(reader.at(N), std::out_of_range);
+
+  // Iterators visit the records in order
+  unsigned count = 0;
+  for (const auto& record : reader) {
+    EXPECT_EQ(record.timestamp, std::int64_t(10 * count));
+    count++;
+  }
+  EXPECT_EQ(count, N);
+  EXPECT_EQ(reader.end() - reader.begin(), std::ptrdiff_t(N));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test lookup by timestamp
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, TrajectoryStoreLookup) {
+  TemporaryFile file;
+  const unsigned N = 1000;
+  {
+    io::TrajectoryWriter writer(file.path());
+    for (unsigned i = 0; i < N; i++) {
+      writer.append(std::int64_t(10 * i), randomPose());
+    }
+  }
+
+  io::TrajectoryReader reader(file.path());
+  for (unsigned i = 0; i < N; i++) {
+    auto it = reader.find(std::int64_t(10 * i));
+    ASSERT_TRUE(it != reader.end());
+    EXPECT_EQ(it.index(), i);
+    EXPECT_TRUE(reader.find(std::int64_t(10 * i + 5)) == reader.end());
+    EXPECT_EQ(reader.lowerBound(std::int64_t(10 * i) - 5).index(), i);
+  }
+  EXPECT_TRUE(reader.lowerBound(-100) == reader.begin());
+  EXPECT_TRUE(reader.lowerBound(std::int64_t(10 * N)) == reader.end());
+
+  // Matches the standard algorithm on the same iterators
+  auto it = std::lower_bound(
+      reader.begin(), reader.end(), std::int64_t(4321),
+      [](const io::TrajectoryReader::Record& record, std::int64_t t) {
+        return record.timestamp < t;
+      });
+  EXPECT_TRUE(it == reader.lowerBound(4321));
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test reopening a file for appending, and rejecting bad input
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, TrajectoryStoreAppend) {
+  TemporaryFile file;
+  {
+    io::TrajectoryWriter writer(file.path());
+    writer.append(1, randomPose());
+    writer.append(2, se3::Transformation());
+
+    // Timestamps must increase
+    EXPECT_THROW(writer.append(2, randomPose()), std::invalid_argument);
+
+    // Only a single writer at a time
+    EXPECT_THROW(io::TrajectoryWriter other(file.path()), std::runtime_error);
+  }
+  {
+    io::TrajectoryWriter writer(file.path());
+    EXPECT_EQ(writer.size(), 2u);
+    EXPECT_THROW(writer.append(2, randomPose()), std::invalid_argument);
+    writer.append(3, randomPose());
+  }
+
+  io::TrajectoryReader reader(file.path());
+  ASSERT_EQ(reader.size(), 3u);
+  EXPECT_TRUE(reader[0].pose.covarianceSet());
+  EXPECT_FALSE(reader[1].pose.covarianceSet());
+  EXPECT_EQ(reader[2].timestamp, 3);
+
+  // Not a trajectory file
+  TemporaryFile empty;
+  EXPECT_THROW(io::TrajectoryReader bad(empty.path()), std::runtime_error);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test a reader following a writer that appends concurrently
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, TrajectoryStoreConcurrentReader) {
+  TemporaryFile file;
+  const unsigned N = 50000;
+  io::TrajectoryWriter writer(file.path());
+  io::TrajectoryReader reader(file.path());
+  EXPECT_TRUE(reader.empty());
+
+  std::atomic<bool> done(false);
+  std::thread producer([&]() {
+    for (unsigned i = 0; i < N; i++) {
+      writer.append(std::int64_t(i), se3::Transformation());
+    }
+    done = true;
+  });
+
+  // Every record that becomes visible must be complete
+  std::size_t checked = 0;
+  while (!done || checked < N) {
+    const std::size_t size = reader.refresh();
+    for (; checked < size; checked++) {
+      ASSERT_EQ(reader[checked].timestamp, std::int64_t(checked));
+      ASSERT_TRUE(reader[checked].pose.matrix() == Eigen::Matrix4d::Identity());
+    }
+  }
+  producer.join();
+  EXPECT_EQ(reader.refresh(), N);
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
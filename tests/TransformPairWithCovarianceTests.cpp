@@ -0,0 +1,115 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// \file TransformPairWithCovarianceTests.cpp
+/// \brief Unit tests for two transformations with a joint covariance.
+///
+/// \author ASRL
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+#include <Eigen/Dense>
+
+#include <lgmath.hpp>
+#include <lgmath/CommonMath.hpp>
+#include <lgmath/se3/TransformationPairWithCovariance.hpp>
+
+#include "TestHelpers.hpp"
+
+using namespace lgmath;
+
+namespace {
+
+typedef Eigen::Matrix<double, 6, 1> Vector6d;
+typedef Eigen::Matrix<double, 6, 6> Matrix6d;
+typedef Eigen::Matrix<double, 6, 12> Matrix6x12d;
+typedef se3::TransformationPairWithCovariance::Matrix12d Matrix12d;
+
+/** \brief A random transformation */
+se3::Transformation testTransformation() {
+  return se3::Transformation(Vector6d(Vector6d::Random()));
+}
+
+/** \brief Whether two poses with covariance are close */
+bool nearEqual(const se3::TransformationWithCovariance& T1,
+               const se3::TransformationWithCovariance& T2) {
+  return common::nearEqual(T1.matrix(), T2.matrix(), 1e-9) &&
+         common::nearEqual(T1.cov(), T2.cov(), 1e-9 * T2.cov().norm());
+}
+
+}  // namespace
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+///
+/// UNIT TESTS OF THE JOINT COMPOUNDING
+///
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST(LGMath, TransformPairIndependent) {
+  // Without cross-covariance, the pair agrees with the independent
+  // compounding of TransformationWithCovariance
+  const se3::TransformationWithCovariance T1(
+      testTransformation(), test::randomCovariance(1.0, 1.0));
+  const se3::TransformationWithCovariance T2(
+      testTransformation(), test::randomCovariance(1.0, 1.0));
+  const se3::TransformationPairWithCovariance pair(T1, T2, Matrix6d::Zero());
+  EXPECT_TRUE(nearEqual(pair.first(), T1));
+  EXPECT_TRUE(nearEqual(pair.second(), T2));
+  EXPECT_TRUE(nearEqual(pair.compose(), T1 * T2));
+  EXPECT_TRUE(nearEqual(pair.relative(), T1 / T2));
+  EXPECT_TRUE(nearEqual(pair.inverse().first(), T1.inverse()));
+  EXPECT_TRUE(nearEqual(pair.inverse().second(), T2.inverse()));
+  EXPECT_TRUE(
+      common::nearEqual(pair.inverse().cov().topRightCorner<6, 6>(),
+                        Matrix6d(Matrix6d::Zero()), 1e-12));
+
+  EXPECT_THROW(se3::TransformationPairWithCovariance(
+                   se3::TransformationWithCovariance(testTransformation()), T2,
+                   Matrix6d::Zero()),
+               std::logic_error);
+}
+
+TEST(LGMath, TransformPairCorrelated) {
+  // Against the dense Jacobians of the perturbations
+  const se3::Transformation T1 = testTransformation();
+  const se3::Transformation T2 = testTransformation();
+  const Matrix12d cov = test::randomCovariance<12>(1.0, 1.0);
+  const se3::TransformationPairWithCovariance pair(T1, T2, cov);
+
+  Matrix6x12d J;
+  J << Matrix6d::Identity(), T1.adjoint();
+  EXPECT_TRUE(nearEqual(
+      pair.compose(),
+      se3::TransformationWithCovariance(T1 * T2, J * cov * J.transpose())));
+
+  J << Matrix6d::Identity(), -(T1 / T2).adjoint();
+  EXPECT_TRUE(nearEqual(
+      pair.relative(),
+      se3::TransformationWithCovariance(T1 / T2, J * cov * J.transpose())));
+
+  Matrix12d K = Matrix12d::Zero();
+  K.topLeftCorner<6, 6>() = -T1.inverse().adjoint();
+  K.bottomRightCorner<6, 6>() = -T2.inverse().adjoint();
+  const se3::TransformationPairWithCovariance inverse = pair.inverse();
+  EXPECT_TRUE(common::nearEqual(inverse.cov(), K * cov * K.transpose(),
+                                1e-9 * cov.norm()));
+  EXPECT_TRUE(common::nearEqual(inverse.first().matrix(),
+                                T1.inverse().matrix(), 1e-12));
+
+  // The relative pose of two fully correlated copies is certain
+  const Matrix6d S = test::randomCovariance(1.0, 1.0);
+  Matrix12d same;
+  same << S, S, S, S;
+  const se3::TransformationWithCovariance identity =
+      se3::TransformationPairWithCovariance(T1, T1, same).relative();
+  EXPECT_TRUE(common::nearEqual(identity.matrix(),
+                                Eigen::Matrix4d(Eigen::Matrix4d::Identity()),
+                                1e-12));
+  EXPECT_LT(identity.cov().norm(), 1e-9 * S.norm());
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
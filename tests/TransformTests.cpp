@@ -14,6 +14,7 @@
 #include <iomanip>
 #include <ios>
 #include <iostream>
+#include <type_traits>
 
 #include <Eigen/Dense>
 #include <lgmath/CommonMath.hpp>
@@ -76,6 +77,18 @@ TEST(LGMath, TransformationConstructors) {
         lgmath::common::nearEqual(proj_test.matrix(), test_bad.matrix(), 1e-6));
   }
 
+  // Transformation(const Eigen::Matrix4d& T, bool reproj);
+  {
+    lgmath::se3::Transformation test(rand.matrix(), false);
+    EXPECT_TRUE(rand.matrix() == test.matrix());
+
+    // Skipping the reprojection keeps the matrix as is
+    Eigen::Matrix4d notTransform = Eigen::Matrix4d::Identity();
+    notTransform.topLeftCorner<3, 3>() = Eigen::Matrix3d::Ones();
+    lgmath::se3::Transformation test_bad(notTransform, false);
+    EXPECT_TRUE(notTransform == test_bad.matrix());
+  }
+
   // Transformation& operator=(Transformation T);
   {
     lgmath::se3::Transformation test = rand;
@@ -209,6 +222,32 @@ TEST(LGMath, TransformationGetMethods) {
   std::cout << "T_ba: " << T_ba.r_ab_inb() << std::endl;
   std::cout << "r_ab_inb: " << r_ab_inb << std::endl;
   EXPECT_TRUE(lgmath::common::nearEqual(T_ba.r_ab_inb(), r_ab_inb, 1e-6));
+
+  // Test matrix34() and data(), which view the stored [C_ba | r_ab_inb]
+  EXPECT_TRUE(lgmath::common::nearEqual(T_ba.matrix34(),
+                                        test.topRows<3>(), 1e-12));
+  EXPECT_EQ(T_ba.data(), T_ba.matrix34().data());
+  EXPECT_EQ(T_ba.C_ba().data(), T_ba.data());
+  EXPECT_EQ(T_ba.r_ab_inb().data(), T_ba.data() + 9);
+
+  // A temporary gives copies rather than maps that would outlive it
+  typedef decltype(T_ba.inverse().C_ba()) TemporaryRotation;
+  typedef decltype(T_ba.inverse().r_ab_inb()) TemporaryTranslation;
+  static_assert(std::is_same<TemporaryRotation, Eigen::Matrix3d>::value,
+                "C_ba() of a temporary must copy");
+  static_assert(std::is_same<TemporaryTranslation, Eigen::Vector3d>::value,
+                "r_ab_inb() of a temporary must copy");
+  const auto C_inv = T_ba.inverse().C_ba();
+  const auto r_inv = T_ba.inverse().r_ab_inb();
+  EXPECT_TRUE(lgmath::common::nearEqual(C_inv, T_ba.C_ba().transpose(), 1e-9));
+  EXPECT_TRUE(lgmath::common::nearEqual(
+      r_inv, -T_ba.C_ba().transpose() * T_ba.r_ab_inb(), 1e-9));
+
+  // Test isometry() and the isometry constructor
+  const Eigen::Isometry3d iso = T_ba.isometry();
+  EXPECT_TRUE(lgmath::common::nearEqual(iso.matrix(), test, 1e-12));
+  EXPECT_TRUE(lgmath::common::nearEqual(
+      lgmath::se3::Transformation(iso).matrix(), test, 1e-6));
 }
 
 /////////////////////////////////////////////////////////////////////////////////////////////
@@ -446,6 +485,84 @@ TEST(LGMath, TransformationInverse) {
   }
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////
+/// \brief Test the fused Jacobians against finite differences
+/////////////////////////////////////////////////////////////////////////////////////////////
+TEST(LGMath, TransformationJacobians) {
+  using lgmath::se3::Transformation;
+  typedef Eigen::Matrix<double, 6, 1> Vector6d;
+  typedef Eigen::Matrix<double, 6, 6> Matrix6d;
+  const double h = 1e-6;
+
+  // Perturbs T on the left along axis k
+  auto perturb = [h](const Transformation& T, int k, double sign) {
+    return Transformation(Vector6d(sign * h * Vector6d::Unit(k))) * T;
+  };
+
+  for (unsigned i = 0; i < 20; i++) {
+    const Transformation T_1(Vector6d(Vector6d::Random()));
+    const Transformation T_2(Vector6d(Vector6d::Random()));
+    const Eigen::Vector3d p_a = Eigen::Vector3d::Random();
+
+    // Composition
+    Transformation T_12;
+    Matrix6d J_1, J_2;
+    lgmath::se3::composeWithJacobians(T_1, T_2, &T_12, &J_1, &J_2);
+    EXPECT_TRUE(lgmath::common::nearEqual((T_1 * T_2).matrix(),
+                                          T_12.matrix(), 1e-12));
+    EXPECT_TRUE(lgmath::common::nearEqual(J_1, Matrix6d::Identity(), 1e-12));
+    EXPECT_TRUE(lgmath::common::nearEqual(J_2, T_1.adjoint(), 1e-12));
+    Matrix6d J_num;
+    for (int k = 0; k < 6; ++k) {
+      J_num.col(k) = ((T_1 * perturb(T_2, k, 1.0)) / T_12).vec() / (2 * h) -
+                     ((T_1 * perturb(T_2, k, -1.0)) / T_12).vec() / (2 * h);
+    }
+    EXPECT_TRUE(lgmath::common::nearEqual(J_2, J_num, 1e-6));
+
+    // Composition in place
+    Transformation T_inplace = T_1;
+    lgmath::se3::composeWithJacobians(T_inplace, T_2, &T_inplace, nullptr,
+                                      &J_2);
+    EXPECT_TRUE(lgmath::common::nearEqual(T_inplace.matrix(), T_12.matrix(),
+                                          1e-12));
+    EXPECT_TRUE(lgmath::common::nearEqual(J_2, T_1.adjoint(), 1e-12));
+
+    // Without the reprojection, the product is the plain matrix product
+    Transformation T_plain;
+    lgmath::se3::composeWithJacobians(T_1, T_2, &T_plain, nullptr, nullptr,
+                                      false);
+    EXPECT_TRUE(lgmath::common::nearEqual(
+        T_plain.matrix(), T_1.matrix() * T_2.matrix(), 1e-14));
+    lgmath::se3::inverseWithJacobian(T_1, &T_plain, nullptr, false);
+    EXPECT_TRUE(lgmath::common::nearEqual(
+        T_plain.matrix(), T_1.matrix().inverse(), 1e-12));
+
+    // Inverse
+    Transformation T_inv;
+    Matrix6d J_inv;
+    lgmath::se3::inverseWithJacobian(T_1, &T_inv, &J_inv);
+    EXPECT_TRUE(lgmath::common::nearEqual(T_1.inverse().matrix(),
+                                          T_inv.matrix(), 1e-12));
+    EXPECT_TRUE(lgmath::common::nearEqual(J_inv, -T_inv.adjoint(), 1e-12));
+    for (int k = 0; k < 6; ++k) {
+      J_num.col(k) = (perturb(T_1, k, 1.0).inverse() / T_inv).vec() / (2 * h) -
+                     (perturb(T_1, k, -1.0).inverse() / T_inv).vec() / (2 * h);
+    }
+    EXPECT_TRUE(lgmath::common::nearEqual(J_inv, J_num, 1e-6));
+
+    // Point action
+    Eigen::Matrix3d J_p;
+    Eigen::Matrix<double, 3, 6> J_T;
+    const Eigen::Vector3d p_b =
+        lgmath::se3::transformPointWithJacobian(T_1, p_a, &J_p, &J_T);
+    EXPECT_TRUE(lgmath::common::nearEqual(
+        p_b, (T_1 * p_a.homogeneous()).head<3>(), 1e-12));
+    EXPECT_TRUE(lgmath::common::nearEqual(J_p, T_1.C_ba(), 1e-12));
+    EXPECT_TRUE(lgmath::common::nearEqual(
+        J_T, lgmath::se3::point2fs(p_b).topRows<3>(), 1e-12));
+  }
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
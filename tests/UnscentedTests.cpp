@@ -0,0 +1,119 @@
+//////////////////////////////////////////////////////////////////////////////////////////////
+/// \file UnscentedTests.cpp
+/// \brief Unit tests for the unscented transform through SE3 operations.
+///
+/// \author ASRL
+//////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <stdexcept>
+
+#include <Eigen/Dense>
+
+#include <lgmath.hpp>
+#include <lgmath/CommonMath.hpp>
+#include <lgmath/se3/Mean.hpp>
+#include <lgmath/se3/Sampling.hpp>
+#include <lgmath/se3/Unscented.hpp>
+
+#include "TestHelpers.hpp"
+
+using namespace lgmath;
+
+namespace {
+
+typedef Eigen::Matrix<double, 6, 1> Vector6d;
+typedef Eigen::Matrix<double, 6, 6> Matrix6d;
+
+/** \brief A random pose with a correlated covariance of the given scale */
+se3::TransformationWithCovariance testPose(double scale) {
+  const Matrix6d cov = test::randomCovariance(scale, 0.1 * scale * scale);
+  return se3::TransformationWithCovariance(
+      se3::Transformation(Vector6d(Vector6d::Random())), cov);
+}
+
+/** \brief Whether two poses with covariance are close */
+bool nearEqual(const se3::TransformationWithCovariance& T1,
+               const se3::TransformationWithCovariance& T2, double tolerance) {
+  return common::nearEqual(T1.matrix(), T2.matrix(), tolerance) &&
+         common::nearEqual(T1.cov(), T2.cov(), tolerance * T2.cov().norm());
+}
+
+}  // namespace
+
+/////////////////////////////////////////////////////////////////////////////////////////////
+///
+/// UNIT TESTS OF THE UNSCENTED TRANSFORM
+///
+/////////////////////////////////////////////////////////////////////////////////////////////
+
+TEST(LGMath, UnscentedTransform) {
+  const se3::TransformationWithCovariance T = testPose(0.3);
+
+  // Left multiplication by a constant is exact: A * exp(xi^) * T =
+  // exp((Ad(A) * xi)^) * A * T
+  const se3::Transformation A(Vector6d(Vector6d::Random()));
+  const se3::TransformationWithCovariance AT = se3::unscentedTransform(
+      T, [&](const se3::Transformation& X) { return A * X; });
+  EXPECT_TRUE(common::nearEqual(AT.matrix(), (A * T).matrix(), 1e-9));
+  EXPECT_TRUE(common::nearEqual(
+      AT.cov(), A.adjoint() * T.cov() * A.adjoint().transpose(), 1e-9));
+
+  // Compose and inverse agree with the linearized propagation for small
+  // covariances
+  const se3::TransformationWithCovariance T1 = testPose(1e-3);
+  const se3::TransformationWithCovariance T2 = testPose(1e-3);
+  EXPECT_TRUE(nearEqual(se3::unscentedCompose(T1, T2), T1 * T2, 1e-4));
+  EXPECT_TRUE(nearEqual(se3::unscentedInverse(T1), T1.inverse(), 1e-4));
+
+  se3::UnscentedOptions options;
+  options.alpha = 0.0;
+  EXPECT_THROW(se3::unscentedInverse(T, options), std::invalid_argument);
+  EXPECT_THROW(se3::unscentedInverse(se3::TransformationWithCovariance(
+                   se3::Transformation(T))),
+               std::logic_error);
+}
+
+TEST(LGMath, UnscentedLargeUncertainty) {
+  // With a large rotational uncertainty, the sigma points of T * T are closer
+  // to a Monte-Carlo estimate than the linearized propagation, whose
+  // Jacobian is 1 + Ad(T)
+  Matrix6d cov = 1e-2 * Matrix6d::Identity();
+  cov.bottomRightCorner<3, 3>() = 0.05 * Eigen::Matrix3d::Identity();
+  const se3::TransformationWithCovariance T(
+      se3::Transformation(
+          Vector6d((Vector6d() << 2.0, 0.0, 0.0, 0.0, 0.0, 0.3).finished())),
+      cov);
+
+  const std::size_t K = 20000;
+  se3::PoseArray samples(K);
+  std::mt19937_64 rng(3);
+  se3::sample(T, K, rng, samples.data(), samples.stride());
+  samples *= samples;
+  Matrix6d monteCarlo;
+  const se3::Transformation mean =
+      se3::mean(samples.transformations(), {}, se3::MeanMethod::KARCHER,
+                &monteCarlo);
+
+  const se3::TransformationWithCovariance unscented = se3::unscentedTransform(
+      T, [](const se3::Transformation& X) { return X * X; });
+  const Matrix6d J = Matrix6d::Identity() + T.adjoint();
+  const se3::Transformation linearized = T * T;
+  EXPECT_LT((unscented / mean).vec().norm(),
+            0.1 * (linearized / mean).vec().norm());
+  EXPECT_LT((unscented.cov() - monteCarlo).norm(), 0.1 * monteCarlo.norm());
+  EXPECT_LT((unscented.cov() - monteCarlo).norm(),
+            (J * T.cov() * J.transpose() - monteCarlo).norm());
+
+  // For independent left perturbations, each sigma point of compose is
+  // exactly linear, so that it agrees with the linearized propagation
+  const se3::TransformationWithCovariance T2 = testPose(0.3);
+  EXPECT_TRUE(nearEqual(se3::unscentedCompose(T, T2), T * T2, 1e-6));
+}
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}